@@ -0,0 +1,388 @@
+// Copyright (C) 2013, Steffen Knollmann
+// Released under the terms of the GNU General Public License version 3.
+// This file is part of `ginnungagap'.
+
+
+/*--- Doxygen file description ------------------------------------------*/
+
+/**
+ * @file bench/bench.c
+ * @ingroup  benchHarness
+ * @brief  Implements the benchmark harness.
+ */
+
+
+/*--- Includes ----------------------------------------------------------*/
+#include "bench.h"
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <assert.h>
+#ifdef WITH_MPI
+#  include <mpi.h>
+#endif
+#ifdef _OPENMP
+#  include <omp.h>
+#endif
+#include "../src/libutil/xmem.h"
+#include "../src/libutil/xstring.h"
+#include "../src/libutil/xfile.h"
+#include "../src/libutil/timer.h"
+
+
+/*--- Local defines -----------------------------------------------------*/
+
+/** @brief  The number of results for which space is added at once. */
+#define LOCAL_RESULTS_INCREMENT 16
+
+
+/*--- Local structures and typedefs -------------------------------------*/
+
+/** @brief  The timings of one benchmark. */
+struct local_result_struct {
+	/** @brief  The name of the benchmark. */
+	char     name[BENCHCONFIG_MAX_NAME_LENGTH];
+	/** @brief  The number of MPI ranks. */
+	int      numRanks;
+	/** @brief  The number of OpenMP threads per rank. */
+	int      numThreads;
+	/** @brief  The number of timed repetitions. */
+	int      numReps;
+	/** @brief  The fastest repetition in seconds. */
+	double   timeMin;
+	/** @brief  The median repetition in seconds. */
+	double   timeMedian;
+	/** @brief  The slowest repetition in seconds. */
+	double   timeMax;
+	/** @brief  The number of bytes processed by all ranks per call. */
+	uint64_t numBytes;
+};
+
+/** @brief  Convenience typedef. */
+typedef struct local_result_struct *local_result_t;
+
+/** @brief  The main structure of the harness. */
+struct bench_struct {
+	/** @brief  The number of timed repetitions. */
+	int            numReps;
+	/** @brief  Only benchmarks starting with this are run, or @c NULL. */
+	char           *filter;
+	/** @brief  The number of MPI ranks. */
+	int            numRanks;
+	/** @brief  The number of OpenMP threads per rank. */
+	int            numThreads;
+	/** @brief  The rank of this process. */
+	int            rank;
+	/** @brief  The number of results. */
+	int            numResults;
+	/** @brief  The number of results that fit into #results. */
+	int            numResultsAlloc;
+	/** @brief  The results. */
+	local_result_t results;
+};
+
+
+/*--- Prototypes of local functions -------------------------------------*/
+
+/**
+ * @brief  Compares two doubles, used to sort the times.
+ *
+ * @param[in]  *a
+ *                The first double.
+ * @param[in]  *b
+ *                The second double.
+ *
+ * @return  Returns -1, 0 or 1 if @c a is smaller, equal or larger
+ *          than @c b.
+ */
+static int
+local_cmpDouble(const void *a, const void *b);
+
+
+/**
+ * @brief  Appends an empty result.
+ *
+ * @param[in,out]  bench
+ *                    The harness.
+ * @param[in]      *name
+ *                    The name of the benchmark.
+ *
+ * @return  Returns the new result.
+ */
+static local_result_t
+local_addResult(bench_t bench, const char *name);
+
+
+/**
+ * @brief  Looks up a result in a baseline file.
+ *
+ * @param[in]   *f
+ *                 The baseline file, will be rewound.
+ * @param[in]   result
+ *                 The result to look for.
+ * @param[out]  *timeMedian
+ *                 Receives the median time of the baseline.
+ *
+ * @return  Returns @c true if the baseline has an entry for the result.
+ */
+static bool
+local_findInBaseline(FILE                 *f,
+                     const local_result_t result,
+                     double               *timeMedian);
+
+
+/*--- Implementations of exported functions -----------------------------*/
+extern bench_t
+bench_new(int numReps, const char *filter)
+{
+	bench_t bench;
+
+	assert(numReps > 0);
+
+	bench                  = xmalloc(sizeof(struct bench_struct));
+	bench->numReps         = numReps;
+	bench->filter          = (filter == NULL) ? NULL : xstrdup(filter);
+	bench->numRanks        = 1;
+	bench->numThreads      = 1;
+	bench->rank            = 0;
+	bench->numResults      = 0;
+	bench->numResultsAlloc = 0;
+	bench->results         = NULL;
+#ifdef WITH_MPI
+	MPI_Comm_size(MPI_COMM_WORLD, &(bench->numRanks));
+	MPI_Comm_rank(MPI_COMM_WORLD, &(bench->rank));
+#endif
+#ifdef _OPENMP
+	bench->numThreads = omp_get_max_threads();
+#endif
+
+	return bench;
+}
+
+extern void
+bench_del(bench_t *bench)
+{
+	assert(bench != NULL && *bench != NULL);
+
+	if ((*bench)->filter != NULL)
+		xfree((*bench)->filter);
+	if ((*bench)->results != NULL)
+		xfree((*bench)->results);
+	xfree(*bench);
+
+	*bench = NULL;
+}
+
+extern bool
+bench_isSelected(const bench_t bench, const char *prefix)
+{
+	size_t lenPrefix, lenFilter;
+
+	assert(bench != NULL);
+	assert(prefix != NULL);
+
+	if (bench->filter == NULL)
+		return true;
+
+	lenPrefix = strlen(prefix);
+	lenFilter = strlen(bench->filter);
+
+	// Either the filter selects a part of the group or the whole group.
+	return strncmp(prefix, bench->filter,
+	               lenPrefix < lenFilter ? lenPrefix : lenFilter) == 0;
+}
+
+extern void
+bench_run(bench_t      bench,
+          const char   *name,
+          bench_func_t prepare,
+          bench_func_t run,
+          void         *data,
+          uint64_t     numBytes)
+{
+	local_result_t result;
+	double         *times;
+	double         numBytesTotal = (double)numBytes;
+
+	assert(bench != NULL);
+	assert(name != NULL && strlen(name) < BENCHCONFIG_MAX_NAME_LENGTH);
+	assert(strchr(name, ',') == NULL);
+	assert(run != NULL);
+
+	if ((bench->filter != NULL)
+	    && (strncmp(name, bench->filter, strlen(bench->filter)) != 0))
+		return;
+
+	if (bench->rank == 0) {
+		printf("  %-40s ", name);
+		fflush(stdout);
+	}
+
+	times = xmalloc(sizeof(double) * bench->numReps);
+	for (int i = 0; i < bench->numReps; i++) {
+		double timing;
+
+		if (prepare != NULL)
+			prepare(data);
+		// timer_start() and timer_stop() synchronise the ranks and
+		// give the time of the slowest one.
+		timing   = timer_start();
+		run(data);
+		times[i] = timer_stop(timing);
+	}
+	qsort(times, (size_t)(bench->numReps), sizeof(double),
+	      &local_cmpDouble);
+#ifdef WITH_MPI
+	MPI_Allreduce(MPI_IN_PLACE, &numBytesTotal, 1, MPI_DOUBLE, MPI_SUM,
+	              MPI_COMM_WORLD);
+#endif
+
+	result             = local_addResult(bench, name);
+	result->timeMin    = times[0];
+	result->timeMedian = times[bench->numReps / 2];
+	result->timeMax    = times[bench->numReps - 1];
+	result->numBytes   = (uint64_t)numBytesTotal;
+	xfree(times);
+
+	if (bench->rank == 0) {
+		printf("%12.6fs", result->timeMedian);
+		if ((result->numBytes > 0) && (result->timeMedian > 0.))
+			printf("  %10.2f MiB/s", result->numBytes / result->timeMedian
+			       / (1024. * 1024.));
+		printf("\n");
+	}
+} /* bench_run */
+
+extern void
+bench_write(const bench_t bench, const char *fileName)
+{
+	FILE *f;
+
+	assert(bench != NULL);
+
+	if (bench->rank != 0)
+		return;
+
+	f = (fileName == NULL) ? stdout : xfopen(fileName, "w");
+
+	fprintf(f, "# name,numRanks,numThreads,numReps,timeMin,timeMedian,"
+	        "timeMax,numBytes,bytesPerSec\n");
+	for (int i = 0; i < bench->numResults; i++) {
+		local_result_t r = bench->results + i;
+		fprintf(f, "%s,%i,%i,%i,%e,%e,%e,%" PRIu64 ",%e\n",
+		        r->name, r->numRanks, r->numThreads, r->numReps,
+		        r->timeMin, r->timeMedian, r->timeMax, r->numBytes,
+		        (r->timeMedian > 0.) ? r->numBytes / r->timeMedian : 0.);
+	}
+
+	if (fileName != NULL)
+		xfclose(&f);
+}
+
+extern int
+bench_compare(const bench_t bench,
+              const char    *baselineFileName,
+              double        tolerance)
+{
+	FILE *f;
+	int  numRegressions = 0;
+
+	assert(bench != NULL);
+	assert(baselineFileName != NULL);
+	assert(tolerance >= 0.0);
+
+	if (bench->rank == 0) {
+		f = xfopen(baselineFileName, "r");
+		printf("\nComparison against %s (tolerance %.1f%%):\n",
+		       baselineFileName, tolerance * 100.);
+		printf("  %-40s %12s %12s %8s\n",
+		       "name", "baseline", "current", "ratio");
+		for (int i = 0; i < bench->numResults; i++) {
+			local_result_t r = bench->results + i;
+			double         timeBaseline;
+
+			if (!local_findInBaseline(f, r, &timeBaseline)) {
+				printf("  %-40s %12s %11.6fs %8s  new\n",
+				       r->name, "-", r->timeMedian, "-");
+			} else {
+				double ratio = r->timeMedian / timeBaseline;
+				printf("  %-40s %11.6fs %11.6fs %8.3f",
+				       r->name, timeBaseline, r->timeMedian, ratio);
+				if (ratio > 1. + tolerance) {
+					printf("  REGRESSION");
+					numRegressions++;
+				} else if (ratio < 1. - tolerance) {
+					printf("  improved");
+				}
+				printf("\n");
+			}
+		}
+		xfclose(&f);
+		printf("%i regression(s)\n", numRegressions);
+	}
+#ifdef WITH_MPI
+	MPI_Bcast(&numRegressions, 1, MPI_INT, 0, MPI_COMM_WORLD);
+#endif
+
+	return numRegressions;
+} /* bench_compare */
+
+/*--- Implementations of local functions --------------------------------*/
+static int
+local_cmpDouble(const void *a, const void *b)
+{
+	double da = *(const double *)a;
+	double db = *(const double *)b;
+
+	return (da < db) ? -1 : ((da > db) ? 1 : 0);
+}
+
+static local_result_t
+local_addResult(bench_t bench, const char *name)
+{
+	local_result_t result;
+
+	if (bench->numResults == bench->numResultsAlloc) {
+		bench->numResultsAlloc += LOCAL_RESULTS_INCREMENT;
+		bench->results          = xrealloc(bench->results,
+		                                   sizeof(struct local_result_struct)
+		                                   * bench->numResultsAlloc);
+	}
+	result = bench->results + bench->numResults;
+	bench->numResults++;
+
+	memset(result, 0, sizeof(struct local_result_struct));
+	strcpy(result->name, name);
+	result->numRanks   = bench->numRanks;
+	result->numThreads = bench->numThreads;
+	result->numReps    = bench->numReps;
+
+	return result;
+}
+
+static bool
+local_findInBaseline(FILE                 *f,
+                     const local_result_t result,
+                     double               *timeMedian)
+{
+	char   line[256];
+	char   name[BENCHCONFIG_MAX_NAME_LENGTH];
+	int    numRanks, numThreads, numReps;
+	double timeMin, timeMax;
+
+	rewind(f);
+	while (fgets(line, 256, f) != NULL) {
+		if (line[0] == '#')
+			continue;
+		if (sscanf(line, "%63[^,],%i,%i,%i,%le,%le,%le", name, &numRanks,
+		           &numThreads, &numReps, &timeMin, timeMedian,
+		           &timeMax) != 7)
+			continue;
+		if ((strcmp(name, result->name) == 0)
+		    && (numRanks == result->numRanks)
+		    && (numThreads == result->numThreads))
+			return true;
+	}
+
+	return false;
+}
@@ -0,0 +1,173 @@
+// Copyright (C) 2013, Steffen Knollmann
+// Released under the terms of the GNU General Public License version 3.
+// This file is part of `ginnungagap'.
+
+#ifndef BENCH_H
+#define BENCH_H
+
+
+/*--- Doxygen file description ------------------------------------------*/
+
+/**
+ * @file bench/bench.h
+ * @ingroup  benchHarness
+ * @brief  Provides the interface of the benchmark harness.
+ *
+ * A benchmark is a function that is called a number of times, each call
+ * is preceded by an untimed preparation (to reset the input data) and a
+ * barrier.  The time of a call is the time of the slowest rank.  For
+ * every benchmark the minimum, median and maximum of these times are
+ * kept together with the number of bytes processed by all ranks in one
+ * call.  The results are written as CSV and can be compared against the
+ * CSV of an earlier run.
+ *
+ * All functions are collective over @c MPI_COMM_WORLD.
+ */
+
+
+/*--- Includes ----------------------------------------------------------*/
+#include "benchConfig.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+
+/*--- ADT handle --------------------------------------------------------*/
+
+/** @brief  Provides a handle for the benchmark harness. */
+typedef struct bench_struct *bench_t;
+
+/** @brief  The signature of the functions that are run and timed. */
+typedef void (*bench_func_t)(void *data);
+
+
+/*--- Prototypes of exported functions ----------------------------------*/
+
+/**
+ * @brief  Creates a new harness.
+ *
+ * @param[in]  numReps
+ *                The number of timed repetitions of every benchmark,
+ *                must be positive.
+ * @param[in]  *filter
+ *                Only benchmarks whose name starts with this string are
+ *                run, pass @c NULL to run all.
+ *
+ * @return  Returns a new harness without results.
+ */
+extern bench_t
+bench_new(int numReps, const char *filter);
+
+
+/**
+ * @brief  Deletes a harness.
+ *
+ * @param[in,out]  *bench
+ *                    The harness to delete, will be set to @c NULL.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+bench_del(bench_t *bench);
+
+
+/**
+ * @brief  Checks whether benchmarks with a given prefix will be run.
+ *
+ * This allows to skip the setup of a group of benchmarks that are all
+ * filtered out.
+ *
+ * @param[in]  bench
+ *                The harness.
+ * @param[in]  *prefix
+ *                The prefix of the names of the benchmarks.
+ *
+ * @return  Returns @c true if at least one benchmark with a name
+ *          starting with @c prefix passes the filter.
+ */
+extern bool
+bench_isSelected(const bench_t bench, const char *prefix);
+
+
+/**
+ * @brief  Runs and times a benchmark.
+ *
+ * Does nothing if the benchmark is filtered out.
+ *
+ * @param[in,out]  bench
+ *                    The harness.
+ * @param[in]      *name
+ *                    The name of the benchmark, must be unique, must not
+ *                    contain a comma and must be shorter than
+ *                    #BENCHCONFIG_MAX_NAME_LENGTH.
+ * @param[in]      prepare
+ *                    This is called before every repetition and not timed,
+ *                    may be @c NULL.
+ * @param[in]      run
+ *                    The function to time.
+ * @param[in,out]  *data
+ *                    Passed to @c prepare and @c run.
+ * @param[in]      numBytes
+ *                    The number of bytes the calling rank processes in one
+ *                    call of @c run, used to calculate the bandwidth.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+bench_run(bench_t      bench,
+          const char   *name,
+          bench_func_t prepare,
+          bench_func_t run,
+          void         *data,
+          uint64_t     numBytes);
+
+
+/**
+ * @brief  Writes the results as CSV.
+ *
+ * Only rank 0 writes.
+ *
+ * @param[in]  bench
+ *                The harness.
+ * @param[in]  *fileName
+ *                The file to write to, if @c NULL the results are written
+ *                to @c stdout.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+bench_write(const bench_t bench, const char *fileName);
+
+
+/**
+ * @brief  Compares the results against a baseline.
+ *
+ * Benchmarks are matched by name, number of ranks and number of threads;
+ * the median times are compared.  A table with the ratios is printed by
+ * rank 0.
+ *
+ * @param[in]  bench
+ *                The harness.
+ * @param[in]  *baselineFileName
+ *                A file written by bench_write().
+ * @param[in]  tolerance
+ *                The relative slowdown that is still accepted.
+ *
+ * @return  Returns the number of benchmarks that are slower than the
+ *          baseline by more than @c tolerance, the same on all ranks.
+ */
+extern int
+bench_compare(const bench_t bench,
+              const char    *baselineFileName,
+              double        tolerance);
+
+
+/*--- Doxygen group definitions -----------------------------------------*/
+
+/**
+ * @defgroup benchHarness Harness
+ * @ingroup  bench
+ * @brief  Provides the timing and reporting of benchmarks.
+ */
+
+#endif
@@ -0,0 +1,62 @@
+// Copyright (C) 2013, Steffen Knollmann
+// Released under the terms of the GNU General Public License version 3.
+// This file is part of `ginnungagap'.
+
+#ifndef BENCHCONFIG_H
+#define BENCHCONFIG_H
+
+
+/*--- Doxygen file description ------------------------------------------*/
+
+/**
+ * @file bench/benchConfig.h
+ * @ingroup  benchConfig
+ * @brief  Provides code configuration for the benchmark harness.
+ */
+
+
+/*--- Includes ----------------------------------------------------------*/
+#include "../config.h"
+
+
+/*--- Defines -----------------------------------------------------------*/
+
+/** @brief  Gives the default number of cells per dimension of the grids. */
+#define BENCHCONFIG_DEFAULT_DIM1D 64
+
+/** @brief  Gives the default number of timed repetitions. */
+#define BENCHCONFIG_DEFAULT_NUMREPS 5
+
+/**
+ * @brief  Gives the default relative slowdown of the median time
+ *         against the baseline above which a benchmark counts as
+ *         regressed.
+ */
+#define BENCHCONFIG_DEFAULT_TOLERANCE 0.1
+
+/** @brief  Gives the maximal length of the name of a benchmark. */
+#define BENCHCONFIG_MAX_NAME_LENGTH 64
+
+/** @brief  Gives the prefix of all files written by the I/O benchmarks. */
+#define BENCHCONFIG_FILE_PREFIX "benchTmp"
+
+/** @brief  Gives the number of ranks writing a Grafic file concurrently. */
+#define BENCHCONFIG_NUM_CONCURRENT_WRITERS 4
+
+
+/*--- Doxygen group definitions -----------------------------------------*/
+
+/**
+ * @defgroup benchConfig Code Configuration
+ * @ingroup  bench
+ * @brief  Provides the code configuration.
+ */
+
+/**
+ * @defgroup bench  Benchmarks
+ * @brief  Provides micro- and macro-benchmarks of the performance
+ *         critical parts of the code and a comparison against stored
+ *         baselines.
+ */
+
+#endif
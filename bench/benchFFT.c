@@ -0,0 +1,140 @@
+// Copyright (C) 2013, Steffen Knollmann
+// Released under the terms of the GNU General Public License version 3.
+// This file is part of `ginnungagap'.
+
+
+/*--- Doxygen file description ------------------------------------------*/
+
+/**
+ * @file bench/benchFFT.c
+ * @ingroup  benchKernels
+ * @brief  Implements the benchmarks of the parallel FFT and the grid
+ *         transposition.
+ */
+
+
+/*--- Includes ----------------------------------------------------------*/
+#include "benchFFT.h"
+#include <stdio.h>
+#include <assert.h>
+#ifdef WITH_MPI
+#  include <mpi.h>
+#endif
+#include "benchGrid.h"
+#include "../src/libutil/memPool.h"
+
+
+/*--- Prototypes of local functions -------------------------------------*/
+
+/**
+ * @brief  Benchmarks one process grid.
+ *
+ * @param[in,out]  bench
+ *                    The harness.
+ * @param[in]      dim1D
+ *                    The number of cells per dimension of the grid.
+ * @param[in]      nProcs
+ *                    The process grid.
+ *
+ * @return  Returns nothing.
+ */
+static void
+local_runForProcessGrid(bench_t              bench,
+                        uint32_t             dim1D,
+                        const gridPointInt_t nProcs);
+
+
+/** @brief  Refills the grid, a #bench_func_t. */
+static void
+local_prepare(void *data);
+
+
+#ifdef WITH_FFT_FFTW3
+/** @brief  Does a forward and a backward FFT, a #bench_func_t. */
+static void
+local_roundTrip(void *data);
+
+#endif
+
+/** @brief  Transposes the first two dimensions twice, a #bench_func_t. */
+static void
+local_transpose(void *data);
+
+
+/*--- Implementations of exported functions -----------------------------*/
+extern void
+benchFFT_run(bench_t bench, uint32_t dim1D)
+{
+	gridPointInt_t nProcs;
+	int            numRanks = 1;
+
+	assert(bench != NULL);
+
+	if (!bench_isSelected(bench, "fft.")
+	    && !bench_isSelected(bench, "transpose."))
+		return;
+
+#ifdef WITH_MPI
+	MPI_Comm_size(MPI_COMM_WORLD, &numRanks);
+#endif
+	for (int i = 0; benchGrid_getProcessGrid(numRanks, i, nProcs); i++)
+		local_runForProcessGrid(bench, dim1D, nProcs);
+
+	memPool_trim();
+}
+
+/*--- Implementations of local functions --------------------------------*/
+static void
+local_runForProcessGrid(bench_t              bench,
+                        uint32_t             dim1D,
+                        const gridPointInt_t nProcs)
+{
+	benchGrid_t bg;
+	char        name[BENCHCONFIG_MAX_NAME_LENGTH];
+	uint64_t    numBytes;
+
+	bg       = benchGrid_new(dim1D, nProcs,
+	                         bench_isSelected(bench, "fft."));
+	numBytes = benchGrid_getLocalBytes(bg);
+
+#ifdef WITH_FFT_FFTW3
+	snprintf(name, BENCHCONFIG_MAX_NAME_LENGTH, "fft.roundtrip.%ix%ix%i.%u",
+	         nProcs[0], nProcs[1], nProcs[2], dim1D);
+	bench_run(bench, name, &local_prepare, &local_roundTrip, bg,
+	          2 * numBytes);
+#endif
+
+	snprintf(name, BENCHCONFIG_MAX_NAME_LENGTH, "transpose.xy.%ix%ix%i.%u",
+	         nProcs[0], nProcs[1], nProcs[2], dim1D);
+	bench_run(bench, name, &local_prepare, &local_transpose, bg,
+	          2 * numBytes);
+
+	benchGrid_del(&bg);
+}
+
+static void
+local_prepare(void *data)
+{
+	benchGrid_fill((benchGrid_t)data);
+}
+
+#ifdef WITH_FFT_FFTW3
+static void
+local_roundTrip(void *data)
+{
+	benchGrid_t bg = (benchGrid_t)data;
+
+	gridRegularFFT_execute(bg->fft, GRIDREGULARFFT_FORWARD);
+	gridRegularFFT_execute(bg->fft, GRIDREGULARFFT_BACKWARD);
+}
+
+#endif
+
+static void
+local_transpose(void *data)
+{
+	benchGrid_t bg = (benchGrid_t)data;
+
+	gridRegularDistrib_transpose(bg->distrib, 0, 1);
+	gridRegularDistrib_transpose(bg->distrib, 0, 1);
+}
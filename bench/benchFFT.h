@@ -0,0 +1,55 @@
+// Copyright (C) 2013, Steffen Knollmann
+// Released under the terms of the GNU General Public License version 3.
+// This file is part of `ginnungagap'.
+
+#ifndef BENCHFFT_H
+#define BENCHFFT_H
+
+
+/*--- Doxygen file description ------------------------------------------*/
+
+/**
+ * @file bench/benchFFT.h
+ * @ingroup  benchKernels
+ * @brief  Provides the benchmarks of the parallel FFT and the grid
+ *         transposition.
+ */
+
+
+/*--- Includes ----------------------------------------------------------*/
+#include "benchConfig.h"
+#include <stdint.h>
+#include "bench.h"
+
+
+/*--- Prototypes of exported functions ----------------------------------*/
+
+/**
+ * @brief  Runs the benchmarks @c fft.* and @c transpose.*.
+ *
+ * Every process grid 1 x a x b that can be formed from the ranks is
+ * benchmarked.  @c fft.roundtrip times a forward and a backward FFT,
+ * @c transpose.xy times two transpositions of the first two dimensions
+ * of the real grid, i.e. the communication of the FFT without the
+ * transforms.
+ *
+ * @param[in,out]  bench
+ *                    The harness.
+ * @param[in]      dim1D
+ *                    The number of cells per dimension of the grid.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+benchFFT_run(bench_t bench, uint32_t dim1D);
+
+
+/*--- Doxygen group definitions -----------------------------------------*/
+
+/**
+ * @defgroup benchKernels Benchmarks
+ * @ingroup  bench
+ * @brief  Provides the benchmarks of the individual parts of the code.
+ */
+
+#endif
@@ -0,0 +1,191 @@
+// Copyright (C) 2013, Steffen Knollmann
+// Released under the terms of the GNU General Public License version 3.
+// This file is part of `ginnungagap'.
+
+
+/*--- Doxygen file description ------------------------------------------*/
+
+/**
+ * @file bench/benchGenICs.c
+ * @ingroup  benchKernels
+ * @brief  Implements the benchmarks of the particle kernels of
+ *         generateICs.
+ */
+
+
+/*--- Includes ----------------------------------------------------------*/
+#include "benchGenICs.h"
+#include <stdio.h>
+#include <assert.h>
+#ifdef WITH_MPI
+#  include <mpi.h>
+#endif
+#include "benchIC.h"
+#include "../src/libgrid/gridPatch.h"
+#include "../src/libgrid/gridRegularDistrib.h"
+#include "../src/libdata/dataVar.h"
+#include "../src/libcosmo/cosmoModel.h"
+#include "../src/libutil/xmem.h"
+#include "../src/libg9p/g9pHierarchy.h"
+#include "../src/libg9p/g9pIDGenerator.h"
+#include "../tools/generateICs/generateICsCore.h"
+#include "../tools/generateICs/generateICsData.h"
+#include "../tools/generateICs/generateICsMode.h"
+
+
+/*--- Local defines -----------------------------------------------------*/
+
+/** @brief  The expansion factor of the initial conditions. */
+#define LOCAL_AINIT (1. / 51.)
+
+
+/*--- Prototypes of local functions -------------------------------------*/
+
+/**
+ * @brief  Creates the patch holding the velocities of this rank.
+ *
+ * @param[in]  dim1D
+ *                The number of cells per dimension of the grid.
+ *
+ * @return  Returns a slab of the grid with three filled velocity
+ *          variables.
+ */
+static gridPatch_t
+local_newVelocityPatch(uint32_t dim1D);
+
+
+/** @brief  Runs generateICsCore_initPosID(), a #bench_func_t. */
+static void
+local_initPosID(void *data);
+
+
+/** @brief  Runs generateICsCore_vel2pos(), a #bench_func_t. */
+static void
+local_vel2pos(void *data);
+
+
+/** @brief  Runs generateICsCore_convertVel(), a #bench_func_t. */
+static void
+local_convertVel(void *data);
+
+
+/*--- Implementations of exported functions -----------------------------*/
+extern void
+benchGenICs_run(bench_t bench, uint32_t dim1D)
+{
+	cosmoModel_t      model;
+	generateICsData_t data;
+	generateICsMode_t mode;
+	char              name[BENCHCONFIG_MAX_NAME_LENGTH];
+	uint64_t          numBytes;
+
+	assert(bench != NULL);
+
+	if (!bench_isSelected(bench, "genics."))
+		return;
+
+	model = benchIC_newModel();
+	data  = generateICsData_new((double)dim1D, LOCAL_AINIT, model);
+	mode  = generateICsMode_new(false, false, false, false, false, false,
+	                            G9PIDGENERATOR_SCHEME_ROWMAJOR);
+	{
+		generateICsCore_s core = GENICSCORE_INIT_STRUCT(data, mode);
+
+		core.patch        = local_newVelocityPatch(dim1D);
+		core.numParticles = gridPatch_getNumCells(core.patch);
+		core.pos          = xmalloc(sizeof(fpv_t) * 3 * core.numParticles);
+		core.vel          = xmalloc(sizeof(fpv_t) * 3 * core.numParticles);
+		core.id           = xmalloc(sizeof(uint32_t) * core.numParticles);
+		core.maskDim1D    = dim1D;
+		core.partDim1D    = dim1D;
+		core.idGen        = g9pIDGenerator_new(
+		    g9pHierarchy_newWithSimpleFactor(1, dim1D, 2), 0);
+		for (int i = 0; i < NDIM; i++)
+			core.fullDims[i] = dim1D;
+
+		numBytes = (sizeof(fpv_t) * 9 + sizeof(uint32_t))
+		           * core.numParticles;
+		snprintf(name, BENCHCONFIG_MAX_NAME_LENGTH, "genics.initPosID.%u",
+		         dim1D);
+		bench_run(bench, name, NULL, &local_initPosID, &core, numBytes);
+
+		// The other kernels change the particles in place, they are
+		// recreated before every repetition.
+		numBytes = sizeof(fpv_t) * 9 * core.numParticles;
+		snprintf(name, BENCHCONFIG_MAX_NAME_LENGTH, "genics.vel2pos.%u",
+		         dim1D);
+		bench_run(bench, name, &local_initPosID, &local_vel2pos, &core,
+		          numBytes);
+		numBytes = sizeof(fpv_t) * 6 * core.numParticles;
+		snprintf(name, BENCHCONFIG_MAX_NAME_LENGTH, "genics.convertVel.%u",
+		         dim1D);
+		bench_run(bench, name, &local_initPosID, &local_convertVel, &core,
+		          numBytes);
+
+		g9pIDGenerator_del(&(core.idGen));
+		xfree(core.id);
+		xfree(core.vel);
+		xfree(core.pos);
+		gridPatch_del(&(core.patch));
+	}
+	generateICsMode_del(&mode);
+	// The data has taken over the model.
+	generateICsData_del(&data);
+} /* benchGenICs_run */
+
+/*--- Implementations of local functions --------------------------------*/
+static gridPatch_t
+local_newVelocityPatch(uint32_t dim1D)
+{
+	gridPatch_t       patch;
+	gridPointUint32_t idxLo, idxHi;
+	int               numRanks = 1;
+	int               rank     = 0;
+	const char        *names[3] = {"velx", "vely", "velz"};
+
+#ifdef WITH_MPI
+	MPI_Comm_size(MPI_COMM_WORLD, &numRanks);
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+	idxLo[0] = idxLo[1] = 0;
+	idxHi[0] = idxHi[1] = dim1D - 1;
+	gridRegularDistrib_calcIdxsForRank1D(dim1D, numRanks, rank,
+	                                     idxLo + 2, idxHi + 2, 1, 1);
+
+	patch = gridPatch_new(idxLo, idxHi);
+	for (int i = 0; i < 3; i++) {
+		dataVar_t var = dataVar_new(names[i], DATAVARTYPE_FPV, 1);
+		fpv_t     *values;
+		uint64_t  numCells;
+
+		(void)gridPatch_attachVar(patch, var);
+		dataVar_del(&var);
+		values   = gridPatch_getVarDataHandle(patch, i);
+		numCells = gridPatch_getNumCells(patch);
+		for (uint64_t j = 0; j < numCells; j++)
+			values[j] = (fpv_t)((int)((j + i) % 17) - 8) * FPV_C(0.125);
+	}
+
+	return patch;
+}
+
+static void
+local_initPosID(void *data)
+{
+	generateICsCore_t core = data;
+
+	core->startID = 0;
+	generateICsCore_initPosID(core);
+}
+
+static void
+local_vel2pos(void *data)
+{
+	generateICsCore_vel2pos((generateICsCore_t)data);
+}
+
+static void
+local_convertVel(void *data)
+{
+	generateICsCore_convertVel((generateICsCore_t)data);
+}
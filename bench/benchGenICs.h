@@ -0,0 +1,44 @@
+// Copyright (C) 2013, Steffen Knollmann
+// Released under the terms of the GNU General Public License version 3.
+// This file is part of `ginnungagap'.
+
+#ifndef BENCHGENICS_H
+#define BENCHGENICS_H
+
+
+/*--- Doxygen file description ------------------------------------------*/
+
+/**
+ * @file bench/benchGenICs.h
+ * @ingroup  benchKernels
+ * @brief  Provides the benchmarks of the particle kernels of generateICs.
+ */
+
+
+/*--- Includes ----------------------------------------------------------*/
+#include "benchConfig.h"
+#include <stdint.h>
+#include "bench.h"
+
+
+/*--- Prototypes of exported functions ----------------------------------*/
+
+/**
+ * @brief  Runs the benchmarks @c genics.*.
+ *
+ * Every rank turns a slab of the grid into particles without a mask,
+ * timing generateICsCore_initPosID(), generateICsCore_vel2pos() and
+ * generateICsCore_convertVel() separately.
+ *
+ * @param[in,out]  bench
+ *                    The harness.
+ * @param[in]      dim1D
+ *                    The number of cells per dimension of the grid.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+benchGenICs_run(bench_t bench, uint32_t dim1D);
+
+
+#endif
@@ -0,0 +1,145 @@
+// Copyright (C) 2013, Steffen Knollmann
+// Released under the terms of the GNU General Public License version 3.
+// This file is part of `ginnungagap'.
+
+
+/*--- Doxygen file description ------------------------------------------*/
+
+/**
+ * @file bench/benchGrid.c
+ * @ingroup  benchGrid
+ * @brief  Implements the synthetic distributed grid.
+ */
+
+
+/*--- Includes ----------------------------------------------------------*/
+#include "benchGrid.h"
+#include <assert.h>
+#ifdef WITH_MPI
+#  include <mpi.h>
+#endif
+#include "../src/libutil/xmem.h"
+#include "../src/libutil/memPool.h"
+#include "../src/libdata/dataVar.h"
+
+
+/*--- Implementations of exported functions -----------------------------*/
+extern benchGrid_t
+benchGrid_new(uint32_t dim1D, const gridPointInt_t nProcs, bool withFFT)
+{
+	benchGrid_t       bg;
+	gridPointDbl_t    origin, extent;
+	gridPointUint32_t dims;
+	dataVar_t         var;
+	int               localRank = 0;
+
+	assert(dim1D > 0);
+
+	bg        = xmalloc(sizeof(struct benchGrid_struct));
+	bg->dim1D = dim1D;
+	for (int i = 0; i < NDIM; i++) {
+		bg->nProcs[i] = nProcs[i];
+		origin[i]     = 0.0;
+		extent[i]     = (double)dim1D;
+		dims[i]       = dim1D;
+	}
+
+	bg->grid    = gridRegular_new("bench", origin, extent, dims);
+	bg->distrib = gridRegularDistrib_new(bg->grid, NULL);
+#ifdef WITH_MPI
+	gridRegularDistrib_initMPI(bg->distrib, bg->nProcs, MPI_COMM_WORLD);
+	localRank = gridRegularDistrib_getLocalRank(bg->distrib);
+#endif
+	bg->patch = gridRegularDistrib_getPatchForRank(bg->distrib, localRank);
+	gridRegular_attachPatch(bg->grid, bg->patch);
+
+	var = dataVar_new("data", DATAVARTYPE_FPV, 1);
+	dataVar_setMemFuncs(var, &memPool_malloc, &memPool_free);
+	if (withFFT)
+		dataVar_setFFTWPadded(var);
+	bg->idxOfVar = gridRegular_attachVar(bg->grid, var);
+
+	bg->fft      = withFFT ? gridRegularFFT_new(bg->grid, bg->distrib,
+	                                            bg->idxOfVar) : NULL;
+
+	return bg;
+}
+
+extern void
+benchGrid_del(benchGrid_t *bg)
+{
+	assert(bg != NULL && *bg != NULL);
+
+	if ((*bg)->fft != NULL)
+		gridRegularFFT_del(&((*bg)->fft));
+	gridRegularDistrib_del(&((*bg)->distrib));
+	gridRegular_del(&((*bg)->grid));
+	xfree(*bg);
+
+	*bg = NULL;
+}
+
+extern void
+benchGrid_fill(benchGrid_t bg)
+{
+	fpv_t    *data;
+	uint64_t numCells;
+
+	assert(bg != NULL);
+
+	// Transpositions under MPI replace the patch of the grid.
+	bg->patch = gridRegular_getPatchHandle(bg->grid, 0);
+	data      = gridPatch_getVarDataHandle(bg->patch, bg->idxOfVar);
+	numCells  = gridPatch_getNumCellsActual(bg->patch, bg->idxOfVar);
+
+#ifdef _OPENMP
+#  pragma omp parallel for
+#endif
+	for (uint64_t i = 0; i < numCells; i++)
+		data[i] = (fpv_t)((int)(i % 17) - 8) * FPV_C(0.125);
+}
+
+extern uint64_t
+benchGrid_getLocalBytes(const benchGrid_t bg)
+{
+	assert(bg != NULL);
+
+	return gridPatch_getNumCells(bg->patch) * sizeof(fpv_t);
+}
+
+extern bool
+benchGrid_getProcessGrid(int numRanks, int idx, gridPointInt_t nProcs)
+{
+	assert(numRanks > 0);
+	assert(idx >= 0);
+
+	for (int a = 1; a <= numRanks; a++) {
+		if (numRanks % a != 0)
+			continue;
+		if (idx == 0) {
+			nProcs[0] = 1;
+			nProcs[1] = a;
+			nProcs[2] = numRanks / a;
+			return true;
+		}
+		idx--;
+	}
+
+	return false;
+}
+
+extern void
+benchGrid_getDefaultProcessGrid(int numRanks, gridPointInt_t nProcs)
+{
+	int a = 1;
+
+	assert(numRanks > 0);
+
+	for (int i = 1; i * i <= numRanks; i++) {
+		if (numRanks % i == 0)
+			a = i;
+	}
+	nProcs[0] = 1;
+	nProcs[1] = a;
+	nProcs[2] = numRanks / a;
+}
@@ -0,0 +1,155 @@
+// Copyright (C) 2013, Steffen Knollmann
+// Released under the terms of the GNU General Public License version 3.
+// This file is part of `ginnungagap'.
+
+#ifndef BENCHGRID_H
+#define BENCHGRID_H
+
+
+/*--- Doxygen file description ------------------------------------------*/
+
+/**
+ * @file bench/benchGrid.h
+ * @ingroup  benchGrid
+ * @brief  Provides the synthetic distributed grid used by the benchmarks.
+ */
+
+
+/*--- Includes ----------------------------------------------------------*/
+#include "benchConfig.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include "../src/libgrid/gridRegular.h"
+#include "../src/libgrid/gridRegularDistrib.h"
+#include "../src/libgrid/gridRegularFFT.h"
+#include "../src/libgrid/gridPatch.h"
+
+
+/*--- ADT handle --------------------------------------------------------*/
+
+/** @brief  Provides a handle for a synthetic grid. */
+typedef struct benchGrid_struct *benchGrid_t;
+
+
+/*--- Structure definition ----------------------------------------------*/
+
+/** @brief  A cubic grid with one variable, distributed onto all ranks. */
+struct benchGrid_struct {
+	/** @brief  The number of cells per dimension. */
+	uint32_t             dim1D;
+	/** @brief  The process grid. */
+	gridPointInt_t       nProcs;
+	/** @brief  The grid. */
+	gridRegular_t        grid;
+	/** @brief  The distribution of the grid. */
+	gridRegularDistrib_t distrib;
+	/** @brief  The patch held by this rank. */
+	gridPatch_t          patch;
+	/** @brief  The position of the variable in the grid. */
+	int                  idxOfVar;
+	/** @brief  The FFT of the grid, @c NULL if not requested. */
+	gridRegularFFT_t     fft;
+};
+
+
+/*--- Prototypes of exported functions ----------------------------------*/
+
+/**
+ * @brief  Creates a new grid.
+ *
+ * @param[in]  dim1D
+ *                The number of cells per dimension.
+ * @param[in]  nProcs
+ *                The process grid, the product must be the number of
+ *                ranks.  Ignored without MPI.
+ * @param[in]  withFFT
+ *                Whether to set up a FFT for the grid.
+ *
+ * @return  Returns a new grid, the data is filled by benchGrid_fill().
+ */
+extern benchGrid_t
+benchGrid_new(uint32_t dim1D, const gridPointInt_t nProcs, bool withFFT);
+
+
+/**
+ * @brief  Deletes a grid.
+ *
+ * @param[in,out]  *bg
+ *                    The grid to delete, will be set to @c NULL.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+benchGrid_del(benchGrid_t *bg);
+
+
+/**
+ * @brief  Fills the real data of the local patch with a deterministic
+ *         pattern of order unity.
+ *
+ * This also refreshes @c patch, which is replaced when the grid is
+ * transposed.
+ *
+ * @param[in,out]  bg
+ *                    The grid to fill.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+benchGrid_fill(benchGrid_t bg);
+
+
+/**
+ * @brief  Gives the number of bytes of the local real patch.
+ *
+ * @param[in]  bg
+ *                The grid.
+ *
+ * @return  Returns the size of the local data in bytes.
+ */
+extern uint64_t
+benchGrid_getLocalBytes(const benchGrid_t bg);
+
+
+/**
+ * @brief  Enumerates the process grids of the form 1 x a x b.
+ *
+ * @param[in]   numRanks
+ *                 The number of ranks.
+ * @param[in]   idx
+ *                 The number of the process grid.
+ * @param[out]  nProcs
+ *                 Receives the process grid.
+ *
+ * @return  Returns @c false if there is no process grid with the given
+ *          number, i.e. all process grids have been enumerated.
+ */
+extern bool
+benchGrid_getProcessGrid(int numRanks, int idx, gridPointInt_t nProcs);
+
+
+/**
+ * @brief  Gives the process grid 1 x a x b with a and b as close as
+ *         possible, the layout used for the benchmarks that do not scan
+ *         the process grids.
+ *
+ * @param[in]   numRanks
+ *                 The number of ranks.
+ * @param[out]  nProcs
+ *                 Receives the process grid.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+benchGrid_getDefaultProcessGrid(int numRanks, gridPointInt_t nProcs);
+
+
+/*--- Doxygen group definitions -----------------------------------------*/
+
+/**
+ * @defgroup benchGrid Synthetic Grids
+ * @ingroup  bench
+ * @brief  Provides the grids the benchmarks work on.
+ */
+
+#endif
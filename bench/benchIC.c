@@ -0,0 +1,184 @@
+// Copyright (C) 2013, Steffen Knollmann
+// Released under the terms of the GNU General Public License version 3.
+// This file is part of `ginnungagap'.
+
+
+/*--- Doxygen file description ------------------------------------------*/
+
+/**
+ * @file bench/benchIC.c
+ * @ingroup  benchKernels
+ * @brief  Implements the benchmarks of the Fourier space kernels of
+ *         ginnungagap.
+ */
+
+
+/*--- Includes ----------------------------------------------------------*/
+#include "benchIC.h"
+#include <stdio.h>
+#include <math.h>
+#include <assert.h>
+#ifdef WITH_MPI
+#  include <mpi.h>
+#endif
+#include "benchGrid.h"
+#include "../src/libcosmo/cosmoPk.h"
+#include "../src/libutil/memPool.h"
+#include "../src/ginnungagap/g9pIC.h"
+
+
+/*--- Local defines -----------------------------------------------------*/
+
+/** @brief  The expansion factor passed to the velocity kernel. */
+#define LOCAL_AINIT (1. / 51.)
+
+/** @brief  The number of sampling points of the power spectrum. */
+#define LOCAL_PK_NUMPOINTS 1000
+
+
+/*--- Local structures and typedefs -------------------------------------*/
+
+/** @brief  The data passed to the benchmark functions. */
+struct local_ic_struct {
+	/** @brief  The grid, in Fourier space. */
+	benchGrid_t  bg;
+	/** @brief  The cosmological model. */
+	cosmoModel_t model;
+	/** @brief  The power spectrum. */
+	cosmoPk_t    pk;
+};
+
+
+/*--- Prototypes of local functions -------------------------------------*/
+#ifdef WITH_FFT_FFTW3
+
+/** @brief  Refills the Fourier space grid, a #bench_func_t. */
+static void
+local_prepare(void *data);
+
+
+/** @brief  Runs g9pIC_calcDeltaFromWN(), a #bench_func_t. */
+static void
+local_deltaFromWN(void *data);
+
+
+/** @brief  Runs g9pIC_calcVelFromDelta(), a #bench_func_t. */
+static void
+local_velFromDelta(void *data);
+
+#endif
+
+
+/*--- Implementations of exported functions -----------------------------*/
+extern void
+benchIC_run(bench_t bench, uint32_t dim1D)
+{
+#ifdef WITH_FFT_FFTW3
+	struct local_ic_struct ic;
+	gridPointInt_t         nProcs;
+	int                    numRanks = 1;
+	char                   name[BENCHCONFIG_MAX_NAME_LENGTH];
+	uint64_t               numBytes;
+	double                 kMax;
+
+	assert(bench != NULL);
+
+	if (!bench_isSelected(bench, "ic."))
+		return;
+
+#  ifdef WITH_MPI
+	MPI_Comm_size(MPI_COMM_WORLD, &numRanks);
+#  endif
+	benchGrid_getDefaultProcessGrid(numRanks, nProcs);
+	ic.bg    = benchGrid_new(dim1D, nProcs, true);
+	ic.model = benchIC_newModel();
+	// The cells are 1 Mpc/h wide, the largest wave number of the grid is
+	// sqrt(3) pi h/Mpc.
+	kMax     = 2. * M_PI;
+	ic.pk    = cosmoPk_newFromModel(ic.model, 1e-4, kMax, LOCAL_PK_NUMPOINTS,
+	                                COSMOTF_TYPE_EISENSTEINHU1998);
+
+	benchGrid_fill(ic.bg);
+	gridRegularFFT_execute(ic.bg->fft, GRIDREGULARFFT_FORWARD);
+	// The complex data holds about twice as many bytes as the real data.
+	numBytes = 2 * benchGrid_getLocalBytes(ic.bg);
+
+	snprintf(name, BENCHCONFIG_MAX_NAME_LENGTH, "ic.deltaFromWN.%u", dim1D);
+	bench_run(bench, name, &local_prepare, &local_deltaFromWN, &ic,
+	          numBytes);
+	snprintf(name, BENCHCONFIG_MAX_NAME_LENGTH, "ic.velFromDelta.%u",
+	         dim1D);
+	bench_run(bench, name, &local_prepare, &local_velFromDelta, &ic,
+	          numBytes);
+
+	gridRegularFFT_execute(ic.bg->fft, GRIDREGULARFFT_BACKWARD);
+	cosmoPk_del(&(ic.pk));
+	cosmoModel_del(&(ic.model));
+	benchGrid_del(&(ic.bg));
+	memPool_trim();
+#else
+	(void)bench;
+	(void)dim1D;
+#endif
+} /* benchIC_run */
+
+extern cosmoModel_t
+benchIC_newModel(void)
+{
+	cosmoModel_t model = cosmoModel_new();
+
+	cosmoModel_setOmegaRad0(model, 8.348451673443855e-05);
+	cosmoModel_setOmegaLambda0(model, 0.734);
+	cosmoModel_setOmegaMatter0(model, 0.2669);
+	cosmoModel_setOmegaBaryon0(model, 0.0449);
+	cosmoModel_setSmallH(model, 0.71);
+	cosmoModel_setSigma8(model, 0.801);
+	cosmoModel_setNs(model, 0.963);
+	cosmoModel_setTempCMB(model, 2.725);
+
+	return model;
+}
+
+/*--- Implementations of local functions --------------------------------*/
+#ifdef WITH_FFT_FFTW3
+static void
+local_prepare(void *data)
+{
+	struct local_ic_struct *ic = data;
+	gridRegular_t          grid;
+	gridPatch_t            patch;
+	fpvComplex_t           *values;
+	uint64_t               numCells;
+
+	grid     = gridRegularFFT_getGridFFTed(ic->bg->fft);
+	patch    = gridRegular_getPatchHandle(grid, 0);
+	values   = gridPatch_getVarDataHandle(patch, 0);
+	numCells = gridPatch_getNumCells(patch);
+
+#  ifdef _OPENMP
+#    pragma omp parallel for
+#  endif
+	for (uint64_t i = 0; i < numCells; i++)
+		values[i] = 1.0;
+}
+
+static void
+local_deltaFromWN(void *data)
+{
+	struct local_ic_struct *ic = data;
+
+	g9pIC_calcDeltaFromWN(ic->bg->fft, ic->bg->dim1D,
+	                      (double)(ic->bg->dim1D), ic->pk);
+}
+
+static void
+local_velFromDelta(void *data)
+{
+	struct local_ic_struct *ic = data;
+
+	g9pIC_calcVelFromDelta(ic->bg->fft, ic->bg->dim1D,
+	                       (double)(ic->bg->dim1D), ic->model,
+	                       LOCAL_AINIT, 0.0, G9PIC_MODE_VX);
+}
+
+#endif
@@ -0,0 +1,54 @@
+// Copyright (C) 2013, Steffen Knollmann
+// Released under the terms of the GNU General Public License version 3.
+// This file is part of `ginnungagap'.
+
+#ifndef BENCHIC_H
+#define BENCHIC_H
+
+
+/*--- Doxygen file description ------------------------------------------*/
+
+/**
+ * @file bench/benchIC.h
+ * @ingroup  benchKernels
+ * @brief  Provides the benchmarks of the Fourier space kernels of
+ *         ginnungagap.
+ */
+
+
+/*--- Includes ----------------------------------------------------------*/
+#include "benchConfig.h"
+#include <stdint.h>
+#include "bench.h"
+#include "../src/libcosmo/cosmoModel.h"
+
+
+/*--- Prototypes of exported functions ----------------------------------*/
+
+/**
+ * @brief  Runs the benchmarks @c ic.deltaFromWN and @c ic.velFromDelta.
+ *
+ * The kernels work on the Fourier transformed grid, which is refilled
+ * with a constant before every repetition.
+ *
+ * @param[in,out]  bench
+ *                    The harness.
+ * @param[in]      dim1D
+ *                    The number of cells per dimension of the grid.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+benchIC_run(bench_t bench, uint32_t dim1D);
+
+
+/**
+ * @brief  Creates the cosmological model used by the benchmarks.
+ *
+ * @return  Returns a new model with the WMAP7 parameters.
+ */
+extern cosmoModel_t
+benchIC_newModel(void);
+
+
+#endif
@@ -0,0 +1,446 @@
+// Copyright (C) 2013, Steffen Knollmann
+// Released under the terms of the GNU General Public License version 3.
+// This file is part of `ginnungagap'.
+
+
+/*--- Doxygen file description ------------------------------------------*/
+
+/**
+ * @file bench/benchIO.c
+ * @ingroup  benchKernels
+ * @brief  Implements the benchmarks of the grid and particle file
+ *         formats.
+ */
+
+
+/*--- Includes ----------------------------------------------------------*/
+#include "benchIO.h"
+#include <stdio.h>
+#include <assert.h>
+#ifdef WITH_MPI
+#  include <mpi.h>
+#endif
+#include "benchGrid.h"
+#include "../src/libgrid/gridWriterGrafic.h"
+#include "../src/libgrid/gridReaderGrafic.h"
+#include "../src/libgrid/gridWriterBov.h"
+#include "../src/libgrid/gridReaderBov.h"
+#ifdef WITH_HDF5
+#  include "../src/libgrid/gridWriterHDF5.h"
+#  include "../src/libgrid/gridReaderHDF5.h"
+#endif
+#include "../src/libutil/filename.h"
+#include "../src/libutil/gadget.h"
+#include "../src/libutil/gadgetHeader.h"
+#include "../src/libutil/gadgetTOC.h"
+#include "../src/libutil/stai.h"
+#include "../src/libutil/xfile.h"
+#include "../src/libutil/xmem.h"
+#include "../src/libutil/memPool.h"
+
+
+/*--- Local defines -----------------------------------------------------*/
+
+/** @brief  The maximal length of the name of the Gadget file. */
+#define LOCAL_MAX_FILENAME_LENGTH 128
+
+/** @brief  The maximal length of the suffix of the grid files. */
+#define LOCAL_MAX_SUFFIX_LENGTH 32
+
+
+/*--- Local structures and typedefs -------------------------------------*/
+
+/** @brief  The data passed to the benchmark functions. */
+struct local_io_struct {
+	/** @brief  The grid that is written or read. */
+	benchGrid_t  bg;
+	/** @brief  The reader for the current grid benchmark. */
+	gridReader_t reader;
+	/** @brief  The number of particles in the Gadget file of this rank. */
+	uint32_t     numParticles;
+	/** @brief  The positions of the particles. */
+	float        *pos;
+	/** @brief  The velocities of the particles. */
+	float        *vel;
+	/** @brief  The IDs of the particles. */
+	uint32_t     *id;
+	/** @brief  The name of the Gadget file of this rank. */
+	char         gadgetFileName[LOCAL_MAX_FILENAME_LENGTH];
+};
+
+/** @brief  Convenience typedef. */
+typedef struct local_io_struct *local_io_t;
+
+
+/*--- Prototypes of local functions -------------------------------------*/
+
+/**
+ * @brief  Gives the name of a grid file.
+ *
+ * @param[in]  *suffix
+ *                The suffix of the file.
+ *
+ * @return  Returns a new file name object.
+ */
+static filename_t
+local_getFileName(const char *suffix);
+
+
+/**
+ * @brief  Benchmarks writing and reading the grid in one format.
+ *
+ * @param[in,out]  bench
+ *                    The harness.
+ * @param[in,out]  io
+ *                    The data of the benchmarks.
+ * @param[in]      *format
+ *                    The name of the format in the benchmark name, also
+ *                    used as the suffix of the file.
+ * @param[in]      write
+ *                    The function writing the grid.
+ * @param[in]      reader
+ *                    The reader to use, the function takes ownership.
+ *
+ * @return  Returns nothing.
+ */
+static void
+local_runGridFormat(bench_t      bench,
+                    local_io_t   io,
+                    const char   *format,
+                    bench_func_t write,
+                    gridReader_t reader);
+
+
+/**
+ * @brief  Activates a writer, writes the grid and deletes the writer.
+ *
+ * @param[in,out]  writer
+ *                    The writer to use, will be deleted.
+ * @param[in]      grid
+ *                    The grid to write.
+ *
+ * @return  Returns nothing.
+ */
+static void
+local_writeAndDelete(gridWriter_t writer, gridRegular_t grid);
+
+
+/** @brief  Writes the grid as Grafic file, a #bench_func_t. */
+static void
+local_writeGrafic(void *data);
+
+
+#ifdef WITH_MPI
+/**
+ * @brief  Writes the grid as Grafic file with several ranks writing at the
+ *         same time, a #bench_func_t.
+ */
+static void
+local_writeGraficConcurrent(void *data);
+
+#endif
+
+#ifdef WITH_HDF5
+/** @brief  Writes the grid as HDF5 file, a #bench_func_t. */
+static void
+local_writeHDF5(void *data);
+
+#endif
+
+
+/** @brief  Writes the grid as BOV file, a #bench_func_t. */
+static void
+local_writeBov(void *data);
+
+
+/** @brief  Reads the grid, a #bench_func_t. */
+static void
+local_readGrid(void *data);
+
+
+/** @brief  Writes the Gadget file of this rank, a #bench_func_t. */
+static void
+local_writeGadget(void *data);
+
+
+/** @brief  Reads the Gadget file of this rank, a #bench_func_t. */
+static void
+local_readGadget(void *data);
+
+
+/*--- Implementations of exported functions -----------------------------*/
+extern void
+benchIO_run(bench_t bench, uint32_t dim1D)
+{
+	struct local_io_struct io;
+	gridPointInt_t         nProcs;
+	int                    numRanks = 1;
+	int                    rank     = 0;
+	char                   name[BENCHCONFIG_MAX_NAME_LENGTH];
+	uint64_t               numBytes;
+
+	assert(bench != NULL);
+
+	if (!bench_isSelected(bench, "io."))
+		return;
+
+#ifdef WITH_MPI
+	MPI_Comm_size(MPI_COMM_WORLD, &numRanks);
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+	benchGrid_getDefaultProcessGrid(numRanks, nProcs);
+	io.bg = benchGrid_new(dim1D, nProcs, false);
+	benchGrid_fill(io.bg);
+
+	local_runGridFormat(bench, &io, "grafic", &local_writeGrafic,
+	                    (gridReader_t)gridReaderGrafic_new());
+#ifdef WITH_MPI
+	local_runGridFormat(bench, &io, "graficConcurrent",
+	                    &local_writeGraficConcurrent,
+	                    (gridReader_t)gridReaderGrafic_new());
+#endif
+#ifdef WITH_HDF5
+	local_runGridFormat(bench, &io, "hdf5", &local_writeHDF5,
+	                    (gridReader_t)gridReaderHDF5_new());
+#endif
+	local_runGridFormat(bench, &io, "bov", &local_writeBov,
+	                    (gridReader_t)gridReaderBov_new());
+	if (rank == 0)
+		remove(BENCHCONFIG_FILE_PREFIX ".raw");
+
+	io.numParticles = (uint32_t)gridPatch_getNumCells(io.bg->patch);
+	io.pos          = xmalloc(sizeof(float) * 3 * io.numParticles);
+	io.vel          = xmalloc(sizeof(float) * 3 * io.numParticles);
+	io.id           = xmalloc(sizeof(uint32_t) * io.numParticles);
+	for (uint32_t i = 0; i < io.numParticles; i++) {
+		for (int j = 0; j < 3; j++) {
+			io.pos[i * 3 + j] = (float)(i % dim1D);
+			io.vel[i * 3 + j] = 1.f;
+		}
+		io.id[i] = i;
+	}
+	snprintf(io.gadgetFileName, LOCAL_MAX_FILENAME_LENGTH,
+	         "%s.gadget.%i", BENCHCONFIG_FILE_PREFIX, rank);
+	numBytes = (sizeof(float) * 6 + sizeof(uint32_t)) * io.numParticles;
+	snprintf(name, BENCHCONFIG_MAX_NAME_LENGTH, "io.gadget.write.%u", dim1D);
+	bench_run(bench, name, NULL, &local_writeGadget, &io, numBytes);
+	snprintf(name, BENCHCONFIG_MAX_NAME_LENGTH, "io.gadget.read.%u", dim1D);
+	bench_run(bench, name, NULL, &local_readGadget, &io, numBytes);
+	remove(io.gadgetFileName);
+	xfree(io.id);
+	xfree(io.vel);
+	xfree(io.pos);
+
+	benchGrid_del(&(io.bg));
+	memPool_trim();
+} /* benchIO_run */
+
+/*--- Implementations of local functions --------------------------------*/
+static filename_t
+local_getFileName(const char *suffix)
+{
+	return filename_newFull(NULL, BENCHCONFIG_FILE_PREFIX, NULL, suffix);
+}
+
+static void
+local_runGridFormat(bench_t      bench,
+                    local_io_t   io,
+                    const char   *format,
+                    bench_func_t write,
+                    gridReader_t reader)
+{
+	char       name[BENCHCONFIG_MAX_NAME_LENGTH];
+	char       suffix[LOCAL_MAX_SUFFIX_LENGTH];
+	filename_t fn;
+	uint64_t   numBytes = benchGrid_getLocalBytes(io->bg);
+	int        rank     = 0;
+
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+	if (write != NULL) {
+		snprintf(name, BENCHCONFIG_MAX_NAME_LENGTH, "io.%s.write.%u",
+		         format, io->bg->dim1D);
+		bench_run(bench, name, NULL, write, io, numBytes);
+	}
+
+	snprintf(suffix, LOCAL_MAX_SUFFIX_LENGTH, ".%s", format);
+	fn = local_getFileName(suffix);
+	if (xfile_checkIfFileExists(filename_getFullName(fn))) {
+		gridReader_setFileName(reader, fn);
+		io->reader = reader;
+		snprintf(name, BENCHCONFIG_MAX_NAME_LENGTH, "io.%s.read.%u",
+		         format, io->bg->dim1D);
+		bench_run(bench, name, NULL, &local_readGrid, io, numBytes);
+		io->reader = NULL;
+#ifdef WITH_MPI
+		MPI_Barrier(MPI_COMM_WORLD);
+#endif
+		if (rank == 0)
+			remove(filename_getFullName(fn));
+	} else {
+		filename_del(&fn);
+	}
+	gridReader_del(&reader);
+}
+
+static void
+local_writeAndDelete(gridWriter_t writer, gridRegular_t grid)
+{
+	gridWriter_setOverwriteFileIfExists(writer, true);
+#ifdef WITH_MPI
+	gridWriter_initParallel(writer, MPI_COMM_WORLD);
+#endif
+	gridWriter_activate(writer);
+	gridWriter_writeGridRegular(writer, grid);
+	gridWriter_deactivate(writer);
+	gridWriter_del(&writer);
+}
+
+static void
+local_writeGrafic(void *data)
+{
+	local_io_t         io = data;
+	gridWriterGrafic_t writer;
+	uint32_t           size[3];
+
+	for (int i = 0; i < 3; i++)
+		size[i] = io->bg->dim1D;
+
+	writer = gridWriterGrafic_new();
+	grafic_setSize(gridWriterGrafic_getGrafic(writer), size);
+	gridWriter_setFileName((gridWriter_t)writer,
+	                       local_getFileName(".grafic"));
+	local_writeAndDelete((gridWriter_t)writer, io->bg->grid);
+}
+
+#ifdef WITH_MPI
+static void
+local_writeGraficConcurrent(void *data)
+{
+	local_io_t         io = data;
+	gridWriterGrafic_t writer;
+	uint32_t           size[3];
+
+	for (int i = 0; i < 3; i++)
+		size[i] = io->bg->dim1D;
+
+	writer = gridWriterGrafic_new();
+	grafic_setSize(gridWriterGrafic_getGrafic(writer), size);
+	gridWriterGrafic_setNumConcurrentWriters(
+	    writer, BENCHCONFIG_NUM_CONCURRENT_WRITERS);
+	gridWriter_setFileName((gridWriter_t)writer,
+	                       local_getFileName(".graficConcurrent"));
+	local_writeAndDelete((gridWriter_t)writer, io->bg->grid);
+}
+
+#endif
+
+#ifdef WITH_HDF5
+static void
+local_writeHDF5(void *data)
+{
+	local_io_t       io = data;
+	gridWriterHDF5_t writer;
+
+	writer = gridWriterHDF5_new();
+	gridWriter_setFileName((gridWriter_t)writer, local_getFileName(".hdf5"));
+	local_writeAndDelete((gridWriter_t)writer, io->bg->grid);
+}
+
+#endif
+
+static void
+local_writeBov(void *data)
+{
+	local_io_t      io = data;
+	gridWriterBov_t writer;
+
+	writer = gridWriterBov_new();
+	gridWriter_setFileName((gridWriter_t)writer, local_getFileName(".bov"));
+	local_writeAndDelete((gridWriter_t)writer, io->bg->grid);
+}
+
+static void
+local_readGrid(void *data)
+{
+	local_io_t io = data;
+
+	// Reading into the existing variable keeps the patch from growing
+	// by one variable per repetition.
+	gridReader_readIntoPatchForVar(io->reader, io->bg->patch,
+	                               io->bg->idxOfVar);
+}
+
+static void
+local_writeGadget(void *data)
+{
+	local_io_t     io         = data;
+	uint32_t       np[6]      = {0, io->numParticles, 0, 0, 0, 0};
+	uint64_t       nall[6]    = {0, io->numParticles, 0, 0, 0, 0};
+	double         massarr[6] = {0.0, 1.0, 0.0, 0.0, 0.0, 0.0};
+	gadget_t       gadget;
+	gadgetHeader_t header;
+	gadgetTOC_t    toc;
+	stai_t         stai;
+
+	gadget = gadget_newSimple(io->gadgetFileName, 1);
+	gadget_setFileVersion(gadget, GADGETVERSION_TWO);
+
+	header = gadgetHeader_new();
+	gadgetHeader_setNp(header, np);
+	gadgetHeader_setMassArr(header, massarr);
+	gadgetHeader_setNall(header, nall);
+	gadgetHeader_setNumFiles(header, 1);
+	gadget_setHeaderOfFile(gadget, 0, header);
+
+	toc = gadgetTOC_new();
+	gadgetTOC_setFileVersion(toc, GADGETVERSION_TWO);
+	gadgetTOC_addEntryByType(toc, GADGETBLOCK_HEAD);
+	gadgetTOC_addEntryByType(toc, GADGETBLOCK_POS_);
+	gadgetTOC_addEntryByType(toc, GADGETBLOCK_VEL_);
+	gadgetTOC_addEntryByType(toc, GADGETBLOCK_ID__);
+	gadgetTOC_calcSizes(toc, np, massarr, false, false);
+	gadgetTOC_calcOffset(toc);
+	gadget_setTOCOfFile(gadget, 0, toc);
+
+	gadget_createEmptyFile(gadget, 0);
+	gadget_open(gadget, GADGET_MODE_WRITE_CONT, 0);
+	gadget_writeHeaderToCurrentFile(gadget);
+	stai = stai_new(io->pos, 3 * sizeof(float), 3 * sizeof(float));
+	gadget_writeBlockToCurrentFile(gadget, GADGETBLOCK_POS_, 0,
+	                               io->numParticles, stai);
+	stai_del(&stai);
+	stai = stai_new(io->vel, 3 * sizeof(float), 3 * sizeof(float));
+	gadget_writeBlockToCurrentFile(gadget, GADGETBLOCK_VEL_, 0,
+	                               io->numParticles, stai);
+	stai_del(&stai);
+	stai = stai_new(io->id, sizeof(uint32_t), sizeof(uint32_t));
+	gadget_writeBlockToCurrentFile(gadget, GADGETBLOCK_ID__, 0,
+	                               io->numParticles, stai);
+	stai_del(&stai);
+	gadget_close(gadget);
+	gadget_del(&gadget);
+} /* local_writeGadget */
+
+static void
+local_readGadget(void *data)
+{
+	local_io_t io = data;
+	gadget_t   gadget;
+	stai_t     stai;
+
+	gadget = gadget_newSimple(io->gadgetFileName, 1);
+	gadget_initForRead(gadget);
+	stai = stai_new(io->pos, 3 * sizeof(float), 3 * sizeof(float));
+	gadget_readBlock(gadget, GADGETBLOCK_POS_, 0, io->numParticles, stai);
+	stai_del(&stai);
+	stai = stai_new(io->vel, 3 * sizeof(float), 3 * sizeof(float));
+	gadget_readBlock(gadget, GADGETBLOCK_VEL_, 0, io->numParticles, stai);
+	stai_del(&stai);
+	stai = stai_new(io->id, sizeof(uint32_t), sizeof(uint32_t));
+	gadget_readBlock(gadget, GADGETBLOCK_ID__, 0, io->numParticles, stai);
+	stai_del(&stai);
+	gadget_del(&gadget);
+}
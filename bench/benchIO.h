@@ -0,0 +1,46 @@
+// Copyright (C) 2013, Steffen Knollmann
+// Released under the terms of the GNU General Public License version 3.
+// This file is part of `ginnungagap'.
+
+#ifndef BENCHIO_H
+#define BENCHIO_H
+
+
+/*--- Doxygen file description ------------------------------------------*/
+
+/**
+ * @file bench/benchIO.h
+ * @ingroup  benchKernels
+ * @brief  Provides the benchmarks of the grid and particle file formats.
+ */
+
+
+/*--- Includes ----------------------------------------------------------*/
+#include "benchConfig.h"
+#include <stdint.h>
+#include "bench.h"
+
+
+/*--- Prototypes of exported functions ----------------------------------*/
+
+/**
+ * @brief  Runs the benchmarks @c io.*.
+ *
+ * The distributed grid is written to and read from Grafic, BOV and (if
+ * available) HDF5 files.  With MPI, the Grafic file is also written
+ * with several ranks writing at the same time.  Every rank writes the
+ * particles of its patch to and reads them from its own Gadget file.
+ * The files are created in the working directory and removed afterwards.
+ *
+ * @param[in,out]  bench
+ *                    The harness.
+ * @param[in]      dim1D
+ *                    The number of cells per dimension of the grid.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+benchIO_run(bench_t bench, uint32_t dim1D);
+
+
+#endif
@@ -0,0 +1,120 @@
+// Copyright (C) 2013, Steffen Knollmann
+// Released under the terms of the GNU General Public License version 3.
+// This file is part of `ginnungagap'.
+
+
+/*--- Doxygen file description ------------------------------------------*/
+
+/**
+ * @file bench/benchRNG.c
+ * @ingroup  benchKernels
+ * @brief  Implements the benchmark of the random number generator.
+ */
+
+
+/*--- Includes ----------------------------------------------------------*/
+#include "benchRNG.h"
+#include <stdio.h>
+#include <assert.h>
+#ifdef WITH_MPI
+#  include <mpi.h>
+#endif
+#ifdef _OPENMP
+#  include <omp.h>
+#endif
+#include "../src/libutil/rng.h"
+#include "../src/libutil/xmem.h"
+
+
+/*--- Local defines -----------------------------------------------------*/
+
+/** @brief  The SPRNG generator to use, the one of the example setups. */
+#define LOCAL_GENERATOR_TYPE 4
+
+/** @brief  The seed of the streams. */
+#define LOCAL_RANDOM_SEED 1
+
+
+/*--- Local structures and typedefs -------------------------------------*/
+
+/** @brief  The data passed to the benchmark function. */
+struct local_rng_struct {
+	/** @brief  The generator. */
+	rng_t    rng;
+	/** @brief  Receives the numbers. */
+	fpv_t    *data;
+	/** @brief  The number of values to draw. */
+	uint64_t numValues;
+};
+
+
+/*--- Prototypes of local functions -------------------------------------*/
+#ifdef WITH_SPRNG
+
+/** @brief  Fills the buffer with Gaussian numbers, a #bench_func_t. */
+static void
+local_draw(void *data);
+
+#endif
+
+
+/*--- Implementations of exported functions -----------------------------*/
+extern void
+benchRNG_run(bench_t bench, uint32_t dim1D)
+{
+#ifdef WITH_SPRNG
+	struct local_rng_struct r;
+	int                     numRanks   = 1;
+	int                     numThreads = 1;
+	char                    name[BENCHCONFIG_MAX_NAME_LENGTH];
+
+	assert(bench != NULL);
+
+	if (!bench_isSelected(bench, "rng."))
+		return;
+
+#  ifdef WITH_MPI
+	MPI_Comm_size(MPI_COMM_WORLD, &numRanks);
+#  endif
+#  ifdef _OPENMP
+	numThreads = omp_get_max_threads();
+#  endif
+	r.rng       = rng_new(LOCAL_GENERATOR_TYPE, numRanks * numThreads,
+	                      LOCAL_RANDOM_SEED);
+	r.numValues = ((uint64_t)dim1D * dim1D * dim1D) / numRanks;
+	r.data      = xmalloc(sizeof(fpv_t) * r.numValues);
+
+	snprintf(name, BENCHCONFIG_MAX_NAME_LENGTH, "rng.gaussUnit.%u", dim1D);
+	bench_run(bench, name, NULL, &local_draw, &r,
+	          sizeof(fpv_t) * r.numValues);
+
+	xfree(r.data);
+	rng_del(&(r.rng));
+#else
+	(void)bench;
+	(void)dim1D;
+#endif
+}
+
+/*--- Implementations of local functions --------------------------------*/
+#ifdef WITH_SPRNG
+static void
+local_draw(void *data)
+{
+	struct local_rng_struct *r         = data;
+	int                     numStreams = rng_getNumStreamsLocal(r->rng);
+
+#  ifdef _OPENMP
+#    pragma omp parallel for shared(r, numStreams)
+#  endif
+	for (int i = 0; i < numStreams; i++) {
+		uint64_t cps   = r->numValues / numStreams;
+		uint64_t start = i * cps;
+		uint64_t stop  = (i == numStreams - 1) ? r->numValues
+		                 : start + cps;
+		for (uint64_t j = start; j < stop; j++)
+			r->data[j] = (fpv_t)rng_getGaussUnit(r->rng, i);
+	}
+}
+
+#endif
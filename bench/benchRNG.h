@@ -0,0 +1,44 @@
+// Copyright (C) 2013, Steffen Knollmann
+// Released under the terms of the GNU General Public License version 3.
+// This file is part of `ginnungagap'.
+
+#ifndef BENCHRNG_H
+#define BENCHRNG_H
+
+
+/*--- Doxygen file description ------------------------------------------*/
+
+/**
+ * @file bench/benchRNG.h
+ * @ingroup  benchKernels
+ * @brief  Provides the benchmark of the random number generator.
+ */
+
+
+/*--- Includes ----------------------------------------------------------*/
+#include "benchConfig.h"
+#include <stdint.h>
+#include "bench.h"
+
+
+/*--- Prototypes of exported functions ----------------------------------*/
+
+/**
+ * @brief  Runs the benchmark @c rng.gaussUnit.
+ *
+ * This draws as many Gaussian numbers as the white noise of a grid with
+ * the given size needs, using one stream per thread and the same loop as
+ * the white noise generation.  Needs SPRNG, does nothing otherwise.
+ *
+ * @param[in,out]  bench
+ *                    The harness.
+ * @param[in]      dim1D
+ *                    The number of cells per dimension of the grid.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+benchRNG_run(bench_t bench, uint32_t dim1D);
+
+
+#endif
@@ -0,0 +1,301 @@
+// Copyright (C) 2013, Steffen Knollmann
+// Released under the terms of the GNU General Public License version 3.
+// This file is part of `ginnungagap'.
+
+
+/*--- Doxygen file description ------------------------------------------*/
+
+/**
+ * @file bench/main.c
+ * @ingroup  benchMain
+ * @brief  Implements the main routine of the benchmarks.
+ */
+
+
+/*--- Includes ----------------------------------------------------------*/
+#include "benchConfig.h"
+#include "../version.h"
+#include "bench.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#ifdef WITH_MPI
+#  include <mpi.h>
+#endif
+#include "benchFFT.h"
+#include "benchRNG.h"
+#include "benchIC.h"
+#include "benchIO.h"
+#include "benchGenICs.h"
+#include "../src/libutil/xmem.h"
+#include "../src/libutil/cmdline.h"
+
+
+/*--- Local variables ---------------------------------------------------*/
+
+/** @brief  The name of the program. */
+static const char *local_thisProgramName = "bench";
+
+/** @brief  The number of cells per dimension of the grids. */
+static int local_dim1D = BENCHCONFIG_DEFAULT_DIM1D;
+
+/** @brief  The number of timed repetitions. */
+static int local_numReps = BENCHCONFIG_DEFAULT_NUMREPS;
+
+/** @brief  The accepted slowdown against the baseline. */
+static double local_tolerance = BENCHCONFIG_DEFAULT_TOLERANCE;
+
+/** @brief  Only benchmarks starting with this are run. */
+static char *local_filter = NULL;
+
+/** @brief  The file receiving the results. */
+static char *local_outputFileName = NULL;
+
+/** @brief  The results to compare against. */
+static char *local_baselineFileName = NULL;
+
+/** @brief  Stores the position of the various elements in the cmdline. */
+struct local_cmdlinePos {
+	/** @brief  The position for the version screen. */
+	int version;
+	/** @brief  The position for the help screen. */
+	int help;
+	/** @brief  The position for #local_dim1D. */
+	int dim1D;
+	/** @brief  The position for #local_numReps. */
+	int numReps;
+	/** @brief  The position for #local_filter. */
+	int filter;
+	/** @brief  The position for #local_outputFileName. */
+	int outputFileName;
+	/** @brief  The position for #local_baselineFileName. */
+	int baselineFileName;
+	/** @brief  The position for #local_tolerance. */
+	int tolerance;
+} local_cmdlinePos;
+
+
+/*--- Prototypes of local functions -------------------------------------*/
+static void
+local_initEnvironment(int *argc, char ***argv);
+
+static void
+local_registerCleanUpFunctions(void);
+
+static cmdline_t
+local_cmdlineSetup(void);
+
+static void
+local_checkForPrematureTermination(cmdline_t cmdline);
+
+static void
+local_finalMessage(void);
+
+static void
+local_verifyCloseOfStdout(void);
+
+
+/*--- M A I N -----------------------------------------------------------*/
+int
+main(int argc, char **argv)
+{
+	bench_t  bench;
+	uint32_t dim1D;
+	int      numRegressions = 0;
+
+	local_registerCleanUpFunctions();
+	local_initEnvironment(&argc, &argv);
+
+	dim1D = (uint32_t)local_dim1D;
+	bench = bench_new(local_numReps, local_filter);
+
+	benchFFT_run(bench, dim1D);
+	benchRNG_run(bench, dim1D);
+	benchIC_run(bench, dim1D);
+	benchIO_run(bench, dim1D);
+	benchGenICs_run(bench, dim1D);
+
+	bench_write(bench, local_outputFileName);
+	if (local_baselineFileName != NULL)
+		numRegressions = bench_compare(bench, local_baselineFileName,
+		                               local_tolerance);
+	bench_del(&bench);
+
+	return (numRegressions == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/*--- Implementations of local functions --------------------------------*/
+static void
+local_initEnvironment(int *argc, char ***argv)
+{
+	cmdline_t cmdline;
+
+#ifdef WITH_MPI
+	MPI_Init(argc, argv);
+#endif
+	cmdline = local_cmdlineSetup();
+	cmdline_parse(cmdline, *argc, *argv);
+	local_checkForPrematureTermination(cmdline);
+	if (cmdline_checkOptSetByNum(cmdline, local_cmdlinePos.dim1D))
+		cmdline_getOptValueByNum(cmdline, local_cmdlinePos.dim1D,
+		                         &local_dim1D);
+	if (cmdline_checkOptSetByNum(cmdline, local_cmdlinePos.numReps))
+		cmdline_getOptValueByNum(cmdline, local_cmdlinePos.numReps,
+		                         &local_numReps);
+	if (cmdline_checkOptSetByNum(cmdline, local_cmdlinePos.filter))
+		cmdline_getOptValueByNum(cmdline, local_cmdlinePos.filter,
+		                         &local_filter);
+	if (cmdline_checkOptSetByNum(cmdline, local_cmdlinePos.outputFileName))
+		cmdline_getOptValueByNum(cmdline, local_cmdlinePos.outputFileName,
+		                         &local_outputFileName);
+	if (cmdline_checkOptSetByNum(cmdline, local_cmdlinePos.baselineFileName))
+		cmdline_getOptValueByNum(cmdline, local_cmdlinePos.baselineFileName,
+		                         &local_baselineFileName);
+	if (cmdline_checkOptSetByNum(cmdline, local_cmdlinePos.tolerance))
+		cmdline_getOptValueByNum(cmdline, local_cmdlinePos.tolerance,
+		                         &local_tolerance);
+	cmdline_del(&cmdline);
+
+	if ((local_dim1D < 2) || (local_numReps < 1) || (local_tolerance < 0.)) {
+		fprintf(stderr, "FATAL:  Need dim >= 2, reps >= 1 and "
+		        "tolerance >= 0.\n");
+		exit(EXIT_FAILURE);
+	}
+}
+
+static void
+local_registerCleanUpFunctions(void)
+{
+	if (atexit(&local_verifyCloseOfStdout) != 0) {
+		fprintf(stderr, "cannot register `%s' as exit function\n",
+		        "local_verifyCloseOfStdout");
+		exit(EXIT_FAILURE);
+	}
+	if (atexit(&local_finalMessage) != 0) {
+		fprintf(stderr, "cannot register `%s' as exit function\n",
+		        "local_finalMessage");
+		exit(EXIT_FAILURE);
+	}
+}
+
+static void
+local_finalMessage(void)
+{
+	int rank = 0;
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+	MPI_Finalize();
+#endif
+	if (local_filter != NULL)
+		xfree(local_filter);
+	if (local_outputFileName != NULL)
+		xfree(local_outputFileName);
+	if (local_baselineFileName != NULL)
+		xfree(local_baselineFileName);
+#ifdef XMEM_TRACK_MEM
+	if (rank == 0) {
+		printf("\n");
+		xmem_info(stdout);
+		printf("\n");
+	}
+#else
+	(void)rank;
+#endif
+}
+
+static void
+local_verifyCloseOfStdout(void)
+{
+	if (fclose(stdout) != 0) {
+		int errnum = errno;
+		fprintf(stderr, "%s", strerror(errnum));
+		_Exit(EXIT_FAILURE);
+	}
+}
+
+static cmdline_t
+local_cmdlineSetup(void)
+{
+	cmdline_t cmdline;
+
+	cmdline = cmdline_new(0, 8, local_thisProgramName);
+
+	local_cmdlinePos.version
+	    = cmdline_addOpt(cmdline, "version",
+	                     "This will output a version information.",
+	                     false, CMDLINE_TYPE_NONE);
+	local_cmdlinePos.help
+	    = cmdline_addOpt(cmdline, "help",
+	                     "This will print this help text.",
+	                     false, CMDLINE_TYPE_NONE);
+	local_cmdlinePos.dim1D
+	    = cmdline_addOpt(cmdline, "dim",
+	                     "The number of cells per dimension of the grids.",
+	                     true, CMDLINE_TYPE_INT);
+	local_cmdlinePos.numReps
+	    = cmdline_addOpt(cmdline, "reps",
+	                     "The number of timed repetitions per benchmark.",
+	                     true, CMDLINE_TYPE_INT);
+	local_cmdlinePos.filter
+	    = cmdline_addOpt(cmdline, "filter",
+	                     "Only run the benchmarks whose name starts with "
+	                     "this, e.g. fft. or io.hdf5.",
+	                     true, CMDLINE_TYPE_STRING);
+	local_cmdlinePos.outputFileName
+	    = cmdline_addOpt(cmdline, "output",
+	                     "Writes the results as CSV to this file instead "
+	                     "of stdout.",
+	                     true, CMDLINE_TYPE_STRING);
+	local_cmdlinePos.baselineFileName
+	    = cmdline_addOpt(cmdline, "baseline",
+	                     "Compares the results against this file, written "
+	                     "by an earlier run with --output; the exit status "
+	                     "is non-zero if a benchmark regressed.",
+	                     true, CMDLINE_TYPE_STRING);
+	local_cmdlinePos.tolerance
+	    = cmdline_addOpt(cmdline, "tolerance",
+	                     "The relative slowdown against the baseline that "
+	                     "is accepted.",
+	                     true, CMDLINE_TYPE_DOUBLE);
+
+	return cmdline;
+} /* local_cmdlineSetup */
+
+static void
+local_checkForPrematureTermination(cmdline_t cmdline)
+{
+	int rank = 0;
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+	if (cmdline_checkOptSetByNum(cmdline, local_cmdlinePos.version)) {
+		if (rank == 0) {
+			PRINT_VERSION_INFO2(stdout, local_thisProgramName);
+			PRINT_BUILT_INFO(stdout);
+			printf("%s", CONFIG_SUMMARY_STRING);
+		}
+		cmdline_del(&cmdline);
+		exit(EXIT_SUCCESS);
+	}
+	if (cmdline_checkOptSetByNum(cmdline, local_cmdlinePos.help)) {
+		cmdline_printHelp(cmdline, stdout);
+		cmdline_del(&cmdline);
+		exit(EXIT_SUCCESS);
+	}
+	if (!cmdline_verify(cmdline)) {
+		cmdline_printHelp(cmdline, stderr);
+		cmdline_del(&cmdline);
+		exit(EXIT_FAILURE);
+	}
+}
+
+
+/*--- Doxygen group definitions -----------------------------------------*/
+
+/**
+ * @defgroup benchMain Main
+ * @ingroup  bench
+ * @brief  Provides the main routine of the benchmarks.
+ */
@@ -983,7 +983,11 @@
  * Otherwise massArr is used. Type 0 is gas, type 1 is halo, ...
  *
  * The particle IDs are assigned according to their Lagrangian coordinates 
- * at the highest resolution level. The transform is done with ::lIdx_fromCoord3d function.
+ * at the highest resolution level. The transform is done with
+ * ::g9pIDGenerator_calcID using the scheme given by the optional key
+ * idScheme: rowMajor (the default), morton or hilbert.  With the
+ * space-filling curves the particles of every tile are also written in the
+ * order of the curve, and sequential IDs follow that order.
  * 
  * The option doGas will enable the production of the gas particles. In zoom simulations,
  * this should be enabled only for the highest resolution level. The gas particles are produced
@@ -996,6 +1000,19 @@
  * when using GADGET-2 options '-DPLACEHIGHRESREGION', see GADGET manual for
  * more details.
  * 
+ * The optional key costModelFile names a file receiving the time taken for
+ * every output file together with the cells read and particles written.
+ * If the file exists when generateICs starts, the tiles are distributed
+ * onto the files with a cost model fitted to these timings, otherwise a
+ * default model is used.  The files are handed out to the MPI tasks one
+ * at a time, most expensive first, so it pays to ask for a few files more
+ * than tasks.
+ * 
+ * With the optional key allLevels = true all levels from minLevel to
+ * maxLevel are produced in one run, zoomLevel is then not needed.  The mask
+ * is only set up once and the particle IDs of the levels follow each other
+ * as in separate runs.  Each level reads its own velocities, see below.
+ * 
  * @subsection pageGenerateICs_subInput Input velocity fields are specified in [GenicsInput]
  * This section contains the names of sections for reading x, y and z components of
  * the velocity field:
@@ -1006,6 +1023,17 @@
  * velzSection = GenicsInput_velz
  * @endcode
  * 
+ * When all levels are produced in one run, the sections are given for
+ * every level instead:
+ * @code
+ * [GenicsInput]
+ * velxSection5 = GenicsInput_level5_velx
+ * velySection5 = GenicsInput_level5_vely
+ * velzSection5 = GenicsInput_level5_velz
+ * velxSection6 = GenicsInput_level6_velx
+ * ...
+ * @endcode
+ * 
  * An example of GenicsInput_velx:
  * @code
  * [GenicsInput_velx]
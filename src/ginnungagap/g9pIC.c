@@ -61,6 +61,15 @@ static const char *local_modeSVyStr = "small_vely";
 /** @brief  The name for the mode corresponding to small scale vz. */
 static const char *local_modeSVzStr = "small_velz";
 
+/** @brief  The name for the mode corresponding to second order vx. */
+static const char *local_modeV2xStr = "vel2x";
+
+/** @brief  The name for the mode corresponding to second order vy. */
+static const char *local_modeV2yStr = "vel2y";
+
+/** @brief  The name for the mode corresponding to second order vz. */
+static const char *local_modeV2zStr = "vel2z";
+
 
 /*--- Prototypes of local functions -------------------------------------*/
 
@@ -151,6 +160,9 @@ local_getDisplacementToVelocityFactor(cosmoModel_t model, double aInit);
  *                The initial expansion factor for which to calculate
  *                the conversion factor.
  *
+ * The factor includes @f$ -D_2/D_1^2 @f$ to go from the potential of
+ * the source field to the second order displacement.
+ *
  * @return  Returns the conversion factor to go from displacement field to
  *          velocities for the second order displacement field.
  */
@@ -311,6 +323,16 @@ g9pIC_calcVelFromDelta(gridRegularFFT_t gridFFT,
 		                             idxLo, dimsPatch, kMaxGrid,
 		                             dimsGrid, norm, wavenumToFreq, false, cutoffScale, data);
 			break;
+		case G9PIC_MODE_V2X:
+		case G9PIC_MODE_V2Y:
+		case G9PIC_MODE_V2Z:
+			norm  = local_getDisplacementToVelocityFactor2lpt(model, aInit);
+			norm *= gridRegularFFT_getNorm(gridFFT);
+			local_calcVelFromDeltaActual(
+			    gridRegular_getCurrentDim(grid, mode - G9PIC_MODE_V2X),
+			    idxLo, dimsPatch, kMaxGrid, dimsGrid, norm, wavenumToFreq,
+			    data);
+			break;
 		default:
 			diediedie(EXIT_FAILURE);
 	}
@@ -323,57 +345,60 @@ g9pIC_calcDDPhiFromDelta(gridRegularFFT_t gridFFT,
                          uint32_t         d1,
                          uint32_t         d2)
 {
+	gridRegular_t     grid;
 	gridPointUint32_t dimsGrid, dimsPatch, idxLo, kMaxGrid;
 	fpvComplex_t      *data;
+	int               c1, c2;
+	double            norm;
 
 	assert(gridFFT != NULL);
-	assert(d1 >= 0 && d1 < NDIM);
-	assert(d2 >= 0 && d2 < NDIM);
+	assert(d1 < NDIM);
+	assert(d2 < NDIM);
 
 	local_getGridStuff(gridFFT, dim1D, &data, dimsGrid, dimsPatch,
 	                   idxLo, kMaxGrid);
+	grid = gridRegularFFT_getGridFFTed(gridFFT);
+	c1   = gridRegular_getCurrentDim(grid, (int)d1);
+	c2   = gridRegular_getCurrentDim(grid, (int)d2);
+	norm = gridRegularFFT_getNorm(gridFFT);
 
 #ifdef _OPENMP
 #  pragma omp parallel for shared(dimsPatch, idxLo, kMaxGrid, \
-	dimsGrid, data, d1, d2)
+	dimsGrid, data, c1, c2, norm)
 #endif
 	for (uint64_t k = 0; k < dimsPatch[2]; k++) {
-		int64_t k2 = k + idxLo[2];
-		k2 = (k2 > kMaxGrid[2]) ? k2 - dimsGrid[2] : k2;
+		int64_t kReal[3];
+		kReal[2] = k + idxLo[2];
+		kReal[2] = (kReal[2] > kMaxGrid[2]) ? kReal[2] - dimsGrid[2]
+		           : kReal[2];
 		for (uint64_t j = 0; j < dimsPatch[1]; j++) {
-			int64_t k1 = j + idxLo[1];
-			k1 = (k1 > kMaxGrid[1]) ? k1 - dimsGrid[1] : k1;
+			kReal[1] = j + idxLo[1];
+			kReal[1] = (kReal[1] > kMaxGrid[1]) ? kReal[1] - dimsGrid[1]
+			           : kReal[1];
 			for (uint64_t i = 0; i < dimsPatch[0]; i++) {
-				int64_t  k0 = i + idxLo[0], kd1, kd2;
 				double   kCellSqr;
 				uint64_t idx;
-				k0 = (k0 > kMaxGrid[0]) ? k0 - dimsGrid[0] : k0;
 
-				if (d1 == 0)
-					kd1 = k1;
-				else if (d1 == 1)
-					kd1 = k2;
-				else
-					kd1 = k0;
-
-				if (d2 == 0)
-					kd2 = k1;
-				else if (d2 == 1)
-					kd2 = k2;
-				else
-					kd2 = k0;
+				kReal[0] = i + idxLo[0];
+				kReal[0] = (kReal[0] > kMaxGrid[0]) ? kReal[0] - dimsGrid[0]
+				           : kReal[0];
 
 				idx      = i + (j + k * dimsPatch[1]) * dimsPatch[0];
-				kCellSqr = (double)(k0 * k0 + k1 * k1 + k2 * k2);
+				kCellSqr = (double)(kReal[0] * kReal[0] + kReal[1] * kReal[1]
+				                    + kReal[2] * kReal[2]);
 
-				if ((k0 == 0) && (k1 == 0) && (k2 == 0))
+				if ((kReal[0] == 0) && (kReal[1] == 0) && (kReal[2] == 0))
+					data[idx] = 0.0;
+				else if ((c1 != c2) && ((kReal[c1] == kMaxGrid[c1])
+				                        || (kReal[c2] == kMaxGrid[c2])))
 					data[idx] = 0.0;
 				else
-					data[idx] *= (fpv_t)(-kd1 * kd2 / kCellSqr);
+					data[idx] *= (fpv_t)(-kReal[c1] * kReal[c2] / kCellSqr
+					                     * norm);
 			}
 		}
 	}
-} /* g9pIC_calcDDFromDelta */
+} /* g9pIC_calcDDPhiFromDelta */
 
 extern cosmoPk_t
 g9pIC_calcPkFromDelta(gridRegularFFT_t gridFFT,
@@ -478,6 +503,15 @@ g9pIC_getModeStr(g9pICMode_t mode)
 		case G9PIC_MODE_SVZ:
 			s = local_modeSVzStr;
 			break;
+		case G9PIC_MODE_V2X:
+			s = local_modeV2xStr;
+			break;
+		case G9PIC_MODE_V2Y:
+			s = local_modeV2yStr;
+			break;
+		case G9PIC_MODE_V2Z:
+			s = local_modeV2zStr;
+			break;
 		default:
 			diediedie(EXIT_FAILURE);
 	}
@@ -553,10 +587,12 @@ local_getDisplacementToVelocityFactor2lpt(cosmoModel_t model, double aInit)
 
 	double error;
 	double adot       = cosmoModel_calcADot(model, aInit);
+	double growth     = cosmoModel_calcGrowth(model, aInit, &error);
+	double growth2    = cosmoModel_calcGrowth2lpt(model, aInit, &error);
 	double growthVel2 = cosmoModel_calcDlnGrowthDlna2lpt(model, aInit,
 	                                                     &error);
 
-	return adot * 100. * growthVel2;
+	return -adot * 100. * growthVel2 * growth2 / (growth * growth);
 }
 
 #define WRAP_WAVENUM(k, kmax, dims) \
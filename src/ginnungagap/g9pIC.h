@@ -44,7 +44,19 @@ typedef enum {
 	/** @brief  Do the y-component of the small scale velocity. */
 	G9PIC_MODE_SVY,
 	/** @brief  Do the z-component of the small scale velocity. */
-	G9PIC_MODE_SVZ
+	G9PIC_MODE_SVZ,
+	/**
+	 * @brief  Do the x-component of the second order velocity.
+	 *
+	 * For the second order modes the grid must hold the forward
+	 * transform of the second order source field instead of the
+	 * overdensity, see g9pIC_calcDDPhiFromDelta().
+	 */
+	G9PIC_MODE_V2X,
+	/** @brief  Do the y-component of the second order velocity. */
+	G9PIC_MODE_V2Y,
+	/** @brief  Do the z-component of the second order velocity. */
+	G9PIC_MODE_V2Z
 } g9pICMode_t;
 
 
@@ -127,6 +139,18 @@ g9pIC_calcDeltaFromWN(gridRegularFFT_t gridFFT,
  * details on the calculations of the first and last factor in the last
  * equation.
  *
+ * For the second order modes (#G9PIC_MODE_V2X and friends) the grid
+ * holds the unnormalised forward transform of the source
+ * @f$ S = \sum_{i<j} (\phi_{,ii}\phi_{,jj} - \phi_{,ij}^2) @f$
+ * and the normalisation is
+ * @f[
+ *    \mbox{norm} = -\dot{a} H_0 \frac{D_2}{D_1^2}
+ *                  \frac{\mbox{d} \ln D_2}{ \mbox{d} \ln a}
+ *                  \frac{1}{N}
+ * @f]
+ * where @f$ N @f$ is the number of cells of the grid, see
+ * cosmoModel_calcGrowth2lpt() and cosmoModel_calcDlnGrowthDlna2lpt().
+ *
  * @bug This is only valid in MPI mode, where the grid is permuted in
  *      the order @f$ z, x, y @f$.
  *
@@ -170,6 +194,26 @@ g9pIC_calcVelFromDelta(gridRegularFFT_t gridFFT,
 /**
  * @brief  Calculates the second derivative of the linear potential.
  *
+ * The potential is defined by @f$ \nabla^2 \phi = -\delta @f$, hence
+ * @f[
+ *    \hat{\phi}_{,ij} = -\frac{k_i k_j}{k^2} \hat{\delta} .
+ * @f]
+ * For mixed derivatives the Nyquist modes of the two directions are set
+ * to zero, as is done for the velocities.
+ *
+ * The input is expected to come straight from the forward FFT of the real
+ * space overdensity, hence the normalisation of the FFT (see
+ * gridRegularFFT_getNorm()) is applied here as well.  The backward FFT of
+ * the result then directly yields @f$ \phi_{,ij} @f$ in real space.
+ *
+ * The second order source is then found in real space as
+ * @f[
+ *    S = \frac{1}{2} \left( \delta^2 - \sum_{i,j} \phi_{,ij}^2
+ *        \right) ,
+ * @f]
+ * which only requires to accumulate squares of the six independent
+ * derivatives one after the other.
+ *
  * @param[in,out]  gridFFT
  *                    The interface to the FFT'ed grid.  The underyling grid
  *                    must be in Fourier space and contain the overdensity
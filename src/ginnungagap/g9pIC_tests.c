@@ -0,0 +1,197 @@
+// Copyright (C) 2012, Steffen Knollmann
+// Released under the terms of the GNU General Public License version 3.
+// This file is part of `ginnungagap'.
+
+
+/*--- Doxygen file description ------------------------------------------*/
+
+/**
+ * @file ginnungagap/g9pIC_tests.c
+ * @ingroup  ginnungagapIC
+ * @brief  Implements the test functions for the initial conditions.
+ */
+
+
+/*--- Includes ----------------------------------------------------------*/
+#include "g9pConfig.h"
+#include "g9pIC_tests.h"
+#include "g9pIC.h"
+#include <stdio.h>
+#include <math.h>
+#include <complex.h>
+#ifdef WITH_MPI
+#  include <mpi.h>
+#endif
+#include "../libutil/xmem.h"
+#include "../libgrid/gridRegular.h"
+#include "../libgrid/gridRegularDistrib.h"
+#include "../libgrid/gridRegularFFT.h"
+#include "../libgrid/gridPatch.h"
+#include "../libdata/dataVar.h"
+
+
+/*--- Local defines -----------------------------------------------------*/
+#define LOCAL_DIM1D 16
+
+
+/*--- Prototypes of local functions -------------------------------------*/
+static gridRegular_t
+local_getGrid(void);
+
+static gridRegularDistrib_t
+local_getGridDistrib(gridRegular_t grid);
+
+static bool
+local_getLocalIdxOfMode(gridRegular_t  grid,
+                        const int32_t  mode[NDIM],
+                        uint64_t       *idx);
+
+
+/*--- Implementations of exported functions -----------------------------*/
+extern bool
+g9pIC_calcDDPhiFromDelta_test(void)
+{
+	bool                 hasPassed = true;
+	int                  rank      = 0;
+	gridRegular_t        grid, gridFFTed;
+	gridRegularDistrib_t distrib;
+	gridRegularFFT_t     fft;
+	gridPatch_t          patch;
+	fpvComplex_t         *data;
+	uint64_t             numCells, idxMode = 0;
+	bool                 hasMode;
+	// The plane wave delta(x) = cos(2 pi m.x / N), the forward FFT puts
+	// N^3/2 into the mode m of the (half) complex grid.
+	const int32_t        m[NDIM] = {1, 2, -3};
+	const double         kSqr    = m[0] * m[0] + m[1] * m[1] + m[2] * m[2];
+	const double         amp     = 0.5 * LOCAL_DIM1D * LOCAL_DIM1D
+	                               * LOCAL_DIM1D;
+#ifdef XMEM_TRACK_MEM
+	size_t               allocatedBytes = global_allocated_bytes;
+#endif
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	grid      = local_getGrid();
+	distrib   = local_getGridDistrib(grid);
+	fft       = gridRegularFFT_new(grid, distrib, 0);
+	gridFFTed = gridRegularFFT_getGridFFTed(fft);
+	patch     = gridRegular_getPatchHandle(gridFFTed, 0);
+	data      = gridPatch_getVarDataHandle(patch, 0);
+	numCells  = gridPatch_getNumCells(patch);
+	hasMode   = local_getLocalIdxOfMode(gridFFTed, m, &idxMode);
+
+	for (uint32_t d1 = 0; d1 < NDIM; d1++) {
+		for (uint32_t d2 = d1; d2 < NDIM; d2++) {
+			// phi_,ij(x) = -m_i m_j / m^2 cos(2 pi m.x / N), hence the
+			// normalised coefficient is half of the amplitude.
+			double expected = -0.5 * m[d1] * m[d2] / kSqr;
+
+			for (uint64_t i = 0; i < numCells; i++)
+				data[i] = 0.0;
+			if (hasMode)
+				data[idxMode] = amp;
+
+			g9pIC_calcDDPhiFromDelta(fft, LOCAL_DIM1D, d1, d2);
+
+			for (uint64_t i = 0; i < numCells; i++) {
+				double wanted = (hasMode && (i == idxMode)) ? expected : 0.0;
+				if ((fabs(creal(data[i]) - wanted) > 1e-6)
+				    || (fabs(cimag(data[i])) > 1e-6))
+					hasPassed = false;
+			}
+		}
+	}
+
+	gridRegularFFT_del(&fft);
+	gridRegularDistrib_del(&distrib);
+	gridRegular_del(&grid);
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+} /* g9pIC_calcDDPhiFromDelta_test */
+
+/*--- Implementations of local functions --------------------------------*/
+static gridRegular_t
+local_getGrid(void)
+{
+	gridRegular_t     grid;
+	gridPointDbl_t    origin;
+	gridPointDbl_t    extent;
+	gridPointUint32_t dims;
+	dataVar_t         var;
+
+	for (int i = 0; i < NDIM; i++) {
+		origin[i] = 0.0;
+		extent[i] = 1.0;
+		dims[i]   = LOCAL_DIM1D;
+	}
+	var = dataVar_new("delta", DATAVARTYPE_FPV, 1);
+	dataVar_setFFTWPadded(var);
+
+	grid = gridRegular_new("test", origin, extent, dims);
+	gridRegular_attachVar(grid, var);
+
+	return grid;
+}
+
+static gridRegularDistrib_t
+local_getGridDistrib(gridRegular_t grid)
+{
+	gridRegularDistrib_t distrib;
+	int                  rank = 0;
+#ifdef WITH_MPI
+	gridPointInt_t       nProcs;
+#endif
+	gridPatch_t          patch;
+
+	distrib = gridRegularDistrib_new(grid, NULL);
+#ifdef WITH_MPI
+	for (int i = 0; i < NDIM - 1; i++)
+		nProcs[i] = 1;
+	MPI_Comm_size(MPI_COMM_WORLD, &(nProcs[NDIM - 1]));
+	gridRegularDistrib_initMPI(distrib, nProcs, MPI_COMM_WORLD);
+	rank = gridRegularDistrib_getLocalRank(distrib);
+#endif
+
+	patch = gridRegularDistrib_getPatchForRank(distrib, rank);
+	gridRegular_attachPatch(grid, patch);
+
+	return distrib;
+}
+
+static bool
+local_getLocalIdxOfMode(gridRegular_t  grid,
+                        const int32_t  mode[NDIM],
+                        uint64_t       *idx)
+{
+	gridPatch_t       patch = gridRegular_getPatchHandle(grid, 0);
+	gridPointUint32_t dimsGrid, dimsPatch, idxLo;
+	gridPointUint32_t idxInPatch;
+
+	gridRegular_getDims(grid, dimsGrid);
+	gridPatch_getDims(patch, dimsPatch);
+	gridPatch_getIdxLo(patch, idxLo);
+
+	// The Fourier grid may be stored transposed, so the wave number of the
+	// real space direction d lives in the current dimension of d.
+	for (int d = 0; d < NDIM; d++) {
+		int     c = gridRegular_getCurrentDim(grid, d);
+		int64_t k = (mode[d] < 0) ? mode[d] + dimsGrid[c] : mode[d];
+
+		if ((k < idxLo[c]) || (k >= idxLo[c] + dimsPatch[c]))
+			return false;
+		idxInPatch[c] = (uint32_t)(k - idxLo[c]);
+	}
+	*idx = idxInPatch[0] + (idxInPatch[1] + idxInPatch[2] * dimsPatch[1])
+	       * (uint64_t)dimsPatch[0];
+
+	return true;
+}
@@ -0,0 +1,29 @@
+// Copyright (C) 2012, Steffen Knollmann
+// Released under the terms of the GNU General Public License version 3.
+// This file is part of `ginnungagap'.
+
+#ifndef G9PIC_TESTS_H
+#define G9PIC_TESTS_H
+
+
+/*--- Doxygen file description ------------------------------------------*/
+
+/**
+ * @file ginnungagap/g9pIC_tests.h
+ * @ingroup  ginnungagapIC
+ * @brief  Provides the interface to the test functions for the initial
+ *         conditions.
+ */
+
+
+/*--- Includes ----------------------------------------------------------*/
+#include "g9pConfig.h"
+#include <stdbool.h>
+
+
+/*--- Prototypes of exported functions ----------------------------------*/
+extern bool
+g9pIC_calcDDPhiFromDelta_test(void);
+
+
+#endif
@@ -161,10 +161,10 @@ g9pSetup_del(g9pSetup_t *setup);
  * #################
  * #
  * # This can be used to switch on the calculation of an additional set of
- * # velocity fields which encode the second order corrections to linear
- * # theory.  To calculate this corrections, a significantly larger amount
- * # of memory is required.  If this key is not set, no corrections will be
- * # calculated.
+ * # velocity fields (vel2x, vel2y and vel2z) which encode the second order
+ * # corrections to linear theory.  To calculate this corrections, memory
+ * # for two more fields of the size of the grid is required.  If this key
+ * # is not set, no corrections will be calculated.
  * do2LPTCorrections = <true|false>
  * #
  * # A tag whether or not to write the density field.  Note: This should
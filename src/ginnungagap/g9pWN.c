@@ -180,13 +180,18 @@ local_setupFromRNG(g9pWN_t     wn,
 	int      numStreams;
 	fpv_t    *data;
 	uint64_t numCells = 0;
+	uint64_t lenRun, strideRun, numRuns;
 
 	data       = gridPatch_getVarDataHandle(patch, idxOfDensVar);
 	numCells   = gridPatch_getNumCells(patch);
 	numStreams = rng_getNumStreamsLocal(wn->rng);
+	// The cells are numbered as if the storage were dense, so that a padded
+	// variable receives the same random numbers as an unpadded one.
+	gridPatch_getVarRuns(patch, idxOfDensVar, &lenRun, &strideRun, &numRuns);
 
 #ifdef _OPENMP
-#  pragma omp parallel for shared(data, numStreams, numCells)
+#  pragma omp parallel for shared(data, numStreams, numCells, lenRun, \
+	strideRun)
 #endif
 	for (int i = 0; i < numStreams; i++) {
 		uint64_t cps   = numCells / numStreams;
@@ -195,7 +200,8 @@ local_setupFromRNG(g9pWN_t     wn,
 		                                                     + cps);
 		for (uint64_t j = start; j < stop; j++) {
 			assert(j < numCells);
-			data[j] = (fpv_t)rng_getGaussUnit(wn->rng, i);
+			data[(j / lenRun) * strideRun + j % lenRun]
+			    = (fpv_t)rng_getGaussUnit(wn->rng, i);
 		}
 	}
 }
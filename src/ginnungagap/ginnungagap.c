@@ -24,6 +24,7 @@
 #include <stdbool.h>
 #include <assert.h>
 #include <inttypes.h>
+#include <string.h>
 #ifdef WITH_MPI
 #  include <mpi.h>
 #endif
@@ -31,9 +32,10 @@
 #  include <omp.h>
 #endif
 #include "../libutil/xmem.h"
+#include "../libutil/memPool.h"
 #include "../libutil/xstring.h"
 #include "../libutil/xfile.h"
-#include "../libutil/timer.h"
+#include "../libutil/profile.h"
 #include "../libutil/filename.h"
 #include "../libutil/utilMath.h"
 #include "../libcosmo/cosmo.h"
@@ -103,6 +105,15 @@ local_doRenames(dataVar_t var, gridWriter_t writer, const char *newName);
 static void
 local_do2LPTCorrections(ginnungagap_t g9p);
 
+static void
+local_addSquare(fpv_t *restrict       source,
+                const fpv_t *restrict data,
+                uint64_t              numElements,
+                double                weight);
+
+static uint64_t
+local_getNumBytesLocal(ginnungagap_t g9p);
+
 
 /*--- Implementations of exported functios ------------------------------*/
 extern ginnungagap_t
@@ -166,6 +177,7 @@ ginnungagap_run(ginnungagap_t g9p)
 
 	if (g9p->rank == 0)
 		printf("\nGenerating IC:\n\n");
+	profile_enter("ginnungagap_run");
 
 	local_doWhiteNoise(g9p, true);
 	local_doWhiteNoisePk(g9p);
@@ -270,6 +282,7 @@ ginnungagap_run(ginnungagap_t g9p)
 	
 	if (g9p->setup->do2LPTCorrections)
 		local_do2LPTCorrections(g9p);
+	profile_leave();
 } /* ginnungagap_run */
 
 extern void
@@ -292,6 +305,7 @@ ginnungagap_del(ginnungagap_t *g9p)
 	gridRegular_del(&((*g9p)->grid));
 	gridWriter_del(&((*g9p)->finalWriter));
 	g9pSetup_del(&((*g9p)->setup));
+	memPool_trim();
 	xfree(*g9p);
 	*g9p = NULL;
 }
@@ -347,13 +361,10 @@ local_initGrid(gridRegular_t grid, gridRegularDistrib_t distrib)
 	gridRegular_attachPatch(grid, patch);
 
 	dens = dataVar_new("wn", DATAVARTYPE_FPV, 1);
-#ifdef WITH_FFT_FFTW3
-#  ifdef ENABLE_DOUBLE
-	dataVar_setMemFuncs(dens, &fftw_malloc, &fftw_free);
-#  else
-	dataVar_setMemFuncs(dens, &fftwf_malloc, &fftwf_free);
-#  endif
-#endif
+	dataVar_setMemFuncs(dens, &memPool_malloc, &memPool_free);
+	// Allows the FFT to work in place, the readers, writers and statistics
+	// hide the padding of the rows.
+	dataVar_setFFTWPadded(dens);
 	return gridRegular_attachVar(grid, dens);
 }
 
@@ -390,98 +401,97 @@ local_newHistograms(ginnungagap_t g9p)
 static void
 local_doWhiteNoise(ginnungagap_t g9p, bool doDumpOfWhiteNoise)
 {
-	double timing;
-
-	timing = timer_start_text("  Setting up white noise... ");
+	profile_enter_text("whiteNoise", "  Setting up white noise... ");
 	g9pWN_setup(g9p->whiteNoise,
 	            g9p->grid,
 	            g9p->posOfDens);
-	timing = timer_stop_text(timing, "took %.5fs\n");
+	profile_leave_text("took %.5fs\n");
 
 	if (doDumpOfWhiteNoise) {
-		timing = timer_start_text("  Writing white noise to file... ");
+		profile_enter_text("writeWhiteNoise",
+		                   "  Writing white noise to file... ");
 		g9pWN_dump(g9p->whiteNoise, g9p->grid);
-		timing = timer_stop_text(timing, "took %.5fs\n");
+		profile_addBytes(local_getNumBytesLocal(g9p));
+		profile_leave_text("took %.5fs\n");
 		if (g9p->setup->doHistograms)
 			local_doHistogram(g9p, 0, g9p->histoWN,
 			                  g9p->setup->nameHistogramWN);
 	}
 
-	timing = timer_start_text("  Going to k-space... ");
+	profile_enter_text("fftForward", "  Going to k-space... ");
 	gridRegularFFT_execute(g9p->gridFFT, GRIDREGULARFFT_FORWARD);
-	timing = timer_stop_text(timing, "took %.5fs\n");
+	profile_leave_text("took %.5fs\n");
 }
 
 static void
 local_doWhiteNoisePk(ginnungagap_t g9p)
 {
-	double    timing;
 	cosmoPk_t pk;
 
 	if (g9p->setup->dim1D >= G9P_MINGRIDSIZE_FOR_PS) {
-		timing = timer_start_text("  Calculating P(k) for white noise... ");
-		pk     = g9pIC_calcPkFromDelta(g9p->gridFFT,
-		                               g9p->setup->dim1D,
-		                               g9p->setup->boxsizeInMpch);
+		profile_enter_text("pkWhiteNoise",
+		                   "  Calculating P(k) for white noise... ");
+		pk = g9pIC_calcPkFromDelta(g9p->gridFFT,
+		                           g9p->setup->dim1D,
+		                           g9p->setup->boxsizeInMpch);
 		cosmoPk_dumpToFile(pk, g9p->setup->namePkWN, 1);
 		cosmoPk_del(&pk);
-		timing = timer_stop_text(timing, "took %.5fs\n");
+		profile_leave_text("took %.5fs\n");
 	}
 }
 
 static void
 local_doDeltaK(ginnungagap_t g9p)
 {
-	double timing;
-
-	timing = timer_start_text("  Generating delta(k)... ");
+	profile_enter_text("deltaK", "  Generating delta(k)... ");
 	g9pIC_calcDeltaFromWN(g9p->gridFFT,
 	                      g9p->setup->dim1D,
 	                      g9p->setup->boxsizeInMpch,
 	                      g9p->pk);
-	timing = timer_stop_text(timing, "took %.5fs\n");
+	profile_leave_text("took %.5fs\n");
 }
 
 static void
 local_doDeltaKPk(ginnungagap_t g9p)
 {
-	double    timing;
 	cosmoPk_t pk;
 
 	if (g9p->setup->dim1D >= G9P_MINGRIDSIZE_FOR_PS) {
-		timing = timer_start_text("  Calculating P(k) for delta(k)... ");
-		pk     = g9pIC_calcPkFromDelta(g9p->gridFFT,
-		                               g9p->setup->dim1D,
-		                               g9p->setup->boxsizeInMpch);
+		profile_enter_text("pkDeltaK",
+		                   "  Calculating P(k) for delta(k)... ");
+		pk = g9pIC_calcPkFromDelta(g9p->gridFFT,
+		                           g9p->setup->dim1D,
+		                           g9p->setup->boxsizeInMpch);
 		cosmoPk_dumpToFile(pk, g9p->setup->namePkDeltak, 1);
 		cosmoPk_del(&pk);
-		timing = timer_stop_text(timing, "took %.5fs\n");
+		profile_leave_text("took %.5fs\n");
 	}
 }
 
 static void
 local_doDeltaX(ginnungagap_t g9p)
 {
-	double    timing;
 #ifdef ENABLE_WRITING
 	dataVar_t var;
 #endif
 
-	timing = timer_start_text("  Going back to real space... ");
+	profile_enter_text("fftBackward", "  Going back to real space... ");
 	gridRegularFFT_execute(g9p->gridFFT, GRIDREGULARFFT_BACKWARD);
-	timing = timer_stop_text(timing, "took %.5fs\n");
+	profile_leave_text("took %.5fs\n");
 
 #ifdef ENABLE_WRITING
 	var = gridRegular_getVarHandle(g9p->grid, g9p->posOfDens);
 	if (g9p->setup->writeDensityField) {
-		timing = timer_start_text("  Writing delta(x) to file... ");
+		profile_enter_text("writeDeltaX",
+		                   "  Writing delta(x) to file... ");
 		local_doRenames(var, g9p->finalWriter, "delta");
 		gridWriter_activate(g9p->finalWriter);
 		gridWriter_writeGridRegular(g9p->finalWriter,
 		                            g9p->grid);
 		gridWriter_deactivate(g9p->finalWriter);
 		dataVar_rename(var, "wn");
-		timing = timer_stop_text(timing, "took %.5fs\n");
+		profile_addBytes(local_getNumBytesLocal(g9p));
+		profile_leave_text("took %.5fs\n");
 	}
 #endif
 }
@@ -489,7 +499,6 @@ local_doDeltaX(ginnungagap_t g9p)
 static void
 local_doVelocities(ginnungagap_t g9p, g9pICMode_t mode)
 {
-	double    timing;
 	char      *msg = NULL, *msg2 = NULL;
 #ifdef ENABLE_WRITING
 	dataVar_t var;
@@ -497,7 +506,7 @@ local_doVelocities(ginnungagap_t g9p, g9pICMode_t mode)
 
 	msg    = xstrmerge("  Generating ", g9pIC_getModeStr(mode));
 	msg2   = xstrmerge(msg, "(k)... ");
-	timing = timer_start_text(msg2);
+	profile_enter_text("velocity", msg2);
 	g9pIC_calcVelFromDelta(g9p->gridFFT,
 	                       g9p->setup->dim1D,
 	                       g9p->setup->boxsizeInMpch,
@@ -505,18 +514,18 @@ local_doVelocities(ginnungagap_t g9p, g9pICMode_t mode)
 	                       cosmo_z2a(g9p->setup->zInit),
 	                       g9p->setup->cutoffScale,
 	                       mode);
-	timing = timer_stop_text(timing, "took %.5fs\n");
+	profile_leave_text("took %.5fs\n");
 	xfree(msg2);
 	xfree(msg);
 
-	timing = timer_start_text("  Going back to real space... ");
+	profile_enter_text("fftBackward", "  Going back to real space... ");
 	gridRegularFFT_execute(g9p->gridFFT, GRIDREGULARFFT_BACKWARD);
-	timing = timer_stop_text(timing, "took %.5fs\n");
+	profile_leave_text("took %.5fs\n");
 
 #ifdef ENABLE_WRITING
 	msg    = xstrmerge("  Writing ", g9pIC_getModeStr(mode));
 	msg2   = xstrmerge(msg, "(x) to file... ");
-	timing = timer_start_text(msg2);
+	profile_enter_text("writeVelocity", msg2);
 	var    = gridRegular_getVarHandle(g9p->grid,
 	                                  g9p->posOfDens);
 	local_doRenames(var, g9p->finalWriter, g9pIC_getModeStr(mode));
@@ -526,7 +535,8 @@ local_doVelocities(ginnungagap_t g9p, g9pICMode_t mode)
 	                            g9p->grid);
 	gridWriter_deactivate(g9p->finalWriter);
 	dataVar_rename(var, "wn");
-	timing = timer_stop_text(timing, "took %.5fs\n");
+	profile_addBytes(local_getNumBytesLocal(g9p));
+	profile_leave_text("took %.5fs\n");
 	xfree(msg2);
 	xfree(msg);
 #endif
@@ -535,14 +545,13 @@ local_doVelocities(ginnungagap_t g9p, g9pICMode_t mode)
 static void
 local_doStatistics(ginnungagap_t g9p, int idxOfVar)
 {
-	double           timing;
 	gridStatistics_t stat;
 
-	timing = timer_start_text("  Calculating statistics... ");
-	stat   = gridStatistics_new();
+	profile_enter_text("statistics", "  Calculating statistics... ");
+	stat = gridStatistics_new();
 	gridStatistics_calcGridRegularDistrib(stat, g9p->gridDistrib,
 	                                      idxOfVar);
-	timing = timer_stop_text(timing, "took %.5fs\n");
+	profile_leave_text("took %.5fs\n");
 	if (g9p->rank == 0)
 		gridStatistics_printPretty(stat, stdout, "  ");
 	gridStatistics_del(&stat);
@@ -554,11 +563,9 @@ local_doHistogram(ginnungagap_t         g9p,
                   const gridHistogram_t histo,
                   const char            *histoName)
 {
-	double timing;
-
-	timing = timer_start_text("  Calculating histogram... ");
+	profile_enter_text("histogram", "  Calculating histogram... ");
 	gridHistogram_calcGridRegularDistrib(histo, g9p->gridDistrib, idxOfVar);
-	timing = timer_stop_text(timing, "took %.5fs\n");
+	profile_leave_text("took %.5fs\n");
 
 	if (g9p->rank == 0) {
 		gridHistogram_printPrettyFile(histo, histoName, false, "");
@@ -585,4 +592,93 @@ local_doRenames(dataVar_t var, gridWriter_t writer, const char *newName)
 static void
 local_do2LPTCorrections(ginnungagap_t g9p)
 {
+	gridPatch_t patch = gridRegular_getPatchHandle(g9p->grid, 0);
+	uint64_t    numElements;
+	size_t      numBytes;
+	fpv_t       *delta, *source, *data;
+
+	// Only the white noise is reused, delta(x) and the source are kept in
+	// real space, as the FFT moves the field between the real and the
+	// Fourier patch.  At most three fields are held at any time.
+	g9pWN_reset(g9p->whiteNoise);
+	local_doWhiteNoise(g9p, false);
+	local_doDeltaK(g9p);
+	profile_enter_text("fftBackward", "  Going back to real space... ");
+	gridRegularFFT_execute(g9p->gridFFT, GRIDREGULARFFT_BACKWARD);
+	profile_leave_text("took %.5fs\n");
+
+	// The copies include the FFTW padding of the rows, the padding cells are
+	// carried along as ordinary values and are ignored by the FFT.
+	numElements = gridPatch_getNumCellsActual(patch, g9p->posOfDens);
+	numBytes    = numElements * sizeof(fpv_t);
+	delta       = xmalloc(numBytes);
+	source      = xmalloc(numBytes);
+	data        = gridPatch_getVarDataHandle(patch, g9p->posOfDens);
+	memcpy(delta, data, numBytes);
+	memset(source, 0, numBytes);
+	local_addSquare(source, delta, numElements, 0.5);
+
+	for (uint32_t d1 = 0; d1 < NDIM; d1++) {
+		for (uint32_t d2 = d1; d2 < NDIM; d2++) {
+			data = gridPatch_getVarDataHandle(patch, g9p->posOfDens);
+			memcpy(data, delta, numBytes);
+			profile_enter_text("fftForward", "  Going to k-space... ");
+			gridRegularFFT_execute(g9p->gridFFT, GRIDREGULARFFT_FORWARD);
+			profile_leave_text("took %.5fs\n");
+
+			profile_enter_text("ddphi", "  Generating phi_ij(k)... ");
+			g9pIC_calcDDPhiFromDelta(g9p->gridFFT, g9p->setup->dim1D,
+			                         d1, d2);
+			profile_leave_text("took %.5fs\n");
+
+			profile_enter_text("fftBackward",
+			                   "  Going back to real space... ");
+			gridRegularFFT_execute(g9p->gridFFT, GRIDREGULARFFT_BACKWARD);
+			profile_leave_text("took %.5fs\n");
+
+			data = gridPatch_getVarDataHandle(patch, g9p->posOfDens);
+			local_addSquare(source, data, numElements,
+			                (d1 == d2) ? -0.5 : -1.0);
+		}
+	}
+	xfree(delta);
+	if (g9p->rank == 0)
+		printf("\n");
+
+	for (int i = 0; i < NDIM; i++) {
+		data = gridPatch_getVarDataHandle(patch, g9p->posOfDens);
+		memcpy(data, source, numBytes);
+		profile_enter_text("fftForward", "  Going to k-space... ");
+		gridRegularFFT_execute(g9p->gridFFT, GRIDREGULARFFT_FORWARD);
+		profile_leave_text("took %.5fs\n");
+		local_doVelocities(g9p, G9PIC_MODE_V2X + i);
+		local_doStatistics(g9p, 0);
+		if (g9p->rank == 0)
+			printf("\n");
+	}
+	xfree(source);
+} /* local_do2LPTCorrections */
+
+static void
+local_addSquare(fpv_t *restrict       source,
+                const fpv_t *restrict data,
+                uint64_t              numElements,
+                double                weight)
+{
+	const fpv_t w = (fpv_t)weight;
+
+#ifdef _OPENMP
+#  pragma omp parallel for shared(source, data, numElements, w)
+#endif
+	for (uint64_t i = 0; i < numElements; i++)
+		source[i] += w * data[i] * data[i];
+}
+
+static uint64_t
+local_getNumBytesLocal(ginnungagap_t g9p)
+{
+	gridPatch_t patch = gridRegular_getPatchHandle(g9p->grid, 0);
+	dataVar_t   var   = gridRegular_getVarHandle(g9p->grid, g9p->posOfDens);
+
+	return gridPatch_getNumCells(patch) * dataVar_getSizePerElement(var);
 }
@@ -33,6 +33,7 @@
 #include "../libutil/xfile.h"
 #include "../libutil/cmdline.h"
 #include "../libutil/parse_ini.h"
+#include "../libutil/profile.h"
 
 
 /*--- Local variables ---------------------------------------------------*/
@@ -54,6 +55,12 @@ bool localVerify = false;
  */
 bool localInitOnly = false;
 
+/**
+ * @brief  Stores the name of the file to which the profile of the run is
+ *         written, @c NULL if no profile should be written.
+ */
+char *localProfileFname = NULL;
+
 
 /*--- Prototypes of local functions -------------------------------------*/
 static void
@@ -115,7 +122,13 @@ main(int argc, char **argv)
 		return EXIT_SUCCESS;
 
 	ginnungagap_run(g9p);
+	if (localProfileFname != NULL)
+		profile_report(localProfileFname);
+#ifdef XMEM_TRACK_MEM
+	xmem_infoGlobal(stdout);
+#endif
 	ginnungagap_del(&g9p);
+	profile_reset();
 
 	return EXIT_SUCCESS;
 }
@@ -139,6 +152,8 @@ local_initEnvironment(int *argc, char ***argv)
 	cmdline_getArgValueByNum(cmdline, 0, &localIniFname);
 	localVerify   = cmdline_checkOptSetByNum(cmdline, 2);
 	localInitOnly = cmdline_checkOptSetByNum(cmdline, 3);
+	if (cmdline_checkOptSetByNum(cmdline, 4))
+		cmdline_getOptValueByNum(cmdline, 4, &localProfileFname);
 	cmdline_del(&cmdline);
 }
 
@@ -188,6 +203,8 @@ local_finalMessage(void)
 	//MPI_Finalize();
 #endif
 	xfree(localIniFname);
+	if (localProfileFname != NULL)
+		xfree(localProfileFname);
 	if (rank == 0) {
 #ifdef XMEM_TRACK_MEM
 		printf("\n");
@@ -215,7 +232,7 @@ local_cmdlineSetup(void)
 {
 	cmdline_t cmdline;
 
-	cmdline = cmdline_new(1, 4, PACKAGE_NAME);
+	cmdline = cmdline_new(1, 5, PACKAGE_NAME);
 	(void)cmdline_addOpt(cmdline, "version",
 	                     "This will output a version information.",
 	                     false, CMDLINE_TYPE_NONE);
@@ -228,6 +245,11 @@ local_cmdlineSetup(void)
 	(void)cmdline_addOpt(cmdline, "initOnly",
 	                     "This will stop after initialisation.",
 	                     false, CMDLINE_TYPE_NONE);
+	(void)cmdline_addOpt(cmdline, "profile",
+	                     "This will write a timing profile of the run to the "
+	                     "given file (JSON if it ends in .json, CSV "
+	                     "otherwise).",
+	                     true, CMDLINE_TYPE_STRING);
 	(void)cmdline_addArg(cmdline,
 	                     "An ini file containing the configuration.",
 	                     CMDLINE_TYPE_STRING);
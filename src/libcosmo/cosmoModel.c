@@ -41,9 +41,153 @@
 /** @brief  The default value of the slope of the primordial power spectrum. */
 #define LOCAL_DEFAULT_NS 1.0
 
+/** @brief  The smallest expansion factor covered by the growth table. */
+#define LOCAL_GROWTH_AMIN 1e-6
+/** @brief  The largest expansion factor covered by the growth table. */
+#define LOCAL_GROWTH_AMAX 2.0
+/** @brief  The number of nodes (equally spaced in ln(a)) of the table. */
+#define LOCAL_GROWTH_NUM 2048
+/** @brief  The number of values stored per node of the table. */
+#define LOCAL_GROWTH_NUMVALUES 4
+/** @brief  The relative accuracy required from the integration. */
+#define LOCAL_GROWTH_EPSREL 1e-12
+/** @brief  The maximal number of integration steps between two nodes. */
+#define LOCAL_GROWTH_MAXSTEPS 1024
+
 
 /*--- Prototypes of local functions -------------------------------------*/
 
+/**
+ * @brief  Returns the expansion factor of matter-radiation equality.
+ *
+ * @param[in]  model
+ *                The model to work with.
+ *
+ * @return  Returns OmegaRad0/OmegaMatter0.
+ */
+static double
+local_getAEquality(const cosmoModel_t model);
+
+
+/**
+ * @brief  Evaluates the right hand side of the growth equations.
+ *
+ * The equations for the first and the second order growth factor are
+ * written as a system of four first order equations in ln(a).
+ *
+ * @param[in]   model
+ *                 The model to work with.
+ * @param[in]   lna
+ *                 The logarithm of the expansion factor.
+ * @param[in]   y
+ *                 D, dD/dln(a), D2 and dD2/dln(a) at @c lna.
+ * @param[out]  dydlna
+ *                 Receives the derivatives of @c y with respect to
+ *                 ln(a).
+ *
+ * @return  Returns nothing.
+ */
+static void
+local_growthDeriv(const cosmoModel_t model,
+                  double             lna,
+                  const double       *y,
+                  double             *dydlna);
+
+
+/**
+ * @brief  Integrates the growth equations with fourth order Runge-Kutta.
+ *
+ * @param[in]      model
+ *                    The model to work with.
+ * @param[in]      lna
+ *                    The starting point.
+ * @param[in]      dlna
+ *                    The total length of the integration.
+ * @param[in]      numSteps
+ *                    The number of equal steps to use.
+ * @param[in,out]  y
+ *                    The values at @c lna, receives the values at
+ *                    @c lna + @c dlna.
+ *
+ * @return  Returns nothing.
+ */
+static void
+local_growthIntegrate(const cosmoModel_t model,
+                      double             lna,
+                      double             dlna,
+                      int                numSteps,
+                      double             *y);
+
+
+/**
+ * @brief  Fills the growth table of a model.
+ *
+ * The step between two nodes is refined by step doubling until
+ * #LOCAL_GROWTH_EPSREL is reached.
+ *
+ * @param[in,out]  model
+ *                    The model to work with.
+ *
+ * @return  Returns nothing.
+ */
+static void
+local_growthTabulate(cosmoModel_t model);
+
+
+/**
+ * @brief  Gets the growth factors at a given expansion factor.
+ *
+ * Between the nodes of the table the values are interpolated with cubic
+ * Hermite polynomials, using the derivatives given by the growth
+ * equations.  Below #LOCAL_GROWTH_AMIN the initial growing mode is used.
+ *
+ * @param[in,out]  model
+ *                    The model to work with, the table is created if
+ *                    required.
+ * @param[in]      a
+ *                    The expansion factor, must not be larger than
+ *                    #LOCAL_GROWTH_AMAX.
+ * @param[out]     y
+ *                    Receives D, dD/dln(a), D2 and dD2/dln(a).
+ *
+ * @return  Returns nothing.
+ */
+static void
+local_growthEval(cosmoModel_t model, double a, double *y);
+
+
+/**
+ * @brief  Deletes the growth table of a model.
+ *
+ * Must be called whenever a parameter of the model changes.
+ *
+ * @param[in,out]  model
+ *                    The model to work with.
+ *
+ * @return  Returns nothing.
+ */
+static void
+local_growthInvalidate(cosmoModel_t model);
+
+
+/**
+ * @brief  Calculates the linear growth factor by direct integration.
+ *
+ * This is used beyond #LOCAL_GROWTH_AMAX (Heath 1977), ignoring
+ * radiation.
+ *
+ * @param[in]   model
+ *                 The model to work with.
+ * @param[in]   a
+ *                 The expansion factor.
+ * @param[out]  *error
+ *                 Receives the error estimate of the integration.
+ *
+ * @return  Returns the growth factor.
+ */
+static double
+local_calcGrowthIntegral(cosmoModel_t model, double a, double *error);
+
 
 /*--- Implementations of exported functios ------------------------------*/
 extern cosmoModel_t
@@ -60,6 +204,8 @@ cosmoModel_new(void)
 	model->sigma8       = 0.0;
 	model->ns           = 0.0;
 	model->tempCMB      = 0.0;
+	model->growthTable  = NULL;
+	model->growthError  = 0.0;
 
 	return model;
 }
@@ -135,6 +281,7 @@ extern void
 cosmoModel_del(cosmoModel_t *model)
 {
 	assert(model != NULL && *model != NULL);
+	local_growthInvalidate(*model);
 	xfree(*model);
 	*model = NULL;
 }
@@ -208,6 +355,7 @@ cosmoModel_setOmegaRad0(cosmoModel_t model, const double omegaRad0)
 {
 	assert(model != NULL);
 
+	local_growthInvalidate(model);
 	model->omegaRad0 = omegaRad0;
 }
 
@@ -216,6 +364,7 @@ cosmoModel_setOmegaLambda0(cosmoModel_t model, const double omegaLambda0)
 {
 	assert(model != NULL);
 
+	local_growthInvalidate(model);
 	model->omegaLambda0 = omegaLambda0;
 }
 
@@ -224,6 +373,7 @@ cosmoModel_setOmegaMatter0(cosmoModel_t model, const double omegaMatter0)
 {
 	assert(model != NULL);
 
+	local_growthInvalidate(model);
 	model->omegaMatter0 = omegaMatter0;
 }
 
@@ -390,30 +540,23 @@ cosmoModel_calcOmegaLambda(cosmoModel_t model, double a)
 extern double
 cosmoModel_calcGrowth(cosmoModel_t model, double a, double *error)
 {
-	double                    tmp1;
-	cosmoFunc_dtda_struct_t   param;
-	gsl_integration_workspace *w;
-	gsl_function              F;
+	double y[LOCAL_GROWTH_NUMVALUES];
 
 	assert(model != NULL && isgreater(a, 0.0) && error != NULL);
 
-	param.omegaRad0    = model->omegaRad0;
-	param.omegaMatter0 = model->omegaMatter0;
-	param.omegaLambda0 = model->omegaLambda0;
-	F.function         = &cosmoFunc_dtdaCube;
-	F.params           = &param;
-	w                  = gsl_integration_workspace_alloc(1000);
-	gsl_integration_qags(&F, 0.0, a, 0, 1e-8, 1000, w, &tmp1, error);
-	gsl_integration_workspace_free(w);
+	if (isgreater(a, LOCAL_GROWTH_AMAX))
+		return local_calcGrowthIntegral(model, a, error);
 
-	return 2.5 * (model->omegaMatter0)
-	       * cosmoModel_calcADot(model, a)
-	       * tmp1 / a;
+	local_growthEval(model, a, y);
+	*error = fabs(y[0]) * model->growthError;
+
+	return y[0];
 }
 
 extern double
 cosmoModel_calcDlnGrowthDlna(cosmoModel_t model, double a, double *error)
 {
+	double y[LOCAL_GROWTH_NUMVALUES];
 	double growth;
 	double fupper;
 	double flower;
@@ -424,7 +567,13 @@ cosmoModel_calcDlnGrowthDlna(cosmoModel_t model, double a, double *error)
 	assert(error != NULL);
 	assert(isgreater(a, 0.0));
 
-	growth = cosmoModel_calcGrowth(model, a, error);
+	if (!isgreater(a, LOCAL_GROWTH_AMAX)) {
+		local_growthEval(model, a, y);
+		*error = model->growthError;
+		return y[1] / y[0];
+	}
+
+	growth = local_calcGrowthIntegral(model, a, error);
 	ainv   = 1. / a;
 
 	tmp    = 1. - (model->omegaRad0) - (model->omegaMatter0)
@@ -441,24 +590,225 @@ cosmoModel_calcDlnGrowthDlna(cosmoModel_t model, double a, double *error)
 	return fupper / flower;
 }
 
+extern double
+cosmoModel_calcGrowth2lpt(cosmoModel_t model, double a, double *error)
+{
+	double y[LOCAL_GROWTH_NUMVALUES];
+
+	assert(model != NULL && isgreater(a, 0.0) && error != NULL);
+
+	if (isgreater(a, LOCAL_GROWTH_AMAX)) {
+		// Bouchet et al. 1995, eq. 45.
+		double growth = local_calcGrowthIntegral(model, a, error);
+		double omegaM = cosmoModel_calcOmegaMatter(model, a);
+
+		*error = 2. * fabs(*error / growth);
+		return -3. / 7. * growth * growth * pow(omegaM, -1. / 143.);
+	}
+
+	local_growthEval(model, a, y);
+	*error = fabs(y[2]) * model->growthError;
+
+	return y[2];
+}
+
 extern double
 cosmoModel_calcDlnGrowthDlna2lpt(cosmoModel_t model,
                                  double       a,
                                  double       *error)
 {
-	double omegaM;
+	double y[LOCAL_GROWTH_NUMVALUES];
 
 	assert(model != NULL);
 	assert(error != NULL);
+	assert(isgreater(a, 0.0));
 
-	assert(isgreater(model->omegaLambda0, 0.0));
+	if (isgreater(a, LOCAL_GROWTH_AMAX)) {
+		// Bouchet et al. 1995, eq. 50.
+		*error = 0.0;
+		return 2. * pow(cosmoModel_calcOmegaMatter(model, a), 6. / 11.);
+	}
 
-	omegaM = cosmoModel_calcOmegaMatter(model, a);
-	assert(isgreater(omegaM, 0.1) && isless(omegaM, 1.0));
-	*error = 0.0;
+	local_growthEval(model, a, y);
+	*error = model->growthError;
 
-	return 2. * pow(omegaM, 6. / 11.);
+	return y[3] / y[2];
 }
 
 
 /*--- Implementations of local functions --------------------------------*/
+static double
+local_getAEquality(const cosmoModel_t model)
+{
+	return (model->omegaRad0) / (model->omegaMatter0);
+}
+
+static void
+local_growthDeriv(const cosmoModel_t model,
+                  double             lna,
+                  const double       *y,
+                  double             *dydlna)
+{
+	double aInv   = exp(-lna);
+	double aInv2  = aInv * aInv;
+	double omegaK = 1. - (model->omegaRad0) - (model->omegaMatter0)
+	                - (model->omegaLambda0);
+	double rad    = (model->omegaRad0) * aInv2 * aInv2;
+	double mat    = (model->omegaMatter0) * aInv2 * aInv;
+	double curv   = omegaK * aInv2;
+	double hSqr   = rad + mat + curv + (model->omegaLambda0);
+	double damp   = 2. - (2. * rad + 1.5 * mat + curv) / hSqr;
+	double source = 1.5 * mat / hSqr;
+
+	dydlna[0] = y[1];
+	dydlna[1] = source * y[0] - damp * y[1];
+	dydlna[2] = y[3];
+	dydlna[3] = source * (y[2] - y[0] * y[0]) - damp * y[3];
+}
+
+static void
+local_growthIntegrate(const cosmoModel_t model,
+                      double             lna,
+                      double             dlna,
+                      int                numSteps,
+                      double             *y)
+{
+	const double h = dlna / numSteps;
+	double       k1[LOCAL_GROWTH_NUMVALUES], k2[LOCAL_GROWTH_NUMVALUES];
+	double       k3[LOCAL_GROWTH_NUMVALUES], k4[LOCAL_GROWTH_NUMVALUES];
+	double       tmp[LOCAL_GROWTH_NUMVALUES];
+
+	for (int i = 0; i < numSteps; i++) {
+		double x = lna + i * h;
+
+		local_growthDeriv(model, x, y, k1);
+		for (int j = 0; j < LOCAL_GROWTH_NUMVALUES; j++)
+			tmp[j] = y[j] + 0.5 * h * k1[j];
+		local_growthDeriv(model, x + 0.5 * h, tmp, k2);
+		for (int j = 0; j < LOCAL_GROWTH_NUMVALUES; j++)
+			tmp[j] = y[j] + 0.5 * h * k2[j];
+		local_growthDeriv(model, x + 0.5 * h, tmp, k3);
+		for (int j = 0; j < LOCAL_GROWTH_NUMVALUES; j++)
+			tmp[j] = y[j] + h * k3[j];
+		local_growthDeriv(model, x + h, tmp, k4);
+		for (int j = 0; j < LOCAL_GROWTH_NUMVALUES; j++)
+			y[j] += h / 6. * (k1[j] + 2. * (k2[j] + k3[j]) + k4[j]);
+	}
+}
+
+static void
+local_growthTabulate(cosmoModel_t model)
+{
+	const double lnaMin   = log(LOCAL_GROWTH_AMIN);
+	const double dlna     = (log(LOCAL_GROWTH_AMAX) - lnaMin)
+	                        / (LOCAL_GROWTH_NUM - 1);
+	int          numSteps = 1;
+	double       *table;
+
+	table = xmalloc(sizeof(double) * LOCAL_GROWTH_NUMVALUES
+	                * LOCAL_GROWTH_NUM);
+	local_growthEval(model, LOCAL_GROWTH_AMIN, table);
+	model->growthError = 0.0;
+
+	for (int i = 1; i < LOCAL_GROWTH_NUM; i++) {
+		const double *yOld = table + (i - 1) * LOCAL_GROWTH_NUMVALUES;
+		double       *y    = table + i * LOCAL_GROWTH_NUMVALUES;
+		double       yCoarse[LOCAL_GROWTH_NUMVALUES];
+		double       err;
+
+		while (true) {
+			for (int j = 0; j < LOCAL_GROWTH_NUMVALUES; j++)
+				yCoarse[j] = y[j] = yOld[j];
+			local_growthIntegrate(model, lnaMin + (i - 1) * dlna, dlna,
+			                      numSteps, yCoarse);
+			local_growthIntegrate(model, lnaMin + (i - 1) * dlna, dlna,
+			                      2 * numSteps, y);
+			err = 0.0;
+			for (int j = 0; j < LOCAL_GROWTH_NUMVALUES; j++)
+				err = fmax(err, fabs(y[j] - yCoarse[j]) / fabs(y[j]));
+			if (!isgreater(err, LOCAL_GROWTH_EPSREL)
+			    || (numSteps >= LOCAL_GROWTH_MAXSTEPS))
+				break;
+			numSteps *= 2;
+		}
+		model->growthError = fmax(model->growthError, err);
+		if (isless(err, LOCAL_GROWTH_EPSREL / 64.) && (numSteps > 1))
+			numSteps /= 2;
+	}
+
+	model->growthTable = table;
+}
+
+static void
+local_growthEval(cosmoModel_t model, double a, double *y)
+{
+	const double lnaMin = log(LOCAL_GROWTH_AMIN);
+	const double dlna   = (log(LOCAL_GROWTH_AMAX) - lnaMin)
+	                      / (LOCAL_GROWTH_NUM - 1);
+	const double *y0, *y1;
+	double       d0[LOCAL_GROWTH_NUMVALUES], d1[LOCAL_GROWTH_NUMVALUES];
+	double       x, t, h00, h10, h01, h11;
+	int          i;
+
+	assert(!isgreater(a, LOCAL_GROWTH_AMAX));
+
+	if (!isgreater(a, LOCAL_GROWTH_AMIN)) {
+		// The growing mode of a matter and radiation universe (Meszaros
+		// 1974), normalised to D = a during matter domination.
+		y[0] = a + 2. / 3. * local_getAEquality(model);
+		y[1] = a;
+		y[2] = -3. / 7. * y[0] * y[0];
+		y[3] = -6. / 7. * y[0] * y[1];
+		return;
+	}
+
+	if (model->growthTable == NULL)
+		local_growthTabulate(model);
+
+	x  = (log(a) - lnaMin) / dlna;
+	i  = (int)x;
+	i  = (i > LOCAL_GROWTH_NUM - 2) ? LOCAL_GROWTH_NUM - 2 : i;
+	t  = x - i;
+	y0 = model->growthTable + i * LOCAL_GROWTH_NUMVALUES;
+	y1 = y0 + LOCAL_GROWTH_NUMVALUES;
+	local_growthDeriv(model, lnaMin + i * dlna, y0, d0);
+	local_growthDeriv(model, lnaMin + (i + 1) * dlna, y1, d1);
+
+	h00 = (2. * t - 3.) * t * t + 1.;
+	h10 = ((t - 2.) * t + 1.) * t;
+	h01 = (3. - 2. * t) * t * t;
+	h11 = (t - 1.) * t * t;
+	for (int j = 0; j < LOCAL_GROWTH_NUMVALUES; j++)
+		y[j] = h00 * y0[j] + h10 * dlna * d0[j]
+		       + h01 * y1[j] + h11 * dlna * d1[j];
+}
+
+static void
+local_growthInvalidate(cosmoModel_t model)
+{
+	if (model->growthTable != NULL)
+		xfree(model->growthTable);
+	model->growthTable = NULL;
+}
+
+static double
+local_calcGrowthIntegral(cosmoModel_t model, double a, double *error)
+{
+	double                    tmp1;
+	cosmoFunc_dtda_struct_t   param;
+	gsl_integration_workspace *w;
+	gsl_function              F;
+
+	param.omegaRad0    = model->omegaRad0;
+	param.omegaMatter0 = model->omegaMatter0;
+	param.omegaLambda0 = model->omegaLambda0;
+	F.function         = &cosmoFunc_dtdaCube;
+	F.params           = &param;
+	w                  = gsl_integration_workspace_alloc(1000);
+	gsl_integration_qags(&F, 0.0, a, 0, 1e-8, 1000, w, &tmp1, error);
+	gsl_integration_workspace_free(w);
+
+	return 2.5 * (model->omegaMatter0)
+	       * cosmoModel_calcADot(model, a)
+	       * tmp1 / a;
+}
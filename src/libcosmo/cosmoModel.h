@@ -127,20 +127,82 @@ cosmoModel_calcOmegaBaryon(cosmoModel_t model, double a);
 extern double
 cosmoModel_calcOmegaLambda(cosmoModel_t model, double a);
 
+/**
+ * @brief  Calculates the linear growth factor.
+ *
+ * On the first call the growth equations for the first and second order
+ * growth factors are integrated once over ln(a) and tabulated in the
+ * model; this and the other growth functions then interpolate in the
+ * table.  The table is discarded when a density parameter of the model
+ * is changed.  The growth factor is normalised to D = a during matter
+ * domination.  Beyond a = 2 the growth factor is integrated directly
+ * (Heath 1977), ignoring radiation.
+ *
+ * As the table is filled lazily, the first call for a model must not
+ * happen concurrently with other calls for the same model.
+ *
+ * @param[in,out]  model
+ *                    The model to work with.
+ * @param[in]      a
+ *                    The expansion factor.
+ * @param[out]     *error
+ *                    Receives an estimate of the absolute error.
+ *
+ * @return  Returns the growth factor D(a).
+ */
 extern double
 cosmoModel_calcGrowth(cosmoModel_t model, double a, double *error);
 
+/**
+ * @brief  Calculates the linear growth velocity f = dln(D)/dln(a).
+ *
+ * See cosmoModel_calcGrowth() for how this is evaluated.
+ *
+ * @param[in,out]  model
+ *                    The model to work with.
+ * @param[in]      a
+ *                    The expansion factor.
+ * @param[out]     *error
+ *                    Receives an estimate of the relative error.
+ *
+ * @return  Returns the growth velocity.
+ */
 extern double
 cosmoModel_calcDlnGrowthDlna(cosmoModel_t model, double a, double *error);
 
+/**
+ * @brief  Calculates the second order growth factor.
+ *
+ * The second order growth factor is negative, -3/7 D^2 in an
+ * Einstein-de Sitter universe.  See cosmoModel_calcGrowth() for how this
+ * is evaluated; beyond a = 2 the approximation of Bouchet et al. 1995,
+ * eq. 45, is used.
+ *
+ * @param[in,out]  model
+ *                    The model to work with.
+ * @param[in]      a
+ *                    The expansion factor.
+ * @param[out]     *error
+ *                    Receives an estimate of the absolute error.
+ *
+ * @return  Returns the second order growth factor D2(a).
+ */
+extern double
+cosmoModel_calcGrowth2lpt(cosmoModel_t model, double a, double *error);
+
 /**
  * @brief  Calculates the second order growth velocity from a given model.
  *
- * Actually uses an approximation (see Bouchet et al. 1995, eq. 50).
+ * This is f2 = dln(D2)/dln(a), see cosmoModel_calcGrowth() for how this
+ * is evaluated; beyond a = 2 the approximation of Bouchet et al. 1995,
+ * eq. 50, is used.
  *
- * @param[in]   model
- * @param[in]   a
- * @param[out]  *error
+ * @param[in,out]  model
+ *                    The model to work with.
+ * @param[in]      a
+ *                    The expansion factor.
+ * @param[out]     *error
+ *                    Receives an estimate of the relative error.
  *
  * @return  Returns the growth velocity.
  */
@@ -21,6 +21,15 @@ struct cosmoModel_struct {
 	double sigma8;
 	double ns;
 	double tempCMB;
+	/**
+	 * @brief  The tabulated growth factors, NULL until first needed.
+	 *
+	 * Holds D, dD/dln(a), D2 and dD2/dln(a) for each of the
+	 * #LOCAL_GROWTH_NUM nodes, see cosmoModel_calcGrowth().
+	 */
+	double *growthTable;
+	/** @brief  The largest relative integration error in the table. */
+	double growthError;
 };
 
 
@@ -350,4 +350,59 @@ cosmoModel_calcDlnGrowthDlna_test(void)
 	return hasSucceeded;
 }
 
+extern bool
+cosmoModel_calcGrowth2lpt_test(void)
+{
+	cosmoModel_t model;
+	bool         hasSucceeded = true;
+	double       a, error;
+	double       D2, D2EdS;
+
+	printf("Testing %s... ", __func__);
+	model = cosmoModel_newFromFile("tests/model_EdS.dat");
+	for (int i = 0; i < 10; i++) {
+		a     = 1.0 - i * 0.1;
+		D2    = cosmoModel_calcGrowth2lpt(model, a, &error);
+		D2EdS = -3. / 7. * a * a;
+		if (isgreater(fabs(D2 - D2EdS), 1e-10))
+			hasSucceeded = false;
+	}
+	cosmoModel_del(&model);
+
+	return hasSucceeded;
+}
+
+extern bool
+cosmoModel_calcDlnGrowthDlna2lpt_test(void)
+{
+	cosmoModel_t model;
+	bool         hasSucceeded = true;
+	double       a, error;
+	double       f2, f2Approx, omegaM;
+
+	printf("Testing %s... ", __func__);
+	model = cosmoModel_newFromFile("tests/model_EdS.dat");
+	for (int i = 0; i < 20; i++) {
+		a  = 1.0 - i * 0.05;
+		f2 = cosmoModel_calcDlnGrowthDlna2lpt(model, a, &error);
+		if (isgreater(fabs(f2 - 2.0), 1e-10))
+			hasSucceeded = false;
+	}
+	cosmoModel_del(&model);
+
+	// The approximation of Bouchet et al. 1995 is good to a percent.
+	model = cosmoModel_newFromFile("tests/model_wmap7.dat");
+	for (int i = 0; i < 20; i++) {
+		a        = 1.0 - i * 0.05;
+		f2       = cosmoModel_calcDlnGrowthDlna2lpt(model, a, &error);
+		omegaM   = cosmoModel_calcOmegaMatter(model, a);
+		f2Approx = 2. * pow(omegaM, 6. / 11.);
+		if (isgreater(fabs(f2 / f2Approx - 1.), 1e-2))
+			hasSucceeded = false;
+	}
+	cosmoModel_del(&model);
+
+	return hasSucceeded;
+}
+
 /*--- Implementations of local functions --------------------------------*/
@@ -57,4 +57,10 @@ cosmoModel_calcGrowth_test(void);
 extern bool
 cosmoModel_calcDlnGrowthDlna_test(void);
 
+extern bool
+cosmoModel_calcGrowth2lpt_test(void);
+
+extern bool
+cosmoModel_calcDlnGrowthDlna2lpt_test(void);
+
 #endif
@@ -68,6 +68,8 @@ main(void)
 	RUNTEST(cosmoModel_calcOmegas_test, hasFailed);
 	RUNTEST(cosmoModel_calcGrowth_test, hasFailed);
 	RUNTEST(cosmoModel_calcDlnGrowthDlna_test, hasFailed);
+	RUNTEST(cosmoModel_calcGrowth2lpt_test, hasFailed);
+	RUNTEST(cosmoModel_calcDlnGrowthDlna2lpt_test, hasFailed);
 
 	if (hasFailed) {
 		fprintf(stderr, "\nSome tests failed!\n\n");
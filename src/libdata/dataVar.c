@@ -18,6 +18,9 @@
 #include "../libutil/refCounter.h"
 #include "../libutil/xmem.h"
 #include "../libutil/xstring.h"
+#ifdef XMEM_TRACK_MEM
+#  include "../libutil/memPool.h"
+#endif
 
 
 /*--- Implemention of main structure ------------------------------------*/
@@ -145,8 +148,14 @@ dataVar_getMemory(dataVar_t var, uint64_t numElements)
 
 	sizeToAlloc = dataVar_getSizePerElement(var) * numElements;
 
-	if (var->mallocFunc != NULL)
+	if (var->mallocFunc != NULL) {
+#ifdef XMEM_TRACK_MEM
+		// The pool gets its buffers from xmalloc(), they are accounted.
+		if (var->mallocFunc != &memPool_malloc)
+			return xmem_mallocExternal(var->mallocFunc, sizeToAlloc);
+#endif
 		return var->mallocFunc(sizeToAlloc);
+	}
 
 	return xmalloc(sizeToAlloc);
 }
@@ -174,10 +183,17 @@ dataVar_freeMemory(dataVar_t var, void *data)
 	assert(var != NULL);
 	assert(data != NULL);
 
-	if (var->freeFunc != NULL)
+	if (var->freeFunc != NULL) {
+#ifdef XMEM_TRACK_MEM
+		if (var->freeFunc != &memPool_free) {
+			xmem_freeExternal(var->freeFunc, data);
+			return;
+		}
+#endif
 		var->freeFunc(data);
-	else
+	} else {
 		xfree(data);
+	}
 }
 
 extern void *
@@ -6,9 +6,9 @@
 /*--- Doxygen file description ------------------------------------------*/
 
 /**
- * @file g9pICMap.c
- * @ingroup  GROUP
- * @brief  SHORT DESC
+ * @file libg9p/g9pICMap.c
+ * @ingroup  libg9pICMap
+ * @brief  Implements the IC map.
  */
 
 
@@ -17,6 +17,7 @@
 #include "g9pICMap.h"
 #include <assert.h>
 #include <string.h>
+#include <math.h>
 #include "../libutil/xmem.h"
 
 
@@ -28,12 +29,64 @@
 
 
 /*--- Prototypes of local functions -------------------------------------*/
+
+/**
+ * @brief  Computes the cost of every tile.
+ *
+ * @param[in]  map
+ *                The map to work with, the cost model and the zoom level
+ *                must be set.
+ *
+ * @return  Returns a new array holding the cost of the tiles preceded by
+ *          all tiles, i.e. its length is the number of tiles plus one and
+ *          the first element is @c 0.  The caller must free it.
+ */
+static double *
+local_calcCumulativeCost(const g9pICMap_t map);
+
+/**
+ * @brief  Cuts the tiles into contiguous ranges of similar cost.
+ *
+ * @param[in,out]  map
+ *                    The map to work with.
+ * @param[in]      *cumCost
+ *                    The cumulative cost as computed by
+ *                    local_calcCumulativeCost().
+ *
+ * @return  Returns nothing.
+ */
 static void
-local_calcIdx(g9pICMap_t map, uint32_t zoomlevel);
+local_calcIdx(g9pICMap_t map, const double *cumCost);
 
 static void
 local_calcNumCellsPerFile(g9pICMap_t map);
 
+/**
+ * @brief  Checks whether particles on the zoom level are gas particles.
+ *
+ * @param[in]  map
+ *                The map to query.
+ *
+ * @return  Returns @c true if the zoom level is one of the gas levels.
+ */
+static bool
+local_isGasLevel(const g9pICMap_t map);
+
+/**
+ * @brief  Fits a single coefficient in a least squares sense.
+ *
+ * @param[in]  numSamples
+ *                The number of samples.
+ * @param[in]  *x
+ *                The independent variable.
+ * @param[in]  *seconds
+ *                The timings.
+ *
+ * @return  Returns the coefficient, this is @c 0 if all @c x are zero.
+ */
+static double
+local_fitOne(uint32_t numSamples, const uint64_t *x, const double *seconds);
+
 
 /*--- Implementations of exported functions -----------------------------*/
 extern g9pICMap_t
@@ -43,11 +96,27 @@ g9pICMap_new(uint32_t     numFiles,
              g9pMask_t    mask,
              uint32_t zoomlevel)
 {
-	g9pICMap_t map;
+	return g9pICMap_newWithCost(numFiles, numGasLevel, gasLevel, mask,
+	                            zoomlevel, NULL);
+}
+
+extern g9pICMap_t
+g9pICMap_newWithCost(uint32_t             numFiles,
+                     uint32_t             numGasLevel,
+                     const int8_t         *gasLevel,
+                     g9pMask_t            mask,
+                     uint32_t             zoomlevel,
+                     const g9pICMapCost_t cost)
+{
+	g9pICMap_t     map;
+	g9pICMapCost_s defaultCost = G9PICMAPCOST_DEFAULT;
+	double         *cumCost;
 
 	assert(mask != NULL);
 	assert(numFiles > 0);
 	assert(numFiles <= g9pMask_getTotalNumTiles(mask));
+	assert(zoomlevel >= g9pMask_getMinLevel(mask)
+	       && zoomlevel <= g9pMask_getMaxLevel(mask));
 
 	map              = xmalloc(sizeof(struct g9pICMap_struct));
 	map->numFiles    = numFiles;
@@ -61,14 +130,24 @@ g9pICMap_new(uint32_t     numFiles,
 	} else {
 		map->gasLevel = NULL;
 	}
+	map->zoomlevel = zoomlevel;
+	map->cost      = (cost != NULL) ? *cost : defaultCost;
 
 	const int8_t numLevel = g9pMask_getNumLevel(map->mask);
 	map->firstTileIdx = xmalloc(sizeof(uint32_t) * map->numFiles * 2);
 	map->lastTileIdx  = map->firstTileIdx + map->numFiles;
 	map->numCells     = xmalloc(sizeof(uint64_t)
 	                            * (map->numFiles * numLevel));
-
-	local_calcIdx(map,zoomlevel);
+	map->numCellsRead = xmalloc(sizeof(uint64_t) * map->numFiles * 2);
+	map->numParticles = map->numCellsRead + map->numFiles;
+	map->costOfFile   = xmalloc(sizeof(double) * map->numFiles);
+
+	cumCost = local_calcCumulativeCost(map);
+	local_calcIdx(map, cumCost);
+	for (uint32_t i = 0; i < map->numFiles; i++)
+		map->costOfFile[i] = cumCost[map->lastTileIdx[i] + 1]
+		                     - cumCost[map->firstTileIdx[i]];
+	xfree(cumCost);
 	local_calcNumCellsPerFile(map);
 
 	return map;
@@ -81,6 +160,8 @@ g9pICMap_del(g9pICMap_t *g9pICMap)
 
 	xfree((*g9pICMap)->firstTileIdx);
 	xfree((*g9pICMap)->numCells);
+	xfree((*g9pICMap)->numCellsRead);
+	xfree((*g9pICMap)->costOfFile);
 	if ((*g9pICMap)->gasLevel != NULL)
 		xfree((*g9pICMap)->gasLevel);
 	g9pMask_del(&((*g9pICMap)->mask));
@@ -97,10 +178,14 @@ g9pICMap_getFileForTile(const g9pICMap_t map, const uint32_t tile)
 	assert(tile < g9pMask_getTotalNumTiles(map->mask));
 
 	uint32_t file = 0;
-	while ((file < map->numFiles) && (map->lastTileIdx[file] < tile)) {
-		file++;
+	uint32_t hi   = map->numFiles - 1;
+	while (file < hi) {
+		uint32_t mid = file + (hi - file) / 2;
+		if (map->lastTileIdx[mid] < tile)
+			file = mid + 1;
+		else
+			hi = mid;
 	}
-	assert(file < map->numFiles);
 	assert(map->lastTileIdx[file] >= tile);
 	assert(map->firstTileIdx[file] <= tile);
 
@@ -135,61 +220,212 @@ g9pICMap_getNumCellsPerLevelInFile(const g9pICMap_t map,
 	return map->numCells + (file * g9pMask_getNumLevel(map->mask));
 }
 
-/*--- Implementations of local functions --------------------------------*/
-static void
-local_calcIdx(g9pICMap_t map, uint32_t zoomlevel)
+extern void
+g9pICMap_getWorkInFile(const g9pICMap_t map,
+                       const uint32_t   file,
+                       uint64_t         *numCellsRead,
+                       uint64_t         *numParticles)
 {
-	uint32_t numTiles     = g9pMask_getTotalNumTiles(map->mask);
-	//uint32_t numTilesLeft = numTiles;
-	//uint32_t tilePerFile  = numTilesLeft / map->numFiles;
-	uint64_t numCellsTot = 0;
-	for (uint32_t i=0; i<numTiles; i++) {
-		numCellsTot+=g9pMask_getNumCellsInTileForLevel(map->mask, i, zoomlevel);
+	assert(map != NULL);
+	assert(file < map->numFiles);
+	assert(numCellsRead != NULL && numParticles != NULL);
+
+	*numCellsRead = map->numCellsRead[file];
+	*numParticles = map->numParticles[file];
+}
+
+extern double
+g9pICMap_getCostOfFile(const g9pICMap_t map, const uint32_t file)
+{
+	assert(map != NULL);
+	assert(file < map->numFiles);
+
+	return map->costOfFile[file];
+}
+
+extern bool
+g9pICMap_calibrateCost(g9pICMapCost_t cost,
+                       uint32_t       numSamples,
+                       const uint64_t *numCellsRead,
+                       const uint64_t *numParticles,
+                       const double   *seconds)
+{
+	double sRR = 0., sRP = 0., sPP = 0., sRT = 0., sPT = 0., sTT = 0.;
+	double perCellRead, perParticle, det;
+
+	assert(cost != NULL);
+	assert(numSamples == 0 || (numCellsRead != NULL && numParticles != NULL
+	                           && seconds != NULL));
+
+	for (uint32_t i = 0; i < numSamples; i++) {
+		double r = (double)(numCellsRead[i]);
+		double p = (double)(numParticles[i]);
+		sRR += r * r;
+		sRP += r * p;
+		sPP += p * p;
+		sRT += r * seconds[i];
+		sPT += p * seconds[i];
+		sTT += seconds[i] * seconds[i];
 	}
-	uint64_t numCellsLeft = numCellsTot;
-	uint32_t cellsPerFile = numCellsLeft / map->numFiles;
+	if (sTT <= 0.)
+		return false;
 
-	map->firstTileIdx[0] = 0;
-	//map->lastTileIdx[0]  = 0;
-	//numTilesLeft        -= tilePerFile;
-	uint32_t numCells = 0;
-	uint32_t file = 0;
+	det = sRR * sPP - sRP * sRP;
+	if (det > 1e-12 * sRR * sPP) {
+		perCellRead = (sRT * sPP - sPT * sRP) / det;
+		perParticle = (sPT * sRR - sRT * sRP) / det;
+	} else {
+		// The two kinds of work are proportional, the split between them
+		// cannot be determined, hence keep the ratio of the old model.
+		perCellRead = perParticle = -1.;
+	}
+
+	if (perCellRead < 0. || perParticle < 0.) {
+		if (perCellRead >= 0.) {
+			perCellRead = local_fitOne(numSamples, numCellsRead, seconds);
+			perParticle = 0.;
+		} else if (perParticle >= 0.) {
+			perCellRead = 0.;
+			perParticle = local_fitOne(numSamples, numParticles, seconds);
+		} else {
+			double oldCost = 0., scale;
+			for (uint32_t i = 0; i < numSamples; i++)
+				oldCost += cost->perCellRead * (double)(numCellsRead[i])
+				           + cost->perParticle * (double)(numParticles[i]);
+			if (oldCost <= 0.)
+				return false;
+			scale       = 0.;
+			for (uint32_t i = 0; i < numSamples; i++)
+				scale += seconds[i];
+			scale      /= oldCost;
+			perCellRead = cost->perCellRead * scale;
+			perParticle = cost->perParticle * scale;
+		}
+	}
+	if (!(perCellRead > 0. || perParticle > 0.) || !isfinite(perCellRead)
+	    || !isfinite(perParticle))
+		return false;
+
+	cost->perCellRead = perCellRead;
+	cost->perParticle = perParticle;
+
+	return true;
+} /* g9pICMap_calibrateCost */
+
+/*--- Implementations of local functions --------------------------------*/
+static double *
+local_calcCumulativeCost(const g9pICMap_t map)
+{
+	const uint32_t numTiles = g9pMask_getTotalNumTiles(map->mask);
+	const uint64_t readPerTile
+	    = g9pMask_getMaxNumCellsInTileForLevel(map->mask,
+	                                           (uint8_t)(map->zoomlevel));
+	const double   partFac  = local_isGasLevel(map) ? 2. : 1.;
+	double         *cumCost;
+
+	cumCost    = xmalloc(sizeof(double) * (numTiles + 1));
+	cumCost[0] = 0.;
 	for (uint32_t i = 0; i < numTiles; i++) {
-		numCells += g9pMask_getNumCellsInTileForLevel(map->mask, i, zoomlevel);
-		if (numCells >= cellsPerFile) {
-			map->lastTileIdx[file] = i;
-			numCellsLeft -= numCells;
-			numCells = 0;
-			file++;
-			if(file < map->numFiles) 
-				cellsPerFile = numCellsLeft / (map->numFiles - file);
-			if(file < map->numFiles)
-				map->firstTileIdx[file] = i+1;
+		uint64_t np = g9pMask_getNumCellsInTileForLevel(map->mask, i,
+		                                                (uint8_t)(map->zoomlevel));
+		double   c  = 0.;
+		if (np > 0)
+			c = map->cost.perCellRead * (double)readPerTile
+			    + map->cost.perParticle * partFac * (double)np;
+		cumCost[i + 1] = cumCost[i] + c;
+	}
+
+	return cumCost;
+}
+
+static void
+local_calcIdx(g9pICMap_t map, const double *cumCost)
+{
+	const uint32_t numTiles = g9pMask_getTotalNumTiles(map->mask);
+	uint32_t       first    = 0;
+
+	for (uint32_t file = 0; file < map->numFiles; file++) {
+		const uint32_t filesLeft = map->numFiles - file;
+		uint32_t       end;
+
+		if (filesLeft == 1) {
+			end = numTiles;
+		} else {
+			// The file ends before tile end, with first < end <= maxEnd
+			// leaving a tile for every remaining file.
+			const uint32_t maxEnd = numTiles - filesLeft + 1;
+			const double   target = cumCost[first]
+			                        + (cumCost[numTiles] - cumCost[first])
+			                        / filesLeft;
+			uint32_t       lo     = first + 1;
+			uint32_t       hi     = maxEnd;
+			while (lo < hi) {
+				uint32_t mid = lo + (hi - lo) / 2;
+				if (cumCost[mid] < target)
+					lo = mid + 1;
+				else
+					hi = mid;
+			}
+			end = lo;
+			if ((end > first + 1)
+			    && (target - cumCost[end - 1] < cumCost[end] - target))
+				end--;
 		}
-		
-		//tilePerFile          = numTilesLeft / (map->numFiles - i);
-		//map->firstTileIdx[i] = map->lastTileIdx[i - 1] + 1;
-		//map->lastTileIdx[i]  = map->firstTileIdx[i] + tilePerFile - 1;
-		//numTilesLeft        -= tilePerFile;
+		map->firstTileIdx[file] = first;
+		map->lastTileIdx[file]  = end - 1;
+		first                   = end;
 	}
-	map->lastTileIdx[map->numFiles - 1] = numTiles - 1;
+	assert(first == numTiles);
 }
 
 static void
 local_calcNumCellsPerFile(g9pICMap_t map)
 {
-	const int8_t numLevel = g9pMask_getNumLevel(map->mask);
-	uint64_t     *tmp     = NULL;
+	const int8_t   numLevel    = g9pMask_getNumLevel(map->mask);
+	const int8_t   zoomIdx     = (int8_t)(map->zoomlevel
+	                                      - g9pMask_getMinLevel(map->mask));
+	const uint64_t readPerTile
+	    = g9pMask_getMaxNumCellsInTileForLevel(map->mask,
+	                                           (uint8_t)(map->zoomlevel));
+	const uint64_t partFac     = local_isGasLevel(map) ? 2 : 1;
+	uint64_t       *tmp        = NULL;
 
 	for (uint32_t i = 0; i < map->numFiles; i++) {
 		uint32_t j = map->firstTileIdx[i];
 		for (int8_t k = 0; k < numLevel; k++)
 			map->numCells[i * numLevel + k] = UINT64_C(0);
+		map->numCellsRead[i] = UINT64_C(0);
 		do {
 			tmp = g9pMask_getNumCellsInTile(map->mask, j, tmp);
 			for (int8_t k = 0; k < numLevel; k++)
 				map->numCells[i * numLevel + k] += tmp[k];
+			if (tmp[zoomIdx] > 0)
+				map->numCellsRead[i] += readPerTile;
 		} while (++j <= map->lastTileIdx[i]);
+		map->numParticles[i] = map->numCells[i * numLevel + zoomIdx] * partFac;
 	}
 	xfree(tmp);
 }
+
+static bool
+local_isGasLevel(const g9pICMap_t map)
+{
+	for (uint32_t i = 0; i < map->numGasLevel; i++)
+		if ((uint32_t)(map->gasLevel[i]) == map->zoomlevel)
+			return true;
+
+	return false;
+}
+
+static double
+local_fitOne(uint32_t numSamples, const uint64_t *x, const double *seconds)
+{
+	double sXX = 0., sXT = 0.;
+
+	for (uint32_t i = 0; i < numSamples; i++) {
+		sXX += (double)(x[i]) * (double)(x[i]);
+		sXT += (double)(x[i]) * seconds[i];
+	}
+
+	return (sXX > 0.) ? sXT / sXX : 0.;
+}
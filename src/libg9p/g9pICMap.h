@@ -18,15 +18,58 @@
 /*--- Includes ----------------------------------------------------------*/
 #include "g9pConfig.h"
 #include "g9pMask.h"
+#include <stdint.h>
+#include <stdbool.h>
 
 
 /*--- ADT handle --------------------------------------------------------*/
 typedef struct g9pICMap_struct *g9pICMap_t;
 
 
+/*--- Exported types ----------------------------------------------------*/
+
+/**
+ * @brief  The cost model used to balance the work between the files.
+ *
+ * The cost of a tile is the number of cells read from the velocity grids
+ * (the full patch of the tile on the zoom level, if the tile contains any
+ * particles) times @c perCellRead plus the number of particles written
+ * times @c perParticle.  Particles on gas levels count twice.  Only the
+ * ratio of the two coefficients matters for the partitioning.
+ */
+typedef struct g9pICMapCost_struct {
+	/** @brief  The cost per cell read from the input grids. */
+	double perCellRead;
+	/** @brief  The cost per particle written. */
+	double perParticle;
+} g9pICMapCost_s;
+
+/** @brief  Convenience type for a cost model. */
+typedef g9pICMapCost_s *g9pICMapCost_t;
+
+
+/*--- Exported defines --------------------------------------------------*/
+
+/**
+ * @brief  The default cost model.
+ *
+ * Reading a cell moves three velocities, writing a particle moves the
+ * position, the velocity and the ID and requires the displacement.
+ */
+#define G9PICMAPCOST_DEFAULT \
+	{                        \
+		.perCellRead = 1.0,  \
+		.perParticle = 3.0,  \
+	}
+
+
 /*--- Prototypes of exported functions ----------------------------------*/
 
 /**
+ * @brief  Creates a new map using the default cost model.
+ *
+ * This is g9pICMap_newWithCost() with @c NULL as the cost model.
+ *
  * @param[in]  numFiles
  *                The number of files for which to create the mapping. Must
  *                be at least @c 1 and at most equal to the number of tiles
@@ -44,6 +87,10 @@ typedef struct g9pICMap_struct *g9pICMap_t;
  *                The mask to use (giving the realisation of the levels).
  *                Must be a valid mask. The map object takes control of the
  *                mask and will free it when it is destroyed itself.
+ * @param[in]  zoomlevel
+ *                The level for which the particles are generated.
+ *
+ * @return  Returns a new map.
  */
 extern g9pICMap_t
 g9pICMap_new(uint32_t     numFiles,
@@ -52,9 +99,51 @@ g9pICMap_new(uint32_t     numFiles,
              g9pMask_t    mask,
              uint32_t zoomlevel);
 
+/**
+ * @brief  Creates a new map that balances the modelled cost of the files.
+ *
+ * The tiles are cut into @c numFiles contiguous ranges such that the
+ * cost of every range comes as close as possible to the average cost
+ * that is left for the remaining files.  Every file receives at least one
+ * tile.
+ *
+ * @param[in]  numFiles
+ *                See g9pICMap_new().
+ * @param[in]  numGasLevel
+ *                See g9pICMap_new().
+ * @param[in]  *gasLevel
+ *                See g9pICMap_new().
+ * @param[in]  mask
+ *                See g9pICMap_new().
+ * @param[in]  zoomlevel
+ *                See g9pICMap_new().
+ * @param[in]  cost
+ *                The cost model to use, this may be @c NULL to use
+ *                #G9PICMAPCOST_DEFAULT.  The map keeps a copy.
+ *
+ * @return  Returns a new map.
+ */
+extern g9pICMap_t
+g9pICMap_newWithCost(uint32_t             numFiles,
+                     uint32_t             numGasLevel,
+                     const int8_t         *gasLevel,
+                     g9pMask_t            mask,
+                     uint32_t             zoomlevel,
+                     const g9pICMapCost_t cost);
+
 extern void
 g9pICMap_del(g9pICMap_t *g9pICMap);
 
+/**
+ * @brief  Locates the file holding a tile by a binary search.
+ *
+ * @param[in]  map
+ *                The map to query.
+ * @param[in]  tile
+ *                The tile to look for.
+ *
+ * @return  Returns the number of the file holding the tile.
+ */
 extern uint32_t
 g9pICMap_getFileForTile(const g9pICMap_t map, const uint32_t tile);
 
@@ -68,6 +157,73 @@ extern const uint64_t *
 g9pICMap_getNumCellsPerLevelInFile(const g9pICMap_t map,
                                    const uint32_t   file);
 
+/**
+ * @brief  Retrieves the work the cost model sees in a file.
+ *
+ * @param[in]   map
+ *                 The map to query.
+ * @param[in]   file
+ *                 The file to query.
+ * @param[out]  *numCellsRead
+ *                 Receives the number of cells read from the input grids.
+ *                 Passing @c NULL is undefined.
+ * @param[out]  *numParticles
+ *                 Receives the number of particles written (gas and dark
+ *                 matter).  Passing @c NULL is undefined.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+g9pICMap_getWorkInFile(const g9pICMap_t map,
+                       const uint32_t   file,
+                       uint64_t         *numCellsRead,
+                       uint64_t         *numParticles);
+
+/**
+ * @brief  Retrieves the modelled cost of a file.
+ *
+ * @param[in]  map
+ *                The map to query.
+ * @param[in]  file
+ *                The file to query.
+ *
+ * @return  Returns the cost of the file in the units of the cost model.
+ */
+extern double
+g9pICMap_getCostOfFile(const g9pICMap_t map, const uint32_t file);
+
+/**
+ * @brief  Fits a cost model to the timings of an earlier run.
+ *
+ * The coefficients are the least squares solution of
+ * <tt>seconds = perCellRead * numCellsRead + perParticle *
+ * numParticles</tt> over all samples.  If a coefficient would become
+ * negative, it is set to zero and the other one is refitted alone.
+ *
+ * @param[in,out]  cost
+ *                    The cost model to calibrate.  It is left untouched
+ *                    if the samples do not determine a model, e.g. if
+ *                    there are none or all timings are zero.
+ * @param[in]      numSamples
+ *                    The number of samples, typically one per file.
+ * @param[in]      *numCellsRead
+ *                    The cells read per sample, see
+ *                    g9pICMap_getWorkInFile().
+ * @param[in]      *numParticles
+ *                    The particles written per sample.
+ * @param[in]      *seconds
+ *                    The time taken per sample.
+ *
+ * @return  Returns @c true if the model was calibrated and @c false if
+ *          it was left untouched.
+ */
+extern bool
+g9pICMap_calibrateCost(g9pICMapCost_t cost,
+                       uint32_t       numSamples,
+                       const uint64_t *numCellsRead,
+                       const uint64_t *numParticles,
+                       const double   *seconds);
+
 
 /*--- Doxygen group definitions -----------------------------------------*/
 
@@ -80,6 +236,10 @@ g9pICMap_getNumCellsPerLevelInFile(const g9pICMap_t map,
  * tiles in file.  IOW, the aim is to be able to ask two questions, firstly,
  * in which file is a given tile, and secondly, which tiles are in a given
  * file.
+ *
+ * The tiles are distributed such that the files carry roughly the same
+ * cost as given by a #g9pICMapCost_s model.  The model can be calibrated
+ * with the timings of an earlier run using g9pICMap_calibrateCost().
  */
 
 #endif
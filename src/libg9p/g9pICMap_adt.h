@@ -18,6 +18,7 @@
 /*--- Includes ----------------------------------------------------------*/
 #include "g9pConfig.h"
 #include "g9pHierarchy.h"
+#include "g9pICMap.h"
 
 
 /*--- ADT implementation ------------------------------------------------*/
@@ -28,10 +29,15 @@ struct g9pICMap_struct {
 	int8_t         *gasLevel;
 	g9pMask_t      mask;
 	g9pHierarchy_t hierarchy;
+	uint32_t       zoomlevel;
+	g9pICMapCost_s cost;
 	// Computed information
 	uint32_t       *firstTileIdx; // Stores for each file the first tile idx
 	uint32_t       *lastTileIdx;  // Stores for each file the last tile idx
 	uint64_t 		*numCells; // Stores for each file cell counts
+	uint64_t       *numCellsRead; // Stores for each file the cells read
+	uint64_t       *numParticles; // Stores for each file the particles
+	double         *costOfFile;   // Stores for each file the model cost
 };
 
 
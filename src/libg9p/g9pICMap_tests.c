@@ -18,12 +18,11 @@
 #include "g9pICMap.h"
 #include <stdio.h>
 #include <string.h>
+#include <math.h>
 #ifdef WITH_MPI
 #  include <mpi.h>
 #endif
-#ifdef XMEM_TRACK_MEM
-#  include "../libutil/xmem.h"
-#endif
+#include "../libutil/xmem.h"
 
 
 /*--- Implementation of main structure ----------------------------------*/
@@ -61,7 +60,7 @@ g9pICMap_verifySimpleMapCreation(void)
 	// Mask at 32^3, minLevel at 16^3, maxLevel at 128^3, tiling at 2^3
 	g9pMask_t      m = g9pMask_newMinMaxTiledMask(h, 4, 3, 6, 0);
 
-	map = g9pICMap_new(3, 0, NULL, m);
+	map = g9pICMap_new(3, 0, NULL, m, 3);
 
 	const uint64_t *numCells;
 	uint32_t       firstTile, lastTile;
@@ -94,4 +93,113 @@ g9pICMap_verifySimpleMapCreation(void)
 	return hasPassed ? true : false;
 } /* g9pICMap_verifySimpleMapCreation */
 
+extern bool
+g9pICMap_verifyCostBalancedMap(void)
+{
+	bool       hasPassed = true;
+	int        rank      = 0;
+	g9pICMap_t map;
+	const int8_t gasLevel = 4;
+#ifdef XMEM_TRACK_MEM
+	size_t     allocatedBytes = global_allocated_bytes;
+#endif
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	g9pHierarchy_t h = g9pHierarchy_newWithSimpleFactor(7, 2, 2);
+	g9pMask_t      m = g9pMask_newMinMaxTiledMask(h, 4, 3, 6, 0);
+	uint64_t       numCellsInTile = g9pMask_getNumCellsInMaskTile(m);
+
+	// Only the tiles 0, 1, 2 and 7 hold cells on the zoom level 4.
+	for (uint32_t i = 0; i < 8; i++) {
+		int8_t *data = xmalloc(sizeof(int8_t) * numCellsInTile);
+		memset(data, (i < 3 || i == 7) ? 4 : 3, numCellsInTile);
+		g9pMask_setTileData(m, i, data);
+		xfree(data);
+	}
+
+	map = g9pICMap_new(2, 1, &gasLevel, m, 4);
+
+	if (g9pICMap_getFirstTileInFile(map, 0) != 0)
+		hasPassed = false;
+	if (g9pICMap_getLastTileInFile(map, 0) != 1)
+		hasPassed = false;
+	if (g9pICMap_getFirstTileInFile(map, 1) != 2)
+		hasPassed = false;
+	if (g9pICMap_getLastTileInFile(map, 1) != 7)
+		hasPassed = false;
+	if (g9pICMap_getCostOfFile(map, 0) != g9pICMap_getCostOfFile(map, 1))
+		hasPassed = false;
+	for (uint32_t i = 0; i < 8; i++) {
+		if (g9pICMap_getFileForTile(map, i) != (i < 2 ? 0 : 1))
+			hasPassed = false;
+	}
+	for (uint32_t i = 0; i < 2; i++) {
+		uint64_t numCellsRead, numParticles;
+		g9pICMap_getWorkInFile(map, i, &numCellsRead, &numParticles);
+		if (numCellsRead != 2 * 4096 || numParticles != 2 * 2 * 4096)
+			hasPassed = false;
+	}
+
+	g9pICMap_del(&map);
+
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+} /* g9pICMap_verifyCostBalancedMap */
+
+extern bool
+g9pICMap_verifyCalibrateCost(void)
+{
+	bool           hasPassed = true;
+	int            rank      = 0;
+	g9pICMapCost_s cost      = G9PICMAPCOST_DEFAULT;
+	uint64_t       numCellsRead[4] = {4096, 8192, 4096, 0};
+	uint64_t       numParticles[4] = {4096, 1024, 512, 0};
+	double         seconds[4];
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	for (int i = 0; i < 4; i++)
+		seconds[i] = 2e-3 * numCellsRead[i] + 5e-2 * numParticles[i];
+	if (!g9pICMap_calibrateCost(&cost, 4, numCellsRead, numParticles,
+	                            seconds))
+		hasPassed = false;
+	if (fabs(cost.perCellRead - 2e-3) > 1e-9)
+		hasPassed = false;
+	if (fabs(cost.perParticle - 5e-2) > 1e-9)
+		hasPassed = false;
+
+	// Timings that do not depend on the particles at all.
+	for (int i = 0; i < 4; i++)
+		seconds[i] = 1e-3 * numCellsRead[i] - 1e-5 * numParticles[i];
+	if (!g9pICMap_calibrateCost(&cost, 4, numCellsRead, numParticles,
+	                            seconds))
+		hasPassed = false;
+	if (cost.perParticle != 0. || cost.perCellRead <= 0.)
+		hasPassed = false;
+
+	// Without timings the model must not change.
+	for (int i = 0; i < 4; i++)
+		seconds[i] = 0.;
+	if (g9pICMap_calibrateCost(&cost, 4, numCellsRead, numParticles,
+	                           seconds))
+		hasPassed = false;
+	if (cost.perParticle != 0.)
+		hasPassed = false;
+
+	return hasPassed ? true : false;
+} /* g9pICMap_verifyCalibrateCost */
+
 /*--- Implementations of local functions --------------------------------*/
@@ -24,5 +24,11 @@
 extern bool
 g9pICMap_verifySimpleMapCreation(void);
 
+extern bool
+g9pICMap_verifyCostBalancedMap(void);
+
+extern bool
+g9pICMap_verifyCalibrateCost(void);
+
 
 #endif
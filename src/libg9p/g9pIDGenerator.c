@@ -16,7 +16,11 @@
 #include "g9pConfig.h"
 #include "g9pIDGenerator.h"
 #include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include "../libutil/xmem.h"
+#include "../libutil/diediedie.h"
 #include "../libutil/lIdx.h"
 
 
@@ -26,27 +30,92 @@
 
 /*--- Local defines -----------------------------------------------------*/
 
+/** @brief  Defines how many schemes are available. */
+#define LOCAL_NUM_SCHEMES 4
+
+
+/*--- Local variables ---------------------------------------------------*/
+
+/** @brief  Provides the names of the schemes. */
+static const char *const local_schemeStr[LOCAL_NUM_SCHEMES]
+    = { "rowMajor", "morton", "hilbert", "unknown" };
+
 
 /*--- Prototypes of local functions -------------------------------------*/
 static g9pIDGenerator_t
 local_allocate(void);
 
+static void
+local_initCurve(g9pIDGenerator_t idGen);
+
+static g9pID_t
+local_calcKey(const g9pIDGenerator_t idGen, const gridPointUint32_t coord);
+
+static void
+local_calcCoordFromKey(const g9pIDGenerator_t idGen,
+                       g9pID_t                key,
+                       gridPointUint32_t      coord);
+
+static g9pID_t
+local_interleave(const g9pIDGenerator_t idGen, const gridPointUint32_t coord);
+
+static void
+local_deinterleave(const g9pIDGenerator_t idGen,
+                   g9pID_t                key,
+                   gridPointUint32_t      coord);
+
+static void
+local_axesToTranspose(gridPointUint32_t x, int numBits);
+
+static void
+local_transposeToAxes(gridPointUint32_t x, int numBits);
+
 
 /*--- Implementations of exported functions -----------------------------*/
+extern g9pIDGeneratorScheme_t
+g9pIDGenerator_getSchemeFromName(const char *name)
+{
+	g9pIDGeneratorScheme_t scheme = G9PIDGENERATOR_SCHEME_UNKNOWN;
+
+	assert(name != NULL);
+
+	for (int i = 0; i < LOCAL_NUM_SCHEMES; i++) {
+		if (strcmp(name, local_schemeStr[i]) == 0) {
+			scheme = (g9pIDGeneratorScheme_t)i;
+			break;
+		}
+	}
+
+	return scheme;
+}
+
 extern g9pIDGenerator_t
 g9pIDGenerator_new(g9pHierarchy_t h, uint8_t idLevel)
+{
+	return g9pIDGenerator_newWithScheme(h, idLevel,
+	                                    G9PIDGENERATOR_SCHEME_ROWMAJOR);
+}
+
+extern g9pIDGenerator_t
+g9pIDGenerator_newWithScheme(g9pHierarchy_t         h,
+                             uint8_t                idLevel,
+                             g9pIDGeneratorScheme_t scheme)
 {
 	assert(h != NULL);
 	assert(idLevel < g9pHierarchy_getNumLevels(h));
+	assert(scheme != G9PIDGENERATOR_SCHEME_UNKNOWN);
 
 	g9pIDGenerator_t idGen = local_allocate();
 
 	idGen->h       = h;
 	idGen->idLevel = idLevel;
+	idGen->scheme  = scheme;
 	const uint32_t tmp = g9pHierarchy_getDim1DAtLevel(h, idLevel);
 	for (int i = 0; i < NDIM; i++)
 		idGen->idDims[i] = tmp;
 	idGen->maxID = POW_NDIM((g9pID_t)(tmp));
+	if (scheme != G9PIDGENERATOR_SCHEME_ROWMAJOR)
+		local_initCurve(idGen);
 
 	return g9pIDGenerator_getRef(idGen);
 }
@@ -82,6 +151,14 @@ g9pIDGenerator_getMaxID(const g9pIDGenerator_t idGen)
 	return idGen->maxID;
 }
 
+extern g9pIDGeneratorScheme_t
+g9pIDGenerator_getScheme(const g9pIDGenerator_t idGen)
+{
+	assert(idGen != NULL);
+
+	return idGen->scheme;
+}
+
 extern g9pID_t
 g9pIDGenerator_calcID(const g9pIDGenerator_t  idGen,
                       const gridPointUint32_t coord,
@@ -99,9 +176,9 @@ g9pIDGenerator_calcID(const g9pIDGenerator_t  idGen,
 		                                         idGen->idLevel);
 		for (int i = 0; i < NDIM; i++)
 			tmpCoord[i] = coord[i] * fac;
-		return (g9pID_t)lIdx_fromCoordNdim(tmpCoord, idGen->idDims);
+		return local_calcKey(idGen, tmpCoord);
 	} else {
-		return (g9pID_t)lIdx_fromCoordNdim(coord, idGen->idDims);
+		return local_calcKey(idGen, coord);
 	}
 }
 
@@ -117,7 +194,7 @@ g9pIDGenerator_calcCoord(const g9pIDGenerator_t idGen,
 	while (id >= idGen->maxID)
 		id -= idGen->maxID;
 
-	lIdx_toCoordNdim(id, idGen->idDims, coord);
+	local_calcCoordFromKey(idGen, id, coord);
 	if (coordLevel != idGen->idLevel) {
 		uint32_t fac = g9pHierarchy_getFactorBetweenLevel(idGen->h,
 		                                                  coordLevel,
@@ -138,3 +215,162 @@ local_allocate(void)
 
 	return idGen;
 }
+
+static void
+local_initCurve(g9pIDGenerator_t idGen)
+{
+	idGen->numBits = 0;
+	while ((UINT32_C(1) << idGen->numBits) < idGen->idDims[0])
+		idGen->numBits++;
+	if (idGen->numBits * NDIM >= 64) {
+		fprintf(stderr, "FATAL:  %u cells per dimension exceed the "
+		        "space-filling curve keys.\n", idGen->idDims[0]);
+		diediedie(EXIT_FAILURE);
+	}
+	idGen->maxID = UINT64_C(1) << (idGen->numBits * NDIM);
+
+	for (uint32_t b = 0; b < 256; b++) {
+		idGen->spread[b] = 0;
+		for (int k = 0; k < 8; k++)
+			idGen->spread[b] |= (uint64_t)((b >> k) & 1) << (k * NDIM);
+	}
+}
+
+static g9pID_t
+local_calcKey(const g9pIDGenerator_t idGen, const gridPointUint32_t coord)
+{
+	gridPointUint32_t x;
+
+	switch (idGen->scheme) {
+	case G9PIDGENERATOR_SCHEME_MORTON:
+		return local_interleave(idGen, coord);
+	case G9PIDGENERATOR_SCHEME_HILBERT:
+		for (int i = 0; i < NDIM; i++)
+			x[i] = coord[i];
+		local_axesToTranspose(x, idGen->numBits);
+		// The first axis provides the most significant bit of each
+		// group, the interleaving puts it into the least significant.
+		for (int i = 0; i < NDIM / 2; i++) {
+			uint32_t tmp = x[i];
+			x[i]            = x[NDIM - 1 - i];
+			x[NDIM - 1 - i] = tmp;
+		}
+		return local_interleave(idGen, x);
+	default:
+		return (g9pID_t)lIdx_fromCoordNdim(coord, idGen->idDims);
+	}
+}
+
+static void
+local_calcCoordFromKey(const g9pIDGenerator_t idGen,
+                       g9pID_t                key,
+                       gridPointUint32_t      coord)
+{
+	switch (idGen->scheme) {
+	case G9PIDGENERATOR_SCHEME_MORTON:
+		local_deinterleave(idGen, key, coord);
+		break;
+	case G9PIDGENERATOR_SCHEME_HILBERT:
+		local_deinterleave(idGen, key, coord);
+		for (int i = 0; i < NDIM / 2; i++) {
+			uint32_t tmp = coord[i];
+			coord[i]            = coord[NDIM - 1 - i];
+			coord[NDIM - 1 - i] = tmp;
+		}
+		local_transposeToAxes(coord, idGen->numBits);
+		break;
+	default:
+		lIdx_toCoordNdim(key, idGen->idDims, coord);
+		break;
+	}
+}
+
+static g9pID_t
+local_interleave(const g9pIDGenerator_t idGen, const gridPointUint32_t coord)
+{
+	g9pID_t key = 0;
+
+	for (int i = 0; i < NDIM; i++) {
+		uint32_t c = coord[i];
+		for (int shift = i; c != 0; c >>= 8, shift += 8 * NDIM)
+			key |= idGen->spread[c & 0xff] << shift;
+	}
+
+	return key;
+}
+
+static void
+local_deinterleave(const g9pIDGenerator_t idGen,
+                   g9pID_t                key,
+                   gridPointUint32_t      coord)
+{
+	for (int i = 0; i < NDIM; i++)
+		coord[i] = 0;
+	for (int b = 0; b < idGen->numBits; b++) {
+		for (int i = 0; i < NDIM; i++) {
+			coord[i] |= (uint32_t)(key & 1) << b;
+			key     >>= 1;
+		}
+	}
+}
+
+// Skilling, J. 2004, AIP Conf. Proc. 707, 381: converts the coordinates
+// in place to the transposed form of the Hilbert key.
+static void
+local_axesToTranspose(gridPointUint32_t x, int numBits)
+{
+	uint32_t t;
+
+	if (numBits == 0)
+		return;
+
+	for (uint32_t q = UINT32_C(1) << (numBits - 1); q > 1; q >>= 1) {
+		uint32_t p = q - 1;
+		for (int i = 0; i < NDIM; i++) {
+			if (x[i] & q) {
+				x[0] ^= p;
+			} else {
+				t     = (x[0] ^ x[i]) & p;
+				x[0] ^= t;
+				x[i] ^= t;
+			}
+		}
+	}
+
+	for (int i = 1; i < NDIM; i++)
+		x[i] ^= x[i - 1];
+	t = 0;
+	for (uint32_t q = UINT32_C(1) << (numBits - 1); q > 1; q >>= 1) {
+		if (x[NDIM - 1] & q)
+			t ^= q - 1;
+	}
+	for (int i = 0; i < NDIM; i++)
+		x[i] ^= t;
+}
+
+static void
+local_transposeToAxes(gridPointUint32_t x, int numBits)
+{
+	uint32_t t;
+
+	if (numBits == 0)
+		return;
+
+	t = x[NDIM - 1] >> 1;
+	for (int i = NDIM - 1; i > 0; i--)
+		x[i] ^= x[i - 1];
+	x[0] ^= t;
+
+	for (uint32_t q = 2; q != (UINT32_C(2) << (numBits - 1)); q <<= 1) {
+		uint32_t p = q - 1;
+		for (int i = NDIM - 1; i >= 0; i--) {
+			if (x[i] & q) {
+				x[0] ^= p;
+			} else {
+				t     = (x[0] ^ x[i]) & p;
+				x[0] ^= t;
+				x[i] ^= t;
+			}
+		}
+	}
+}
@@ -29,10 +29,61 @@ typedef struct g9pIDGenerator_struct *g9pIDGenerator_t;
 typedef uint64_t g9pID_t;
 
 
+/*--- Exported types ----------------------------------------------------*/
+
+/** @brief  The ways to map a coordinate to an ID. */
+typedef enum {
+	/** @brief  Row-major order, x varies fastest. */
+	G9PIDGENERATOR_SCHEME_ROWMAJOR = 0,
+	/** @brief  Morton (Z-order) keys. */
+	G9PIDGENERATOR_SCHEME_MORTON = 1,
+	/** @brief  Peano-Hilbert keys. */
+	G9PIDGENERATOR_SCHEME_HILBERT = 2,
+	/** @brief  Stands for an unknown scheme (erroneous to use). */
+	G9PIDGENERATOR_SCHEME_UNKNOWN = 3
+} g9pIDGeneratorScheme_t;
+
+
 /*--- Prototypes of exported functions ----------------------------------*/
+
+/**
+ * @brief  Translates a string into an ID scheme.
+ *
+ * @param[in]  *name
+ *                A properly terminated string containing the name of the
+ *                scheme, i.e. @c rowMajor, @c morton or @c hilbert.
+ *
+ * @return  Returns the corresponding scheme, or
+ *          #G9PIDGENERATOR_SCHEME_UNKNOWN if the name is not a valid
+ *          scheme name.
+ */
+extern g9pIDGeneratorScheme_t
+g9pIDGenerator_getSchemeFromName(const char *name);
+
 extern g9pIDGenerator_t
 g9pIDGenerator_new(g9pHierarchy_t h, uint8_t idLevel);
 
+/**
+ * @brief  Creates an ID generator using a given scheme.
+ *
+ * For the space-filling curves the IDs are the keys on the smallest
+ * power-of-two grid covering the grid of @c idLevel, hence they are not
+ * dense if that grid is not a power of two.
+ *
+ * @param[in]  h
+ *                The hierarchy, the reference is taken over.
+ * @param[in]  idLevel
+ *                The level on which the IDs are calculated.
+ * @param[in]  scheme
+ *                The mapping from coordinates to IDs.
+ *
+ * @return  Returns a new ID generator.
+ */
+extern g9pIDGenerator_t
+g9pIDGenerator_newWithScheme(g9pHierarchy_t         h,
+                             uint8_t                idLevel,
+                             g9pIDGeneratorScheme_t scheme);
+
 extern g9pIDGenerator_t
 g9pIDGenerator_getRef(g9pIDGenerator_t idGen);
 
@@ -42,6 +93,9 @@ g9pIDGenerator_del(g9pIDGenerator_t *idGen);
 extern g9pID_t
 g9pIDGenerator_getMaxID(const g9pIDGenerator_t idGen);
 
+extern g9pIDGeneratorScheme_t
+g9pIDGenerator_getScheme(const g9pIDGenerator_t idGen);
+
 extern g9pID_t
 g9pIDGenerator_calcID(const g9pIDGenerator_t  idGen,
                       const gridPointUint32_t coord,
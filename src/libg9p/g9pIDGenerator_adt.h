@@ -19,6 +19,7 @@
 #include "g9pConfig.h"
 #include "../libutil/refCounter.h"
 #include "g9pHierarchy.h"
+#include "g9pIDGenerator.h"
 
 
 /*--- ADT implementation ------------------------------------------------*/
@@ -28,6 +29,9 @@ struct g9pIDGenerator_struct {
 	uint8_t           idLevel;
 	gridPointUint32_t idDims;
 	g9pID_t           maxID;
+	g9pIDGeneratorScheme_t scheme;
+	int               numBits;
+	uint64_t          spread[256];
 };
 
 
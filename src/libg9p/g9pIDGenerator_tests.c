@@ -21,9 +21,7 @@
 #ifdef WITH_MPI
 #  include <mpi.h>
 #endif
-#ifdef XMEM_TRACK_MEM
-#  include "../libutil/xmem.h"
-#endif
+#include "../libutil/xmem.h"
 
 
 /*--- Implementation of main structure ----------------------------------*/
@@ -37,6 +35,9 @@
 static g9pHierarchy_t
 local_getComplexHierarchy(void);
 
+static bool
+local_checkCurve(g9pIDGeneratorScheme_t scheme, uint32_t dim1D);
+
 
 /*--- Implementations of exported functions -----------------------------*/
 extern bool
@@ -200,7 +201,142 @@ g9pIDGenerator_verifyIDResolving(void)
 	return hasPassed ? true : false;
 }
 
+extern bool
+g9pIDGenerator_verifyCurveSchemes(void)
+{
+	bool              hasPassed = true;
+	int               rank      = 0;
+	g9pIDGenerator_t  idGen;
+	gridPointUint32_t coord;
+#ifdef XMEM_TRACK_MEM
+	size_t            allocatedBytes = global_allocated_bytes;
+#endif
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	if (!local_checkCurve(G9PIDGENERATOR_SCHEME_MORTON, 8))
+		hasPassed = false;
+	if (!local_checkCurve(G9PIDGENERATOR_SCHEME_MORTON, 6))
+		hasPassed = false;
+	if (!local_checkCurve(G9PIDGENERATOR_SCHEME_HILBERT, 8))
+		hasPassed = false;
+	if (!local_checkCurve(G9PIDGENERATOR_SCHEME_HILBERT, 6))
+		hasPassed = false;
+
+	idGen = g9pIDGenerator_newWithScheme(local_getComplexHierarchy(), 7,
+	                                     G9PIDGENERATOR_SCHEME_MORTON);
+	if (g9pIDGenerator_getMaxID(idGen) != (UINT64_C(1) << (16 * NDIM)))
+		hasPassed = false;
+	for (int i = 0; i < NDIM; i++)
+		coord[i] = 0;
+	coord[NDIM - 1] = 1;
+	if (g9pIDGenerator_calcID(idGen, coord, 7) != (UINT64_C(1) << (NDIM - 1)))
+		hasPassed = false;
+	g9pIDGenerator_calcCoord(idGen, UINT64_C(1), coord, 0);
+	if (coord[0] != 0)
+		hasPassed = false;
+	g9pIDGenerator_del(&idGen);
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+} /* g9pIDGenerator_verifyCurveSchemes */
+
+extern bool
+g9pIDGenerator_verifySchemeFromName(void)
+{
+	bool hasPassed = true;
+	int  rank      = 0;
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	if (g9pIDGenerator_getSchemeFromName("rowMajor")
+	    != G9PIDGENERATOR_SCHEME_ROWMAJOR)
+		hasPassed = false;
+	if (g9pIDGenerator_getSchemeFromName("morton")
+	    != G9PIDGENERATOR_SCHEME_MORTON)
+		hasPassed = false;
+	if (g9pIDGenerator_getSchemeFromName("hilbert")
+	    != G9PIDGENERATOR_SCHEME_HILBERT)
+		hasPassed = false;
+	if (g9pIDGenerator_getSchemeFromName("hilbertCurve")
+	    != G9PIDGENERATOR_SCHEME_UNKNOWN)
+		hasPassed = false;
+	if (g9pIDGenerator_getSchemeFromName("")
+	    != G9PIDGENERATOR_SCHEME_UNKNOWN)
+		hasPassed = false;
+
+	return hasPassed ? true : false;
+}
+
 /*--- Implementations of local functions --------------------------------*/
+static bool
+local_checkCurve(g9pIDGeneratorScheme_t scheme, uint32_t dim1D)
+{
+	bool              hasPassed = true;
+	g9pHierarchy_t    h         = g9pHierarchy_newWithSimpleFactor(2, dim1D,
+	                                                               2);
+	g9pIDGenerator_t  idGen = g9pIDGenerator_newWithScheme(h, 0, scheme);
+	g9pID_t           maxID = g9pIDGenerator_getMaxID(idGen);
+	gridPointUint32_t coord, back, last;
+	uint64_t          numCells = 1;
+	bool              *isSeen  = xmalloc(sizeof(bool) * maxID);
+
+	memset(isSeen, 0, sizeof(bool) * maxID);
+	for (int i = 0; i < NDIM; i++) {
+		coord[i]  = 0;
+		numCells *= dim1D;
+	}
+
+	// Every coordinate maps to a distinct key that maps back to it.
+	for (uint64_t j = 0; j < numCells; j++) {
+		g9pID_t id = g9pIDGenerator_calcID(idGen, coord, 0);
+		if ((id >= maxID) || isSeen[id])
+			hasPassed = false;
+		else
+			isSeen[id] = true;
+		g9pIDGenerator_calcCoord(idGen, id, back, 0);
+		for (int i = 0; i < NDIM; i++) {
+			if (back[i] != coord[i])
+				hasPassed = false;
+		}
+		for (int i = 0; i < NDIM && ++coord[i] == dim1D; i++)
+			coord[i] = 0;
+	}
+
+	// On a power-of-two grid, successive Hilbert keys are neighbours.
+	if ((scheme == G9PIDGENERATOR_SCHEME_HILBERT) && (maxID == numCells)) {
+		g9pIDGenerator_calcCoord(idGen, 0, last, 0);
+		for (g9pID_t id = 1; id < maxID; id++) {
+			uint32_t dist = 0;
+			g9pIDGenerator_calcCoord(idGen, id, coord, 0);
+			for (int i = 0; i < NDIM; i++) {
+				dist   += (coord[i] > last[i]) ? coord[i] - last[i]
+				          : last[i] - coord[i];
+				last[i] = coord[i];
+			}
+			if (dist != 1)
+				hasPassed = false;
+		}
+	}
+
+	xfree(isSeen);
+	g9pIDGenerator_del(&idGen);
+
+	return hasPassed;
+} /* local_checkCurve */
+
+
 static g9pHierarchy_t
 local_getComplexHierarchy(void)
 {
@@ -31,5 +31,11 @@ g9pIDGenerator_verifyIDGeneration(void);
 extern bool
 g9pIDGenerator_verifyIDResolving(void);
 
+extern bool
+g9pIDGenerator_verifyCurveSchemes(void);
+
+extern bool
+g9pIDGenerator_verifySchemeFromName(void);
+
 
 #endif
@@ -43,6 +43,22 @@ local_allocateTilePointer(g9pMask_t mask);
 static uint64_t *
 local_initNumCellVector(const g9pMask_t mask, uint64_t *numCells);
 
+static void
+local_countTile(g9pMask_t mask, uint32_t tile);
+
+static void
+local_setTileUniform(struct g9pMaskTile_struct *t, int8_t level,
+                     uint32_t dim1D);
+
+static void
+local_freeTile(struct g9pMaskTile_struct *t);
+
+static uint32_t
+local_getRunsInRow(const struct g9pMaskTile_struct *t,
+                   uint64_t                        row,
+                   const int8_t                    **runLevel,
+                   const uint32_t                  **runEnd);
+
 static gridPatch_t
 local_getEmptyPatchForTile_impl(const g9pMask_t         mask,
                                 const uint32_t          tile,
@@ -88,9 +104,9 @@ g9pMask_del(g9pMask_t *mask)
 
 	if ( refCounter_deref( &( (*mask)->refCounter ) ) ) {
 		for (uint32_t i = 0; i < (*mask)->totalNumTiles; i++)
-			if ( (*mask)->maskTiles[i] != NULL )
-				xfree( (*mask)->maskTiles[i] );
+			local_freeTile( (*mask)->maskTiles + i );
 		xfree( (*mask)->maskTiles );
+		xfree( (*mask)->tileCounts );
 		g9pHierarchy_del( &( (*mask)->hierarchy ) );
 
 		xfree(*mask);
@@ -149,28 +165,151 @@ g9pMask_getNumTiles(const g9pMask_t mask)
 }
 
 extern int8_t *
-g9pMask_getTileData(g9pMask_t mask, uint32_t tile)
+g9pMask_getTileData(const g9pMask_t mask, uint32_t tile, int8_t *data)
 {
 	assert(mask != NULL);
 	assert(tile < mask->totalNumTiles);
 
-	return mask->maskTiles[tile];
-}
+	const struct g9pMaskTile_struct *t   = mask->maskTiles + tile;
+	const uint32_t                  dim  = mask->tileDim1D;
+	const uint64_t                  nCTM = g9pMask_getNumCellsInMaskTile(mask);
 
-extern int8_t *
-g9pMask_setTileData(g9pMask_t mask, uint32_t tile, int8_t *data)
+	if (data == NULL)
+		data = xmalloc(sizeof(int8_t) * nCTM);
+
+	if (t->rowStart == NULL) {
+		memset(data, t->level, nCTM);
+		return data;
+	}
+
+	for (uint64_t row = 0; row < nCTM / dim; row++) {
+		int8_t   *rowData = data + row * dim;
+		uint32_t x        = 0;
+		for (uint64_t r = t->rowStart[row]; r < t->rowStart[row + 1]; r++) {
+			memset(rowData + x, t->runLevel[r], t->runEnd[r] - x);
+			x = t->runEnd[r];
+		}
+	}
+
+	return data;
+} // g9pMask_getTileData
+
+extern void
+g9pMask_setTileData(g9pMask_t mask, uint32_t tile, const int8_t *data)
 {
 	assert(mask != NULL);
 	assert(tile < mask->totalNumTiles);
 
-	int8_t *oldData = NULL;
+	struct g9pMaskTile_struct *t   = mask->maskTiles + tile;
+	const uint32_t            dim  = mask->tileDim1D;
+	const uint64_t            nCTM = g9pMask_getNumCellsInMaskTile(mask);
+	const uint64_t            numRows  = nCTM / dim;
+	uint64_t                  numRuns  = numRows;
+
+	local_freeTile(t);
+
+	// A tile without data is entirely on the coarsest level.
+	if (data == NULL) {
+		local_setTileUniform(t, mask->minLevel, dim);
+		local_countTile(mask, tile);
+		return;
+	}
+
+	for (uint64_t i = 1; i < nCTM; i++) {
+		if ((i % dim != 0) && (data[i] != data[i - 1]))
+			numRuns++;
+	}
 
-	if (mask->maskTiles[tile] != data) {
-		oldData               = mask->maskTiles[tile];
-		mask->maskTiles[tile] = data;
+	if (numRuns == numRows) {
+		bool isUniform = true;
+		for (uint64_t row = 1; row < numRows && isUniform; row++)
+			isUniform = (data[row * dim] == data[0]);
+		if (isUniform) {
+			local_setTileUniform(t, data[0], dim);
+			local_countTile(mask, tile);
+			return;
+		}
 	}
 
-	return oldData;
+	t->rowStart = xmalloc(sizeof(uint64_t) * (numRows + 1));
+	t->runLevel = xmalloc(sizeof(int8_t) * numRuns);
+	t->runEnd   = xmalloc(sizeof(uint32_t) * numRuns);
+
+	uint64_t r = 0;
+	for (uint64_t row = 0; row < numRows; row++) {
+		const int8_t *rowData = data + row * dim;
+		t->rowStart[row] = r;
+		for (uint32_t x = 1; x < dim; x++) {
+			if (rowData[x] != rowData[x - 1]) {
+				t->runLevel[r] = rowData[x - 1];
+				t->runEnd[r++] = x;
+			}
+		}
+		t->runLevel[r] = rowData[dim - 1];
+		t->runEnd[r++] = dim;
+	}
+	t->rowStart[numRows] = r;
+	assert(r == numRuns);
+
+	local_countTile(mask, tile);
+} // g9pMask_setTileData
+
+extern int8_t
+g9pMask_getLevelInTile(const g9pMask_t         mask,
+                       uint32_t                tile,
+                       const gridPointUint32_t idx)
+{
+	assert(mask != NULL);
+	assert(tile < mask->totalNumTiles);
+
+	const int8_t   *runLevel;
+	const uint32_t *runEnd;
+	uint64_t       row = idx[1];
+	uint32_t       lo  = 0, hi;
+
+#if (NDIM > 2)
+	row += (uint64_t)idx[2] * mask->tileDim1D;
+#endif
+	hi = local_getRunsInRow(mask->maskTiles + tile, row, &runLevel, &runEnd)
+	     - 1;
+
+	// Find the first run ending after idx[0].
+	while (lo < hi) {
+		uint32_t mid = (lo + hi) / 2;
+		if (runEnd[mid] <= idx[0])
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	return runLevel[lo];
+}
+
+extern uint32_t
+g9pMask_getRunsInTileRow(const g9pMask_t mask,
+                         uint32_t        tile,
+                         uint32_t        y,
+                         uint32_t        z,
+                         const int8_t    **runLevel,
+                         const uint32_t  **runEnd)
+{
+	assert(mask != NULL);
+	assert(tile < mask->totalNumTiles);
+	assert(y < mask->tileDim1D && z < mask->tileDim1D);
+	assert(runLevel != NULL && runEnd != NULL);
+
+	uint64_t row = y + (uint64_t)z * mask->tileDim1D;
+
+	return local_getRunsInRow(mask->maskTiles + tile, row, runLevel, runEnd);
+}
+
+extern bool
+g9pMask_isTileUniform(const g9pMask_t mask, uint32_t tile)
+{
+	assert(mask != NULL);
+	assert(tile < mask->totalNumTiles);
+
+	return mask->maskTiles[tile].rowStart == NULL;
 }
 
 extern g9pHierarchy_t
@@ -277,26 +416,15 @@ g9pMask_getNumCellsInTileForLevel(const g9pMask_t mask,
 	assert(tile < mask->totalNumTiles);
 	assert(level >= mask->minLevel && level <= mask->maxLevel);
 
-	uint64_t numCells = UINT64_C(0);
-
-	if (mask->maskTiles[tile] == NULL) {
-		if (level == mask->minLevel)
-			numCells = g9pMask_getMaxNumCellsInTileForLevel(mask, level);
-		return numCells;
-	}
-
-	const int8_t   *thisTileData = mask->maskTiles[tile];
+	const uint8_t  numLevel = g9pMask_getNumLevel(mask);
+	uint64_t       numCells = mask->tileCounts[tile * numLevel
+	                                           + level - mask->minLevel];
 
 	const uint64_t nCTL          = g9pMask_getMaxNumCellsInTileForLevel(mask,
 	                                                                    level);
 	const uint64_t nCTM          = g9pMask_getNumCellsInMaskTile(mask);
 	const uint64_t nCFac         = nCTL < nCTM ? nCTM / nCTL : nCTL / nCTM;
 
-	for (uint64_t i = 0; i < nCTM; i++) { // maybe it must be nCTM? // Changed nCTL->nCTM 29.01.2014 SP
-		if (thisTileData[i] == level)
-			numCells++;
-	}
-
 	if (nCTL < nCTM) {
 		assert(numCells % nCFac == 0);
 		numCells /= nCFac;
@@ -315,19 +443,11 @@ g9pMask_getNumCellsInTile(const g9pMask_t mask,
 	assert(mask != NULL);
 	assert(tile < mask->totalNumTiles);
 
-	numCells = local_initNumCellVector(mask, numCells);
-
-	if (mask->maskTiles[tile] == NULL) {
-		numCells[0] = g9pMask_getMaxNumCellsInTileForLevel(mask,
-		                                                   mask->minLevel);
-		return numCells;
-	}
+	const uint8_t numLevel = g9pMask_getNumLevel(mask);
 
-	uint64_t     numCellsInTile = g9pMask_getNumCellsInMaskTile(mask);
-	const int8_t *thisTileData  = mask->maskTiles[tile];
-	for (uint64_t i = 0; i < numCellsInTile; i++) {
-		numCells[thisTileData[i] - mask->minLevel]++;
-	}
+	numCells = local_initNumCellVector(mask, numCells);
+	for (uint8_t i = 0; i < numLevel; i++)
+		numCells[i] = mask->tileCounts[tile * numLevel + i];
 
 	for (uint8_t i = mask->minLevel; i < mask->maskLevel; i++) {
 		uint64_t factor = g9pHierarchy_getFactorBetweenLevel(mask->hierarchy,
@@ -354,7 +474,7 @@ g9pMask_getNumCellsTotal(const g9pMask_t mask, uint64_t *numCells)
 	assert(mask != NULL);
 
 	numCells = local_initNumCellVector(mask, numCells);
-	uint64_t      *numCellsLocal;
+	uint64_t      *numCellsLocal = NULL;
 	const uint8_t numLevel = g9pMask_getNumLevel(mask);
 
 	for (uint32_t i = 0; i < mask->totalNumTiles; i++) {
@@ -424,6 +544,7 @@ local_allocateEmptyMask()
 	refCounter_init( &(mask->refCounter) );
 	mask->totalNumTiles = 0;
 	mask->maskTiles     = NULL;
+	mask->tileCounts    = NULL;
 	//mask->lare = NULL; // !sp
 
 	return mask;
@@ -436,6 +557,9 @@ local_setTilingFromHierarchy(g9pMask_t mask)
 
 	uint32_t dimTileLevel = g9pHierarchy_getDim1DAtLevel(mask->hierarchy,
 	                                                     mask->tileLevel);
+	mask->tileDim1D = g9pHierarchy_getFactorBetweenLevel(mask->hierarchy,
+	                                                     mask->tileLevel,
+	                                                     mask->maskLevel);
 	mask->totalNumTiles = 1;
 	for (int i = 0; i < NDIM; i++) {
 		mask->numTiles[i]    = dimTileLevel;
@@ -449,9 +573,14 @@ local_allocateTilePointer(g9pMask_t mask)
 	assert(mask->totalNumTiles > 0);
 	assert(mask->maskTiles == NULL);
 
-	mask->maskTiles = xmalloc(sizeof(int8_t *) * mask->totalNumTiles);
+	mask->maskTiles  = xmalloc(sizeof(struct g9pMaskTile_struct)
+	                           * mask->totalNumTiles);
+	mask->tileCounts = xmalloc(sizeof(uint64_t) * mask->totalNumTiles
+	                           * g9pMask_getNumLevel(mask));
 	for (size_t i = 0; i < mask->totalNumTiles; i++) {
-		mask->maskTiles[i] = NULL;
+		local_setTileUniform(mask->maskTiles + i, mask->minLevel,
+		                     mask->tileDim1D);
+		local_countTile(mask, i);
 	}
 	mask->isEmpty = true;
 }
@@ -470,6 +599,78 @@ local_initNumCellVector(const g9pMask_t mask, uint64_t *numCells)
 	return numCells;
 }
 
+static void
+local_countTile(g9pMask_t mask, uint32_t tile)
+{
+	const uint8_t                   numLevel = g9pMask_getNumLevel(mask);
+	const uint64_t                  nCTM     = g9pMask_getNumCellsInMaskTile(mask);
+	const struct g9pMaskTile_struct *t       = mask->maskTiles + tile;
+	uint64_t                        *counts  = mask->tileCounts
+	                                           + tile * numLevel;
+
+	for (uint8_t i = 0; i < numLevel; i++)
+		counts[i] = UINT64_C(0);
+
+	// Uniform tiles are counted at once, otherwise each run is.
+	if (t->rowStart == NULL) {
+		assert(t->level >= mask->minLevel && t->level <= mask->maxLevel);
+		counts[t->level - mask->minLevel] = nCTM;
+		return;
+	}
+
+	for (uint64_t row = 0; row < nCTM / mask->tileDim1D; row++) {
+		uint32_t x = 0;
+		for (uint64_t r = t->rowStart[row]; r < t->rowStart[row + 1]; r++) {
+			assert(t->runLevel[r] >= mask->minLevel
+			       && t->runLevel[r] <= mask->maxLevel);
+			counts[t->runLevel[r] - mask->minLevel] += t->runEnd[r] - x;
+			x                                        = t->runEnd[r];
+		}
+	}
+}
+
+static void
+local_setTileUniform(struct g9pMaskTile_struct *t, int8_t level,
+                     uint32_t dim1D)
+{
+	t->rowStart = NULL;
+	t->runLevel = NULL;
+	t->runEnd   = NULL;
+	t->level    = level;
+	t->end      = dim1D;
+}
+
+static void
+local_freeTile(struct g9pMaskTile_struct *t)
+{
+	if (t->rowStart != NULL) {
+		xfree(t->rowStart);
+		xfree(t->runLevel);
+		xfree(t->runEnd);
+		t->rowStart = NULL;
+		t->runLevel = NULL;
+		t->runEnd   = NULL;
+	}
+}
+
+static uint32_t
+local_getRunsInRow(const struct g9pMaskTile_struct *t,
+                   uint64_t                        row,
+                   const int8_t                    **runLevel,
+                   const uint32_t                  **runEnd)
+{
+	if (t->rowStart == NULL) {
+		*runLevel = &(t->level);
+		*runEnd   = &(t->end);
+		return 1;
+	}
+
+	*runLevel = t->runLevel + t->rowStart[row];
+	*runEnd   = t->runEnd + t->rowStart[row];
+
+	return (uint32_t)(t->rowStart[row + 1] - t->rowStart[row]);
+}
+
 static gridPatch_t
 local_getEmptyPatchForTile_impl(const g9pMask_t         mask,
                                 const uint32_t          tile,
@@ -81,11 +81,104 @@ g9pMask_getTotalNumTiles(const g9pMask_t mask);
 extern const uint32_t *
 g9pMask_getNumTiles(const g9pMask_t mask);
 
+/**
+ * @brief  Expands the levels of all cells of a tile.
+ *
+ * The tiles are stored run-length encoded along x, this gives the full
+ * array of g9pMask_getNumCellsInMaskTile() cells (x running fastest).
+ *
+ * @param[in]   mask
+ *                 The mask to work with.
+ * @param[in]   tile
+ *                 The tile to expand.
+ * @param[out]  *data
+ *                 The array receiving the levels, if @c NULL a new array
+ *                 will be allocated.
+ *
+ * @return  Returns the array holding the levels, the caller is
+ *          responsible for freeing it.
+ */
 extern int8_t *
-g9pMask_getTileData(g9pMask_t mask, uint32_t tile);
+g9pMask_getTileData(const g9pMask_t mask, uint32_t tile, int8_t *data);
 
-extern int8_t *
-g9pMask_setTileData(g9pMask_t mask, uint32_t tile, int8_t *data);
+/**
+ * @brief  Sets the levels of all cells of a tile.
+ *
+ * The data is encoded into runs along x and the cells of each level are
+ * recounted; the data remains owned by the caller.
+ *
+ * @param[in,out]  mask
+ *                    The mask to work with.
+ * @param[in]      tile
+ *                    The tile to set.
+ * @param[in]      *data
+ *                    The levels of the cells, laid out as given by
+ *                    g9pMask_getTileData().  Passing @c NULL puts the
+ *                    whole tile on the minimal level.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+g9pMask_setTileData(g9pMask_t mask, uint32_t tile, const int8_t *data);
+
+/**
+ * @brief  Gets the level of one cell of a tile.
+ *
+ * @param[in]  mask
+ *                The mask to work with.
+ * @param[in]  tile
+ *                The tile of the cell.
+ * @param[in]  idx
+ *                The position of the cell in the tile, at the mask level.
+ *
+ * @return  Returns the level of the cell.
+ */
+extern int8_t
+g9pMask_getLevelInTile(const g9pMask_t         mask,
+                       uint32_t                tile,
+                       const gridPointUint32_t idx);
+
+/**
+ * @brief  Gets the runs of equal level in one row of a tile.
+ *
+ * The runs cover the row in order, run @c i ends before the x index
+ * <tt>(*runEnd)[i]</tt>, the last run always ends at the end of the row.
+ *
+ * @param[in]   mask
+ *                 The mask to work with.
+ * @param[in]   tile
+ *                 The tile to look at.
+ * @param[in]   y
+ *                 The y index of the row in the tile, at the mask level.
+ * @param[in]   z
+ *                 The z index of the row in the tile, at the mask level.
+ * @param[out]  **runLevel
+ *                 Will be set to the levels of the runs.
+ * @param[out]  **runEnd
+ *                 Will be set to the ends of the runs.
+ *
+ * @return  Returns the number of runs in the row.
+ */
+extern uint32_t
+g9pMask_getRunsInTileRow(const g9pMask_t mask,
+                         uint32_t        tile,
+                         uint32_t        y,
+                         uint32_t        z,
+                         const int8_t    **runLevel,
+                         const uint32_t  **runEnd);
+
+/**
+ * @brief  Checks whether all cells of a tile are on the same level.
+ *
+ * @param[in]  mask
+ *                The mask to work with.
+ * @param[in]  tile
+ *                The tile to check.
+ *
+ * @return  Returns @c true if the tile is uniform, @c false otherwise.
+ */
+extern bool
+g9pMask_isTileUniform(const g9pMask_t mask, uint32_t tile);
 
 extern g9pHierarchy_t
 g9pMask_getHierarchyRef(g9pMask_t mask);
@@ -116,7 +116,10 @@ g9pMaskCreator_fromCells(g9pMask_t               mask,
 		local_initPatchData(patch, g9pMask_getMinLevel(mask));
 		local_tagCellsInPatch(patch, numCells, cells, sl, gridDims);
 		local_fixTaintedLowLevelCells(patch, mask);
-		g9pMask_setTileData(mask, i, gridPatch_popVarData(patch, 0));
+		// The mask encodes its own copy, only one tile per thread is
+		// held in full.
+		g9pMask_setTileData(mask, i, gridPatch_getVarDataHandle(patch, 0));
+		gridPatch_freeVarData(patch, 0);
 	}
 	g9pMaskShapelet_del(&sl);
 	gridRegular_del(&grid);
@@ -60,7 +60,7 @@ static void
 local_mvDataMask2Grid(g9pMask_t mask, gridRegular_t grid);
 
 static void
-local_mvDataGrid2Mask(g9pMask_t mask, gridRegular_t grid);
+local_mvDataPatch2Mask(g9pMask_t mask, gridPatch_t patch, uint32_t tile);
 
 static lare_t
 local_newLare(parse_ini_t ini, const char *secName);
@@ -132,8 +132,6 @@ g9pMaskIO_write(g9pMask_t mask, gridWriter_t writer)
 	gridWriter_writeGridRegular(writer, grid);
 	gridWriter_deactivate(writer);
 
-	local_mvDataGrid2Mask(mask, grid);
-
 	gridRegular_del(&grid);
 }
 
@@ -145,10 +143,9 @@ g9pMaskIO_read(g9pMask_t mask, gridReader_t reader)
 	for (int i = 0; i < gridRegular_getNumPatches(grid); i++) {
 		gridPatch_t patch = gridRegular_getPatchHandle(grid, i);
 		gridReader_readIntoPatchForVar(reader, patch, 0);
+		local_mvDataPatch2Mask(mask, patch, i);
 	}
 
-	local_mvDataGrid2Mask(mask, grid);
-
 	gridRegular_del(&grid);
 }
 
@@ -279,21 +276,14 @@ local_mvDataMask2Grid(g9pMask_t mask, gridRegular_t grid)
 	for (uint32_t i = 0; i < numTiles; i++) {
 		gridPatch_t patch = gridRegular_getPatchHandle(grid, i);
 
-		gridPatch_replaceVarData(patch, 0, g9pMask_getTileData(mask, i));
+		gridPatch_replaceVarData(patch, 0,
+		                         g9pMask_getTileData(mask, i, NULL));
 	}
 }
 
 static void
-local_mvDataGrid2Mask(g9pMask_t mask, gridRegular_t grid)
+local_mvDataPatch2Mask(g9pMask_t mask, gridPatch_t patch, uint32_t tile)
 {
-	const uint32_t numTiles = g9pMask_getTotalNumTiles(mask);
-	for (uint32_t i = 0; i < numTiles; i++) {
-		int8_t      *d;
-		gridPatch_t patch = gridRegular_getPatchHandle(grid, i);
-
-		d = g9pMask_setTileData(mask, i, gridPatch_popVarData(patch, 0));
-
-		if (d != NULL)
-			diediedie(EXIT_FAILURE);
-	}
+	g9pMask_setTileData(mask, tile, gridPatch_getVarDataHandle(patch, 0));
+	gridPatch_freeVarData(patch, 0);
 }
@@ -22,9 +22,7 @@
 #ifdef WITH_MPI
 #  include <mpi.h>
 #endif
-#ifdef XMEM_TRACK_MEM
-#  include "../libutil/xmem.h"
-#endif
+#include "../libutil/xmem.h"
 #ifdef WITH_HDF5
 #  include "g9pMaskCreator.h"
 #  include "../libgrid/gridReaderFactory.h"
@@ -219,13 +217,18 @@ local_checkMasksAreEqual(g9pMask_t m1, g9pMask_t m2)
 		return false;
 
 	for (int i = 0; i < g9pMask_getTotalNumTiles(m1); i++) {
-		const int8_t *d1 = g9pMask_getTileData(m1, i);
-		const int8_t *d2 = g9pMask_getTileData(m2, i);
+		int8_t *d1       = g9pMask_getTileData(m1, i, NULL);
+		int8_t *d2       = g9pMask_getTileData(m2, i, NULL);
+		bool   areEqual = true;
 
 		for (uint64_t i = 0; i < g9pMask_getNumCellsInMaskTile(m1); i++) {
 			if (d1[i] != d2[i])
-				return false;
+				areEqual = false;
 		}
+		xfree(d1);
+		xfree(d2);
+		if (!areEqual)
+			return false;
 	}
 
 	return true;
@@ -23,6 +23,31 @@
 #include "../liblare/lare.h"
 
 
+/*--- Implementation of the tiles ---------------------------------------*/
+
+/**
+ * @brief  A tile of the mask, run-length encoded along x.
+ *
+ * The cells of a row (fixed y and z) are stored as runs of equal level,
+ * a run ends at (excludes) the x index given in @c runEnd.  A tile that
+ * is on one level throughout has no rows and holds a single run in
+ * @c level and @c end instead.
+ */
+struct g9pMaskTile_struct {
+	/// @brief The first run of each row (y + z * dim), followed by the
+	///        total number of runs; NULL for uniform tiles.
+	uint64_t *rowStart;
+	/// @brief The level of each run.
+	int8_t   *runLevel;
+	/// @brief The x index one past the last cell of each run.
+	uint32_t *runEnd;
+	/// @brief The level of a uniform tile.
+	int8_t   level;
+	/// @brief The end of the single run of a uniform tile.
+	uint32_t end;
+};
+
+
 /*--- ADT implementation ------------------------------------------------*/
 struct g9pMask_struct {
 	/// @brief The reference counter.
@@ -35,7 +60,13 @@ struct g9pMask_struct {
 
 	uint32_t          totalNumTiles;
 	gridPointUint32_t numTiles;
-	int8_t            **maskTiles;
+	/// @brief The number of cells per dimension of a tile at the mask
+	///        level.
+	uint32_t          tileDim1D;
+	struct g9pMaskTile_struct *maskTiles;
+	/// @brief The number of cells of each level in each tile, counted at
+	///        the mask level.
+	uint64_t          *tileCounts;
 	bool              isEmpty;
 	//lare_t			  lare; // !sp
 	float_t			  center[3];
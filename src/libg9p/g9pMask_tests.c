@@ -170,6 +170,145 @@ g9pMask_verifyNumCellsEmptyMask(void)
 	return hasPassed ? true : false;
 } /* g9pMask_verifyNumCellsEmptyMask */
 
+extern bool
+g9pMask_verifyNumCellsFilledTile(void)
+{
+	bool      hasPassed = true;
+	int       rank      = 0;
+	g9pMask_t mask;
+#ifdef XMEM_TRACK_MEM
+	size_t    allocatedBytes = global_allocated_bytes;
+#endif
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	g9pHierarchy_t h = g9pHierarchy_newWithSimpleFactor(7, 2, 2);
+	mask = g9pMask_newMinMaxTiledMask(h, 4, 3, 6, 0);
+
+	uint64_t numCellsInTile = g9pMask_getNumCellsInMaskTile(mask);
+	int8_t   *data          = xmalloc(sizeof(int8_t) * numCellsInTile);
+	memset(data, 4, numCellsInTile / 2);
+	memset(data + numCellsInTile / 2, 5, numCellsInTile / 2);
+	g9pMask_setTileData(mask, 1, data);
+
+	// Half of the tile is on the mask level, half one level finer.
+	if (g9pMask_getNumCellsInTileForLevel(mask, 1, 3) != UINT64_C(0))
+		hasPassed = false;
+	if (g9pMask_getNumCellsInTileForLevel(mask, 1, 4) != numCellsInTile / 2)
+		hasPassed = false;
+	if (g9pMask_getNumCellsInTileForLevel(mask, 1, 5)
+	    != POW_NDIM(2) * numCellsInTile / 2)
+		hasPassed = false;
+
+	// The mask holds its own copy of the data.
+	memset(data, 3, numCellsInTile);
+	if (g9pMask_getNumCellsInTileForLevel(mask, 1, 4) != numCellsInTile / 2)
+		hasPassed = false;
+	g9pMask_setTileData(mask, 1, data);
+	uint64_t *tmp = g9pMask_getNumCellsInTile(mask, 1, NULL);
+	if ((tmp[0] != numCellsInTile / POW_NDIM(2)) || (tmp[1] != UINT64_C(0))
+	    || (tmp[2] != UINT64_C(0)))
+		hasPassed = false;
+	if (!g9pMask_isTileUniform(mask, 1))
+		hasPassed = false;
+
+	xfree(tmp);
+	xfree(data);
+	g9pMask_del(&mask);
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+} /* g9pMask_verifyNumCellsFilledTile */
+
+extern bool
+g9pMask_verifyRunLengthTile(void)
+{
+	bool      hasPassed = true;
+	int       rank      = 0;
+	g9pMask_t mask;
+#ifdef XMEM_TRACK_MEM
+	size_t    allocatedBytes = global_allocated_bytes;
+#endif
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	g9pHierarchy_t h = g9pHierarchy_newWithSimpleFactor(7, 2, 2);
+	mask = g9pMask_newMinMaxTiledMask(h, 4, 3, 6, 0);
+
+	uint64_t          numCellsInTile = g9pMask_getNumCellsInMaskTile(mask);
+	int8_t            *data          = xmalloc(sizeof(int8_t)
+	                                           * numCellsInTile);
+	uint64_t          counts[4]      = {0, 0, 0, 0};
+	gridPointUint32_t idx;
+	const uint32_t    dim            = 16;
+
+	for (idx[2] = 0; idx[2] < dim; idx[2]++) {
+		for (idx[1] = 0; idx[1] < dim; idx[1]++) {
+			for (idx[0] = 0; idx[0] < dim; idx[0]++) {
+				uint64_t i = idx[0] + (idx[1] + idx[2] * dim) * dim;
+				data[i] = 3 + (idx[0] / 4 + idx[1] / 8 + idx[2]) % 4;
+				counts[data[i] - 3]++;
+			}
+		}
+	}
+	g9pMask_setTileData(mask, 2, data);
+	if (g9pMask_isTileUniform(mask, 2) || !g9pMask_isTileUniform(mask, 1))
+		hasPassed = false;
+
+	int8_t *copy = g9pMask_getTileData(mask, 2, NULL);
+	if (memcmp(copy, data, numCellsInTile) != 0)
+		hasPassed = false;
+
+	for (idx[2] = 0; idx[2] < dim; idx[2]++) {
+		for (idx[1] = 0; idx[1] < dim; idx[1]++) {
+			const int8_t   *runLevel;
+			const uint32_t *runEnd;
+			uint32_t       numRuns, r = 0;
+			numRuns = g9pMask_getRunsInTileRow(mask, 2, idx[1], idx[2],
+			                                   &runLevel, &runEnd);
+			if ((numRuns != 4) || (runEnd[numRuns - 1] != dim))
+				hasPassed = false;
+			for (idx[0] = 0; idx[0] < dim; idx[0]++) {
+				uint64_t i = idx[0] + (idx[1] + idx[2] * dim) * dim;
+				while (idx[0] >= runEnd[r])
+					r++;
+				if ((runLevel[r] != data[i])
+				    || (g9pMask_getLevelInTile(mask, 2, idx) != data[i]))
+					hasPassed = false;
+			}
+		}
+	}
+
+	for (uint8_t i = 0; i < 4; i++) {
+		uint64_t n = g9pMask_getNumCellsInTileForLevel(mask, 2, 3 + i);
+		if ((i == 0) && (n * POW_NDIM(2) != counts[i]))
+			hasPassed = false;
+		if ((i > 0) && (n != counts[i] * POW_NDIM(1 << (i - 1))))
+			hasPassed = false;
+	}
+
+	xfree(copy);
+	xfree(data);
+	g9pMask_del(&mask);
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+} /* g9pMask_verifyRunLengthTile */
+
 extern bool
 g9pMask_verifyCreationOfGridStructure(void)
 {
@@ -30,6 +30,18 @@ g9pMask_verifyMaxNumCells(void);
 extern bool
 g9pMask_verifyNumCellsEmptyMask(void);
 
+extern bool
+g9pMask_verifyNumCellsFilledTile(void);
+
+/**
+ * @brief  Verifies that a tile survives the run-length encoding and that
+ *         its cells are found by random access and by the runs of rows.
+ *
+ * @return  Returns @c true if the test passed and @c false otherwise.
+ */
+extern bool
+g9pMask_verifyRunLengthTile(void);
+
 extern bool
 g9pMask_verifyCreationOfGridStructure(void);
 
@@ -105,6 +105,8 @@ main(int argc, char **argv)
 	RUNTEST(&g9pMask_verifyCreationOfMinMaxMask, hasFailed);
 	RUNTEST(&g9pMask_verifyMaxNumCells, hasFailed);
 	RUNTEST(&g9pMask_verifyNumCellsEmptyMask, hasFailed);
+	RUNTEST(&g9pMask_verifyNumCellsFilledTile, hasFailed);
+	RUNTEST(&g9pMask_verifyRunLengthTile, hasFailed);
 	RUNTEST(&g9pMask_verifyCreationOfGridStructure, hasFailed);
 	RUNTEST(&g9pMask_verifyCreationOfPatch, hasFailed);
 	RUNTEST(&g9pMask_verifyDelete, hasFailed);
@@ -164,6 +166,8 @@ main(int argc, char **argv)
 		printf("\nRunning tests for g9pICMap:\n");
 	}
 	RUNTEST(&g9pICMap_verifySimpleMapCreation, hasFailed);
+	RUNTEST(&g9pICMap_verifyCostBalancedMap, hasFailed);
+	RUNTEST(&g9pICMap_verifyCalibrateCost, hasFailed);
 #ifdef XMEM_TRACK_MEM
 	if (rank == 0)
 		xmem_info(stdout);
@@ -187,6 +191,8 @@ main(int argc, char **argv)
 	RUNTEST(&g9pIDGenerator_verifyCreation, hasFailed);
 	RUNTEST(&g9pIDGenerator_verifyIDGeneration, hasFailed);
 	RUNTEST(&g9pIDGenerator_verifyIDResolving, hasFailed);
+	RUNTEST(&g9pIDGenerator_verifyCurveSchemes, hasFailed);
+	RUNTEST(&g9pIDGenerator_verifySchemeFromName, hasFailed);
 #ifdef XMEM_TRACK_MEM
 	if (rank == 0)
 		xmem_info(stdout);
@@ -279,7 +279,7 @@ local_calcRegularCore(gridHistogram_t            histo,
 		gridPatch_t myPatch;
 		dataVar_t   dataVar;
 		void        *data;
-		uint64_t    len;
+		uint64_t    len, stride, numRuns;
 		if (grid != NULL)
 			myPatch = gridRegular_getPatchHandle(grid, i);
 		else
@@ -287,9 +287,11 @@ local_calcRegularCore(gridHistogram_t            histo,
 
 		dataVar = gridPatch_getVarHandle(myPatch, idxOfVar);
 		data    = gridPatch_getVarDataHandle(myPatch, idxOfVar);
-		len     = gridPatch_getNumCells(myPatch);
+		gridPatch_getVarRuns(myPatch, idxOfVar, &len, &stride, &numRuns);
 
-		local_count(data, dataVar, len, histo);
+		for (uint64_t j = 0; j < numRuns; j++)
+			local_count(dataVar_getPointerByOffset(dataVar, data, j * stride),
+			            dataVar, len, histo);
 	}
 
 	if (distrib != NULL) {
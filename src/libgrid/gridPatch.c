@@ -165,6 +165,32 @@ local_getWindowDims(gridPointUint32_t idxLo,
                     uint64_t          *numCells);
 
 
+/**
+ * @brief  Gives the length of the rows of a variable with and without the
+ *         FFTW padding.
+ *
+ * @param[in]   patch
+ *                 The patch to use.
+ * @param[in]   idxOfVarData
+ *                 The variable to use.
+ * @param[out]  *lenRow
+ *                 Will receive the number of bytes of a row without
+ *                 padding.
+ * @param[out]  *lenRowPadded
+ *                 Will receive the number of bytes of a padded row.
+ * @param[out]  *numRows
+ *                 Will receive the number of rows.
+ *
+ * @return  Returns nothing.
+ */
+static void
+local_getRowLayout(const gridPatch_t patch,
+                   int               idxOfVarData,
+                   size_t            *lenRow,
+                   size_t            *lenRowPadded,
+                   uint64_t          *numRows);
+
+
 /*--- Implementations of exported functios ------------------------------*/
 extern gridPatch_t
 gridPatch_new(gridPointUint32_t idxLo, gridPointUint32_t idxHi)
@@ -284,6 +310,28 @@ gridPatch_getNumCellsActual(const gridPatch_t patch, int idxOfVar)
 	return numCellsActual;
 }
 
+extern void
+gridPatch_getVarRuns(const gridPatch_t patch,
+                     int               idxOfVar,
+                     uint64_t          *lenRun,
+                     uint64_t          *strideRun,
+                     uint64_t          *numRuns)
+{
+	assert(patch != NULL);
+	assert(idxOfVar >= 0 && idxOfVar < varArr_getLength(patch->vars));
+	assert(lenRun != NULL && strideRun != NULL && numRuns != NULL);
+
+	if (dataVar_isFFTWPadded(gridPatch_getVarHandle(patch, idxOfVar))) {
+		*lenRun    = patch->dims[0];
+		*strideRun = gridPatch_getDimActual1D(patch, idxOfVar, 0);
+		*numRuns   = patch->numCells / patch->dims[0];
+	} else {
+		*lenRun    = patch->numCells;
+		*strideRun = patch->numCells;
+		*numRuns   = 1;
+	}
+}
+
 extern void
 gridPatch_getIdxLo(const gridPatch_t patch, gridPointUint32_t idxLo)
 {
@@ -390,6 +438,53 @@ gridPatch_popVarData(gridPatch_t patch, int idxOfVarData)
 	return varArr_replace(patch->varData, idxOfVarData, NULL);
 }
 
+extern void
+gridPatch_packVarData(gridPatch_t patch, int idxOfVarData)
+{
+	char     *data;
+	size_t   lenRow, lenRowPadded;
+	uint64_t numRows;
+
+	assert(patch != NULL);
+	assert(idxOfVarData >= 0
+	       && idxOfVarData < varArr_getLength(patch->varData));
+
+	data = varArr_getElementHandle(patch->varData, idxOfVarData);
+	if (data == NULL)
+		return;
+
+	local_getRowLayout(patch, idxOfVarData, &lenRow, &lenRowPadded,
+	                   &numRows);
+
+	// Every row moves towards the front, hence front to back.
+	for (uint64_t i = 1; i < numRows; i++)
+		memmove(data + i * lenRow, data + i * lenRowPadded, lenRow);
+}
+
+extern void
+gridPatch_unpackVarData(gridPatch_t patch, int idxOfVarData)
+{
+	char     *data;
+	size_t   lenRow, lenRowPadded;
+	uint64_t numRows;
+
+	assert(patch != NULL);
+	assert(idxOfVarData >= 0
+	       && idxOfVarData < varArr_getLength(patch->varData));
+
+	data = varArr_getElementHandle(patch->varData, idxOfVarData);
+	if (data == NULL)
+		return;
+
+	local_getRowLayout(patch, idxOfVarData, &lenRow, &lenRowPadded,
+	                   &numRows);
+
+	// Every row moves towards the back, hence back to front.
+	for (uint64_t i = numRows; i > 1; i--)
+		memmove(data + (i - 1) * lenRowPadded, data + (i - 1) * lenRow,
+		        lenRow);
+}
+
 extern dataVar_t
 gridPatch_getVarHandle(const gridPatch_t patch, int idxOfVar)
 {
@@ -789,3 +884,18 @@ local_getWindowDims(gridPointUint32_t idxLo,
 	if (numCells != NULL)
 		*numCells = num;
 }
+
+static void
+local_getRowLayout(const gridPatch_t patch,
+                   int               idxOfVarData,
+                   size_t            *lenRow,
+                   size_t            *lenRowPadded,
+                   uint64_t          *numRows)
+{
+	dataVar_t var      = gridPatch_getVarHandle(patch, idxOfVarData);
+	size_t    sizeElem = dataVar_getSizePerElement(var);
+
+	*lenRow       = patch->dims[0] * sizeElem;
+	*lenRowPadded = 2 * (patch->dims[0] / 2 + 1) * sizeElem;
+	*numRows      = patch->numCells / patch->dims[0];
+}
@@ -167,6 +167,35 @@ extern uint64_t
 gridPatch_getNumCellsActual(const gridPatch_t patch, int idxOfVar);
 
 
+/**
+ * @brief  Describes the storage of a variable as runs of contiguous cells.
+ *
+ * Without padding all cells of the patch form a single run, with the FFTW
+ * padding every row is a run of its own.  Loops over all cells can hence
+ * be written as a loop over the runs and the cells within a run.
+ *
+ * @param[in]   patch
+ *                 The patch to query.
+ * @param[in]   idxOfVar
+ *                 The index of the variable.
+ * @param[out]  *lenRun
+ *                 Will receive the number of cells in a run.
+ * @param[out]  *strideRun
+ *                 Will receive the distance of the starts of two
+ *                 consecutive runs (in elements).
+ * @param[out]  *numRuns
+ *                 Will receive the number of runs.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+gridPatch_getVarRuns(const gridPatch_t patch,
+                     int               idxOfVar,
+                     uint64_t          *lenRun,
+                     uint64_t          *strideRun,
+                     uint64_t          *numRuns);
+
+
 /**
  * @brief  Retrieves the lower left corner of the patch.
  *
@@ -292,6 +321,44 @@ extern void *
 gridPatch_popVarData(gridPatch_t patch, int idxOfVarData);
 
 
+/**
+ * @brief  Moves the rows of an FFTW padded variable together.
+ *
+ * Afterwards the data of the variable is stored without the padding (the
+ * row length is the dimension of the patch), the buffer itself is kept.
+ * The padding flag of the variable is not changed, as the variable is
+ * shared by all patches of a grid; see gridRegular_removePadding() for
+ * the function that also adjusts the flag.  Nothing is done if no data is
+ * allocated.
+ *
+ * @param[in,out]  patch
+ *                    The patch to work with.
+ * @param[in]      idxOfVarData
+ *                    The index of the variable, the data must be in the
+ *                    padded layout.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+gridPatch_packVarData(gridPatch_t patch, int idxOfVarData);
+
+
+/**
+ * @brief  Reverts gridPatch_packVarData().
+ *
+ * @param[in,out]  patch
+ *                    The patch to work with.
+ * @param[in]      idxOfVarData
+ *                    The index of the variable, the data must be in the
+ *                    packed layout and the buffer must be large enough for
+ *                    the padded layout.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+gridPatch_unpackVarData(gridPatch_t patch, int idxOfVarData);
+
+
 /**
  * @brief  Returns a handle to a variable attached to the patch.
  *
@@ -716,6 +716,118 @@ gridPatch_popVarData_test(void)
 	return hasPassed ? true : false;
 }
 
+extern bool
+gridPatch_getVarRuns_test(void)
+{
+	bool              hasPassed = true;
+	int               rank      = 0;
+	gridPatch_t       gridPatch;
+	dataVar_t         var;
+	gridPointUint32_t idxLo;
+	gridPointUint32_t idxHi;
+	uint64_t          lenRun, strideRun, numRuns;
+#ifdef XMEM_TRACK_MEM
+	size_t            allocatedBytes = global_allocated_bytes;
+#endif
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	var = dataVar_new("TEST", DATAVARTYPE_INT, 1);
+	for (int i = 0; i < NDIM; i++) {
+		idxLo[i] = 0;
+		idxHi[i] = 4;
+	}
+	gridPatch = gridPatch_new(idxLo, idxHi);
+	gridPatch_attachVar(gridPatch, var);
+
+	gridPatch_getVarRuns(gridPatch, 0, &lenRun, &strideRun, &numRuns);
+	if ((lenRun != gridPatch->numCells) || (strideRun != lenRun)
+	    || (numRuns != 1))
+		hasPassed = false;
+
+	dataVar_setFFTWPadded(var);
+	gridPatch_getVarRuns(gridPatch, 0, &lenRun, &strideRun, &numRuns);
+	if ((lenRun != 5) || (strideRun != 6)
+	    || (numRuns != gridPatch->numCells / 5))
+		hasPassed = false;
+
+	gridPatch_del(&gridPatch);
+	dataVar_del(&var);
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+} /* gridPatch_getVarRuns_test */
+
+extern bool
+gridPatch_packVarData_test(void)
+{
+	bool              hasPassed = true;
+	int               rank      = 0;
+	gridPatch_t       gridPatch;
+	dataVar_t         var;
+	gridPointUint32_t idxLo;
+	gridPointUint32_t idxHi;
+	int               *data;
+	uint64_t          numRows;
+#ifdef XMEM_TRACK_MEM
+	size_t            allocatedBytes = global_allocated_bytes;
+#endif
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	var = dataVar_new("TEST", DATAVARTYPE_INT, 1);
+	dataVar_setFFTWPadded(var);
+	for (int i = 0; i < NDIM; i++) {
+		idxLo[i] = 0;
+		idxHi[i] = 6;
+	}
+	gridPatch = gridPatch_new(idxLo, idxHi);
+	gridPatch_attachVar(gridPatch, var);
+	numRows = gridPatch->numCells / 7;
+
+	// Rows of 7 cells padded to 8, the padding cell is marked with -1.
+	data = gridPatch_getVarDataHandle(gridPatch, 0);
+	for (uint64_t j = 0; j < numRows; j++) {
+		for (int i = 0; i < 7; i++)
+			data[j * 8 + i] = (int)(j * 7 + i);
+		data[j * 8 + 7] = -1;
+	}
+
+	gridPatch_packVarData(gridPatch, 0);
+	for (uint64_t i = 0; i < gridPatch->numCells; i++) {
+		if (data[i] != (int)i)
+			hasPassed = false;
+	}
+
+	gridPatch_unpackVarData(gridPatch, 0);
+	for (uint64_t j = 0; j < numRows; j++) {
+		for (int i = 0; i < 7; i++) {
+			if (data[j * 8 + i] != (int)(j * 7 + i))
+				hasPassed = false;
+		}
+	}
+
+	gridPatch_del(&gridPatch);
+	dataVar_del(&var);
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+} /* gridPatch_packVarData_test */
+
 extern bool
 gridPatch_getVarHandle_test(void)
 {
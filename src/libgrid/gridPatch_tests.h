@@ -157,6 +157,25 @@ gridPatch_replaceVarData_test(void);
 extern bool
 gridPatch_popVarData_test(void);
 
+/**
+ * @brief  This will test gridPatch_getVarRuns().
+ *
+ * @return  Returns @c true if the test succeeded and @c false
+ *          otherwise.
+ */
+extern bool
+gridPatch_getVarRuns_test(void);
+
+/**
+ * @brief  This will test gridPatch_packVarData() and
+ *         gridPatch_unpackVarData().
+ *
+ * @return  Returns @c true if the test succeeded and @c false
+ *          otherwise.
+ */
+extern bool
+gridPatch_packVarData_test(void);
+
 /**
  * @brief  This will test gridPatch_getVarHandle().
  *
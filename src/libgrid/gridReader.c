@@ -57,11 +57,28 @@ gridReader_readIntoPatchForVar(gridReader_t reader,
                                gridPatch_t  patch,
                                int          idxOfVar)
 {
+	dataVar_t var;
+	bool      isPadded;
+
 	assert(reader != NULL);
 	assert(patch != NULL);
 	assert(idxOfVar >= 0 && idxOfVar < gridPatch_getNumVars(patch));
 
+	var      = gridPatch_getVarHandle(patch, idxOfVar);
+	isPadded = dataVar_isFFTWPadded(var);
+	if (isPadded) {
+		// The readers fill rows without padding.  The buffer is allocated
+		// with the padding first and the rows are spread out afterwards.
+		(void)gridPatch_getVarDataHandle(patch, idxOfVar);
+		dataVar_unsetFFTWPadded(var);
+	}
+
 	reader->func->readIntoPatchForVar(reader, patch, idxOfVar);
+
+	if (isPadded) {
+		dataVar_setFFTWPadded(var);
+		gridPatch_unpackVarData(patch, idxOfVar);
+	}
 }
 
 /*--- Implementations of final functions --------------------------------*/
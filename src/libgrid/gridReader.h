@@ -82,7 +82,8 @@ gridReader_readIntoPatch(gridReader_t reader, gridPatch_t patch);
  *         patch.
  *
  * This works like gridReader_readIntoPatch() but an already existing
- * variable is filled.
+ * variable is filled.  If the variable carries the FFTW padding, the data
+ * is read without padding and spread out in place afterwards.
  *
  * @param[in,out]  reader
  *                    The reader that should be used.
@@ -142,6 +142,16 @@ gridReaderBov_getBov(const gridReaderBov_t reader)
 	return reader->bov;
 }
 
+extern void
+gridReaderBov_setUseDirectIO(gridReaderBov_t reader, bool useDirectIO)
+{
+	assert(reader != NULL);
+
+	reader->useDirectIO = useDirectIO;
+	if (reader->bov != NULL)
+		bov_setUseDirectIO(reader->bov, useDirectIO);
+}
+
 /*--- Implementations of protected functions ----------------------------*/
 extern gridReaderBov_t
 gridReaderBov_alloc(void)
@@ -152,7 +162,8 @@ gridReaderBov_alloc(void)
 extern void
 gridReaderBov_init(gridReaderBov_t reader)
 {
-	reader->bov = NULL;
+	reader->bov         = NULL;
+	reader->useDirectIO = false;
 }
 
 extern void
@@ -254,5 +265,6 @@ local_handleFilenameChange(gridReader_t reader)
 	bov_t bov;
 
 	bov = bov_newFromFile(filename_getFullName(reader->fileName));
+	bov_setUseDirectIO(bov, ((gridReaderBov_t)reader)->useDirectIO);
 	gridReaderBov_setBov((gridReaderBov_t)reader, bov);
 }
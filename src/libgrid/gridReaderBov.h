@@ -106,6 +106,31 @@ extern bov_t
 gridReaderBov_getBov(const gridReaderBov_t reader);
 
 
+/** @} */
+
+/**
+ * @name  Setter (Final)
+ *
+ * @{
+ */
+
+/**
+ * @brief  Sets whether the reader bypasses the page cache.
+ *
+ * This is passed on to bov_setUseDirectIO() for the current and all
+ * later files of the reader.
+ *
+ * @param[in,out]  reader
+ *                    The reader to modify, passing @c NULL is undefined.
+ * @param[in]      useDirectIO
+ *                    Whether to use O_DIRECT, the default is @c false.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+gridReaderBov_setUseDirectIO(gridReaderBov_t reader, bool useDirectIO);
+
+
 /** @} */
 
 
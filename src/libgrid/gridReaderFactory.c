@@ -107,9 +107,13 @@ gridReaderFactory_newFromIniBov(parse_ini_t ini,
                                 filename_t  fn)
 {
 	gridReaderBov_t reader;
+	bool            useDirectIO;
 
 	reader = gridReaderBov_new();
 
+	if (parse_ini_get_bool(ini, "useDirectIO", sectionName, &useDirectIO))
+		gridReaderBov_setUseDirectIO(reader, useDirectIO);
+
 	if (fn == GRIDREADERFACTORY_GET_FILENAME_FROM_SPECIFIC_SECTION) {
 		fn = gridIOCommon_getFileName(ini, sectionName, false);
 	} else {
@@ -99,6 +99,9 @@ gridReaderFactory_newReaderFromIni(parse_ini_t ini, const char *sectionName);
  *
  * @code
  * [SectionName]
+ * # Optional, reads the data bypassing the page cache, the default is
+ * # false.
+ * useDirectIO = <true|false>
  * @endcode
  *
  * @section libgridIOInSiloIniFormat  Silo
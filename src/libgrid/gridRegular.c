@@ -362,6 +362,43 @@ gridRegular_freeVarData(gridRegular_t grid, int idxOfVarData)
 	}
 }
 
+extern bool
+gridRegular_removePadding(gridRegular_t grid, int idxOfVar)
+{
+	dataVar_t var;
+
+	assert(grid != NULL);
+	assert(idxOfVar >= 0 && idxOfVar < varArr_getLength(grid->vars));
+
+	var = gridRegular_getVarHandle(grid, idxOfVar);
+	if (!dataVar_isFFTWPadded(var))
+		return false;
+
+	for (int i = 0; i < gridRegular_getNumPatches(grid); i++)
+		gridPatch_packVarData(gridRegular_getPatchHandle(grid, i),
+		                      idxOfVar);
+	dataVar_unsetFFTWPadded(var);
+
+	return true;
+}
+
+extern void
+gridRegular_restorePadding(gridRegular_t grid, int idxOfVar)
+{
+	dataVar_t var;
+
+	assert(grid != NULL);
+	assert(idxOfVar >= 0 && idxOfVar < varArr_getLength(grid->vars));
+
+	var = gridRegular_getVarHandle(grid, idxOfVar);
+	assert(!dataVar_isFFTWPadded(var));
+
+	dataVar_setFFTWPadded(var);
+	for (int i = 0; i < gridRegular_getNumPatches(grid); i++)
+		gridPatch_unpackVarData(gridRegular_getPatchHandle(grid, i),
+		                        idxOfVar);
+}
+
 extern int
 gridRegular_getNumPatches(gridRegular_t grid)
 {
@@ -176,6 +176,25 @@ gridRegular_getVarHandle(gridRegular_t grid, int idxOfVar);
 extern void
 gridRegular_freeVarData(gridRegular_t grid, int idxOfVarData);
 
+/**
+ * @brief  Stores an FFTW padded variable without padding in all patches
+ *         and clears its padding flag.
+ *
+ * @return  Returns @c true if the variable was padded, @c false if
+ *          nothing had to be done.
+ */
+extern bool
+gridRegular_removePadding(gridRegular_t grid, int idxOfVar);
+
+/**
+ * @brief  Reverts gridRegular_removePadding() for a variable.
+ *
+ * The data of the patches must still be held in the buffers of padded size
+ * in which gridRegular_removePadding() packed them.
+ */
+extern void
+gridRegular_restorePadding(gridRegular_t grid, int idxOfVar);
+
 
 /** @} */
 
@@ -6,15 +6,16 @@
 /*--- Includes ----------------------------------------------------------*/
 #include "gridConfig.h"
 #include "gridRegularDistrib.h"
+#include "gridUtil.h"
 #include <assert.h>
 #ifdef WITH_MPI
-#  include "gridUtil.h"
 #  include "../libutil/varArr.h"
 #  include "../libutil/commScheme.h"
 #  include "../libutil/commSchemeBuffer.h"
 #  include <mpi.h>
 #endif
 #include "../libutil/xmem.h"
+#include "../libutil/profile.h"
 #ifdef WITH_MPITRACE
 #  include <mpitrace_user_events.h>
 #endif
@@ -94,6 +95,16 @@ local_transposeGetRecvLayout(gridPointUint32_t dims,
                              int               fn,
                              int               fd);
 
+static varArr_t
+local_transposeGetLayout(gridPointUint32_t dims,
+                         gridPointInt_t    nProcs,
+                         gridPointInt_t    pPos,
+                         int               t0,
+                         int               t1,
+                         int               fn,
+                         int               fd,
+                         bool              isSend);
+
 static void
 local_transposeAllVarsAtPatch(gridPatch_t    patch,
                               gridPatch_t    patchT,
@@ -242,6 +253,14 @@ gridRegularDistrib_getGlobalComm(gridRegularDistrib_t distrib)
 	return distrib->commGlobal;
 }
 
+extern MPI_Comm
+gridRegularDistrib_getCartComm(gridRegularDistrib_t distrib)
+{
+	assert(distrib != NULL);
+
+	return distrib->commCart;
+}
+
 #endif
 
 extern int
@@ -351,7 +370,7 @@ gridRegularDistrib_setFactorFromDim(gridRegularDistrib_t distrib,
                                     int                  dim1D_current,
                                     int                  dim1D_proto)
 {
-	assert(dim1D_current > dim1D_proto);
+	assert(dim1D_current >= dim1D_proto);
 	int a = dim1D_current;
 	int b = dim1D_proto;
 	while(a && b) {
@@ -373,6 +392,88 @@ gridRegularDistrib_getFactor(gridRegularDistrib_t distrib,
 	*factor_denominator = distrib->factor_denominator;
 }
 
+extern uint32_t
+gridRegularDistrib_calcTransposeLayout(const gridPointUint32_t dims,
+                                       const gridPointInt_t    nProcs,
+                                       const gridPointInt_t    pPos,
+                                       int                     t0,
+                                       int                     t1,
+                                       int                     fn,
+                                       int                     fd,
+                                       bool                    isSend,
+                                       gridPointUint32_t       *idxLo,
+                                       gridPointUint32_t       *idxHi,
+                                       gridPointInt_t          *procCoords)
+{
+	gridPointUint32_t loMine, hiMine, lo, hi, loS, hiS;
+	gridPointInt_t    p;
+	uint32_t          num = 0;
+
+	assert(idxLo != NULL && idxHi != NULL && procCoords != NULL);
+
+	for (int i = 0; i < NDIM; i++) {
+		gridRegularDistrib_calcIdxsForRank1D(dims[i], nProcs[i], pPos[i],
+		                                     loMine + i, hiMine + i,
+		                                     fn, fd);
+		loS[i] = loMine[i];
+		hiS[i] = hiMine[i];
+		p[i]   = pPos[i];
+	}
+
+	if (!isSend) {
+		gridRegularDistrib_calcIdxsForRank1D(dims[t0], nProcs[t1], pPos[t1],
+		                                     loMine + t0, hiMine + t0,
+		                                     fn, fd);
+		gridRegularDistrib_calcIdxsForRank1D(dims[t1], nProcs[t0], pPos[t0],
+		                                     loMine + t1, hiMine + t1,
+		                                     fn, fd);
+	}
+
+	for (p[t1] = 0; p[t1] < nProcs[t1]; p[t1]++) {
+		bool hit;
+		if (isSend) {
+			gridRegularDistrib_calcIdxsForRank1D(dims[t0], nProcs[t1], p[t1],
+			                                     lo + t1, hi + t1, fn, fd);
+			hit = gridUtil_intersection1D(loMine[t0], hiMine[t0],
+			                              lo[t1], hi[t1], loS, hiS);
+		} else {
+			gridRegularDistrib_calcIdxsForRank1D(dims[t1], nProcs[t1], p[t1],
+			                                     lo + t1, hi + t1, fn, fd);
+			hit = gridUtil_intersection1D(loMine[t1], hiMine[t1],
+			                              lo[t1], hi[t1], loS + t1,
+			                              hiS + t1);
+		}
+		if (!hit)
+			continue;
+		for (p[t0] = 0; p[t0] < nProcs[t0]; p[t0]++) {
+			if (isSend) {
+				gridRegularDistrib_calcIdxsForRank1D(dims[t1], nProcs[t0],
+				                                     p[t0], lo + t0, hi + t0,
+				                                     fn, fd);
+				hit = gridUtil_intersection1D(loMine[t1], hiMine[t1],
+				                              lo[t0], hi[t0], loS + t1,
+				                              hiS + t1);
+			} else {
+				gridRegularDistrib_calcIdxsForRank1D(dims[t0], nProcs[t0],
+				                                     p[t0], lo + t0, hi + t0,
+				                                     fn, fd);
+				hit = gridUtil_intersection1D(loMine[t0], hiMine[t0],
+				                              lo[t0], hi[t0], loS, hiS);
+			}
+			if (hit) {
+				for (int i = 0; i < NDIM; i++) {
+					idxLo[num][i]      = loS[i];
+					idxHi[num][i]      = hiS[i];
+					procCoords[num][i] = p[i];
+				}
+				num++;
+			}
+		}
+	}
+
+	return num;
+} /* gridRegularDistrib_calcTransposeLayout */
+
 extern void
 gridRegularDistrib_transpose(gridRegularDistrib_t distrib,
                              int                  dimA,
@@ -432,9 +533,16 @@ local_transposeMPI(gridRegularDistrib_t distrib,
 	gridPatch_t patch, patchT;
 	varArr_t    sendLayout;
 	varArr_t    recvLayout;
+	uint64_t    numBytes = 0;
 
+	profile_enter("transpose");
 	local_transposeMPIInit(distrib, dimA, dimB,
 	                       &patch, &patchT, &sendLayout, &recvLayout);
+	for (int i = 0; i < gridPatch_getNumVars(patch); i++) {
+		dataVar_t var = gridPatch_getVarHandle(patch, i);
+		numBytes += gridPatch_getNumCellsActual(patch, i)
+		            * dataVar_getSizePerElement(var);
+	}
 
 	local_transposeAllVarsAtPatch(patch, patchT, distrib->commCart,
 	                              sendLayout, recvLayout);
@@ -443,6 +551,8 @@ local_transposeMPI(gridRegularDistrib_t distrib,
 	gridRegular_replacePatch(distrib->grid, 0, patchT);
 
 	local_transposeMPIClean(sendLayout, recvLayout);
+	profile_addBytes(numBytes);
+	profile_leave();
 }
 
 static void
@@ -527,9 +637,6 @@ local_transposeGetPatchT(gridPointUint32_t dims,
 	return gridPatch_new(idxLo, idxHi);
 }
 
-#  define getIdx gridRegularDistrib_calcIdxsForRank1D
-#  define is     gridUtil_intersection1D
-#  define vAi    varArr_insert
 static varArr_t
 local_transposeGetSendLayout(gridPointUint32_t dims,
                              gridPointInt_t    nProcs,
@@ -539,31 +646,8 @@ local_transposeGetSendLayout(gridPointUint32_t dims,
                              int               fn,
                              int               fd)
 {
-	gridPointUint32_t loMine, hiMine, lo, hi, loS, hiS;
-	gridPointInt_t    p;
-	varArr_t          layout = varArr_new(nProcs[t0] * nProcs[t1] / 20);
-
-	for (int i = 0; i < NDIM; i++) {
-		getIdx(dims[i], nProcs[i], pPos[i], loMine + i, hiMine + i, fn, fd);
-		loS[i] = loMine[i];
-		hiS[i] = hiMine[i];
-		p[i]   = pPos[i];
-	}
-
-	for (p[t1] = 0; p[t1] < nProcs[t1]; p[t1]++) {
-		getIdx(dims[t0], nProcs[t1], p[t1], lo + t1, hi + t1, fn, fd);
-		if (is(loMine[t0], hiMine[t0], lo[t1], hi[t1], loS, hiS)) {
-			for (p[t0] = 0; p[t0] < nProcs[t0]; p[t0]++) {
-				getIdx(dims[t1], nProcs[t0], p[t0], lo + t0, hi + t0, fn, fd);
-				if (is(loMine[t1], hiMine[t1], lo[t0], hi[t0], loS + t1,
-				       hiS + t1)) {
-					// i, j is the process we need to send loS,hiS to
-					vAi(layout, local_layoutElement_new(loS, hiS, p));
-				}
-			}
-		}
-	}
-	return layout;
+	return local_transposeGetLayout(dims, nProcs, pPos, t0, t1, fn, fd,
+	                                true);
 }
 
 static varArr_t
@@ -575,38 +659,45 @@ local_transposeGetRecvLayout(gridPointUint32_t dims,
                              int               fn,
                              int               fd)
 {
-	gridPointUint32_t loMine, hiMine, lo, hi, loS, hiS;
-	gridPointInt_t    p;
-	varArr_t          layout = varArr_new(nProcs[t0] * nProcs[t1] / 20);
+	return local_transposeGetLayout(dims, nProcs, pPos, t0, t1, fn, fd,
+	                                false);
+}
 
-	for (int i = 0; i < NDIM; i++) {
-		getIdx(dims[i], nProcs[i], pPos[i], loMine + i, hiMine + i, fn, fd);
-		loS[i] = loMine[i];
-		hiS[i] = hiMine[i];
-		p[i]   = pPos[i];
-	}
+static varArr_t
+local_transposeGetLayout(gridPointUint32_t dims,
+                         gridPointInt_t    nProcs,
+                         gridPointInt_t    pPos,
+                         int               t0,
+                         int               t1,
+                         int               fn,
+                         int               fd,
+                         bool              isSend)
+{
+	int               maxNum = nProcs[t0] * nProcs[t1];
+	uint32_t          num;
+	gridPointUint32_t *idxLo, *idxHi;
+	gridPointInt_t    *procCoords;
+	varArr_t          layout = varArr_new(maxNum / 20);
+
+	idxLo      = xmalloc(sizeof(gridPointUint32_t) * maxNum);
+	idxHi      = xmalloc(sizeof(gridPointUint32_t) * maxNum);
+	procCoords = xmalloc(sizeof(gridPointInt_t) * maxNum);
+
+	num = gridRegularDistrib_calcTransposeLayout(dims, nProcs, pPos,
+	                                             t0, t1, fn, fd, isSend,
+	                                             idxLo, idxHi, procCoords);
+	for (uint32_t i = 0; i < num; i++)
+		(void)varArr_insert(layout,
+		                    local_layoutElement_new(idxLo[i], idxHi[i],
+		                                            procCoords[i]));
+
+	xfree(procCoords);
+	xfree(idxHi);
+	xfree(idxLo);
 
-	getIdx(dims[t0], nProcs[t1], pPos[t1], loMine + t0, hiMine + t0, fn, fd);
-	getIdx(dims[t1], nProcs[t0], pPos[t0], loMine + t1, hiMine + t1, fn, fd);
-	for (p[t1] = 0; p[t1] < nProcs[t1]; p[t1]++) {
-		getIdx(dims[t1], nProcs[t1], p[t1], lo + t1, hi + t1, fn, fd);
-		if (is(loMine[t1], hiMine[t1], lo[t1], hi[t1], loS + t1, hiS
-		       + t1)) {
-			for (p[t0] = 0; p[t0] < nProcs[t0]; p[t0]++) {
-				getIdx(dims[t0], nProcs[t0], p[t0], lo + t0, hi + t0, fn, fd);
-				if (is(loMine[t0], hiMine[t0], lo[t0], hi[t0], loS, hiS)) {
-					// i, j is the process we will receive loS,hiS from
-					vAi(layout, local_layoutElement_new(loS, hiS, p));
-				}
-			}
-		}
-	}
 	return layout;
 }
 
-#  undef vAi
-#  undef intersect
-#  undef getIdx
 
 static void
 local_transposeAllVarsAtPatch(gridPatch_t    patch,
@@ -21,6 +21,7 @@
 #include "gridRegular.h"
 #include "gridPatch.h"
 #include <stdint.h>
+#include <stdbool.h>
 #ifdef WITH_MPI
 #  include <mpi.h>
 #endif
@@ -123,6 +124,22 @@ gridRegularDistrib_getProcCoords(gridRegularDistrib_t distrib,
 extern MPI_Comm
 gridRegularDistrib_getGlobalComm(gridRegularDistrib_t distrib);
 
+/**
+ * @brief  Retrieves the Cartesian communicator of the distribution.
+ *
+ * The ranks returned by gridRegularDistrib_getLocalRank() and used by
+ * gridRegularDistrib_getPatchForRank() refer to this communicator, which
+ * may differ from the global communicator due to rank reordering.
+ *
+ * @param[in]  distrib
+ *                The distribution object to query.  Passing @c NULL is
+ *                undefined.
+ *
+ * @return  Returns the Cartesian communicator.
+ */
+extern MPI_Comm
+gridRegularDistrib_getCartComm(gridRegularDistrib_t distrib);
+
 #endif
 
 extern int
@@ -180,6 +197,56 @@ gridRegularDistrib_getFactor(gridRegularDistrib_t distrib,
                              int                  *factor_numerator,
                              int                  *factor_denominator);
 
+/**
+ * @brief  Calculates the windows a process exchanges in a transposition.
+ *
+ * This is the layout used by gridRegularDistrib_transpose(), it does not
+ * require MPI and may hence also be used to size the communication
+ * buffers up front.
+ *
+ * @param[in]   dims
+ *                 The dimensions of the grid before the transposition.
+ * @param[in]   nProcs
+ *                 The process grid.
+ * @param[in]   pPos
+ *                 The coordinates of the process in the process grid.
+ * @param[in]   t0
+ *                 The dimension to exchange.
+ * @param[in]   t1
+ *                 The dimension to exchange with.
+ * @param[in]   fn
+ *                 The numerator of the distribution factor.
+ * @param[in]   fd
+ *                 The denominator of the distribution factor.
+ * @param[in]   isSend
+ *                 Selects whether the windows that are sent (in the
+ *                 untransposed grid) or the windows that are received
+ *                 (in the transposed grid) are calculated.
+ * @param[out]  *idxLo
+ *                 Receives the lower indices of the windows, must have
+ *                 room for <tt>nProcs[t0] * nProcs[t1]</tt> elements.
+ * @param[out]  *idxHi
+ *                 Receives the upper indices of the windows, like
+ *                 @c idxLo.
+ * @param[out]  *procCoords
+ *                 Receives the coordinates of the partner processes,
+ *                 like @c idxLo.
+ *
+ * @return  Returns the number of windows.
+ */
+extern uint32_t
+gridRegularDistrib_calcTransposeLayout(const gridPointUint32_t dims,
+                                       const gridPointInt_t    nProcs,
+                                       const gridPointInt_t    pPos,
+                                       int                     t0,
+                                       int                     t1,
+                                       int                     fn,
+                                       int                     fd,
+                                       bool                    isSend,
+                                       gridPointUint32_t       *idxLo,
+                                       gridPointUint32_t       *idxHi,
+                                       gridPointInt_t          *procCoords);
+
 /**
  * @brief  Performs a transposition of the distributed grid.
  *
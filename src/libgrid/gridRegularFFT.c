@@ -33,6 +33,9 @@
 static void
 local_getFFTedThings(gridRegularFFT_t fft);
 
+static void *
+local_getDataOut(gridRegularFFT_t fft, int direction);
+
 
 #if (defined WITH_MPI)
 static void
@@ -95,6 +98,7 @@ gridRegularFFT_new(gridRegular_t        grid,
 	local_initMPIStuff(fft);
 #endif
 	local_getFFTedThings(fft);
+	fft->isInPlace = dataVar_isFFTWPadded(fft->var);
 #if (defined WITH_FFT_FFTW3)
 	fft->norm = 1. / ((double)gridRegular_getNumCellsTotal(grid));
 #endif
@@ -149,6 +153,53 @@ gridRegularFFT_execute(gridRegularFFT_t fft, int direction)
 	return result;
 }
 
+extern void
+gridRegularFFT_calcIdxsForPhases(const gridPointUint32_t dims,
+                                 const gridPointInt_t    nProcs,
+                                 const gridPointInt_t    procCoords,
+                                 int                     fn,
+                                 int                     fd,
+                                 gridPointUint32_t       globalDims[NDIM],
+                                 gridPointUint32_t       idxLo[NDIM],
+                                 gridPointUint32_t       idxHi[NDIM])
+{
+	for (int j = 0; j < NDIM; j++)
+		globalDims[0][j] = dims[j];
+	globalDims[0][0] = dims[0] / 2 + 1;
+
+	for (int i = 1; i < NDIM; i++) {
+		uint32_t tmp;
+		for (int j = 0; j < NDIM; j++) {
+			globalDims[i][j] = globalDims[i - 1][j];
+		}
+		tmp                     = globalDims[i][i % NDIM];
+		globalDims[i][i % NDIM] = globalDims[i][0];
+		globalDims[i][0]        = tmp;
+	}
+
+	for (int i = 0; i < NDIM; i++) {
+		for (int j = 0; j < NDIM; j++) {
+			// The r2c dimension is never rescaled.
+			if (globalDims[i][j] == globalDims[0][0])
+				gridRegularDistrib_calcIdxsForRank1D(globalDims[i][j],
+				                                     nProcs[j],
+				                                     procCoords[j],
+				                                     idxLo[i] + j,
+				                                     idxHi[i] + j,
+				                                     1,
+				                                     1);
+			else
+				gridRegularDistrib_calcIdxsForRank1D(globalDims[i][j],
+				                                     nProcs[j],
+				                                     procCoords[j],
+				                                     idxLo[i] + j,
+				                                     idxHi[i] + j,
+				                                     fn,
+				                                     fd);
+		}
+	}
+} /* gridRegularFFT_calcIdxsForPhases */
+
 /*--- Implementations of local functions --------------------------------*/
 static void
 local_getFFTedThings(gridRegularFFT_t fft)
@@ -180,58 +231,64 @@ local_getFFTedThings(gridRegularFFT_t fft)
 	                                                     rank);
 	fft->varFFTed   = dataVar_clone(fft->var);
 	dataVar_setComplexified(fft->varFFTed);
+	dataVar_unsetFFTWPadded(fft->varFFTed);
 	gridRegular_attachPatch(fft->gridFFTed, fft->patchFFTed);
 	fft->idxFFTVarFFTed = gridRegular_attachVar(fft->gridFFTed,
 	                                            fft->varFFTed);
 }
 
+static void *
+local_getDataOut(gridRegularFFT_t fft, int direction)
+{
+	gridPatch_t patchIn, patchOut;
+	int         idxIn, idxOut;
+	void        *data;
+
+	if (direction == GRIDREGULARFFT_FORWARD) {
+		patchIn  = fft->patch;
+		idxIn    = fft->idxFFTVar;
+		patchOut = fft->patchFFTed;
+		idxOut   = fft->idxFFTVarFFTed;
+	} else {
+		patchIn  = fft->patchFFTed;
+		idxIn    = fft->idxFFTVarFFTed;
+		patchOut = fft->patch;
+		idxOut   = fft->idxFFTVar;
+	}
+
+	if (!fft->isInPlace)
+		return gridPatch_getVarDataHandle(patchOut, idxOut);
+
+	// The padded real data and the complex data have the same size, so
+	// the buffer is simply handed over to the other patch.
+	data = gridPatch_getVarDataHandle(patchIn, idxIn);
+	(void)gridPatch_popVarData(patchIn, idxIn);
+	gridPatch_replaceVarData(patchOut, idxOut, data);
+
+	return data;
+}
+
 #if (defined WITH_MPI)
 static void
 local_initMPIStuff(gridRegularFFT_t fft)
 {
-	int fn, fd;
-	gridPointInt_t procCoords;
-	gridRegularDistrib_getFactor(fft->distrib, &fn, &fd);
+	int               fn, fd;
+	gridPointInt_t    procCoords;
+	gridPointUint32_t dims;
 
+	gridRegularDistrib_getFactor(fft->distrib, &fn, &fd);
 	gridRegularDistrib_getProcCoords(fft->distrib, procCoords);
-	gridRegular_getDims(fft->grid, fft->globalDims[0]);
+	gridRegular_getDims(fft->grid, dims);
 
-	fft->localNumRealElements = fft->globalDims[0][0];
-	fft->globalDims[0][0]     = fft->globalDims[0][0] / 2 + 1;
+	fft->localNumRealElements = dims[0];
+	gridRegularFFT_calcIdxsForPhases(dims, fft->nProcs, procCoords, fn, fd,
+	                                 fft->globalDims, fft->localIdxLo,
+	                                 fft->localIdxHi);
 
-	for (int i = 1; i < NDIM; i++) {
-		uint32_t tmp;
-		for (int j = 0; j < NDIM; j++) {
-			fft->globalDims[i][j] = fft->globalDims[i - 1][j];
-		}
-		tmp                          = fft->globalDims[i][i % NDIM];
-		fft->globalDims[i][i % NDIM] = fft->globalDims[i][0];
-		fft->globalDims[i][0]        = tmp;
-	}
-
-	for (int i = 0; i < NDIM; i++) {
-		for (int j = 0; j < NDIM; j++) {
-			//printf("%i %i",i,j);
-			if(fft->globalDims[i][j] == fft->globalDims[0][0])
-				gridRegularDistrib_calcIdxsForRank1D(fft->globalDims[i][j],
-													 fft->nProcs[j],
-													 procCoords[j],
-													 fft->localIdxLo[i] + j,
-													 fft->localIdxHi[i] + j,
-													 1,
-													 1);
-			else
-				gridRegularDistrib_calcIdxsForRank1D(fft->globalDims[i][j],
-													 fft->nProcs[j],
-													 procCoords[j],
-													 fft->localIdxLo[i] + j,
-													 fft->localIdxHi[i] + j,
-													 fn,
-													 fd);
+	for (int i = 0; i < NDIM; i++)
+		for (int j = 0; j < NDIM; j++)
 			fft->localDims[i][j] = fft->localIdxHi[i][j]
 			                       - fft->localIdxLo[i][j] + 1;
-		}
-	}
 }
 
 #endif
@@ -246,15 +303,12 @@ local_doFFTCompletelyLocal(gridRegularFFT_t fft, int direction)
 	void              *dataIn;
 	void              *dataOut;
 
-	if (direction == GRIDREGULARFFT_FORWARD) {
-		dataIn  = gridPatch_getVarDataHandle(fft->patch, fft->idxFFTVar);
-		dataOut = gridPatch_getVarDataHandle(fft->patchFFTed,
-		                                     fft->idxFFTVarFFTed);
-	} else {
-		dataIn  = gridPatch_getVarDataHandle(fft->patchFFTed,
-		                                     fft->idxFFTVarFFTed);
-		dataOut = gridPatch_getVarDataHandle(fft->patch, fft->idxFFTVar);
-	}
+	if (direction == GRIDREGULARFFT_FORWARD)
+		dataIn = gridPatch_getVarDataHandle(fft->patch, fft->idxFFTVar);
+	else
+		dataIn = gridPatch_getVarDataHandle(fft->patchFFTed,
+		                                    fft->idxFFTVarFFTed);
+	dataOut = local_getDataOut(fft, direction);
 
 	// We always need the non-complex dimensions
 	gridPatch_getDims(fft->patch, dims);
@@ -291,10 +345,12 @@ local_doFFTCompletelyLocal(gridRegularFFT_t fft, int direction)
 		fftw_destroy_plan(plan);
 	}
 
-	if (direction == GRIDREGULARFFT_FORWARD)
-		gridPatch_freeVarData(fft->patch, fft->idxFFTVar);
-	else
-		gridPatch_freeVarData(fft->patchFFTed, fft->idxFFTVarFFTed);
+	if (!fft->isInPlace) {
+		if (direction == GRIDREGULARFFT_FORWARD)
+			gridPatch_freeVarData(fft->patch, fft->idxFFTVar);
+		else
+			gridPatch_freeVarData(fft->patchFFTed, fft->idxFFTVarFFTed);
+	}
 
 	return dataOut;
 #  endif
@@ -325,14 +381,12 @@ local_doFFTParallelForward(gridRegularFFT_t fft)
 	fft->patchFFTed = gridRegular_getPatchHandle(fft->gridFFTed, 0);
 	result          = local_doFFTParallelC2CPencil(fft, 1,
 	                                               GRIDREGULARFFT_FORWARD);
-	gridPatch_replaceVarData(fft->patchFFTed, fft->idxFFTVarFFTed, result);
 
 #  if (NDIM > 2)
 	gridRegularDistrib_transpose(fft->distribFFTed, 0, 2);
 	fft->patchFFTed = gridRegular_getPatchHandle(fft->gridFFTed, 0);
 	result          = local_doFFTParallelC2CPencil(fft, 2,
 	                                               GRIDREGULARFFT_FORWARD);
-	gridPatch_replaceVarData(fft->patchFFTed, fft->idxFFTVarFFTed, result);
 #  endif
 
 	return result;
@@ -344,15 +398,12 @@ local_doFFTParallelBackward(gridRegularFFT_t fft)
 	void *result;
 
 #  if (NDIM > 2)
-	result = local_doFFTParallelC2CPencil(fft, 2, GRIDREGULARFFT_BACKWARD);
-	gridPatch_replaceVarData(fft->patchFFTed, fft->idxFFTVarFFTed, result);
+	(void)local_doFFTParallelC2CPencil(fft, 2, GRIDREGULARFFT_BACKWARD);
 
 	gridRegularDistrib_transpose(fft->distribFFTed, 0, 2);
 	fft->patchFFTed = gridRegular_getPatchHandle(fft->gridFFTed, 0);
 #  endif
-	result          = local_doFFTParallelC2CPencil(fft, 1,
-	                                               GRIDREGULARFFT_BACKWARD);
-	gridPatch_replaceVarData(fft->patchFFTed, fft->idxFFTVarFFTed, result);
+	(void)local_doFFTParallelC2CPencil(fft, 1, GRIDREGULARFFT_BACKWARD);
 
 	gridRegularDistrib_transpose(fft->distribFFTed, 0, 1);
 	fft->patchFFTed = gridRegular_getPatchHandle(fft->gridFFTed, 0);
@@ -364,11 +415,15 @@ local_doFFTParallelBackward(gridRegularFFT_t fft)
 static void *
 local_doFFTParallelR2CPencil(gridRegularFFT_t fft)
 {
-	int  howmany  = 1;
-	void *dataIn  = gridPatch_getVarDataHandle(fft->patch,
-	                                           fft->idxFFTVar);
-	void *dataOut = gridPatch_getVarDataHandle(fft->patchFFTed,
-	                                           fft->idxFFTVarFFTed);
+	int  howmany = 1;
+	int  distReal;
+	void *dataIn;
+	void *dataOut;
+
+	dataIn   = gridPatch_getVarDataHandle(fft->patch, fft->idxFFTVar);
+	dataOut  = local_getDataOut(fft, GRIDREGULARFFT_FORWARD);
+	distReal = fft->isInPlace ? 2 * fft->localDims[0][0]
+	           : fft->localNumRealElements;
 
 	for (int i = 1; i < NDIM; i++)
 		howmany *= fft->localDims[0][i];
@@ -380,7 +435,7 @@ local_doFFTParallelR2CPencil(gridRegularFFT_t fft)
 		fftwf_plan plan;
 		plan = fftwf_plan_many_dft_r2c(1, &(fft->localNumRealElements),
 		                               howmany, (float *)dataIn,
-		                               NULL, 1, fft->localNumRealElements,
+		                               NULL, 1, distReal,
 		                               (fftwf_complex *)dataOut,
 		                               NULL, 1, fft->localDims[0][0],
 		                               FFTW_ESTIMATE);
@@ -390,7 +445,7 @@ local_doFFTParallelR2CPencil(gridRegularFFT_t fft)
 		fftw_plan plan;
 		plan = fftw_plan_many_dft_r2c(1, &(fft->localNumRealElements),
 		                              howmany, (double *)dataIn,
-		                              NULL, 1, fft->localNumRealElements,
+		                              NULL, 1, distReal,
 		                              (fftw_complex *)dataOut,
 		                              NULL, 1, fft->localDims[0][0],
 		                              FFTW_ESTIMATE);
@@ -400,7 +455,8 @@ local_doFFTParallelR2CPencil(gridRegularFFT_t fft)
 #  ifdef WITH_MPITRACE
 	MPItrace_event(LOCAL_MPITRACE_EVENT, 0);
 #  endif
-	gridPatch_freeVarData(fft->patch, fft->idxFFTVar);
+	if (!fft->isInPlace)
+		gridPatch_freeVarData(fft->patch, fft->idxFFTVar);
 
 	return dataOut;
 } /* local_doFFTParallelR2CPencil */
@@ -408,11 +464,16 @@ local_doFFTParallelR2CPencil(gridRegularFFT_t fft)
 static void *
 local_doFFTParallelC2RPencil(gridRegularFFT_t fft)
 {
-	int  howmany  = 1;
-	void *dataIn  = gridPatch_getVarDataHandle(fft->patchFFTed,
-	                                           fft->idxFFTVarFFTed);
-	void *dataOut = gridPatch_getVarDataHandle(fft->patch,
-	                                           fft->idxFFTVar);
+	int  howmany = 1;
+	int  distReal;
+	void *dataIn;
+	void *dataOut;
+
+	dataIn   = gridPatch_getVarDataHandle(fft->patchFFTed,
+	                                      fft->idxFFTVarFFTed);
+	dataOut  = local_getDataOut(fft, GRIDREGULARFFT_BACKWARD);
+	distReal = fft->isInPlace ? 2 * fft->localDims[0][0]
+	           : fft->localNumRealElements;
 
 	for (int i = 1; i < NDIM; i++)
 		howmany *= fft->localDims[0][i];
@@ -426,7 +487,7 @@ local_doFFTParallelC2RPencil(gridRegularFFT_t fft)
 		                               howmany, (fftwf_complex *)dataIn,
 		                               NULL, 1, fft->localDims[0][0],
 		                               (float *)dataOut,
-		                               NULL, 1, fft->localNumRealElements,
+		                               NULL, 1, distReal,
 		                               FFTW_ESTIMATE);
 		fftwf_execute(plan);
 		fftwf_destroy_plan(plan);
@@ -436,7 +497,7 @@ local_doFFTParallelC2RPencil(gridRegularFFT_t fft)
 		                              howmany, (fftw_complex *)dataIn,
 		                              NULL, 1, fft->localDims[0][0],
 		                              (double *)dataOut,
-		                              NULL, 1, fft->localNumRealElements,
+		                              NULL, 1, distReal,
 		                              FFTW_ESTIMATE);
 		fftw_execute(plan);
 		fftw_destroy_plan(plan);
@@ -445,7 +506,8 @@ local_doFFTParallelC2RPencil(gridRegularFFT_t fft)
 	MPItrace_event(LOCAL_MPITRACE_EVENT, 0);
 #  endif
 
-	gridPatch_freeVarData(fft->patchFFTed, fft->idxFFTVarFFTed);
+	if (!fft->isInPlace)
+		gridPatch_freeVarData(fft->patchFFTed, fft->idxFFTVarFFTed);
 
 	return dataOut;
 } /* local_doFFTParallelC2RPencil */
@@ -454,7 +516,6 @@ static void *
 local_doFFTParallelC2CPencil(gridRegularFFT_t fft, int phase, int sign)
 {
 	int  howmany = 1;
-	void *result;
 	void *data   = gridPatch_getVarDataHandle(fft->patchFFTed,
 	                                          fft->idxFFTVarFFTed);
 
@@ -468,26 +529,22 @@ local_doFFTParallelC2CPencil(gridRegularFFT_t fft, int phase, int sign)
 #  endif
 	if (dataVarType_isNativeFloat(dataVar_getType(fft->var))) {
 		fftwf_plan plan;
-		result = fftwf_malloc(sizeof(fftwf_complex) * howmany
-		                      * fft->localDims[phase][0]);
-		plan   = fftwf_plan_many_dft(1, fft->localDims[phase],
-		                             howmany, (float complex *)data,
-		                             NULL, 1, fft->localDims[phase][0],
-		                             (fftwf_complex *)result,
-		                             NULL, 1, fft->localDims[phase][0],
-		                             sign, FFTW_ESTIMATE);
+		plan = fftwf_plan_many_dft(1, fft->localDims[phase],
+		                           howmany, (fftwf_complex *)data,
+		                           NULL, 1, fft->localDims[phase][0],
+		                           (fftwf_complex *)data,
+		                           NULL, 1, fft->localDims[phase][0],
+		                           sign, FFTW_ESTIMATE);
 		fftwf_execute(plan);
 		fftwf_destroy_plan(plan);
 	} else {
 		fftw_plan plan;
-		result = fftw_malloc(sizeof(fftw_complex) * howmany
-		                     * fft->localDims[phase][0]);
-		plan   = fftw_plan_many_dft(1, fft->localDims[phase],
-		                            howmany, (double complex *)data,
-		                            NULL, 1, fft->localDims[phase][0],
-		                            (fftw_complex *)result,
-		                            NULL, 1, fft->localDims[phase][0],
-		                            sign, FFTW_ESTIMATE);
+		plan = fftw_plan_many_dft(1, fft->localDims[phase],
+		                          howmany, (fftw_complex *)data,
+		                          NULL, 1, fft->localDims[phase][0],
+		                          (fftw_complex *)data,
+		                          NULL, 1, fft->localDims[phase][0],
+		                          sign, FFTW_ESTIMATE);
 		fftw_execute(plan);
 		fftw_destroy_plan(plan);
 	}
@@ -495,7 +552,7 @@ local_doFFTParallelC2CPencil(gridRegularFFT_t fft, int phase, int sign)
 	MPItrace_event(LOCAL_MPITRACE_EVENT, 0);
 #  endif
 
-	return result;
+	return data;
 } /* local_doFFTParallelC2CPencil */
 
 #endif
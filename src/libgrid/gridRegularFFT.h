@@ -39,4 +39,45 @@ gridRegularFFT_getNorm(const gridRegularFFT_t fft);
 extern void *
 gridRegularFFT_execute(gridRegularFFT_t fft, int direction);
 
+/**
+ * @brief  Calculates the complex patch a process holds in every phase of
+ *         a parallel FFT.
+ *
+ * Phase 0 is the r2c pencil, phase @c i is the pencil after the
+ * transposition of dimension 0 with dimension @c i.  This is used by
+ * the FFT itself and allows to size the buffers without setting up a
+ * grid.
+ *
+ * @param[in]   dims
+ *                 The real-space dimensions of the grid.
+ * @param[in]   nProcs
+ *                 The process grid, @c nProcs[0] must be 1.
+ * @param[in]   procCoords
+ *                 The coordinates of the process in the process grid.
+ * @param[in]   fn
+ *                 The numerator of the distribution factor.
+ * @param[in]   fd
+ *                 The denominator of the distribution factor.
+ * @param[out]  globalDims
+ *                 Receives the complex dimensions of the grid in every
+ *                 phase.
+ * @param[out]  idxLo
+ *                 Receives the lower indices of the local patch in every
+ *                 phase.
+ * @param[out]  idxHi
+ *                 Receives the upper indices of the local patch in every
+ *                 phase.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+gridRegularFFT_calcIdxsForPhases(const gridPointUint32_t dims,
+                                 const gridPointInt_t    nProcs,
+                                 const gridPointInt_t    procCoords,
+                                 int                     fn,
+                                 int                     fd,
+                                 gridPointUint32_t       globalDims[NDIM],
+                                 gridPointUint32_t       idxLo[NDIM],
+                                 gridPointUint32_t       idxHi[NDIM]);
+
 #endif
@@ -8,6 +8,7 @@
 
 /*--- Includes ----------------------------------------------------------*/
 #include "gridConfig.h"
+#include <stdbool.h>
 
 
 /*--- ADT implementation ------------------------------------------------*/
@@ -23,6 +24,7 @@ struct gridRegularFFT_struct {
 	int                  idxFFTVarFFTed;
 	dataVar_t            varFFTed;
 	gridPatch_t          patchFFTed;
+	bool                 isInPlace;
 	double               norm;
 #if (defined WITH_MPI)
 	gridPointUint32_t    globalDims[NDIM];
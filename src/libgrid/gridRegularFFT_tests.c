@@ -257,9 +257,7 @@ local_getFakeGrid(void)
 		dims[i]   = 32 + i;
 	}
 	var = dataVar_new("test", DATAVARTYPE_FPV, 1);
-#ifndef WITH_MPI
 	dataVar_setFFTWPadded(var);
-#endif
 #ifdef WITH_FFT_FFTW3
 #  ifdef ENABLE_DOUBLE
 	dataVar_setMemFuncs(var, &fftw_malloc, &fftw_free);
@@ -345,6 +343,7 @@ static bool
 local_testFFTResult(gridRegular_t grid, fpv_t *dataCpy)
 {
 	gridPointUint32_t dims;
+	gridPointUint32_t dimsActual;
 	gridPointUint32_t dimsGlobal;
 	uint64_t          normFac = 1;
 	uint64_t          offset  = UINT64_C(0);
@@ -355,6 +354,7 @@ local_testFFTResult(gridRegular_t grid, fpv_t *dataCpy)
 	dataVarType_t     varType = dataVar_getType(var);
 
 	gridPatch_getDims(patch, dims);
+	gridPatch_getDimsActual(patch, 0, dimsActual);
 	gridRegular_getDims(grid, dimsGlobal);
 
 	for (int i = 0; i < NDIM; i++)
@@ -368,6 +368,8 @@ local_testFFTResult(gridRegular_t grid, fpv_t *dataCpy)
 				sumSqr += tmp * tmp;
 				offset++;
 			}
+			// Skip the padding, it is not preserved by the FFT.
+			offset += dimsActual[0] - dims[0];
 		}
 	}
 #elif (NDIM == 2)
@@ -377,6 +379,7 @@ local_testFFTResult(gridRegular_t grid, fpv_t *dataCpy)
 			sumSqr += tmp * tmp;
 			offset++;
 		}
+		offset += dimsActual[0] - dims[0];
 	}
 #endif
 
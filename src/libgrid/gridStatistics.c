@@ -321,7 +321,7 @@ local_calcRegularMeanMinMax(gridStatistics_t           stat,
 	gridPatch_t myPatch;
 	dataVar_t   dataVar;
 	void        *data;
-	uint64_t    len;
+	uint64_t    len, stride, numRuns;
 	double      min, max;
 
 	for (int i = 0; i < numPatches; i++) {
@@ -335,10 +335,12 @@ local_calcRegularMeanMinMax(gridStatistics_t           stat,
 
 		dataVar = gridPatch_getVarHandle(myPatch, idxOfVar);
 		data    = gridPatch_getVarDataHandle(myPatch, idxOfVar);
-		len     = gridPatch_getNumCells(myPatch);
+		gridPatch_getVarRuns(myPatch, idxOfVar, &len, &stride, &numRuns);
 
-		local_calcProtoMeanMinMax(data, dataVar, len, &(stat->mean),
-		                          &min, &max);
+		for (uint64_t j = 0; j < numRuns; j++)
+			local_calcProtoMeanMinMax(
+			    dataVar_getPointerByOffset(dataVar, data, j * stride),
+			    dataVar, len, &(stat->mean), &min, &max);
 		stat->min = (stat->min > min) ? min : stat->min;
 		stat->max = (stat->max < max) ? max : stat->max;
 	}
@@ -366,7 +368,7 @@ local_calcRegularVarSkewKurt(gridStatistics_t           stat,
 	gridPatch_t myPatch;
 	dataVar_t   dataVar;
 	void        *data;
-	uint64_t    len;
+	uint64_t    len, stride, numRuns;
 
 	for (int i = 0; i < numPatches; i++) {
 		if (grid != NULL)
@@ -376,11 +378,13 @@ local_calcRegularVarSkewKurt(gridStatistics_t           stat,
 
 		dataVar = gridPatch_getVarHandle(myPatch, idxOfVar);
 		data    = gridPatch_getVarDataHandle(myPatch, idxOfVar);
-		len     = gridPatch_getNumCells(myPatch);
+		gridPatch_getVarRuns(myPatch, idxOfVar, &len, &stride, &numRuns);
 
-		local_calcProtoVarSkewKurt(data, dataVar, len, &(stat->var),
-		                           &(stat->skew), &(stat->kurt),
-		                           stat->mean);
+		for (uint64_t j = 0; j < numRuns; j++)
+			local_calcProtoVarSkewKurt(
+			    dataVar_getPointerByOffset(dataVar, data, j * stride),
+			    dataVar, len, &(stat->var), &(stat->skew), &(stat->kurt),
+			    stat->mean);
 	}
 
 	if (distrib != NULL) {
@@ -74,21 +74,59 @@ gridWriter_writeGridPatch(gridWriter_t   writer,
                           gridPointDbl_t origin,
                           gridPointDbl_t delta)
 {
+	int  numVars = gridPatch_getNumVars(patch);
+	bool *wasPadded;
+
 	assert(writer != NULL);
 	assert(writer->func->writeGridPatch != NULL);
 
+	// The writers expect rows without padding, the variable is unpacked
+	// in place and restored afterwards.
+	wasPadded = xmalloc(sizeof(bool) * numVars);
+	for (int i = 0; i < numVars; i++) {
+		dataVar_t var = gridPatch_getVarHandle(patch, i);
+		wasPadded[i] = dataVar_isFFTWPadded(var);
+		if (wasPadded[i]) {
+			gridPatch_packVarData(patch, i);
+			dataVar_unsetFFTWPadded(var);
+		}
+	}
+
 	writer->func->writeGridPatch(writer, patch, patchName, origin, delta);
+
+	for (int i = 0; i < numVars; i++) {
+		if (wasPadded[i]) {
+			dataVar_setFFTWPadded(gridPatch_getVarHandle(patch, i));
+			gridPatch_unpackVarData(patch, i);
+		}
+	}
+	xfree(wasPadded);
 }
 
 extern void
 gridWriter_writeGridRegular(gridWriter_t  writer,
                             gridRegular_t grid)
 {
+	int  numVars;
+	bool *wasPadded;
+
 	assert(writer != NULL);
 	assert(grid != NULL);
 	assert(writer->func->writeGridRegular != NULL);
 
+	// See gridWriter_writeGridPatch().
+	numVars   = gridRegular_getNumVars(grid);
+	wasPadded = xmalloc(sizeof(bool) * numVars);
+	for (int i = 0; i < numVars; i++)
+		wasPadded[i] = gridRegular_removePadding(grid, i);
+
 	writer->func->writeGridRegular(writer, grid);
+
+	for (int i = 0; i < numVars; i++) {
+		if (wasPadded[i])
+			gridRegular_restorePadding(grid, i);
+	}
+	xfree(wasPadded);
 }
 
 #ifdef WITH_MPI
@@ -102,6 +102,9 @@ gridWriter_deactivate(gridWriter_t writer);
 /**
  * @brief  This will write a patch to the file.
  *
+ * Variables stored with the FFTW padding are temporarily packed in place,
+ * the concrete writers always see rows without padding.
+ *
  * @param[in,out]  writer
  *                    The writer to use.
  * @param[in,out]  patch
@@ -127,6 +130,9 @@ gridWriter_writeGridPatch(gridWriter_t   writer,
 /**
  * @brief  This will write a regular grid to the file.
  *
+ * As gridWriter_writeGridPatch(), padded variables are packed in place for
+ * the duration of the call.
+ *
  * @param[in,out]  writer
  * @param[in,out]  grid
  *
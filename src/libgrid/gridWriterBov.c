@@ -0,0 +1,414 @@
+// Copyright (C) 2013, Steffen Knollmann
+// Released under the terms of the GNU General Public License version 3.
+// This file is part of `ginnungagap'.
+
+
+/*--- Doxygen file description ------------------------------------------*/
+
+/**
+ * @file libgrid/gridWriterBov.c
+ * @ingroup  libgridIOOutBov
+ * @brief  Implements the BOV writer.
+ */
+
+
+/*--- Includes ----------------------------------------------------------*/
+#include "gridConfig.h"
+#include "gridWriterBov.h"
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#ifdef WITH_MPI
+#  include <mpi.h>
+#endif
+#include "../libdata/dataVar.h"
+#include "gridPatch.h"
+#include "gridRegular.h"
+#include "gridPoint.h"
+#include "../libutil/xmem.h"
+#include "../libutil/diediedie.h"
+
+
+/*--- Implemention of main structure ------------------------------------*/
+#include "gridWriterBov_adt.h"
+
+
+/*--- Local variables ---------------------------------------------------*/
+
+/** @brief  Stores the functions table for the BOV writer. */
+static struct gridWriter_func_struct local_func
+    = {&gridWriterBov_del,
+	   &gridWriterBov_activate,
+	   &gridWriterBov_deactivate,
+	   &gridWriterBov_writeGridPatch,
+	   &gridWriterBov_writeGridRegular,
+#ifdef WITH_MPI
+	   &gridWriterBov_initParallel
+#endif
+	};
+
+/** @brief  Gives the default path of the output file. */
+static const char *local_defaultFileNamePath = NULL;
+
+/** @brief  Gives the default prefix of the output file. */
+static const char *local_defaultFileNamePrefix = "out";
+
+/** @brief  Gives the default qualifier of the output file. */
+static const char *local_defaultFileNameQualifier = NULL;
+
+/** @brief  Gives the default suffix of the output file. */
+static const char *local_defaultFileNameSuffix = ".bov";
+
+/** @brief  Gives the suffix of the raw data file. */
+static const char *local_dataFileNameSuffix = ".raw";
+
+
+/*--- Prototypes of local functions -------------------------------------*/
+
+/**
+ * @brief  Describes the variable in the BOV.
+ *
+ * @param[in,out]  bov
+ *                    The BOV to update.
+ * @param[in]      var
+ *                    The variable that is written.
+ *
+ * @return  Returns nothing.
+ */
+static void
+local_setBovVar(bov_t bov, const dataVar_t var);
+
+
+/**
+ * @brief  Translates the grid variable type to a BOV data format.
+ *
+ * @param[in]  type
+ *                The type of the grid variable.
+ *
+ * @return  Returns the corresponding BOV format.
+ */
+static bovFormat_t
+local_getBovTypeFromGridType(dataVarType_t type);
+
+
+/**
+ * @brief  Converts grid points to the three dimensions of a BOV.
+ *
+ * Missing dimensions get a lower index of @c 0 and a size of @c 1.
+ *
+ * @param[in]   idxLo
+ *                 The lower corner in the grid.
+ * @param[in]   dims
+ *                 The size in the grid.
+ * @param[out]  *idxLoBov
+ *                 Array of three values receiving the lower corner.
+ * @param[out]  *dimsBov
+ *                 Array of three values receiving the size.
+ *
+ * @return  Returns nothing.
+ */
+static void
+local_getBovIdxs(const gridPointUint32_t idxLo,
+                 const gridPointUint32_t dims,
+                 uint32_t                *idxLoBov,
+                 uint32_t                *dimsBov);
+
+
+/**
+ * @brief  Writes the first variable of a patch to the data file.
+ *
+ * @param[in,out]  writer
+ *                    The writer to use.
+ * @param[in]      patch
+ *                    The patch to write.
+ * @param[in]      isFullBrick
+ *                    Whether the patch is written as the full brick, or
+ *                    at its position in the grid.
+ *
+ * @return  Returns nothing.
+ */
+static void
+local_writePatchData(gridWriterBov_t writer,
+                     gridPatch_t     patch,
+                     bool            isFullBrick);
+
+
+/*--- Implementations of abstract functions -----------------------------*/
+extern void
+gridWriterBov_del(gridWriter_t *writer)
+{
+	assert(writer != NULL && *writer != NULL);
+	assert((*writer)->type == GRIDIO_TYPE_BOV);
+
+	gridWriter_free(*writer);
+	gridWriterBov_free((gridWriterBov_t)*writer);
+
+	xfree(*writer);
+	*writer = NULL;
+}
+
+extern void
+gridWriterBov_activate(gridWriter_t writer)
+{
+	gridWriterBov_t w = (gridWriterBov_t)writer;
+
+	assert(w != NULL);
+	assert(w->base.type == GRIDIO_TYPE_BOV);
+
+	if (!gridWriter_isActive(writer)) {
+		filename_t dataFileName = filename_clone(w->base.fileName);
+
+		filename_setPath(dataFileName, NULL);
+		filename_setSuffix(dataFileName, local_dataFileNameSuffix);
+		bov_setDataFileName(w->bov, filename_getFullName(dataFileName));
+		bov_setFileName(w->bov, filename_getFullName(w->base.fileName));
+		filename_del(&dataFileName);
+
+		w->mayOverwriteDataFile = gridWriter_getOverwriteFileIfExists(writer)
+		                          || gridWriter_hasBeenActivated(writer);
+
+		gridWriter_setIsActive(writer);
+	}
+}
+
+extern void
+gridWriterBov_deactivate(gridWriter_t writer)
+{
+	assert(writer != NULL);
+	assert(writer->type == GRIDIO_TYPE_BOV);
+
+	if (gridWriter_isActive(writer)) {
+#ifdef WITH_MPI
+		// The file is complete once every task has written its part.
+		MPI_Barrier(((gridWriterBov_t)writer)->mpiComm);
+#endif
+		gridWriter_setIsInactive(writer);
+	}
+}
+
+extern void
+gridWriterBov_writeGridPatch(gridWriter_t   writer,
+                             gridPatch_t    patch,
+                             const char     *patchName,
+                             gridPointDbl_t origin,
+                             gridPointDbl_t delta)
+{
+	gridWriterBov_t   w = (gridWriterBov_t)writer;
+	gridPointUint32_t idxLo, dims;
+	uint32_t          idxLoBov[3], dimsBov[3];
+	double            brickOrigin[3] = {0., 0., 0.};
+	double            brickSize[3]   = {1., 1., 1.};
+
+	assert(w != NULL);
+	assert(w->base.type == GRIDIO_TYPE_BOV);
+	assert(gridWriter_isActive(writer));
+	assert(patch != NULL);
+	assert(origin != NULL);
+	assert(delta != NULL);
+
+	gridPatch_getIdxLo(patch, idxLo);
+	gridPatch_getDims(patch, dims);
+	local_getBovIdxs(idxLo, dims, idxLoBov, dimsBov);
+	for (int i = 0; i < NDIM; i++) {
+		brickOrigin[i] = origin[i];
+		brickSize[i]   = delta[i] * dims[i];
+	}
+	bov_setDataSize(w->bov, dimsBov);
+	bov_setBrickOrigin(w->bov, brickOrigin);
+	bov_setBrickSize(w->bov, brickSize);
+	local_setBovVar(w->bov, gridPatch_getVarHandle(patch, 0));
+
+	bov_createDataFile(w->bov, w->mayOverwriteDataFile);
+	w->mayOverwriteDataFile = true;
+	local_writePatchData(w, patch, true);
+	bov_write(w->bov, NULL);
+}
+
+extern void
+gridWriterBov_writeGridRegular(gridWriter_t  writer,
+                               gridRegular_t grid)
+{
+	gridWriterBov_t   w    = (gridWriterBov_t)writer;
+	int               rank = 0;
+	gridPointUint32_t idxLo, dims;
+	gridPointDbl_t    origin, extent;
+	uint32_t          idxLoBov[3], dimsBov[3];
+	double            brickOrigin[3] = {0., 0., 0.};
+	double            brickSize[3]   = {1., 1., 1.};
+	int               numPatches;
+
+	assert(w != NULL);
+	assert(w->base.type == GRIDIO_TYPE_BOV);
+	assert(gridWriter_isActive(writer));
+	assert(grid != NULL);
+
+#ifdef WITH_MPI
+	MPI_Comm_rank(w->mpiComm, &rank);
+#endif
+
+	for (int i = 0; i < NDIM; i++)
+		idxLo[i] = 0;
+	gridRegular_getDims(grid, dims);
+	gridRegular_getOrigin(grid, origin);
+	gridRegular_getExtent(grid, extent);
+	local_getBovIdxs(idxLo, dims, idxLoBov, dimsBov);
+	for (int i = 0; i < NDIM; i++) {
+		brickOrigin[i] = origin[i];
+		brickSize[i]   = extent[i];
+	}
+	bov_setDataSize(w->bov, dimsBov);
+	bov_setBrickOrigin(w->bov, brickOrigin);
+	bov_setBrickSize(w->bov, brickSize);
+	local_setBovVar(w->bov, gridRegular_getVarHandle(grid, 0));
+
+	if (rank == 0)
+		bov_createDataFile(w->bov, w->mayOverwriteDataFile);
+	w->mayOverwriteDataFile = true;
+#ifdef WITH_MPI
+	MPI_Barrier(w->mpiComm);
+#endif
+
+	numPatches = gridRegular_getNumPatches(grid);
+	for (int i = 0; i < numPatches; i++)
+		local_writePatchData(w, gridRegular_getPatchHandle(grid, i), false);
+
+	if (rank == 0)
+		bov_write(w->bov, NULL);
+} /* gridWriterBov_writeGridRegular */
+
+#ifdef WITH_MPI
+extern void
+gridWriterBov_initParallel(gridWriter_t writer, MPI_Comm mpiComm)
+{
+	gridWriterBov_t w = (gridWriterBov_t)writer;
+
+	assert(w != NULL);
+	assert(w->base.type == GRIDIO_TYPE_BOV);
+
+	w->mpiComm = mpiComm;
+}
+
+#endif
+
+
+/*--- Implementations of final functions --------------------------------*/
+extern gridWriterBov_t
+gridWriterBov_new(void)
+{
+	gridWriterBov_t writer;
+
+	writer = gridWriterBov_alloc();
+
+	gridWriter_init((gridWriter_t)writer, GRIDIO_TYPE_BOV, &local_func);
+	gridWriterBov_init(writer);
+
+	return writer;
+}
+
+extern bov_t
+gridWriterBov_getBov(const gridWriterBov_t writer)
+{
+	assert(writer != NULL);
+
+	return writer->bov;
+}
+
+/*--- Implementations of protected functions ----------------------------*/
+extern gridWriterBov_t
+gridWriterBov_alloc(void)
+{
+	gridWriterBov_t writer;
+
+	writer = xmalloc(sizeof(struct gridWriterBov_struct));
+
+	return writer;
+}
+
+extern void
+gridWriterBov_init(gridWriterBov_t writer)
+{
+	gridWriter_setFileName((gridWriter_t)writer,
+	                       filename_newFull(local_defaultFileNamePath,
+	                                        local_defaultFileNamePrefix,
+	                                        local_defaultFileNameQualifier,
+	                                        local_defaultFileNameSuffix));
+
+	writer->bov                  = bov_new();
+	writer->mayOverwriteDataFile = false;
+#ifdef WITH_MPI
+	writer->mpiComm              = MPI_COMM_WORLD;
+#endif
+}
+
+extern void
+gridWriterBov_free(gridWriterBov_t writer)
+{
+	if (writer->bov != NULL)
+		bov_del(&(writer->bov));
+}
+
+/*--- Implementations of local functions --------------------------------*/
+static void
+local_setBovVar(bov_t bov, const dataVar_t var)
+{
+	bov_setVarName(bov, dataVar_getName(var));
+	bov_setDataFormat(bov, local_getBovTypeFromGridType(dataVar_getType(var)));
+	bov_setDataComponents(bov, dataVar_getNumComponents(var));
+}
+
+static bovFormat_t
+local_getBovTypeFromGridType(dataVarType_t type)
+{
+	bovFormat_t typeAsBovType;
+
+	if (type == DATAVARTYPE_INT) {
+		typeAsBovType = BOV_FORMAT_INT;
+	} else if (type == DATAVARTYPE_INT8) {
+		typeAsBovType = BOV_FORMAT_BYTE;
+	} else if (type == DATAVARTYPE_DOUBLE) {
+		typeAsBovType = BOV_FORMAT_DOUBLE;
+	} else if (type == DATAVARTYPE_FPV) {
+		if (dataVarType_isNativeFloat(type))
+			typeAsBovType = BOV_FORMAT_FLOAT;
+		else
+			typeAsBovType = BOV_FORMAT_DOUBLE;
+	} else {
+		fprintf(stderr, "Grid type not compatible with bov type.\n");
+		diediedie(EXIT_FAILURE);
+	}
+
+	return typeAsBovType;
+}
+
+static void
+local_getBovIdxs(const gridPointUint32_t idxLo,
+                 const gridPointUint32_t dims,
+                 uint32_t                *idxLoBov,
+                 uint32_t                *dimsBov)
+{
+	for (int i = 0; i < 3; i++) {
+		idxLoBov[i] = (i < NDIM) ? idxLo[i] : 0;
+		dimsBov[i]  = (i < NDIM) ? dims[i] : 1;
+	}
+}
+
+static void
+local_writePatchData(gridWriterBov_t writer,
+                     gridPatch_t     patch,
+                     bool            isFullBrick)
+{
+	gridPointUint32_t idxLo, dims;
+	uint32_t          idxLoBov[3], dimsBov[3];
+	dataVar_t         var;
+
+	gridPatch_getIdxLo(patch, idxLo);
+	gridPatch_getDims(patch, dims);
+	local_getBovIdxs(idxLo, dims, idxLoBov, dimsBov);
+	if (isFullBrick)
+		idxLoBov[0] = idxLoBov[1] = idxLoBov[2] = 0;
+
+	var = gridPatch_getVarHandle(patch, 0);
+	bov_writeWindowed(writer->bov, gridPatch_getVarDataHandle(patch, 0),
+	                  local_getBovTypeFromGridType(dataVar_getType(var)),
+	                  dataVar_getNumComponents(var), idxLoBov, dimsBov);
+}
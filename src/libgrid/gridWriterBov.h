@@ -0,0 +1,201 @@
+// Copyright (C) 2013, Steffen Knollmann
+// Released under the terms of the GNU General Public License version 3.
+// This file is part of `ginnungagap'.
+
+#ifndef GRIDWRITERBOV_H
+#define GRIDWRITERBOV_H
+
+
+/*--- Doxygen file description ------------------------------------------*/
+
+/**
+ * @file libgrid/gridWriterBov.h
+ * @ingroup  libgridIOOutBov
+ * @brief  Provides the interface for the BOV writer.
+ */
+
+
+/*--- Includes ----------------------------------------------------------*/
+#include "gridConfig.h"
+#include "gridWriter.h"
+#include "gridPatch.h"
+#include "gridRegular.h"
+#include "gridPoint.h"
+#ifdef WITH_MPI
+#  include <mpi.h>
+#endif
+#include "../libutil/bov.h"
+
+
+/*--- ADT handle --------------------------------------------------------*/
+
+/** @brief  The handle for the BOV writer object. */
+typedef struct gridWriterBov_struct *gridWriterBov_t;
+
+
+/*--- Prototypes of implemented abstract functions ----------------------*/
+
+
+/**
+ * @name  Creating and Deleting (Virtual)
+ *
+ * @{
+ */
+
+
+/** @copydoc gridWriter_del() */
+extern void
+gridWriterBov_del(gridWriter_t *writer);
+
+
+/** @} */
+
+
+/**
+ * @name  Using (Virtual)
+ *
+ * @{
+ */
+
+/** @copydoc gridWriter_activate() */
+extern void
+gridWriterBov_activate(gridWriter_t writer);
+
+
+/** @copydoc gridWriter_deactivate() */
+extern void
+gridWriterBov_deactivate(gridWriter_t writer);
+
+
+/**
+ * @brief  Writes a single patch as the full brick of the BOV.
+ *
+ * Only the first variable of the patch is written.  This is a local
+ * operation, the calling task creates the data file and writes the
+ * header.
+ *
+ * @param[in,out]  writer
+ *                    The writer to use, must be active.
+ * @param[in]      patch
+ *                    The patch to write.
+ * @param[in]      patchName
+ *                    Ignored.
+ * @param[in]      origin
+ *                    The origin of the brick.
+ * @param[in]      delta
+ *                    The size of a cell, the brick size is derived from
+ *                    it.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+gridWriterBov_writeGridPatch(gridWriter_t   writer,
+                             gridPatch_t    patch,
+                             const char     *patchName,
+                             gridPointDbl_t origin,
+                             gridPointDbl_t delta);
+
+
+/**
+ * @brief  Writes the first variable of a distributed grid.
+ *
+ * The data file is created by the first task, afterwards every task
+ * writes its patches straight into their place in the shared data file
+ * and the first task writes the header.
+ *
+ * @param[in,out]  writer
+ *                    The writer to use, must be active.
+ * @param[in]      grid
+ *                    The grid to write.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+gridWriterBov_writeGridRegular(gridWriter_t  writer,
+                               gridRegular_t grid);
+
+
+/** @} */
+
+#ifdef WITH_MPI
+
+/**
+ * @name  Additional Initialization (Virtual)
+ *
+ * @{
+ */
+
+/** @copydoc gridWriter_initParallel() */
+extern void
+gridWriterBov_initParallel(gridWriter_t writer, MPI_Comm mpiComm);
+
+
+/** @} */
+
+#endif
+
+
+/*--- Prototypes of final functions -------------------------------------*/
+
+/**
+ * @name  Creating and Deleting (Final)
+ *
+ * @{
+ */
+
+/**
+ * @brief  Creates a new BOV writer.
+ *
+ * @return  The new writer.
+ */
+extern gridWriterBov_t
+gridWriterBov_new(void);
+
+
+/** @} */
+
+/**
+ * @name  Getting (Final)
+ *
+ * @{
+ */
+
+/**
+ * @brief  Retrieves a the underlying BOV object from a BOV grid writer.
+ *
+ * @param[in]  writer
+ *                The writer that should be queried, passing @c NULL is
+ *                undefined.
+ *
+ * @return  Returns a handle to the internal BOV object, the caller must
+ *          not try free the object.
+ */
+extern bov_t
+gridWriterBov_getBov(const gridWriterBov_t writer);
+
+
+/** @} */
+
+
+/*--- Doxygen group definitions -----------------------------------------*/
+
+/**
+ * @defgroup libgridIOOutBov BOV Writer
+ * @ingroup libgridIOOut
+ * @brief  Provides the BOV Writer.
+ *
+ * The writer stores one variable per file.  The header is written to the
+ * file name of the writer (with the default suffix @c .bov), the raw data
+ * next to it with the suffix @c .raw.  This is the simplest format to
+ * hand a field from one tool to the next, the data can be read back with
+ * the BOV reader.
+ *
+ * @section libgridIOOutBovIniFormat  Expected Format for Ini Files
+ *
+ * @code
+ * [SectionName]
+ * @endcode
+ */
+
+
+#endif
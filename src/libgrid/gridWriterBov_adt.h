@@ -0,0 +1,95 @@
+// Copyright (C) 2013, Steffen Knollmann
+// Released under the terms of the GNU General Public License version 3.
+// This file is part of `ginnungagap'.
+
+#ifndef GRIDWRITERBOV_ADT_H
+#define GRIDWRITERBOV_ADT_H
+
+
+/*--- Doxygen file description ------------------------------------------*/
+
+/**
+ * @file libgrid/gridWriterBov_adt.h
+ * @ingroup  libgridIOOutBov
+ * @brief  Implements the main structure for the BOV writer object.
+ */
+
+
+/*--- Includes ----------------------------------------------------------*/
+#include "gridConfig.h"
+#include "gridWriter_adt.h"
+#include <stdbool.h>
+#ifdef WITH_MPI
+#  include <mpi.h>
+#endif
+#include "../libutil/bov.h"
+
+
+/*--- ADT implementation ------------------------------------------------*/
+
+/** @brief  The main structure. */
+struct gridWriterBov_struct {
+	/** @brief  The base structure. */
+	struct gridWriter_struct base;
+	/** @brief  The low level BOV interface. */
+	bov_t                    bov;
+	/** @brief  Whether an existing data file may be replaced. */
+	bool                     mayOverwriteDataFile;
+#ifdef WITH_MPI
+	/** @brief  The communicator of the ranks sharing the data file. */
+	MPI_Comm                 mpiComm;
+#endif
+};
+
+/*--- Prototypes of protected functions ---------------------------------*/
+
+/**
+ * @name  Creating and Deleting (Protected)
+ *
+ * Those are the functions that are only available from within the basic
+ * writer and the ones that inherit from the basic writer (the OO equivalent
+ * would be @a protected).
+ *
+ * @{
+ */
+
+/**
+ * @brief  Allocates memory for a BOV grid writer.
+ *
+ * @return  Returns a handle to a new (uninitialized) BOV writer structure.
+ */
+extern gridWriterBov_t
+gridWriterBov_alloc();
+
+
+/**
+ * @brief  Sets all required fields of the BOV writer structure to safe
+ *         initial values.
+ *
+ * @param[in,out]  writer
+ *                    The writer to initialize.  This must be a valid writer
+ *                    object.  Passing @c NULL is undefined.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+gridWriterBov_init(gridWriterBov_t writer);
+
+
+/**
+ * @brief  Frees all members of the BOV writer structure.
+ *
+ * @param[in,out]  writer
+ *                    The writer to work with,  This must be a valid writer,
+ *                    passing @c NULL is undefined.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+gridWriterBov_free(gridWriterBov_t writer);
+
+
+/** @} */
+
+
+#endif
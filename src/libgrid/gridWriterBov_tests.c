@@ -0,0 +1,245 @@
+// Copyright (C) 2013, Steffen Knollmann
+// Released under the terms of the GNU General Public License version 3.
+// This file is part of `ginnungagap'.
+
+
+/*--- Doxygen file description ------------------------------------------*/
+
+/**
+ * @file libgrid/gridWriterBov_tests.c
+ * @ingroup  libgridIOOutBovTests
+ * @brief  Implements the tests for gridWriterBov.c.
+ */
+
+
+/*--- Includes ----------------------------------------------------------*/
+#include "gridConfig.h"
+#include "gridWriterBov_tests.h"
+#include "gridWriterBov.h"
+#include <stdio.h>
+#include <assert.h>
+#include <math.h>
+#ifdef WITH_MPI
+#  include <mpi.h>
+#endif
+#include "../libutil/xmem.h"
+#include "gridRegular.h"
+#include "gridRegularDistrib.h"
+#include "gridPatch.h"
+#include "../libdata/dataVar.h"
+#include "../libutil/bov.h"
+
+
+/*--- Implementation of main structure ----------------------------------*/
+#include "gridWriterBov_adt.h"
+
+
+/*--- Prototypes of local functions -------------------------------------*/
+static gridRegular_t
+local_getFakeGrid(bool isPadded);
+
+static void
+local_fillPatchWithIdxOfCells(gridPatch_t patch, gridPointUint32_t dimsGrid);
+
+
+/*--- Implementations of exported functions -----------------------------*/
+extern bool
+gridWriterBov_new_test(void)
+{
+	bool            hasPassed = true;
+	int             rank      = 0;
+	gridWriterBov_t writer;
+#ifdef XMEM_TRACK_MEM
+	size_t          allocatedBytes = global_allocated_bytes;
+#endif
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	writer = gridWriterBov_new();
+	if (writer->bov == NULL)
+		hasPassed = false;
+	if (writer->mayOverwriteDataFile)
+		hasPassed = false;
+	gridWriterBov_del((gridWriter_t *)&writer);
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+}
+
+extern bool
+gridWriterBov_del_test(void)
+{
+	bool            hasPassed = true;
+	int             rank      = 0;
+	gridWriterBov_t writer;
+#ifdef XMEM_TRACK_MEM
+	size_t          allocatedBytes = global_allocated_bytes;
+#endif
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	writer = gridWriterBov_new();
+	gridWriterBov_del((gridWriter_t *)&writer);
+	if (writer != NULL)
+		hasPassed = false;
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+}
+
+extern bool
+gridWriterBov_writeGridRegular_test(void)
+{
+	bool              hasPassed = true;
+	int               rank      = 0;
+	gridWriterBov_t   writer;
+	gridRegular_t     grid;
+	gridPatch_t       patch;
+	filename_t        fn;
+	bov_t             bov;
+	gridPointUint32_t idxLo, dims;
+	uint64_t          numCells, dimRow;
+	double            *data, *dataRead;
+#ifdef XMEM_TRACK_MEM
+	size_t            allocatedBytes = global_allocated_bytes;
+#endif
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	// The second pass writes an FFTW padded grid, the file must not contain
+	// the padding.
+	for (int pass = 0; pass < 2; pass++) {
+		grid   = local_getFakeGrid(pass == 1);
+
+		writer = gridWriterBov_new();
+		fn     = filename_newFull(NULL, "outGridBov", NULL, ".bov");
+		gridWriter_setFileName((gridWriter_t)writer, fn);
+		gridWriter_setOverwriteFileIfExists((gridWriter_t)writer, true);
+#ifdef WITH_MPI
+		gridWriterBov_initParallel((gridWriter_t)writer, MPI_COMM_WORLD);
+#endif
+		gridWriterBov_activate((gridWriter_t)writer);
+		gridWriter_writeGridRegular((gridWriter_t)writer, grid);
+		gridWriterBov_deactivate((gridWriter_t)writer);
+		gridWriterBov_del((gridWriter_t *)&writer);
+
+		// Every task reads back its own part of the grid.
+		patch    = gridRegular_getPatchHandle(grid, 0);
+		data     = gridPatch_getVarDataHandle(patch, 0);
+		numCells = gridPatch_getNumCells(patch);
+		gridPatch_getIdxLo(patch, idxLo);
+		gridPatch_getDims(patch, dims);
+		dimRow   = gridPatch_getDimActual1D(patch, 0, 0);
+		dataRead = xmalloc(sizeof(double) * numCells);
+		bov      = bov_newFromFile("outGridBov.bov");
+		bov_readWindowed(bov, dataRead, BOV_FORMAT_DOUBLE, 1, idxLo, dims);
+		for (uint64_t i = 0; i < numCells; i++) {
+			uint64_t idx = (i / dims[0]) * dimRow + i % dims[0];
+			if (islessgreater(data[idx], dataRead[i]))
+				hasPassed = false;
+		}
+		bov_del(&bov);
+		xfree(dataRead);
+
+#ifdef WITH_MPI
+		MPI_Barrier(MPI_COMM_WORLD);
+#endif
+		if (rank == 0) {
+			remove("outGridBov.bov");
+			remove("outGridBov.raw");
+		}
+#ifdef WITH_MPI
+		MPI_Barrier(MPI_COMM_WORLD);
+#endif
+
+		gridRegular_del(&grid);
+	}
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+} /* gridWriterBov_writeGridRegular_test */
+
+/*--- Implementations of local functions --------------------------------*/
+static gridRegular_t
+local_getFakeGrid(bool isPadded)
+{
+	dataVar_t            var;
+	int                  rank;
+	gridRegular_t        grid;
+	gridRegularDistrib_t gridDistrib;
+	gridPatch_t          patch;
+	gridPointDbl_t       origin = { 0., 0., 0. };
+	gridPointDbl_t       extent = { 1., 1., 1. };
+	gridPointUint32_t    dims   = { 4, 8, 16 };
+
+
+	var         = dataVar_new("FakeVar", DATAVARTYPE_DOUBLE, 1);
+	if (isPadded)
+		dataVar_setFFTWPadded(var);
+	grid        = gridRegular_new("Fake", origin, extent, dims);
+	gridRegular_attachVar(grid, var);
+	gridDistrib = gridRegularDistrib_new(grid, NULL);
+#ifdef WITH_MPI
+	gridPointInt_t nProcs = { 1, 1, 1 };
+	MPI_Comm_size(MPI_COMM_WORLD, nProcs + 2);
+	gridRegularDistrib_initMPI(gridDistrib, nProcs, MPI_COMM_WORLD);
+#endif
+	rank  = gridRegularDistrib_getLocalRank(gridDistrib);
+	patch = gridRegularDistrib_getPatchForRank(gridDistrib, rank);
+	gridRegular_attachPatch(grid, patch);
+	local_fillPatchWithIdxOfCells(patch, dims);
+
+	gridRegularDistrib_del(&gridDistrib);
+
+	return grid;
+} /* local_getFakeGrid */
+
+static void
+local_fillPatchWithIdxOfCells(gridPatch_t patch, gridPointUint32_t dimsGrid)
+{
+	gridPointUint32_t idxLo;
+	gridPointUint32_t dims;
+	uint64_t          dimRow;
+	double            *data;
+
+	gridPatch_getIdxLo(patch, idxLo);
+	gridPatch_getDims(patch, dims);
+	dimRow = gridPatch_getDimActual1D(patch, 0, 0);
+
+	data = gridPatch_getVarDataHandle(patch, 0);
+	assert(data != NULL);
+
+	for (uint32_t z = 0; z < dims[2]; z++) {
+		for (uint32_t y = 0; y < dims[1]; y++) {
+			for (uint32_t x = 0; x < dims[0]; x++) {
+				uint64_t idxPatch = x + (y + z * dims[1]) * dimRow;
+				uint64_t idxGrid  = (x + idxLo[0])
+				                    + (y + idxLo[1]) * dimsGrid[0]
+				                    + (z + idxLo[2]) * dimsGrid[0]
+				                    * dimsGrid[1];
+				data[idxPatch] = idxGrid;
+			}
+		}
+	}
+}
@@ -0,0 +1,49 @@
+// Copyright (C) 2013, Steffen Knollmann
+// Released under the terms of the GNU General Public License version 3.
+// This file is part of `ginnungagap'.
+
+#ifndef GRIDWRITERBOV_TESTS_H
+#define GRIDWRITERBOV_TESTS_H
+
+
+/*--- Doxygen file description ------------------------------------------*/
+
+/**
+ * @file libgrid/gridWriterBov_tests.h
+ * @ingroup  libgridIOOutBovTests
+ * @brief  Provides the interface to the tests.
+ */
+
+
+/*--- Includes ----------------------------------------------------------*/
+#include "gridConfig.h"
+#include <stdbool.h>
+
+
+/*--- Prototypes of exported functions ----------------------------------*/
+
+/** @brief  Tests gridWriterBov_new(). */
+extern bool
+gridWriterBov_new_test(void);
+
+
+/** @brief  Tests gridWriterBov_del(). */
+extern bool
+gridWriterBov_del_test(void);
+
+
+/** @brief  Tests gridWriterBov_writeGridRegular(). */
+extern bool
+gridWriterBov_writeGridRegular_test(void);
+
+
+/*--- Doxygen group definitions -----------------------------------------*/
+
+/**
+ * @defgroup libgridIOOutBovTests Tests
+ * @ingroup libgridIOOutBov
+ * @brief  Provides the tests for the BOV writer.
+ */
+
+
+#endif
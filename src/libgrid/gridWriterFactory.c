@@ -20,6 +20,7 @@
 #include "../libutil/diediedie.h"
 #include "gridIOCommon.h"
 #include "gridWriterGrafic.h"
+#include "gridWriterBov.h"
 #ifdef WITH_SILO
 #  include "gridWriterSilo.h"
 #  include <silo.h>
@@ -110,6 +111,7 @@ gridWriterFactory_newFromIniGrafic(parse_ini_t ini, const char *sectionName)
 	gridWriterGrafic_t writer;
 	grafic_t           grafic;
 	bool               isWhiteNoise;
+	int32_t            numConcurrentWriters;
 	uint32_t           *size = NULL;
 
 
@@ -122,6 +124,17 @@ gridWriterFactory_newFromIniGrafic(parse_ini_t ini, const char *sectionName)
 	if (parse_ini_get_bool(ini, "isWhiteNoise", sectionName, &isWhiteNoise))
 		grafic_setIsWhiteNoise(grafic, isWhiteNoise);
 
+	if (parse_ini_get_int32(ini, "numConcurrentWriters", sectionName,
+	                        &numConcurrentWriters)) {
+		if (numConcurrentWriters < 0) {
+			fprintf(stderr, "FATAL:  numConcurrentWriters must not be "
+			        "negative in section %s.\n", sectionName);
+			exit(EXIT_FAILURE);
+		}
+		gridWriterGrafic_setNumConcurrentWriters(writer,
+		                                         (int)numConcurrentWriters);
+	}
+
 	if (!parse_ini_get_int32list(ini, "size", sectionName, 3,
 	                             (int32_t **)&size)) {
 		fprintf(stderr, "FATAL:  Could not get size from section %s.\n",
@@ -154,6 +167,19 @@ gridWriterFactory_newFromIniGrafic(parse_ini_t ini, const char *sectionName)
 	return (gridWriter_t)writer;
 } /* gridWriterFactory_newFromIniGrafic */
 
+extern gridWriter_t
+gridWriterFactory_newFromIniBov(parse_ini_t ini, const char *sectionName)
+{
+	gridWriterBov_t writer;
+
+	assert(ini != NULL);
+	assert(sectionName != NULL);
+
+	writer = gridWriterBov_new();
+
+	return (gridWriter_t)writer;
+}
+
 #ifdef WITH_HDF5
 extern gridWriter_t
 gridWriterFactory_newFromIniHDF5(parse_ini_t ini, const char *sectionName)
@@ -315,6 +341,7 @@ gridWriterFactory_newFromIniSilo(parse_ini_t ini, const char *sectionName)
 	char             *dbTypeStr;
 	int              dbType;
 	int              numFiles;
+	int              previewFactor;
 
 
 	if (parse_ini_get_string(ini, "dbType", sectionName, &dbTypeStr)) {
@@ -334,6 +361,10 @@ gridWriterFactory_newFromIniSilo(parse_ini_t ini, const char *sectionName)
 	if (parse_ini_get_int32(ini, "numFiles", sectionName, &numFiles))
 		gridWriterSilo_setNumFiles(writer, numFiles);
 
+	if (parse_ini_get_int32(ini, "previewFactor", sectionName,
+	                        &previewFactor))
+		gridWriterSilo_setPreviewFactor(writer, previewFactor);
+
 	return (gridWriter_t)writer;
 }
 
@@ -380,6 +411,8 @@ local_getWriter(parse_ini_t ini, const char *secName, gridIO_type_t type)
 #endif
 	} else if (type == GRIDIO_TYPE_GRAFIC) {
 		writer = gridWriterFactory_newFromIniGrafic(ini, secName);
+	} else if (type == GRIDIO_TYPE_BOV) {
+		writer = gridWriterFactory_newFromIniBov(ini, secName);
 	} else if (type == GRIDIO_TYPE_HDF5) {
 #ifdef WITH_HDF5
 		writer = gridWriterFactory_newFromIniHDF5(ini, secName);
@@ -73,6 +73,9 @@ gridWriterFactory_newWriterFromIni(parse_ini_t ini,
  *  <dt>Grafic</dt>
  *  <dd>The name is given by #local_typeGraficStr.  For further
  *      constrution details see @ref libgridIOOutGraficIniFormat.</dd>
+ *  <dt>BOV</dt>
+ *  <dd>The name is given by #local_typeBovStr.  For further
+ *      construction details see @ref libgridIOOutBovIniFormat.</dd>
  *  <dt>Silo</dt>
  *  <dd>The name is given by #local_typeSiloStr.  For further
  *      construction details see @ref libgridIOOutSiloIniFormat.</dd>
@@ -114,7 +114,7 @@ gridWriterGrafic_activate(gridWriter_t writer)
 
 #ifdef WITH_MPI
 		groupi_acquire(w->groupi);
-		isFirst = groupi_isFirstInGroup(w->groupi);
+		isFirst = (groupi_getSeqNum(w->groupi) == 0);
 #endif
 		grafic_setFileName(w->grafic, filename_getFullName(w->base.fileName));
 		if (isFirst)
@@ -204,6 +204,8 @@ gridWriterGrafic_initParallel(gridWriter_t writer, MPI_Comm mpiComm)
 
 	tmp->groupi = groupi_new(1, mpiComm, LOCAL_MPI_TAG,
 	                         GROUPI_MODE_BLOCK);
+	if (tmp->numConcurrentWriters > 0)
+		groupi_setMaxConcurrent(tmp->groupi, tmp->numConcurrentWriters);
 }
 
 #endif
@@ -243,6 +245,19 @@ gridWriterGrafic_getGrafic(const gridWriterGrafic_t writer)
 	return writer->grafic;
 }
 
+extern void
+gridWriterGrafic_setNumConcurrentWriters(gridWriterGrafic_t writer,
+                                         int                numConcurrentWriters)
+{
+	assert(writer != NULL);
+	assert(numConcurrentWriters >= 0);
+#ifdef WITH_MPI
+	assert(writer->groupi == NULL);
+#endif
+
+	writer->numConcurrentWriters = numConcurrentWriters;
+}
+
 /*--- Implementations of protected functions ----------------------------*/
 extern gridWriterGrafic_t
 gridWriterGrafic_alloc(void)
@@ -267,6 +282,7 @@ gridWriterGrafic_init(gridWriterGrafic_t writer)
 #ifdef WITH_MPI
 	writer->groupi = NULL;
 #endif
+	writer->numConcurrentWriters = 0;
 }
 
 extern void
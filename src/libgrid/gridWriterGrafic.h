@@ -173,6 +173,28 @@ extern void
 gridWriterGrafic_setIsWhiteNoise(gridWriterGrafic_t writer,
                                  bool               isWhiteNoise);
 
+/**
+ * @brief  Sets how many MPI tasks may write to the file at the same time.
+ *
+ * By default the tasks write one after the other in rank order.  With a
+ * value of @c 1 or more they write in the order in which they become
+ * ready, up to @c numConcurrentWriters at a time, see
+ * groupi_setMaxConcurrent().  This has no effect without MPI and must be
+ * called before the writer is initialised for parallel use.
+ *
+ * @param[in,out]  writer
+ *                    The writer to deal with.  Passing @c NULL is
+ *                    undefined.
+ * @param[in]      numConcurrentWriters
+ *                    The number of tasks writing at the same time, @c 0
+ *                    restores the default.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+gridWriterGrafic_setNumConcurrentWriters(gridWriterGrafic_t writer,
+                                         int                numConcurrentWriters);
+
 
 /** @} */
 
@@ -188,6 +210,9 @@ gridWriterGrafic_setIsWhiteNoise(gridWriterGrafic_t writer,
  *
  * @code
  * [SectionName]
+ * # Optional, the number of MPI tasks writing at the same time, by
+ * # default they write one after the other in rank order.
+ * numConcurrentWriters = <integer>
  * @endcode
  */
 
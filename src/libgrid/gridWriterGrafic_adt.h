@@ -38,6 +38,8 @@ struct gridWriterGrafic_struct {
 	/** @brief  Provides a Poor-Man Parallel IO interface. */
 	groupi_t groupi;
 #endif
+	/** @brief  The number of tasks writing at the same time, 0 is serial. */
+	int                      numConcurrentWriters;
 };
 
 /*--- Prototypes of protected functions ---------------------------------*/
@@ -38,6 +38,8 @@
 
 /** @brief  Number of digits used for the file numbers. */
 #define LOCAL_NUMFILEDIGITS 3
+/** @brief  The suffix appended to the names of the preview objects. */
+#define LOCAL_PREVIEWSUFFIX "_preview"
 #ifdef WITH_MPI
 /** @brief  The prefix used for the directories in the files. */
 #  define LOCAL_DIRPREFIX "domain_"
@@ -180,16 +182,27 @@ local_closeDB(void *file, void *udata);
  */
 
 /**
- * @brief  Sets the proper file name for this reader to use by adjusting the
- *         qualifier.
+ * @brief  Constructs the name of the data file of a PMPIO group.
  *
- * @param[in,out]  writer
- *                    The writer to work with, passing @c NULL is undefined.
+ * The file name of the writer itself is left untouched, in the parallel
+ * case the group number is appended to a copy of its qualifier.  In the
+ * serial case the file name of the writer is used as is.
  *
- * @return  Returns nothing.
+ * @param[in]  writer
+ *                The writer to work with, passing @c NULL is undefined.
+ * @param[in]  groupRank
+ *                The group for which to construct the file name, ignored in
+ *                the serial case.
+ * @param[in]  withPath
+ *                Whether the path of the file should be included.
+ *
+ * @return  Returns a new string holding the file name, the caller is
+ *          responsible for freeing it.
  */
-static void
-local_createFileName(gridWriterSilo_t writer);
+static char *
+local_getDataFileName(const gridWriterSilo_t writer,
+                      int                    groupRank,
+                      bool                   withPath);
 
 
 /**
@@ -318,6 +331,181 @@ static bool
 local_dirExistsInFile(DBfile *db, const char *dname);
 
 
+/** @} */
+
+/**
+ * @name  Preview and Root Support Functions
+ *
+ * @{
+ */
+
+/**
+ * @brief  Remembers name, number of patches and variables of a grid, they
+ *         are required to write the root file.
+ *
+ * @param[in,out]  writer
+ *                    The writer to work with, passing @c NULL is undefined.
+ * @param[in]      grid
+ *                    The grid that has been written.
+ *
+ * @return  Returns nothing.
+ */
+static void
+local_setGridInfo(gridWriterSilo_t writer, gridRegular_t grid);
+
+
+/**
+ * @brief  Forgets the grid remembered with local_setGridInfo().
+ *
+ * @param[in,out]  writer
+ *                    The writer to work with, passing @c NULL is undefined.
+ *
+ * @return  Returns nothing.
+ */
+static void
+local_clearGridInfo(gridWriterSilo_t writer);
+
+
+/**
+ * @brief  Writes a coarsened copy of a patch.
+ *
+ * The coarse cells are aligned to the full grid (coarse cell @c c covers
+ * the cells @c c*f to @c c*f+f-1, where @c f is the preview factor) and
+ * clipped at the boundaries of the patch.  Only the single component
+ * variables are written, they are averaged over the coarse cells.
+ *
+ * @param[in]  writer
+ *                The writer to work with, passing @c NULL is undefined.
+ * @param[in]  patch
+ *                The patch that should be written.
+ * @param[in]  *meshName
+ *                The name of the coarse mesh.
+ * @param[in]  origin
+ *                The origin of the grid.
+ * @param[in]  delta
+ *                The cell size of the full grid.
+ *
+ * @return  Returns nothing.
+ */
+static void
+local_writePatchPreview(gridWriterSilo_t writer,
+                        gridPatch_t      patch,
+                        const char       *meshName,
+                        gridPointDbl_t   origin,
+                        gridPointDbl_t   delta);
+
+
+/**
+ * @brief  Averages one variable of a patch over the coarse preview cells.
+ *
+ * @param[in]  patch
+ *                The patch to work with.
+ * @param[in]  idxOfVar
+ *                The variable to average, must have a single component.
+ * @param[in]  factor
+ *                The preview factor.
+ * @param[in]  idxLoCoarse
+ *                The coarse index of the first coarse cell of the patch.
+ * @param[in]  dimsCoarse
+ *                The number of coarse cells in each dimension.
+ * @param[in]  numCoarse
+ *                The total number of coarse cells.
+ *
+ * @return  Returns a new array holding the averaged values.
+ */
+static float *
+local_getPreviewData(gridPatch_t      patch,
+                     int              idxOfVar,
+                     int              factor,
+                     const uint32_t   *idxLoCoarse,
+                     const int        *dimsCoarse,
+                     uint64_t         numCoarse);
+
+
+/**
+ * @brief  Reads one value of a variable as double.
+ *
+ * @param[in]  *data
+ *                The data of the variable.
+ * @param[in]  type
+ *                The type of the variable.
+ * @param[in]  idx
+ *                The index of the value to read.
+ *
+ * @return  Returns the value.
+ */
+inline static double
+local_getValue(const void *data, dataVarType_t type, uint64_t idx);
+
+
+#ifdef WITH_MPI
+
+/**
+ * @brief  Writes the root file holding a multimesh and the multivars that
+ *         point into the domains of all processes.
+ *
+ * This is a collective operation, the number of patches is collected on
+ * the first process which then writes the root file from the known
+ * decomposition (group and rank in group of every process).
+ *
+ * @param[in]  writer
+ *                The writer to work with, passing @c NULL is undefined.
+ *
+ * @return  Returns nothing.
+ */
+static void
+local_writeRoot(const gridWriterSilo_t writer);
+
+
+/**
+ * @brief  Writes the multimesh and the multivars of one level to the root
+ *         file.
+ *
+ * @param[in]      writer
+ *                    The writer to work with, passing @c NULL is undefined.
+ * @param[in,out]  *f
+ *                    The root file.
+ * @param[in]      *numPatches
+ *                    The number of patches of every process.
+ * @param[in]      *suffix
+ *                    The suffix distinguishing the level, the empty string
+ *                    for the full grid.
+ *
+ * @return  Returns nothing.
+ */
+static void
+local_putRootLevel(const gridWriterSilo_t writer,
+                   DBfile                 *f,
+                   const int              *numPatches,
+                   const char             *suffix);
+
+
+/**
+ * @brief  Constructs the names of the patch meshes or variables of all
+ *         processes as seen from the root file.
+ *
+ * @param[in]  writer
+ *                The writer to work with, passing @c NULL is undefined.
+ * @param[in]  *numPatches
+ *                The number of patches of every process.
+ * @param[in]  *varName
+ *                The name of the variable, @c NULL to get the names of the
+ *                meshes.
+ * @param[in]  *suffix
+ *                The suffix distinguishing the level.
+ *
+ * @return  Returns an array of strings, to be freed with
+ *          local_delPatchNames().
+ */
+static char **
+local_getRootNames(const gridWriterSilo_t writer,
+                   const int              *numPatches,
+                   const char             *varName,
+                   const char             *suffix);
+
+#endif
+
+
 /** @} */
 
 /*--- Implementations of abstract functions -----------------------------*/
@@ -346,16 +534,20 @@ gridWriterSilo_activate(gridWriter_t writer)
 #endif
 
 	if (!gridWriter_isActive(writer)) {
-		local_createFileName(w);
+		char *fileName;
 		local_createDirName(w);
+		local_clearGridInfo(w);
 #ifdef WITH_MPI
-		w->f = PMPIO_WaitForBaton(w->baton,
-		                          filename_getFullName(w->base.fileName),
-		                          w->dirName);
+		fileName            = local_getDataFileName(w, w->groupRank, true);
+		w->mayOverwriteRoot = gridWriter_getOverwriteFileIfExists(writer)
+		                      || gridWriter_hasBeenActivated(writer);
+		w->f                = PMPIO_WaitForBaton(w->baton, fileName,
+		                                         w->dirName);
 #else
-		w->f = local_createDB(filename_getFullName(w->base.fileName),
-		                      w->dirName, w);
+		fileName = local_getDataFileName(w, 0, true);
+		w->f     = local_createDB(fileName, w->dirName, w);
 #endif
+		xfree(fileName);
 		gridWriter_setIsActive(writer);
 	}
 }
@@ -374,6 +566,9 @@ gridWriterSilo_deactivate(gridWriter_t writer)
 	if (gridWriter_isActive(writer)) {
 #ifdef WITH_MPI
 		PMPIO_HandOffBaton(w->baton, w->f);
+		// Only after the baton has been passed on, otherwise the
+		// processes waiting for it would never reach the collective call.
+		local_writeRoot(w);
 #else
 		local_closeDB(w->f, (void *)w);
 #endif
@@ -454,6 +649,22 @@ gridWriterSilo_writeGridRegular(gridWriter_t  writer,
 	DBPutMultimesh(tmp->f, gridName, numPatches, patchNames,
 	               meshTypes, NULL);
 
+	if (tmp->previewFactor > 1) {
+		char *previewName   = xstrmerge(gridName, LOCAL_PREVIEWSUFFIX);
+		char **previewNames = local_getPatchNames(previewName, numPatches);
+		for (int i = 0; i < numPatches; i++) {
+			gridPatch_t patch = gridRegular_getPatchHandle(grid, i);
+			local_writePatchPreview(tmp, patch, previewNames[i],
+			                        origin, delta);
+		}
+		DBPutMultimesh(tmp->f, previewName, numPatches, previewNames,
+		               meshTypes, NULL);
+		local_delPatchNames(previewNames, numPatches);
+		xfree(previewName);
+	}
+
+	local_setGridInfo(tmp, grid);
+
 	xfree(meshTypes);
 	local_delPatchNames(patchNames, numPatches);
 	xfree(gridName);
@@ -464,13 +675,19 @@ extern void
 gridWriterSilo_initParallel(gridWriter_t writer, MPI_Comm mpiComm)
 {
 	gridWriterSilo_t tmp = (gridWriterSilo_t)writer;
-	int              rank;
+	int              rank, size;
 
 	assert(tmp != NULL);
-	assert(tmp->type == GRIDIO_TYPE_SILO);
+	assert(tmp->base.type == GRIDIO_TYPE_SILO);
 
 	MPI_Comm_rank(mpiComm, &rank);
+	MPI_Comm_size(mpiComm, &size);
+
+	// PMPIO cannot use more files than there are processes.
+	if (tmp->numFiles > size)
+		tmp->numFiles = size;
 
+	tmp->mpiComm = mpiComm;
 	tmp->baton = PMPIO_Init(tmp->numFiles, PMPIO_WRITE, mpiComm,
 	                        LOCAL_MPI_TAG,
 	                        &local_createDB, &local_openDB,
@@ -519,6 +736,15 @@ gridWriterSilo_setNumFiles(gridWriterSilo_t w, int numFiles)
 	w->numFiles = numFiles;
 }
 
+extern void
+gridWriterSilo_setPreviewFactor(gridWriterSilo_t w, int previewFactor)
+{
+	assert(w != NULL);
+	assert(previewFactor >= 0);
+
+	w->previewFactor = previewFactor;
+}
+
 /*--- Implementations of protected functions ----------------------------*/
 extern gridWriterSilo_t
 gridWriterSilo_alloc(void)
@@ -543,14 +769,22 @@ gridWriterSilo_init(gridWriterSilo_t writer)
 #else
 	writer->dbType      = DB_PDB;
 #endif
-	writer->numFiles    = 1;
-	writer->f           = NULL;
-	writer->dirName     = NULL;
+	writer->numFiles      = 1;
+	writer->f             = NULL;
+	writer->dirName       = NULL;
+	writer->previewFactor = 0;
+	writer->gridName      = NULL;
+	writer->numPatches    = 0;
+	writer->numVars       = 0;
+	writer->varNames      = NULL;
+	writer->varIsScalar   = NULL;
 #ifdef WITH_MPI
-	writer->baton       = NULL;
-	writer->groupRank   = -1;
-	writer->rankInGroup = -1;
-	writer->globalRank  = -1;
+	writer->mpiComm          = MPI_COMM_NULL;
+	writer->mayOverwriteRoot = false;
+	writer->baton            = NULL;
+	writer->groupRank        = -1;
+	writer->rankInGroup      = -1;
+	writer->globalRank       = -1;
 #endif
 }
 
@@ -562,6 +796,7 @@ gridWriterSilo_free(gridWriterSilo_t w)
 
 	if (w->dirName != NULL)
 		xfree(w->dirName);
+	local_clearGridInfo(w);
 #ifdef WITH_MPI
 	if (w->baton != NULL)
 		PMPIO_Finish(w->baton);
@@ -630,24 +865,29 @@ local_closeDB(void *file, void *udata)
 	writer->f = NULL;
 }
 
-static void
-local_createFileName(gridWriterSilo_t writer)
+static char *
+local_getDataFileName(const gridWriterSilo_t writer,
+                      int                    groupRank,
+                      bool                   withPath)
 {
-	char myQualifier[LOCAL_NUMFILEDIGITS + 2]; // account for \0 and _
-	char *fullQualifier;
-
+	filename_t fn = filename_clone(writer->base.fileName);
+	char       *name;
 #ifdef WITH_MPI
-	sprintf(myQualifier, "_%0*i", LOCAL_NUMFILEDIGITS, writer->groupRank);
-#else
-	myQualifier[0] = '\0';
-#endif
+	char       myQualifier[LOCAL_NUMFILEDIGITS + 2]; // account for \0 and _
+	char       *fullQualifier;
 
-	fullQualifier = xstrmerge(filename_getQualifier(writer->base.fileName),
-	                          myQualifier);
+	sprintf(myQualifier, "_%0*i", LOCAL_NUMFILEDIGITS, groupRank);
+	fullQualifier = xstrmerge(filename_getQualifier(fn), myQualifier);
+	filename_setQualifier(fn, fullQualifier);
+	xfree(fullQualifier);
+#endif
 
-	filename_setQualifier(writer->base.fileName, fullQualifier);
+	if (!withPath)
+		filename_setPath(fn, NULL);
+	name = xstrdup(filename_getFullName(fn));
+	filename_del(&fn);
 
-	xfree(fullQualifier);
+	return name;
 }
 
 static void
@@ -792,3 +1032,320 @@ local_dirExistsInFile(DBfile *db, const char *dname)
 
 	return dirExists ? true : false;
 }
+
+static void
+local_setGridInfo(gridWriterSilo_t writer, gridRegular_t grid)
+{
+	local_clearGridInfo(writer);
+
+	writer->gridName    = xstrdup(gridRegular_getName(grid));
+	writer->numPatches  = gridRegular_getNumPatches(grid);
+	writer->numVars     = gridRegular_getNumVars(grid);
+	writer->varNames    = xmalloc(sizeof(char *) * writer->numVars);
+	writer->varIsScalar = xmalloc(sizeof(bool) * writer->numVars);
+	for (int i = 0; i < writer->numVars; i++) {
+		dataVar_t var = gridRegular_getVarHandle(grid, i);
+		writer->varNames[i]    = xstrdup(dataVar_getName(var));
+		writer->varIsScalar[i] = (dataVar_getNumComponents(var) == 1);
+	}
+}
+
+static void
+local_clearGridInfo(gridWriterSilo_t writer)
+{
+	if (writer->gridName != NULL)
+		xfree(writer->gridName);
+	if (writer->varNames != NULL)
+		local_delPatchNames(writer->varNames, writer->numVars);
+	if (writer->varIsScalar != NULL)
+		xfree(writer->varIsScalar);
+
+	writer->gridName    = NULL;
+	writer->numPatches  = 0;
+	writer->numVars     = 0;
+	writer->varNames    = NULL;
+	writer->varIsScalar = NULL;
+}
+
+static void
+local_writePatchPreview(gridWriterSilo_t writer,
+                        gridPatch_t      patch,
+                        const char       *meshName,
+                        gridPointDbl_t   origin,
+                        gridPointDbl_t   delta)
+{
+	int               factor   = writer->previewFactor;
+	int               numVars  = gridPatch_getNumVars(patch);
+	char              *varName = NULL;
+	double            *coords[NDIM];
+	gridPointInt_t    dimsNodes, dimsCells;
+	uint32_t          idxLoCoarse[NDIM];
+	gridPointUint32_t idxLo, dims;
+	uint64_t          numCoarse = 1;
+
+	gridPatch_getIdxLo(patch, idxLo);
+	gridPatch_getDims(patch, dims);
+
+	for (int i = 0; i < NDIM; i++) {
+		uint32_t idxHiCoarse = (idxLo[i] + dims[i] - 1) / factor;
+
+		idxLoCoarse[i] = idxLo[i] / factor;
+		dimsCells[i]   = (int)(idxHiCoarse - idxLoCoarse[i] + 1);
+		dimsNodes[i]   = dimsCells[i] + 1;
+		numCoarse     *= dimsCells[i];
+
+		coords[i] = xmalloc(sizeof(double) * dimsNodes[i]);
+		for (int j = 0; j < dimsNodes[i]; j++) {
+			uint32_t idx = (idxLoCoarse[i] + j) * factor;
+			// The outermost coarse cells are clipped to the patch.
+			if (idx < idxLo[i])
+				idx = idxLo[i];
+			if (idx > idxLo[i] + dims[i])
+				idx = idxLo[i] + dims[i];
+			coords[i][j] = origin[i] + idx * delta[i];
+		}
+	}
+
+	DBPutQuadmesh(writer->f, meshName, NULL, coords, dimsNodes, NDIM,
+	              DB_DOUBLE, DB_COLLINEAR, NULL);
+
+	for (int i = 0; i < NDIM; i++)
+		xfree(coords[i]);
+
+	for (int i = 0; i < numVars; i++) {
+		dataVar_t var = gridPatch_getVarHandle(patch, i);
+		float     *values;
+
+		if (dataVar_getNumComponents(var) != 1)
+			continue;
+
+		values  = local_getPreviewData(patch, i, factor, idxLoCoarse,
+		                               dimsCells, numCoarse);
+		varName = local_getPatchVarName(var, meshName, varName);
+		DBPutQuadvar1(writer->f, varName, meshName, values, dimsCells,
+		              NDIM, NULL, 0, DB_FLOAT, DB_ZONECENT, NULL);
+		xfree(values);
+	}
+
+	if (varName != NULL)
+		xfree(varName);
+} /* local_writePatchPreview */
+
+static float *
+local_getPreviewData(gridPatch_t      patch,
+                     int              idxOfVar,
+                     int              factor,
+                     const uint32_t   *idxLoCoarse,
+                     const int        *dimsCoarse,
+                     uint64_t         numCoarse)
+{
+	dataVar_t         var      = gridPatch_getVarHandle(patch, idxOfVar);
+	const void        *data    = gridPatch_getVarDataHandle(patch, idxOfVar);
+	dataVarType_t     type     = dataVar_getType(var);
+	uint64_t          numCells = gridPatch_getNumCells(patch);
+	uint32_t          pos[NDIM];
+	gridPointUint32_t idxLo, dims;
+	double            *sum;
+	uint32_t          *count;
+	float             *values;
+
+	gridPatch_getIdxLo(patch, idxLo);
+	gridPatch_getDims(patch, dims);
+
+	sum    = xmalloc(sizeof(double) * numCoarse);
+	count  = xmalloc(sizeof(uint32_t) * numCoarse);
+	values = xmalloc(sizeof(float) * numCoarse);
+	for (uint64_t i = 0; i < numCoarse; i++) {
+		sum[i]   = 0.0;
+		count[i] = 0;
+	}
+	for (int j = 0; j < NDIM; j++)
+		pos[j] = 0;
+
+	// Walk through the patch in storage order (x varies fastest).
+	for (uint64_t i = 0; i < numCells; i++) {
+		uint64_t idxCoarse = 0;
+
+		for (int j = NDIM - 1; j >= 0; j--)
+			idxCoarse = idxCoarse * dimsCoarse[j]
+			            + (idxLo[j] + pos[j]) / factor - idxLoCoarse[j];
+		sum[idxCoarse] += local_getValue(data, type, i);
+		count[idxCoarse]++;
+
+		for (int j = 0; j < NDIM; j++) {
+			if (++pos[j] < dims[j])
+				break;
+			pos[j] = 0;
+		}
+	}
+
+	for (uint64_t i = 0; i < numCoarse; i++)
+		values[i] = (float)(sum[i] / count[i]);
+
+	xfree(count);
+	xfree(sum);
+
+	return values;
+} /* local_getPreviewData */
+
+inline static double
+local_getValue(const void *data, dataVarType_t type, uint64_t idx)
+{
+	double value;
+
+	switch (type) {
+	case DATAVARTYPE_INT:
+		value = ((const int *)data)[idx];
+		break;
+	case DATAVARTYPE_INT8:
+		value = ((const int8_t *)data)[idx];
+		break;
+	case DATAVARTYPE_INT32:
+		value = ((const int32_t *)data)[idx];
+		break;
+	case DATAVARTYPE_INT64:
+		value = (double)(((const int64_t *)data)[idx]);
+		break;
+	case DATAVARTYPE_FLOAT:
+		value = ((const float *)data)[idx];
+		break;
+	case DATAVARTYPE_DOUBLE:
+		value = ((const double *)data)[idx];
+		break;
+	case DATAVARTYPE_FPV:
+		value = ((const fpv_t *)data)[idx];
+		break;
+	default:
+		// We should never ever end up here.
+		diediedie(EXIT_FAILURE);
+	}
+
+	return value;
+}
+
+#ifdef WITH_MPI
+static void
+local_writeRoot(const gridWriterSilo_t writer)
+{
+	int numRanks;
+	int *numPatches = NULL;
+
+	MPI_Comm_size(writer->mpiComm, &numRanks);
+	if (writer->globalRank == 0)
+		numPatches = xmalloc(sizeof(int) * numRanks);
+
+	MPI_Gather((void *)&(writer->numPatches), 1, MPI_INT,
+	           numPatches, 1, MPI_INT, 0, writer->mpiComm);
+
+	if ((writer->globalRank == 0) && (writer->gridName != NULL)) {
+		const char *rootName = filename_getFullName(writer->base.fileName);
+		int        mode      = writer->mayOverwriteRoot ? DB_CLOBBER
+		                       : DB_NOCLOBBER;
+		DBfile     *f;
+
+		f = DBCreate(rootName, mode, DB_LOCAL, NULL, writer->dbType);
+		if (f == NULL) {
+			fprintf(stderr, "Could not create the root file %s\n",
+			        rootName);
+			diediedie(EXIT_FAILURE);
+		}
+		local_putRootLevel(writer, f, numPatches, "");
+		if (writer->previewFactor > 1)
+			local_putRootLevel(writer, f, numPatches, LOCAL_PREVIEWSUFFIX);
+		DBClose(f);
+	}
+
+	if (numPatches != NULL)
+		xfree(numPatches);
+} /* local_writeRoot */
+
+static void
+local_putRootLevel(const gridWriterSilo_t writer,
+                   DBfile                 *f,
+                   const int              *numPatches,
+                   const char             *suffix)
+{
+	int       numRanks, numMeshes = 0;
+	int       *types;
+	char      **names;
+	char      *meshName;
+	DBoptlist *optList;
+
+	MPI_Comm_size(writer->mpiComm, &numRanks);
+	for (int i = 0; i < numRanks; i++)
+		numMeshes += numPatches[i];
+	types    = xmalloc(sizeof(int) * numMeshes);
+	meshName = xstrmerge(writer->gridName, suffix);
+
+	for (int i = 0; i < numMeshes; i++)
+		types[i] = DB_QUAD_RECT;
+	names = local_getRootNames(writer, numPatches, NULL, suffix);
+	DBPutMultimesh(f, meshName, numMeshes, names, types, NULL);
+	local_delPatchNames(names, numMeshes);
+
+	optList = DBMakeOptlist(1);
+	DBAddOption(optList, DBOPT_MMESH_NAME, meshName);
+	for (int i = 0; i < numMeshes; i++)
+		types[i] = DB_QUADVAR;
+	for (int j = 0; j < writer->numVars; j++) {
+		char *varName;
+
+		// The preview only holds the single component variables.
+		if ((suffix[0] != '\0') && !(writer->varIsScalar[j]))
+			continue;
+
+		varName = xstrmerge(writer->varNames[j], suffix);
+		names   = local_getRootNames(writer, numPatches,
+		                             writer->varNames[j], suffix);
+		DBPutMultivar(f, varName, numMeshes, names, types, optList);
+		local_delPatchNames(names, numMeshes);
+		xfree(varName);
+	}
+	DBFreeOptlist(optList);
+
+	xfree(meshName);
+	xfree(types);
+} /* local_putRootLevel */
+
+static char **
+local_getRootNames(const gridWriterSilo_t writer,
+                   const int              *numPatches,
+                   const char             *varName,
+                   const char             *suffix)
+{
+	int        numRanks, numNames = 0, k = 0;
+	char       **names;
+	const char *varPrefix = (varName == NULL) ? "" : varName;
+	const char *varSep    = (varName == NULL) ? "" : "_";
+
+	MPI_Comm_size(writer->mpiComm, &numRanks);
+	for (int i = 0; i < numRanks; i++)
+		numNames += numPatches[i];
+	names = xmalloc(sizeof(char *) * numNames);
+
+	for (int i = 0; i < numRanks; i++) {
+		int  groupRank   = PMPIO_GroupRank(writer->baton, i);
+		int  rankInGroup = PMPIO_RankInGroup(writer->baton, i);
+		char *fileName   = local_getDataFileName(writer, groupRank, false);
+
+		for (int j = 0; j < numPatches[i]; j++) {
+			// Same as the names used in gridWriterSilo_writeGridRegular(),
+			// prefixed by the file and the directory of the process.
+			int len = snprintf(NULL, 0, "%s:/%s%0*i/%s%s%s_%03i%s_%03i",
+			                   fileName, LOCAL_DIRPREFIX,
+			                   LOCAL_NUMDIRDIGITS, i, varPrefix, varSep,
+			                   writer->gridName, rankInGroup, suffix, j);
+			names[k] = xmalloc(sizeof(char) * (len + 1));
+			sprintf(names[k], "%s:/%s%0*i/%s%s%s_%03i%s_%03i",
+			        fileName, LOCAL_DIRPREFIX, LOCAL_NUMDIRDIGITS, i,
+			        varPrefix, varSep, writer->gridName, rankInGroup,
+			        suffix, j);
+			k++;
+		}
+		xfree(fileName);
+	}
+
+	return names;
+} /* local_getRootNames */
+
+#endif
@@ -153,6 +153,27 @@ extern void
 gridWriterSilo_setNumFiles(gridWriterSilo_t w, int numFiles);
 
 
+/**
+ * @brief  Sets the coarsening factor of the preview level.
+ *
+ * If the factor is larger than 1, gridWriterSilo_writeGridRegular()
+ * additionally writes a copy of the grid in which @c previewFactor cells
+ * per dimension are averaged into one.  Only variables with a single
+ * component are part of the preview.
+ *
+ * @param[in,out]  w
+ *                    The writer to work with.  Must be a valid writer,
+ *                    passing @c NULL is undefined.
+ * @param[in]      previewFactor
+ *                    The new coarsening factor, @c 0 or @c 1 disable the
+ *                    preview.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+gridWriterSilo_setPreviewFactor(gridWriterSilo_t w, int previewFactor);
+
+
 /** @} */
 
 /*--- Doxygen group definitions -----------------------------------------*/
@@ -162,10 +183,26 @@ gridWriterSilo_setNumFiles(gridWriterSilo_t w, int numFiles);
  * @ingroup libgridIOOut
  * @brief  Provides the Silo Writer.
  *
+ * In the parallel case the processes are split into @c numFiles groups
+ * (via PMPIO), the processes of a group take turns to write into their own
+ * directory (@c domain_XXXXX) of the group file, whose name carries the
+ * group number as additional qualifier (e.g. @c out_000.silo).  On
+ * deactivation the first process writes the root file under the plain
+ * file name of the writer (e.g. @c out.silo), holding a multimesh and
+ * multivars of the last written grid spanning all domains.  The root is
+ * derived from the known decomposition, @c makeSiloRoot is not required.
+ *
  * @section libgridIOOutSiloIniFormat  Expected Format for Ini Files
  *
  * @code
  * [SectionName]
+ * # Optional, either DB_PDB or DB_HDF5 (default if available)
+ * dbType = DB_HDF5
+ * # Optional, the number of files to spread the data over, default 1
+ * numFiles = 4
+ * # Optional, additionally write a level coarsened by this factor,
+ * # default 0 (no preview)
+ * previewFactor = 8
  * @endcode
  */
 
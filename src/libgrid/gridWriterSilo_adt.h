@@ -18,8 +18,10 @@
 /*--- Includes ----------------------------------------------------------*/
 #include "gridConfig.h"
 #include "gridWriter_adt.h"
+#include <stdbool.h>
 #include <silo.h>
 #ifdef WITH_MPI
+#  include <mpi.h>
 #  include <pmpio.h>
 #endif
 
@@ -38,7 +40,23 @@ struct gridWriterSilo_struct {
 	DBfile                   *f;
 	/** @brief  Stores the current directory name. */
 	char                     *dirName;
+	/** @brief  The coarsening factor of the preview, @c 0 writes none. */
+	int                      previewFactor;
+	/** @brief  The name of the grid written last, @c NULL if none. */
+	char                     *gridName;
+	/** @brief  The number of patches of the grid written last. */
+	int                      numPatches;
+	/** @brief  The number of variables of the grid written last. */
+	int                      numVars;
+	/** @brief  The names of the variables of the grid written last. */
+	char                     **varNames;
+	/** @brief  Whether the variables have a single component. */
+	bool                     *varIsScalar;
 #ifdef WITH_MPI
+	/** @brief  The communicator of the writing processes. */
+	MPI_Comm      mpiComm;
+	/** @brief  Whether an existing root file may be replaced. */
+	bool          mayOverwriteRoot;
 	/** @brief  The handle used to negotiate exclusive file access. */
 	PMPIO_baton_t *baton;
 	/** @brief  The rank of the group this writer is in. */
@@ -336,6 +336,75 @@ gridWriterSilo_writeGridRegular_test(void)
 	return hasPassed ? true : false;
 } /* gridWriterSilo_writeGridRegular_test */
 
+extern bool
+gridWriterSilo_writeGridRegularPreview_test(void)
+{
+	bool             hasPassed = true;
+	int              rank      = 0;
+	gridWriterSilo_t writer;
+	gridRegular_t    grid;
+	DBfile           *f;
+#ifdef XMEM_TRACK_MEM
+	size_t           allocatedBytes = global_allocated_bytes;
+#endif
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	grid = local_getFakeGridRegular();
+
+	writer  = gridWriterSilo_new();
+	gridWriter_setFileName((gridWriter_t)writer,
+	                       filename_newFull(NULL, LOCAL_TESTPREFIX,
+	                                        NULL, ".silo"));
+	gridWriter_setOverwriteFileIfExists((gridWriter_t)writer, true);
+	gridWriterSilo_setDbType(writer, DB_HDF5);
+	gridWriterSilo_setPreviewFactor(writer, 4);
+	if (writer->previewFactor != 4)
+		hasPassed = false;
+#ifdef WITH_MPI
+	gridWriterSilo_initParallel((gridWriter_t)writer, MPI_COMM_WORLD);
+#endif
+	gridWriterSilo_activate((gridWriter_t)writer);
+	gridWriterSilo_writeGridRegular((gridWriter_t)writer, grid);
+	gridWriterSilo_deactivate((gridWriter_t)writer);
+	gridWriterSilo_del((gridWriter_t *)&writer);
+
+	// In parallel the preview must be part of the root file, in serial
+	// the single file holds it directly.
+	if (rank == 0) {
+		f = DBOpen(LOCAL_TESTPREFIX ".silo", DB_HDF5, DB_READ);
+#ifdef WITH_MPI
+		if (!DBInqVarExists(f, "TestGrid_preview"))
+			hasPassed = false;
+		if (!DBInqVarExists(f, "var1_preview"))
+			hasPassed = false;
+		if (DBInqVarExists(f, "var2_preview"))
+			hasPassed = false;
+#else
+		if (!DBInqVarExists(f, "TestGrid_000_preview"))
+			hasPassed = false;
+		if (!DBInqVarExists(f, "var1_TestGrid_000_preview_000"))
+			hasPassed = false;
+		if (DBInqVarExists(f, "var2_TestGrid_000_preview_000"))
+			hasPassed = false;
+#endif
+		DBClose(f);
+	}
+
+	gridRegular_del(&grid);
+
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+} /* gridWriterSilo_writeGridRegularPreview_test */
+
 /*--- Implementations of local functions --------------------------------*/
 static gridRegular_t
 local_getFakeGridRegular(void)
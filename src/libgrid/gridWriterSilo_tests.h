@@ -30,6 +30,9 @@ gridWriterSilo_writeGridPatch_test(void);
 extern bool
 gridWriterSilo_writeGridRegular_test(void);
 
+extern bool
+gridWriterSilo_writeGridRegularPreview_test(void);
+
 
 #ifdef WITH_MPI
 extern bool
@@ -15,6 +15,7 @@
 #include "gridReaderFactory_tests.h"
 #include "gridReader_tests.h"
 #include "gridReaderBov_tests.h"
+#include "gridWriterBov_tests.h"
 #ifdef WITH_HDF5
 #  include "gridWriterHDF5_tests.h"
 #  include "gridReaderHDF5_tests.h"
@@ -97,6 +98,8 @@ main(int argc, char **argv)
 	RUNTEST(&gridPatch_freeVarData_test, hasFailed);
 	RUNTEST(&gridPatch_replaceVarData_test, hasFailed);
 	RUNTEST(&gridPatch_popVarData_test, hasFailed);
+	RUNTEST(&gridPatch_getVarRuns_test, hasFailed);
+	RUNTEST(&gridPatch_packVarData_test, hasFailed);
 	RUNTEST(&gridPatch_getVarHandle_test, hasFailed);
 	RUNTEST(&gridPatch_getVarDataHandle_test, hasFailed);
 	RUNTEST(&gridPatch_getVarDataHandleByVar_test, hasFailed);
@@ -253,6 +256,18 @@ main(int argc, char **argv)
 	global_max_allocated_bytes = 0;
 #endif
 
+	if (rank == 0) {
+		printf("\nRunning tests for gridWriterBov:\n");
+	}
+	RUNTEST(&gridWriterBov_new_test, hasFailed);
+	RUNTEST(&gridWriterBov_del_test, hasFailed);
+	RUNTEST(&gridWriterBov_writeGridRegular_test, hasFailed);
+#ifdef XMEM_TRACK_MEM
+	if (rank == 0)
+		xmem_info(stdout);
+	global_max_allocated_bytes = 0;
+#endif
+
 
 #ifdef WITH_HDF5
 	if (rank == 0) {
@@ -301,6 +316,7 @@ main(int argc, char **argv)
 	RUNTEST(&gridWriterSilo_deactivate_test, hasFailed);
 	RUNTEST(&gridWriterSilo_writeGridPatch_test, hasFailed);
 	RUNTEST(&gridWriterSilo_writeGridRegular_test, hasFailed);
+	RUNTEST(&gridWriterSilo_writeGridRegularPreview_test, hasFailed);
 #  ifdef XMEM_TRACK_MEM
 	if (rank == 0)
 		xmem_info(stdout);
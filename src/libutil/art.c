@@ -19,6 +19,12 @@
 #include <assert.h>
 #include <string.h>
 #include <inttypes.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#ifdef WITH_OPENMP
+#  include <omp.h>
+#endif
 #include "xmem.h"
 #include "xfile.h"
 #include "xstring.h"
@@ -65,6 +71,9 @@
  */
 #define ART_SIZEOF_PARTICLE 24
 
+/** @brief  Gives the number of components stored per particle. */
+#define ART_NUM_COMPONENTS 6
+
 
 /*--- Prototypes of local functions -------------------------------------*/
 
@@ -403,6 +412,120 @@ local_calcSkipAct(int      normalizer,
                   uint64_t *pActCalc);
 
 
+/**
+ * @brief  Transfers a range of particles between the file set and the
+ *         data arrays.
+ *
+ * This is the engine behind art_read() and art_write().  Every page
+ * touched by the range is a task of its own.  The tasks are distributed
+ * over the OpenMP threads and use positioned I/O on descriptors that
+ * are shared by all threads, so there is no seek state to protect.
+ *
+ * @param[in]      art
+ *                    The ART file object, a header must be attached.
+ * @param[in]      mode
+ *                    Whether to read or to write.
+ * @param[in]      pSkip
+ *                    The number of particles to skip in the file set.
+ * @param[in]      pAct
+ *                    The number of particles to transfer.
+ * @param[in,out]  *data
+ *                    The 6 stais, see art_writeToPage().
+ *
+ * @return  Returns nothing.
+ */
+static void
+local_transferPages(const art_t art,
+                    artMode_t   mode,
+                    uint64_t    pSkip,
+                    uint64_t    pAct,
+                    stai_t      *data);
+
+
+/**
+ * @brief  Gives the file holding a page and the page number in that
+ *         file.
+ *
+ * @param[in]   art
+ *                 The ART file object.
+ * @param[in]   page
+ *                 The page number counted over the whole file set.
+ * @param[out]  *numFile
+ *                 Receives the file holding the page.
+ * @param[out]  *pageInFile
+ *                 Receives the number of the page within the file.
+ *
+ * @return  Returns nothing.
+ */
+static void
+local_locatePage(const art_t art, int page, int *numFile, int *pageInFile);
+
+
+/**
+ * @brief  Opens a data file for positioned I/O.
+ *
+ * @param[in]  art
+ *                The ART file object.
+ * @param[in]  numFile
+ *                The file to open.  For writing it must already exist,
+ *                see art_createEmptyFile().
+ * @param[in]  mode
+ *                The mode to open the file in.
+ *
+ * @return  Returns the file descriptor.
+ */
+static int
+local_openDataFile(const art_t art, int numFile, artMode_t mode);
+
+
+/**
+ * @brief  Reads a run of one component from a page into a stai.
+ *
+ * @param[in]      fd
+ *                    The file to read from.
+ * @param[in]      offset
+ *                    The position of the first value in the file.
+ * @param[in]      num
+ *                    The number of values to read.
+ * @param[in,out]  component
+ *                    The stai receiving the values.
+ * @param[in]      pos
+ *                    The position in the stai of the first value.
+ * @param[in]      doByteswap
+ *                    Whether the values need to be byteswapped.
+ * @param[in]      *buffer
+ *                    Scratch space for at least @c num values, used if
+ *                    the values cannot be read into the stai directly.
+ *
+ * @return  Returns nothing.
+ */
+static void
+local_readRun(int      fd,
+              off_t    offset,
+              uint64_t num,
+              stai_t   component,
+              uint64_t pos,
+              bool     doByteswap,
+              float    *buffer);
+
+
+/**
+ * @brief  Writes a run of one component of a page from a stai.
+ *
+ * This is the inverse of local_readRun(), the parameters are the same.
+ *
+ * @return  Returns nothing.
+ */
+static void
+local_writeRun(int          fd,
+               off_t        offset,
+               uint64_t     num,
+               const stai_t component,
+               uint64_t     pos,
+               bool         doByteswap,
+               float        *buffer);
+
+
 /**
  * @brief  Calculates how many digits an integer value has.
  *
@@ -468,7 +591,7 @@ art_del(art_t *art)
 		xfree((*art)->fileNameHeader);
 
 	xfree(*art);
-	art = NULL;
+	*art = NULL;
 }
 
 extern void
@@ -574,8 +697,8 @@ art_open(art_t art, artMode_t mode, int numFile)
 
 	art->lastOpened         = numFile;
 	art->numPagesInThisFile = (numFile == art->numFiles - 1)
-	                          ? art->numParticlesInLastPage
-							  : art->numParticlesInPage;
+	                          ? art->numPagesInLastFile
+	                          : art->numPagesInFile;
 	art->numParticlesInThisFile = (numFile == art->numFiles - 1)
 	                              ? art->numParticlesInLastFile
 								  : art->numParticlesInFile;
@@ -600,6 +723,31 @@ art_createEmptyFile(const art_t art, int numFile)
 	                         * numPagesTotal);
 }
 
+extern void
+art_calcRangeForRank(const art_t art,
+                     int         rank,
+                     int         numRanks,
+                     uint64_t    *pSkip,
+                     uint64_t    *pAct)
+{
+	uint64_t numParticles;
+	uint64_t pagesLo, pagesHi, pLo, pHi;
+
+	assert(art != NULL);
+	assert(art->header != NULL);
+	assert(rank >= 0 && rank < numRanks);
+	assert(pSkip != NULL && pAct != NULL);
+
+	numParticles = artHeader_getNumParticlesTotal(art->header);
+	pagesLo      = (uint64_t)art->numTotalPages * rank / numRanks;
+	pagesHi      = (uint64_t)art->numTotalPages * (rank + 1) / numRanks;
+	pLo          = pagesLo * art->numParticlesInPage;
+	pHi          = pagesHi * art->numParticlesInPage;
+
+	*pSkip = (pLo < numParticles) ? pLo : numParticles;
+	*pAct  = ((pHi < numParticles) ? pHi : numParticles) - *pSkip;
+}
+
 extern void
 art_close(art_t art)
 {
@@ -686,34 +834,13 @@ art_write(art_t    art,
           uint64_t pWrite,
           stai_t   *data)
 {
-	uint64_t numPartsWriteTotal = UINT64_C(0);
-	int      firstFile, lastFile;
-
 	assert(art != NULL);
+	assert(art->header != NULL);
 	assert(pSkip + pWrite <= artHeader_getNumParticlesTotal(art->header));
 
-	local_calcFirstLast(art->numParticlesInFile, art->numFiles - 1,
-	                    pSkip, pWrite, &firstFile, &lastFile);
-	pSkip -= ((uint64_t)firstFile) * art->numParticlesInFile;
-
-	for (int i = firstFile; i <= lastFile; i++) {
-		uint64_t pSkipFile, pWriteFile, actualWrite;
-
-		art_open(art, ART_MODE_WRITE, i);
-		local_calcSkipAct(art->numParticlesInThisFile,
-		                  pSkip, pWrite, &pSkipFile, &pWriteFile);
-		actualWrite = art_writeToFile(art, i, pSkipFile, pWriteFile, data);
-		assert(actualWrite == pWriteFile);
-		art_close(art);
-
-		local_rebaseStaisData(data, actualWrite);
-		numPartsWriteTotal += actualWrite;
-		pSkip              -= pSkipFile;
-		pWrite             -= pWriteFile;
-	}
-	local_rebaseStaisData(data, -((int64_t)numPartsWriteTotal));
+	local_transferPages(art, ART_MODE_WRITE, pSkip, pWrite, data);
 
-	return numPartsWriteTotal;
+	return pWrite;
 }
 
 extern uint64_t
@@ -787,34 +914,13 @@ art_readFromFile(art_t    art,
 extern uint64_t
 art_read(art_t art, uint64_t pSkip, uint64_t pRead, stai_t *data)
 {
-	uint64_t numPartsReadTotal = UINT64_C(0);
-	int      firstFile, lastFile;
-
 	assert(art != NULL);
+	assert(art->header != NULL);
 	assert(pSkip + pRead <= artHeader_getNumParticlesTotal(art->header));
 
-	local_calcFirstLast(art->numParticlesInFile, art->numFiles - 1,
-	                    pSkip, pRead, &firstFile, &lastFile);
-	pSkip -= ((uint64_t)firstFile) * art->numParticlesInFile;
-
-	for (int i = firstFile; i <= lastFile; i++) {
-		uint64_t pSkipFile, pReadFile, actualRead;
-
-		art_open(art, ART_MODE_READ, i);
-		local_calcSkipAct(art->numParticlesInThisFile,
-		                  pSkip, pRead, &pSkipFile, &pReadFile);
-		actualRead = art_readFromFile(art, i, pSkipFile, pReadFile, data);
-		assert(actualRead == pReadFile);
-		art_close(art);
-
-		local_rebaseStaisData(data, actualRead);
-		numPartsReadTotal += actualRead;
-		pSkip             -= pSkipFile;
-		pRead             -= pReadFile;
-	}
-	local_rebaseStaisData(data, -((int64_t)numPartsReadTotal));
+	local_transferPages(art, ART_MODE_READ, pSkip, pRead, data);
 
-	return numPartsReadTotal;
+	return pRead;
 }
 
 extern void
@@ -1032,7 +1138,7 @@ local_readComponent(art_t    art,
 		return;
 	}
 	float *buffer;
-	bool  bufferIsAllocated;
+	bool  bufferIsAllocated = false;
 
 	if (stai_isLinear(component)
 	    && (stai_getSizeOfElementInBytes(component) == sizeof(float))) {
@@ -1061,33 +1167,21 @@ local_readComponent(art_t    art,
 static void
 local_fillBufferFromStai(float *buffer, stai_t stai, int numValues)
 {
-	if (stai_getSizeOfElementInBytes(stai) == sizeof(float)) {
-		stai_getElementsMulti(stai, 0, buffer, numValues);
-	} else if (stai_getSizeOfElementInBytes(stai) == sizeof(double)) {
-		double d;
-		for (int i = 0; i < numValues; i++) {
-			stai_getElement(stai, i, &d);
-			buffer[i] = (float)d;
-		}
-	} else {
+	if ((stai_getSizeOfElementInBytes(stai) != sizeof(float))
+	    && (stai_getSizeOfElementInBytes(stai) != sizeof(double)))
 		diediedie(EXIT_FAILURE);
-	}
+
+	stai_getElementsMultiAsFloat(stai, 0, buffer, numValues);
 }
 
 static void
 local_copyBufferToStai(const float *buffer, stai_t stai, int numValues)
 {
-	if (stai_getSizeOfElementInBytes(stai) == sizeof(float)) {
-		stai_setElementsMulti(stai, 0, buffer, numValues);
-	} else if (stai_getSizeOfElementInBytes(stai) == sizeof(double)) {
-		double d;
-		for (int i = 0; i < numValues; i++) {
-			d = (double)(buffer[i]);
-			stai_setElement(stai, i, &d);
-		}
-	} else {
+	if ((stai_getSizeOfElementInBytes(stai) != sizeof(float))
+	    && (stai_getSizeOfElementInBytes(stai) != sizeof(double)))
 		diediedie(EXIT_FAILURE);
-	}
+
+	stai_setElementsMultiFromFloat(stai, 0, buffer, numValues);
 }
 
 static void
@@ -1156,6 +1250,162 @@ local_calcSkipAct(int      normalizer,
 		*pActCalc = pAct;
 }
 
+static void
+local_transferPages(const art_t art,
+                    artMode_t   mode,
+                    uint64_t    pSkip,
+                    uint64_t    pAct,
+                    stai_t      *data)
+{
+	uint64_t numInPage = (uint64_t)art->numParticlesInPage;
+	int      firstPage, lastPage, firstFile, lastFile, pageInFile;
+	int      *fds;
+	float    *buffers;
+	int      numThreads = 1;
+	bool     doByteswap = false;
+
+	if (pAct == UINT64_C(0))
+		return;
+
+	if (endian_getSystemEndianess()
+	    != artHeader_getFileEndianess(art->header))
+		doByteswap = true;
+
+	firstPage = (int)(pSkip / numInPage);
+	lastPage  = (int)((pSkip + pAct - 1) / numInPage);
+	local_locatePage(art, firstPage, &firstFile, &pageInFile);
+	local_locatePage(art, lastPage, &lastFile, &pageInFile);
+
+	fds = xmalloc(sizeof(int) * (lastFile - firstFile + 1));
+	for (int i = firstFile; i <= lastFile; i++)
+		fds[i - firstFile] = local_openDataFile(art, i, mode);
+
+#ifdef WITH_OPENMP
+	numThreads = omp_get_max_threads();
+#endif
+	buffers = xmalloc(sizeof(float) * numInPage * numThreads);
+
+#ifdef WITH_OPENMP
+#  pragma omp parallel for schedule(dynamic)
+#endif
+	for (int page = firstPage; page <= lastPage; page++) {
+		float    *buffer    = buffers;
+		uint64_t pageStart  = (uint64_t)page * numInPage;
+		uint64_t lo         = (pSkip > pageStart) ? pSkip : pageStart;
+		uint64_t hi         = (pSkip + pAct < pageStart + numInPage)
+		                      ? pSkip + pAct : pageStart + numInPage;
+		int      numFile, pageNumber;
+
+#ifdef WITH_OPENMP
+		buffer += numInPage * omp_get_thread_num();
+#endif
+		local_locatePage(art, page, &numFile, &pageNumber);
+		for (int i = 0; i < ART_NUM_COMPONENTS; i++) {
+			off_t offset;
+
+			if (data[i] == NULL)
+				continue;
+
+			offset = (((off_t)pageNumber * ART_NUM_COMPONENTS + i)
+			          * (off_t)numInPage + (off_t)(lo - pageStart))
+			         * (off_t)sizeof(float);
+			if (mode == ART_MODE_READ)
+				local_readRun(fds[numFile - firstFile], offset, hi - lo,
+				              data[i], lo - pSkip, doByteswap, buffer);
+			else
+				local_writeRun(fds[numFile - firstFile], offset, hi - lo,
+				               data[i], lo - pSkip, doByteswap, buffer);
+		}
+	}
+
+	xfree(buffers);
+	for (int i = firstFile; i <= lastFile; i++)
+		close(fds[i - firstFile]);
+	xfree(fds);
+} /* local_transferPages */
+
+static void
+local_locatePage(const art_t art, int page, int *numFile, int *pageInFile)
+{
+	*numFile = page / art->numPagesInFile;
+	if (*numFile > art->numFiles - 1)
+		*numFile = art->numFiles - 1;
+	*pageInFile = page - *numFile * art->numPagesInFile;
+}
+
+static int
+local_openDataFile(const art_t art, int numFile, artMode_t mode)
+{
+	return xopen(art->fileNamesData[numFile],
+	             (mode == ART_MODE_READ) ? O_RDONLY : O_WRONLY, 0);
+}
+
+static void
+local_readRun(int      fd,
+              off_t    offset,
+              uint64_t num,
+              stai_t   component,
+              uint64_t pos,
+              bool     doByteswap,
+              float    *buffer)
+{
+	int sizeOfElement = stai_getSizeOfElementInBytes(component);
+
+	if ((sizeOfElement != sizeof(float)) && (sizeOfElement != sizeof(double)))
+		diediedie(EXIT_FAILURE);
+
+	if (!doByteswap && stai_isLinear(component)
+	    && (sizeOfElement == sizeof(float))) {
+		xpread(fd, (float *)stai_getBase(component) + pos,
+		       num * sizeof(float), offset);
+		return;
+	}
+
+	xpread(fd, buffer, num * sizeof(float), offset);
+	if (doByteswap && (sizeOfElement == sizeof(float))) {
+		stai_setElementsMultiSwapped(component, pos, buffer, num, 1);
+	} else {
+		if (doByteswap) {
+			for (uint64_t i = 0; i < num; i++)
+				byteswap(buffer + i, sizeof(float));
+		}
+		stai_setElementsMultiFromFloat(component, pos, buffer, num);
+	}
+}
+
+static void
+local_writeRun(int          fd,
+               off_t        offset,
+               uint64_t     num,
+               const stai_t component,
+               uint64_t     pos,
+               bool         doByteswap,
+               float        *buffer)
+{
+	int sizeOfElement = stai_getSizeOfElementInBytes(component);
+
+	if ((sizeOfElement != sizeof(float)) && (sizeOfElement != sizeof(double)))
+		diediedie(EXIT_FAILURE);
+
+	if (!doByteswap && stai_isLinear(component)
+	    && (sizeOfElement == sizeof(float))) {
+		xpwrite(fd, (float *)stai_getBase(component) + pos,
+		        num * sizeof(float), offset);
+		return;
+	}
+
+	if (doByteswap && (sizeOfElement == sizeof(float))) {
+		stai_getElementsMultiSwapped(component, pos, buffer, num, 1);
+	} else {
+		stai_getElementsMultiAsFloat(component, pos, buffer, num);
+		if (doByteswap) {
+			for (uint64_t i = 0; i < num; i++)
+				byteswap(buffer + i, sizeof(float));
+		}
+	}
+	xpwrite(fd, buffer, num * sizeof(float), offset);
+}
+
 static int
 local_getRequiredDigits(int numFiles)
 {
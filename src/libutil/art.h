@@ -352,6 +352,38 @@ extern void
 art_createEmptyFile(const art_t art, int numFile);
 
 
+/**
+ * @brief  Calculates the particles a rank should handle when a file set
+ *         is split over several ranks.
+ *
+ * The pages are distributed evenly, every rank gets a contiguous range
+ * of particles that starts and ends at a page boundary.  Handing these
+ * ranges to art_read() or art_write() on every rank thus transfers the
+ * whole set without two ranks ever touching the same page.
+ *
+ * @param[in]   art
+ *                 The ART file object, a header must be attached.
+ *                 Passing @c NULL is undefined.
+ * @param[in]   rank
+ *                 The rank to calculate the range for.
+ * @param[in]   numRanks
+ *                 The number of ranks the set is split over.
+ * @param[out]  *pSkip
+ *                 Receives the number of particles to skip.
+ * @param[out]  *pAct
+ *                 Receives the number of particles to act on, this may
+ *                 be 0 if there are more ranks than pages.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+art_calcRangeForRank(const art_t art,
+                     int         rank,
+                     int         numRanks,
+                     uint64_t    *pSkip,
+                     uint64_t    *pAct);
+
+
 /**
  * @brief  Will close the currently opened PMcrsX.DAT file.
  *
@@ -482,6 +514,12 @@ art_writeToFile(art_t    art,
 /**
  * @brief  Writes a set of particles to a file set.
  *
+ * The pages touched are written concurrently by the OpenMP threads with
+ * positioned writes, the file pointer of the ART object is not used.
+ * Several ranks may write to the same file set at the same time as long
+ * as their ranges do not overlap, see art_calcRangeForRank().  All
+ * files must exist beforehand, see art_createEmptyFile().
+ *
  * @param[in,out]  art
  *                    The ART file object that should be used for
  *                    writing.  It is required that a header is
@@ -605,7 +643,9 @@ art_readFromFile(art_t    art,
 /**
  * @brief  Read a subset of particles from the whole file set.
  *
- * This is the inverse pf art_write().
+ * This is the inverse pf art_write().  Like the latter, it transfers the
+ * pages concurrently and does not use the file pointer of the ART
+ * object.
  *
  * @param[in,out]  art
  *                    The ART file object from which to read.
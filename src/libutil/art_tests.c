@@ -7,13 +7,19 @@
 #include "util_config.h"
 #include "art_tests.h"
 #include "art.h"
+#include "artHeader.h"
+#include "stai.h"
+#include "endian.h"
+#include "byteswap.h"
+#include "xmem.h"
 #include <stdio.h>
 #include <string.h>
+#include <math.h>
 #ifdef WITH_MPI
 #  include <mpi.h>
 #endif
-#ifdef ENABLE_XMEM_TRACK_MEM
-#  include "../libutil/xmem.h"
+#ifdef WITH_OPENMP
+#  include <omp.h>
 #endif
 
 
@@ -22,9 +28,25 @@
 
 
 /*--- Local defines -----------------------------------------------------*/
+/** @brief  The number of files of the test set. */
+#define LOCAL_NUMFILES 3
+
+/** @brief  The number of particles, the last page is not full. */
+#define LOCAL_NUMPARTICLES 117
 
 
 /*--- Prototypes of local functions -------------------------------------*/
+static art_t
+local_getTestArt(endian_t fileEndianess);
+
+static void
+local_setStais(stai_t *data, float *pos, double *vel, uint64_t offset);
+
+static void
+local_delStais(stai_t *data);
+
+static float
+local_getValue(int component, uint64_t particle);
 
 
 /*--- Implementations of exported functions -----------------------------*/
@@ -44,7 +66,7 @@ art_new_test(void)
 	if (rank == 0)
 		printf("Testing %s... ", __func__);
 
-	art = art_new();
+	art = art_new(ART_USE_DEFAULT_PATH, ART_USE_DEFAULT_SUFFIX, 1);
 	art_del(&art);
 #ifdef XMEM_TRACK_MEM
 	if (allocatedBytes != global_allocated_bytes)
@@ -70,7 +92,7 @@ art_del_test(void)
 	if (rank == 0)
 		printf("Testing %s... ", __func__);
 
-	art = art_new();
+	art = art_new(ART_USE_DEFAULT_PATH, ART_USE_DEFAULT_SUFFIX, 1);
 	art_del(&art);
 	if (art != NULL)
 		hasPassed = false;
@@ -82,4 +104,167 @@ art_del_test(void)
 	return hasPassed ? true : false;
 }
 
+extern bool
+art_write_test(void)
+{
+	bool     hasPassed = true;
+	int      rank      = 0;
+	art_t    art;
+	stai_t   data[6];
+	float    *pos;
+	double   *vel;
+	endian_t fileEndianess;
+#ifdef WITH_OPENMP
+	int      numThreads = omp_get_max_threads();
+#endif
+#ifdef XMEM_TRACK_MEM
+	size_t   allocatedBytes = global_allocated_bytes;
+#endif
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+#ifdef WITH_OPENMP
+	// Several threads transfer pages at the same time.
+	omp_set_num_threads(4);
+#endif
+	pos = xmalloc(sizeof(float) * 3 * LOCAL_NUMPARTICLES);
+	vel = xmalloc(sizeof(double) * 3 * LOCAL_NUMPARTICLES);
+
+	// The second pass writes the files in the other endianess.
+	for (int pass = 0; pass < 2; pass++) {
+		fileEndianess = endian_getSystemEndianess();
+		if (pass == 1)
+			fileEndianess = endian_systemIsLittle() ? ENDIAN_BIG
+			                : ENDIAN_LITTLE;
+		art = local_getTestArt(fileEndianess);
+
+		// Write in two ranges, split within a page of the second file.
+		for (uint64_t i = 0; i < LOCAL_NUMPARTICLES; i++) {
+			for (int j = 0; j < 3; j++) {
+				pos[j * LOCAL_NUMPARTICLES + i] = local_getValue(j, i);
+				vel[i * 3 + j] = local_getValue(j + 3, i);
+			}
+		}
+		local_setStais(data, pos, vel, 0);
+		art_write(art, 0, 40, data);
+		local_delStais(data);
+		local_setStais(data, pos, vel, 40);
+		art_write(art, 40, LOCAL_NUMPARTICLES - 40, data);
+		local_delStais(data);
+
+		// The files must hold the values in the file endianess.
+		{
+			FILE  *f = fopen(art_getDataFileName(art, 0), "rb");
+			float value;
+			if ((f == NULL) || (fread(&value, sizeof(float), 1, f) != 1))
+				hasPassed = false;
+			else {
+				if (pass == 1)
+					byteswap(&value, sizeof(float));
+				if (islessgreater(value, local_getValue(0, 0)))
+					hasPassed = false;
+			}
+			if (f != NULL)
+				fclose(f);
+		}
+
+		// Read a range spanning all files, and the whole set without the
+		// velocities.
+		memset(pos, 0, sizeof(float) * 3 * LOCAL_NUMPARTICLES);
+		memset(vel, 0, sizeof(double) * 3 * LOCAL_NUMPARTICLES);
+		local_setStais(data, pos, vel, 0);
+		art_read(art, 13, 100, data);
+		for (uint64_t i = 0; i < 100; i++) {
+			for (int j = 0; j < 3; j++) {
+				if (islessgreater(pos[j * LOCAL_NUMPARTICLES + i],
+				                   local_getValue(j, i + 13))
+				    || islessgreater(vel[i * 3 + j],
+				                     local_getValue(j + 3, i + 13)))
+					hasPassed = false;
+			}
+		}
+		for (int j = 3; j < 6; j++)
+			stai_del(&(data[j]));
+		memset(vel, 0, sizeof(double) * 3 * LOCAL_NUMPARTICLES);
+		art_read(art, 0, LOCAL_NUMPARTICLES, data);
+		for (uint64_t i = 0; i < LOCAL_NUMPARTICLES; i++) {
+			for (int j = 0; j < 3; j++) {
+				if (islessgreater(pos[j * LOCAL_NUMPARTICLES + i],
+				                   local_getValue(j, i))
+				    || islessgreater(vel[i * 3 + j], 0.0))
+					hasPassed = false;
+			}
+		}
+		local_delStais(data);
+
+		for (int i = 0; i < LOCAL_NUMFILES; i++)
+			remove(art_getDataFileName(art, i));
+		art_del(&art);
+	}
+
+	xfree(vel);
+	xfree(pos);
+#ifdef WITH_OPENMP
+	omp_set_num_threads(numThreads);
+#endif
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+} /* art_write_test */
+
 /*--- Implementations of local functions --------------------------------*/
+static art_t
+local_getTestArt(endian_t fileEndianess)
+{
+	art_t       art;
+	artHeader_t header;
+
+	// 16 particles in a page, 8 pages spread as 2, 2, 4 over the files.
+	header = artHeader_new();
+	artHeader_setNrowc(header, 4);
+	artHeader_setNspecies(header, 1);
+	artHeader_setLspecies(header, LOCAL_NUMPARTICLES, 0);
+	artHeader_setFileEndianess(header, fileEndianess);
+
+	art = art_new("tests", "_test.DAT", LOCAL_NUMFILES);
+	art_attachHeader(art, header);
+	for (int i = 0; i < LOCAL_NUMFILES; i++)
+		art_createEmptyFile(art, i);
+
+	return art;
+}
+
+static void
+local_setStais(stai_t *data, float *pos, double *vel, uint64_t offset)
+{
+	// The positions are contiguous floats that are transferred directly,
+	// the velocities are interleaved doubles that need a conversion.
+	for (int j = 0; j < 3; j++) {
+		data[j]     = stai_new(pos + j * LOCAL_NUMPARTICLES + offset,
+		                       sizeof(float), sizeof(float));
+		data[j + 3] = stai_new(vel + offset * 3 + j, sizeof(double),
+		                       3 * sizeof(double));
+	}
+}
+
+static void
+local_delStais(stai_t *data)
+{
+	for (int j = 0; j < 6; j++) {
+		if (data[j] != NULL)
+			stai_del(&(data[j]));
+	}
+}
+
+static float
+local_getValue(int component, uint64_t particle)
+{
+	return (float)(1000 * component) + (float)particle + 0.5f;
+}
@@ -18,5 +18,8 @@ art_new_test(void);
 extern bool
 art_del_test(void);
 
+extern bool
+art_write_test(void);
+
 
 #endif
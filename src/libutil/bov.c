@@ -13,12 +13,18 @@
 
 
 /*--- Includes ----------------------------------------------------------*/
+// ftruncate() and O_DIRECT are not C99.
+#define _GNU_SOURCE
 #include "util_config.h"
 #include "bov.h"
 #include <assert.h>
 #include <string.h>
 #include <ctype.h>
 #include <inttypes.h>
+#include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/types.h>
 #include "endian.h"
 #include "xmem.h"
 #include "xstring.h"
@@ -33,6 +39,12 @@
 
 /*--- Local defines -----------------------------------------------------*/
 
+/** @brief  The largest number of bytes staged in a buffer at once. */
+#define LOCAL_MAX_BUFFER_BYTES (1 << 26)
+
+/** @brief  The alignment of offsets, sizes and buffers for O_DIRECT. */
+#define LOCAL_DIRECT_IO_ALIGN 4096
+
 
 /*--- Prototypes of local functions -------------------------------------*/
 
@@ -249,28 +261,86 @@ local_readDataComponent(const char *line);
 
 
 /**
- * @brief  Reads in a buffered mode from the data file.
+ * @brief  The actual function to read windowed data from a data file.
+ *
+ * Rows of the window that are adjacent in the file are read with a
+ * single pread().  They go straight into @c data if the formats agree,
+ * otherwise they are staged in a buffer of at most
+ * #LOCAL_MAX_BUFFER_BYTES.
+ *
+ * @return  Returns nothing.
  */
 static void
-local_readBuffered(bov_t       bov,
-                   void        *data,
-                   bovFormat_t dataFormat,
-                   int         numComponents,
-                   size_t      numElements,
-                   FILE        *f);
+local_readWindowedActualRead(bov_t          bov,
+                             void           *data,
+                             bovFormat_t    dataFormat,
+                             int            numComponents,
+                             const uint32_t *idxLo,
+                             const uint32_t *dims);
 
 
 /**
- * @brief  The actual function to read windowed data from a data file.
- * @return  Returns nothing.
+ * @brief  Opens the data file, with O_DIRECT if requested and possible.
+ *
+ * @param[in]   *fileName
+ *                 The name of the data file.
+ * @param[in]   flags
+ *                 The flags passed to open().
+ * @param[in]   tryDirectIO
+ *                 Whether to try opening the file with O_DIRECT.
+ * @param[out]  *isDirect
+ *                 Is set to whether the file was opened with O_DIRECT.
+ *
+ * @return  Returns the file descriptor.
  */
-static void
-local_readWindowedActualRead(bov_t       bov,
-                             void        *data,
-                             bovFormat_t dataFormat,
-                             int         numComponents,
-                             uint32_t    *idxLo,
-                             uint32_t    *dims);
+static int
+local_openDataFile(const char *fileName,
+                   int        flags,
+                   bool       tryDirectIO,
+                   bool       *isDirect);
+
+
+/**
+ * @brief  Gives the number of rows of a window, starting at a given
+ *         row, that are consecutive in the data file.
+ *
+ * @param[in]  bov
+ *                The bov object to work with.
+ * @param[in]  *dims
+ *                The size of the window.
+ * @param[in]  row
+ *                The first row, counted as <tt>j + k * dims[1]</tt>.
+ * @param[in]  maxRows
+ *                The largest number of rows to return.
+ *
+ * @return  Returns the number of rows that can be transferred at once.
+ */
+static size_t
+local_getNumRowsInRun(const bov_t    bov,
+                      const uint32_t *dims,
+                      size_t         row,
+                      size_t         maxRows);
+
+
+/**
+ * @brief  Gives the position of a row of a window in the data file.
+ *
+ * @param[in]  bov
+ *                The bov object to work with.
+ * @param[in]  *idxLo
+ *                The lower corner of the window.
+ * @param[in]  *dims
+ *                The size of the window.
+ * @param[in]  row
+ *                The row, counted as <tt>j + k * dims[1]</tt>.
+ *
+ * @return  Returns the offset in bytes.
+ */
+static off_t
+local_getOffsetOfRow(const bov_t    bov,
+                     const uint32_t *idxLo,
+                     const uint32_t *dims,
+                     size_t         row);
 
 
 /**
@@ -287,31 +357,54 @@ local_getSizeForFormat(bovFormat_t format);
 
 
 /**
- * @brief  Reads a pencil from the data file into a buffer.
+ * @brief  Reads a run of consecutive elements from the data file into a
+ *         buffer.
  *
- * This will read a consecutive block of elements from the file into a
- * provided buffer, adjusting the endianess to the system endianess if
- * required.
+ * The endianess is adjusted to the system endianess if required.  With
+ * O_DIRECT the read is widened to aligned boundaries, the buffer must
+ * then be aligned and hold #LOCAL_DIRECT_IO_ALIGN bytes more than the
+ * run on either side.
+ *
+ * @param[in]   bov
+ *                 The bov file object to work with.
+ * @param[in]   fd
+ *                 The data file.
+ * @param[in]   isDirect
+ *                 Whether the data file has been opened with O_DIRECT.
+ * @param[out]  *buffer
+ *                 The buffer to read the data into.
+ * @param[in]   offset
+ *                 The position of the run in the file in bytes.
+ * @param[in]   numElements
+ *                 The number of elements to read.
+ *
+ * @return  Returns a pointer to the first element of the run in the
+ *          buffer.
+ */
+static void *
+local_readRun(const bov_t bov,
+              int         fd,
+              bool        isDirect,
+              void        *buffer,
+              off_t       offset,
+              size_t      numElements);
+
+
+/**
+ * @brief  Swaps the bytes of elements if the file and the system
+ *         endianess differ.
  *
  * @param[in]      bov
  *                    The bov file object to work with.
- * @param[out]     *buffer
- *                    The buffer to read the data into.  The data will be
- *                    returned in the correct endianess of the system,
- *                    regardless of the endianess in the file.
+ * @param[in,out]  *buffer
+ *                    The elements.
  * @param[in]      numElements
- *                    The number of elements to read consecutively from the
- *                    file.
- * @param[in,out]  *f
- *                    The file from which to read.
+ *                    The number of elements.
  *
  * @return  Returns nothing.
  */
 static void
-local_readPencil(const bov_t bov,
-                 void        *buffer,
-                 size_t      numElements,
-                 FILE        *f);
+local_adjustEndianess(const bov_t bov, void *buffer, size_t numElements);
 
 
 /**
@@ -404,6 +497,7 @@ bov_new(void)
 	bov->bovFileName      = NULL;
 	bov->bovFilePath      = NULL;
 	bov->machineEndianess = endian_getSystemEndianess();
+	bov->useDirectIO      = false;
 	bov->time             = 0.0;
 	bov->data_file        = NULL;
 	bov->data_format      = BOV_FORMAT_BYTE;
@@ -559,6 +653,14 @@ bov_getDataComponents(const bov_t bov)
 	return bov->data_components;
 }
 
+extern bool
+bov_getUseDirectIO(const bov_t bov)
+{
+	assert(bov != NULL);
+
+	return bov->useDirectIO;
+}
+
 extern void
 bov_setTime(bov_t bov, const double time)
 {
@@ -657,44 +759,46 @@ bov_setDataComponents(bov_t bov, const int numComponents)
 	bov->data_components = numComponents;
 }
 
+extern void
+bov_setFileName(bov_t bov, const char *bovFileName)
+{
+	assert(bov != NULL);
+	assert(bovFileName != NULL);
+
+	local_setNewBovFileNameAndPath(bov, bovFileName);
+}
+
+extern void
+bov_setUseDirectIO(bov_t bov, bool useDirectIO)
+{
+	assert(bov != NULL);
+
+	bov->useDirectIO = useDirectIO;
+}
+
 extern void
 bov_read(bov_t       bov,
          void        *data,
          bovFormat_t dataFormat,
          int         numComponents)
 {
-	FILE   *f;
-	char   *fileName;
-	size_t numElements;
+	const uint32_t idxLo[3] = {0, 0, 0};
 
 	assert(bov != NULL);
 	assert(data != NULL);
 	assert(numComponents > 0);
 
-	numElements = bov->data_size[0] * bov->data_size[1] * bov->data_size[2];
-	fileName    = bov_getDataFileName(bov);
-	f           = xfopen(fileName, "rb");
-	xfseek(f, bov->byte_offset, SEEK_SET);
-
-	if ((bov->data_format == dataFormat)
-	    && (bov->data_components == numComponents)) {
-		local_readPencil(bov, data, numElements, f);
-	} else {
-		local_readBuffered(bov, data, dataFormat, numComponents,
-		                   numElements, f);
-	}
-
-	xfclose(&f);
-	xfree(fileName);
+	local_readWindowedActualRead(bov, data, dataFormat, numComponents,
+	                             idxLo, bov->data_size);
 }
 
 extern void
-bov_readWindowed(bov_t       bov,
-                 void        *data,
-                 bovFormat_t dataFormat,
-                 int         numComponents,
-                 uint32_t    *idxLo,
-                 uint32_t    *dims)
+bov_readWindowed(bov_t          bov,
+                 void           *data,
+                 bovFormat_t    dataFormat,
+                 int            numComponents,
+                 const uint32_t *idxLo,
+                 const uint32_t *dims)
 {
 	assert(bov != NULL);
 	assert(data != NULL);
@@ -714,6 +818,103 @@ bov_readWindowed(bov_t       bov,
 	                             idxLo, dims);
 }
 
+extern void
+bov_createDataFile(bov_t bov, bool overwrite)
+{
+	char  *fileName;
+	int   fd, flags = O_WRONLY | O_CREAT;
+	off_t size;
+
+	assert(bov != NULL);
+
+	if (!bov_isValidForWrite(bov) || (bov->bovFileName == NULL)) {
+		fprintf(stderr, "The BOV is not valid for writing :-(\n");
+		diediedie(EXIT_FAILURE);
+	}
+
+	flags   |= overwrite ? O_TRUNC : O_EXCL;
+	fileName = bov_getDataFileName(bov);
+	fd       = xopen(fileName, flags, 0666);
+
+	size = (off_t)local_getSizeForFormat(bov->data_format)
+	       * bov->data_components * bov->data_size[0]
+	       * bov->data_size[1] * bov->data_size[2] + bov->byte_offset;
+	if (ftruncate(fd, size) != 0) {
+		fprintf(stderr, "Could not resize %s: %s\n", fileName,
+		        strerror(errno));
+		diediedie(EXIT_FAILURE);
+	}
+
+	close(fd);
+	xfree(fileName);
+}
+
+extern void
+bov_writeWindowed(bov_t          bov,
+                  const void     *data,
+                  bovFormat_t    dataFormat,
+                  int            numComponents,
+                  const uint32_t *idxLo,
+                  const uint32_t *dims)
+{
+	char   *fileName;
+	int    fd;
+	bool   isDirect;
+	size_t sizeRecord, numRows, maxRows;
+	void   *buffer  = NULL;
+
+	assert(bov != NULL);
+	assert(data != NULL);
+	assert(idxLo != NULL);
+	assert(dims != NULL);
+	assert(dims[0] > 0 && dims[1] > 0 && dims[2] > 0);
+
+	if ((dataFormat != bov->data_format)
+	    || (numComponents != bov->data_components)) {
+		fprintf(stderr, "Data must be written in the format of the bov\n");
+		diediedie(EXIT_FAILURE);
+	}
+	if ((idxLo[0] + dims[0] > bov->data_size[0])
+	    || (idxLo[1] + dims[1] > bov->data_size[1])
+	    || (idxLo[2] + dims[2] > bov->data_size[2])) {
+		fprintf(stderr, "Window too large for data in bov :(\n");
+		diediedie(EXIT_FAILURE);
+	}
+
+	fileName   = bov_getDataFileName(bov);
+	fd         = local_openDataFile(fileName, O_WRONLY, false, &isDirect);
+	sizeRecord = local_getSizeForFormat(bov->data_format)
+	             * bov->data_components;
+	numRows    = (size_t)dims[1] * dims[2];
+	maxRows    = numRows;
+	if (bov->machineEndianess != bov->data_endian) {
+		maxRows = LOCAL_MAX_BUFFER_BYTES / (sizeRecord * dims[0]);
+		maxRows = (maxRows < 1) ? 1 : maxRows;
+		buffer  = xmalloc(sizeRecord * dims[0] * maxRows);
+	}
+
+	for (size_t row = 0; row < numRows;) {
+		size_t     numRowsRun  = local_getNumRowsInRun(bov, dims, row,
+		                                               maxRows);
+		size_t     numElements = numRowsRun * dims[0];
+		const char *run        = (const char *)data
+		                         + row * dims[0] * sizeRecord;
+		if (buffer != NULL) {
+			memcpy(buffer, run, numElements * sizeRecord);
+			local_adjustEndianess(bov, buffer, numElements);
+			run = buffer;
+		}
+		xpwrite(fd, run, numElements * sizeRecord,
+		        local_getOffsetOfRow(bov, idxLo, dims, row));
+		row += numRowsRun;
+	}
+
+	if (buffer != NULL)
+		xfree(buffer);
+	close(fd);
+	xfree(fileName);
+} /* bov_writeWindowed */
+
 extern void
 bov_write(bov_t bov, const char *bovFileName)
 {
@@ -721,7 +922,8 @@ bov_write(bov_t bov, const char *bovFileName)
 
 	if (bov_isValidForWrite(bov)
 	    && ((bovFileName != NULL) || (bov->bovFileName != NULL))) {
-		local_setNewBovFileNameAndPath(bov, bovFileName);
+		if (bovFileName != NULL)
+			local_setNewBovFileNameAndPath(bov, bovFileName);
 		local_writeBov(bov);
 	} else {
 		fprintf(stderr, "The BOV is not valid for writing :-(\n");
@@ -1036,71 +1238,136 @@ local_readDataComponent(const char *line)
 }
 
 static void
-local_readBuffered(bov_t       bov,
-                   void        *data,
-                   bovFormat_t dataFormat,
-                   int         numComponents,
-                   size_t      numElements,
-                   FILE        *f)
-{
-	int  sizeBufferEle = local_getSizeForFormat(bov->data_format);
-	void *buffer       = xmalloc(sizeBufferEle * bov->data_components
-	                             * numElements);
-
-	local_readPencil(bov, buffer, numElements, f);
-
-	if (bov->data_format == dataFormat)
-		local_mvBufferToData(bov, buffer, numElements,
-		                     data, 0, dataFormat, numComponents);
-	else
-		local_cpBufferToData(bov, buffer, numElements,
-		                     data, 0, dataFormat, numComponents);
-
-	xfree(buffer);
-}
-
-static void
-local_readWindowedActualRead(bov_t       bov,
-                             void        *data,
-                             bovFormat_t dataFormat,
-                             int         numComponents,
-                             uint32_t    *idxLo,
-                             uint32_t    *dims)
+local_readWindowedActualRead(bov_t          bov,
+                             void           *data,
+                             bovFormat_t    dataFormat,
+                             int            numComponents,
+                             const uint32_t *idxLo,
+                             const uint32_t *dims)
 {
 	char   *dataFileName = bov_getDataFileName(bov);
-	FILE   *f            = xfopen(dataFileName, "rb");
-	size_t sizePerEle    = local_getSizeForFormat(bov->data_format);
-	void   *buffer       = xmalloc(sizePerEle * bov->data_components
-	                               * dims[0]);
-
-	for (uint32_t k = idxLo[2]; k - idxLo[2] < dims[2]; k++) {
-		for (uint32_t j = idxLo[1]; j - idxLo[1] < dims[1]; j++) {
-			long   offset;
-			size_t dataOffset;
-			offset     = idxLo[0]
-			             + (j + k * bov->data_size[1]) * bov->data_size[0];
-			offset    *= sizePerEle * bov->data_components;
-			offset    += bov->byte_offset;
-			dataOffset = (j - idxLo[1] + (k - idxLo[2]) * dims[1])
-			             * dims[0];
-			xfseek(f, offset, SEEK_SET);
-			local_readPencil(bov, buffer, (size_t)(dims[0]), f);
+	bool   isDirect;
+	int    fd            = local_openDataFile(dataFileName, O_RDONLY,
+	                                          bov->useDirectIO, &isDirect);
+	size_t sizeRecord    = local_getSizeForFormat(bov->data_format)
+	                       * bov->data_components;
+	size_t sizeDataRec   = local_getSizeForFormat(dataFormat)
+	                       * numComponents;
+	size_t numRows       = (size_t)dims[1] * dims[2];
+	size_t maxRows       = numRows;
+	void   *buffer       = NULL;
+	bool   isInPlace     = !isDirect && (dataFormat == bov->data_format)
+	                       && (sizeDataRec == sizeRecord)
+	                       && (bov->machineEndianess == bov->data_endian);
+
+	if (!isInPlace) {
+		size_t sizeBuffer;
+		maxRows    = LOCAL_MAX_BUFFER_BYTES / (sizeRecord * dims[0]);
+		maxRows    = (maxRows < 1) ? 1 : maxRows;
+		sizeBuffer = sizeRecord * dims[0] * maxRows;
+		if (isDirect) {
+			sizeBuffer += 2 * LOCAL_DIRECT_IO_ALIGN;
+			if (posix_memalign(&buffer, LOCAL_DIRECT_IO_ALIGN,
+			                   sizeBuffer) != 0) {
+				fprintf(stderr, "Could not allocate %zu bytes\n",
+				        sizeBuffer);
+				diediedie(EXIT_FAILURE);
+			}
+		} else {
+			buffer = xmalloc(sizeBuffer);
+		}
+	}
+
+	for (size_t row = 0; row < numRows;) {
+		size_t numRowsRun  = local_getNumRowsInRun(bov, dims, row, maxRows);
+		size_t numElements = numRowsRun * dims[0];
+		size_t dataOffset  = row * dims[0];
+		off_t  offset      = local_getOffsetOfRow(bov, idxLo, dims, row);
+
+		if (isInPlace) {
+			xpread(fd, (char *)data + dataOffset * sizeDataRec,
+			       numElements * sizeRecord, offset);
+		} else {
+			void *run = local_readRun(bov, fd, isDirect, buffer, offset,
+			                          numElements);
 			if (dataFormat == bov->data_format)
-				local_mvBufferToData(bov, buffer, (size_t)(dims[0]),
-				                     data, dataOffset, dataFormat,
-				                     numComponents);
+				local_mvBufferToData(bov, run, numElements, data,
+				                     dataOffset, dataFormat, numComponents);
 			else
-				local_cpBufferToData(bov, buffer, (size_t)(dims[0]),
-				                     data, dataOffset, dataFormat,
-				                     numComponents);
+				local_cpBufferToData(bov, run, numElements, data,
+				                     dataOffset, dataFormat, numComponents);
 		}
+		row += numRowsRun;
 	}
 
-	xfree(buffer);
-	xfclose(&f);
+	if (isDirect)
+		free(buffer);
+	else if (buffer != NULL)
+		xfree(buffer);
+	close(fd);
 	xfree(dataFileName);
 } /* local_readWindowedActualRead */
 
+static int
+local_openDataFile(const char *fileName,
+                   int        flags,
+                   bool       tryDirectIO,
+                   bool       *isDirect)
+{
+	int fd = -1;
+
+	*isDirect = false;
+#ifdef O_DIRECT
+	// Not every file system supports O_DIRECT, those fall back to the
+	// page cache.
+	if (tryDirectIO) {
+		fd        = open(fileName, flags | O_DIRECT);
+		*isDirect = (fd != -1);
+	}
+#else
+	(void)tryDirectIO;
+#endif
+	if (fd == -1)
+		fd = xopen(fileName, flags, 0);
+
+	return fd;
+}
+
+static size_t
+local_getNumRowsInRun(const bov_t    bov,
+                      const uint32_t *dims,
+                      size_t         row,
+                      size_t         maxRows)
+{
+	size_t numRows = (size_t)dims[1] * dims[2] - row;
+
+	// Rows are only adjacent in the file if they span the whole x range,
+	// and they continue into the next plane only if the planes are full.
+	if (dims[0] != bov->data_size[0])
+		numRows = 1;
+	else if (dims[1] != bov->data_size[1])
+		numRows = dims[1] - row % dims[1];
+
+	return (numRows < maxRows) ? numRows : maxRows;
+}
+
+static off_t
+local_getOffsetOfRow(const bov_t    bov,
+                     const uint32_t *idxLo,
+                     const uint32_t *dims,
+                     size_t         row)
+{
+	off_t j = (off_t)(row % dims[1]) + idxLo[1];
+	off_t k = (off_t)(row / dims[1]) + idxLo[2];
+	off_t offset;
+
+	offset  = idxLo[0] + (j + k * bov->data_size[1]) * bov->data_size[0];
+	offset *= local_getSizeForFormat(bov->data_format)
+	          * bov->data_components;
+
+	return offset + bov->byte_offset;
+}
+
 static size_t
 local_getSizeForFormat(bovFormat_t format)
 {
@@ -1118,16 +1385,45 @@ local_getSizeForFormat(bovFormat_t format)
 	return size;
 }
 
+static void *
+local_readRun(const bov_t bov,
+              int         fd,
+              bool        isDirect,
+              void        *buffer,
+              off_t       offset,
+              size_t      numElements)
+{
+	size_t numBytes = local_getSizeForFormat(bov->data_format)
+	                  * bov->data_components * numElements;
+	char   *run     = buffer;
+
+	if (isDirect) {
+		off_t  offsetAligned = offset - offset % LOCAL_DIRECT_IO_ALIGN;
+		size_t skip          = (size_t)(offset - offsetAligned);
+		size_t numAligned    = (skip + numBytes + LOCAL_DIRECT_IO_ALIGN - 1)
+		                       / LOCAL_DIRECT_IO_ALIGN * LOCAL_DIRECT_IO_ALIGN;
+		// The aligned block may extend beyond the end of the file.
+		if (xfile_preadUpTo(fd, buffer, numAligned, offsetAligned)
+		    < skip + numBytes) {
+			fprintf(stderr, "Could not read from BOV data file: "
+			        "unexpected end of file\n");
+			diediedie(EXIT_FAILURE);
+		}
+		run += skip;
+	} else {
+		xpread(fd, buffer, numBytes, offset);
+	}
+
+	local_adjustEndianess(bov, run, numElements);
+
+	return run;
+}
+
 static void
-local_readPencil(const bov_t bov,
-                 void        *buffer,
-                 size_t      numElements,
-                 FILE        *f)
+local_adjustEndianess(const bov_t bov, void *buffer, size_t numElements)
 {
 	size_t sizePerEle = local_getSizeForFormat(bov->data_format);
 
-	xfread(buffer, sizePerEle * bov->data_components, numElements, f);
-
 	if (bov->machineEndianess != bov->data_endian) {
 		for (size_t i = 0; i < bov->data_components * numElements; i++)
 			byteswap(((char *)buffer) + (i * sizePerEle), sizePerEle);
@@ -18,6 +18,7 @@
 /*--- Includes ----------------------------------------------------------*/
 #include "util_config.h"
 #include <stdint.h>
+#include <stdbool.h>
 #include "endian.h"
 
 
@@ -251,6 +252,17 @@ bov_getBrickSize(const bov_t bov, double *brickSize);
 extern int
 bov_getDataComponents(const bov_t bov);
 
+/**
+ * @brief  Queries whether the data file is read bypassing the page cache.
+ *
+ * @param[in]  bov
+ *                The object to query.
+ *
+ * @return  Returns @c true if O_DIRECT is used for reading.
+ */
+extern bool
+bov_getUseDirectIO(const bov_t bov);
+
 
 /** @} */
 
@@ -402,6 +414,41 @@ bov_setBrickSize(bov_t bov, const double *brickSize);
 extern void
 bov_setDataComponents(bov_t bov, const int numComponents);
 
+/**
+ * @brief  Sets the name of the .bov file without writing it.
+ *
+ * The path of the .bov is used to locate a relative data file, see
+ * bov_getDataFileName(), and the name is used by bov_write() when no
+ * other name is given.
+ *
+ * @param[in,out]  bov
+ *                    The object to update.
+ * @param[in]      *bovFileName
+ *                    A NULL terminated string holding the name of the
+ *                    .bov file.  The function makes a private copy.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+bov_setFileName(bov_t bov, const char *bovFileName);
+
+/**
+ * @brief  Sets whether the data file is read bypassing the page cache.
+ *
+ * With this, reads use O_DIRECT into aligned buffers, which avoids
+ * polluting the page cache when handing large fields between programs.
+ * File systems that do not support O_DIRECT are read normally.
+ *
+ * @param[in,out]  bov
+ *                    The object to update.
+ * @param[in]      useDirectIO
+ *                    Whether to use O_DIRECT, the default is @c false.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+bov_setUseDirectIO(bov_t bov, bool useDirectIO);
+
 
 /** @} */
 
@@ -419,10 +466,10 @@ bov_setDataComponents(bov_t bov, const int numComponents);
  * provided.  Type conversion and endianess adaption will be performed.
  * The whole file is always read, if the file format is identical to the
  * in-memory format, that it will be read directly into this memory
- * location.  However, if the formats differ, then the whole file will
- * be read into a temporary buffer and then copied over to the real data
- * array.  Note that 'format' includes not only the data type but also
- * the number of components.
+ * location.  However, if the formats differ, then the file will be read
+ * in pieces into a temporary buffer and then copied over to the real
+ * data array.  Note that 'format' includes not only the data type but
+ * also the number of components.
  *
  * @param[in]      bov
  *                    The object from which to read.
@@ -447,7 +494,8 @@ bov_read(bov_t       bov,
  *
  * This is used to read only a (rectangular) subsection of the full
  * data.  Type conversion and endianess conversion is performed
- * automatically.
+ * automatically.  Rows of the window that are adjacent in the file are
+ * read with a single pread().
  *
  * @param[in]      bov
  *                    The object from which to read.
@@ -467,12 +515,12 @@ bov_read(bov_t       bov,
  * @return  Returns nothing.
  */
 extern void
-bov_readWindowed(bov_t       bov,
-                 void        *data,
-                 bovFormat_t dataFormat,
-                 int         numComponents,
-                 uint32_t    *idxLo,
-                 uint32_t    *dims);
+bov_readWindowed(bov_t          bov,
+                 void           *data,
+                 bovFormat_t    dataFormat,
+                 int            numComponents,
+                 const uint32_t *idxLo,
+                 const uint32_t *dims);
 
 
 /** @} */
@@ -519,6 +567,59 @@ bov_isValidForWrite(const bov_t bov);
 extern void
 bov_write(bov_t bov, const char *bovFileName);
 
+/**
+ * @brief  Creates the data file and sizes it to hold the full block.
+ *
+ * The name of the .bov must have been set, see bov_setFileName(), to
+ * locate the data file.  In parallel this is done by one task before
+ * any task calls bov_writeWindowed().
+ *
+ * @param[in]  bov
+ *                The BOV object describing the data file, it must be
+ *                valid for writing.
+ * @param[in]  overwrite
+ *                Whether an existing data file is truncated; if not, an
+ *                existing file terminates the program.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+bov_createDataFile(bov_t bov, bool overwrite);
+
+/**
+ * @brief  Writes a windowed sample of the data block into the data file.
+ *
+ * The data file must exist, see bov_createDataFile().  Rows of the window
+ * that are adjacent in the file are written with a single pwrite(), so
+ * several tasks can write disjoint windows of one file at the same time.
+ * The data must be in the format of the bov, only the endianess is
+ * adapted.
+ *
+ * @param[in]  bov
+ *                The object describing the data file.
+ * @param[in]  *data
+ *                The window, x running fastest.
+ * @param[in]  dataFormat
+ *                The format of the data, must be the one of the bov.
+ * @param[in]  numComponents
+ *                The number of components, must be the one of the bov.
+ * @param[in]  *idxLo
+ *                An array of at least 3 values giving the coordinates of
+ *                the lower corner of the window.
+ * @param[in]  *dims
+ *                An array of at least 3 values giving the size of the
+ *                window.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+bov_writeWindowed(bov_t          bov,
+                  const void     *data,
+                  bovFormat_t    dataFormat,
+                  int            numComponents,
+                  const uint32_t *idxLo,
+                  const uint32_t *dims);
+
 
 /** @} */
 
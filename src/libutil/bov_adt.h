@@ -36,6 +36,8 @@ struct bov_struct {
 	char     *bovFilePath;
 	/** @brief The endianess of the machine. */
 	endian_t machineEndianess;
+	/** @brief Whether the data file is read bypassing the page cache. */
+	bool     useDirectIO;
 	//
 	// Required BOV entries
 	//
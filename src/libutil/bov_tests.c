@@ -22,6 +22,9 @@
 
 /*--- Local defines -----------------------------------------------------*/
 
+/** @brief  The length of the names of the files written by the tests. */
+#define LOCAL_TESTFILE_NAME_LENGTH 64
+
 
 /*--- Prototypes of local functions -------------------------------------*/
 
@@ -897,4 +900,140 @@ bov_readWindowed_test(void)
 	return hasPassed ? true : false;
 } /* bov_readWindowed_test */
 
+extern bool
+bov_readWindowedDirectIO_test(void)
+{
+	bool     hasPassed = true;
+	int      rank      = 0;
+	bov_t    bov;
+	uint32_t idxLo[3]  = {0, 1, 1};
+	uint32_t size[3];
+	uint32_t dims[3];
+	size_t   numElements;
+	double   *data, *dataDirect;
+#ifdef XMEM_TRACK_MEM
+	size_t   allocatedBytes = global_allocated_bytes;
+#endif
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	bov = bov_newFromFile("tests/test_1.bov");
+	bov_getDataSize(bov, size);
+	dims[0]     = size[0];
+	dims[1]     = size[1] - 1;
+	dims[2]     = size[2] - 1;
+	numElements = dims[0] * dims[1] * dims[2];
+
+	data       = xmalloc(sizeof(double) * 2 * numElements);
+	dataDirect = xmalloc(sizeof(double) * 2 * numElements);
+	bov_readWindowed(bov, data, BOV_FORMAT_DOUBLE, 2, idxLo, dims);
+	bov_setUseDirectIO(bov, true);
+	if (!bov_getUseDirectIO(bov))
+		hasPassed = false;
+	bov_readWindowed(bov, dataDirect, BOV_FORMAT_DOUBLE, 2, idxLo, dims);
+	if (memcmp(data, dataDirect, sizeof(double) * 2 * numElements) != 0)
+		hasPassed = false;
+
+	xfree(dataDirect);
+	xfree(data);
+	bov_del(&bov);
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+} /* bov_readWindowedDirectIO_test */
+
+extern bool
+bov_writeWindowed_test(void)
+{
+	bool     hasPassed = true;
+	int      rank      = 0;
+	bov_t    bov;
+	uint32_t size[3]   = {5, 4, 3};
+	uint32_t idxLo[3][3] = {{0, 0, 0}, {0, 0, 2}, {2, 0, 2}};
+	uint32_t dims[3][3]  = {{5, 4, 2}, {2, 4, 1}, {3, 4, 1}};
+	float    *data, *window;
+	char     fileNameBov[LOCAL_TESTFILE_NAME_LENGTH];
+	char     fileNameData[LOCAL_TESTFILE_NAME_LENGTH];
+#ifdef XMEM_TRACK_MEM
+	size_t   allocatedBytes = global_allocated_bytes;
+#endif
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	// Every rank works on its own files.
+	snprintf(fileNameBov, LOCAL_TESTFILE_NAME_LENGTH,
+	         "tests/test_write_%i.bov", rank);
+	snprintf(fileNameData, LOCAL_TESTFILE_NAME_LENGTH,
+	         "test_write_%i.raw", rank);
+
+	data   = xmalloc(sizeof(float) * 5 * 4 * 3);
+	window = xmalloc(sizeof(float) * 5 * 4 * 3);
+
+	// The second pass writes the data in the other endianess.
+	for (int pass = 0; pass < 2; pass++) {
+		bov = bov_new();
+		bov_setDataFileName(bov, fileNameData);
+		bov_setDataSize(bov, size);
+		bov_setDataFormat(bov, BOV_FORMAT_FLOAT);
+		bov_setVarName(bov, "test");
+		if (pass == 1) {
+			bov_setDataEndian(bov,
+			                  endian_systemIsLittle() ? ENDIAN_BIG
+			                  : ENDIAN_LITTLE);
+		}
+		bov_setFileName(bov, fileNameBov);
+		bov_createDataFile(bov, true);
+
+		for (int w = 0; w < 3; w++) {
+			uint32_t n = 0;
+			for (uint32_t k = 0; k < dims[w][2]; k++) {
+				for (uint32_t j = 0; j < dims[w][1]; j++) {
+					for (uint32_t i = 0; i < dims[w][0]; i++) {
+						window[n++] = (float)(i + idxLo[w][0]
+						                      + (j + idxLo[w][1]
+						                         + (k + idxLo[w][2])
+						                         * size[1]) * size[0]);
+					}
+				}
+			}
+			bov_writeWindowed(bov, window, BOV_FORMAT_FLOAT, 1,
+			                  idxLo[w], dims[w]);
+		}
+		bov_write(bov, NULL);
+		bov_del(&bov);
+
+		bov = bov_newFromFile(fileNameBov);
+		bov_read(bov, data, BOV_FORMAT_FLOAT, 1);
+		for (uint32_t i = 0; i < 5 * 4 * 3; i++) {
+			if (islessgreater(data[i], (float)i))
+				hasPassed = false;
+		}
+		bov_del(&bov);
+	}
+
+	xfree(window);
+	xfree(data);
+	remove(fileNameBov);
+	snprintf(fileNameData, LOCAL_TESTFILE_NAME_LENGTH,
+	         "tests/test_write_%i.raw", rank);
+	remove(fileNameData);
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+} /* bov_writeWindowed_test */
+
 /*--- Implementations of local functions --------------------------------*/
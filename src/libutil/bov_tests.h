@@ -87,5 +87,11 @@ bov_read_test(void);
 extern bool
 bov_readWindowed_test(void);
 
+extern bool
+bov_readWindowedDirectIO_test(void);
+
+extern bool
+bov_writeWindowed_test(void);
+
 
 #endif
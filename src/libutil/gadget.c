@@ -51,6 +51,13 @@
  */
 #define LOCAL_MAX_SIZE_COMPONENT_IN_BYTES 16
 
+/**
+ * @brief  Gives the number of elements that are staged in memory at once
+ *         when a block needs to be converted between the file and the
+ *         stai.
+ */
+#define LOCAL_NUM_ELEMENTS_PER_CHUNK UINT64_C(262144)
+
 
 /*--- Prototypes of local functions -------------------------------------*/
 
@@ -982,12 +989,20 @@ local_writeBlockActualGeneral(FILE         *f,
 			xfwrite(ele, sizeOfElement, 1, f);
 		}
 	} else {
-		for (uint64_t i = 0; i < pWrite; i++) {
-			stai_getElement(stai, i, ele);
+		uint64_t numChunk = (pWrite < LOCAL_NUM_ELEMENTS_PER_CHUNK)
+		                    ? pWrite : LOCAL_NUM_ELEMENTS_PER_CHUNK;
+		char     *buffer  = xmalloc(sizeOfElement * numChunk);
+
+		for (uint64_t i = 0; i < pWrite; i += numChunk) {
+			uint64_t num = (pWrite - i < numChunk) ? pWrite - i : numChunk;
 			if (doByteSwap)
-				byteswapVec(ele, sizeOfElement, numComponents);
-			xfwrite(ele, sizeOfElement, 1, f);
+				stai_getElementsMultiSwapped(stai, i, buffer, num,
+				                             numComponents);
+			else
+				stai_getElementsMulti(stai, i, buffer, num);
+			xfwrite(buffer, sizeOfElement, num, f);
 		}
+		xfree(buffer);
 	}
 }
 
@@ -1047,12 +1062,20 @@ local_readBlockActualGeneral(FILE     *f,
 			stai_setElement(stai, i, eleStai);
 		}
 	} else {
-		for (uint64_t i = 0; i < pRead; i++) {
-			xfread(ele, sizeOfElement, 1, f);
+		uint64_t numChunk = (pRead < LOCAL_NUM_ELEMENTS_PER_CHUNK)
+		                    ? pRead : LOCAL_NUM_ELEMENTS_PER_CHUNK;
+		char     *buffer  = xmalloc(sizeOfElement * numChunk);
+
+		for (uint64_t i = 0; i < pRead; i += numChunk) {
+			uint64_t num = (pRead - i < numChunk) ? pRead - i : numChunk;
+			xfread(buffer, sizeOfElement, num, f);
 			if (doByteSwap)
-				byteswapVec(ele, sizeOfElement, numComponents);
-			stai_setElement(stai, i, ele);
+				stai_setElementsMultiSwapped(stai, i, buffer, num,
+				                             numComponents);
+			else
+				stai_setElementsMulti(stai, i, buffer, num);
 		}
+		xfree(buffer);
 	}
 }
 
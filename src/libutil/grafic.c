@@ -20,6 +20,9 @@
 #include <stdlib.h>
 #include <stdint.h>
 #include <math.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/types.h>
 #include "endian.h"
 #include "xmem.h"
 #include "xstring.h"
@@ -743,38 +746,33 @@ local_writeWindowedActualRead(const grafic_t           grafic,
                               const uint32_t *restrict dims,
                               bool                     doByteswap)
 {
-	FILE   *f;
-	float  *buffer    = xmalloc(sizeof(float) * dims[0]);
-	size_t dataOffset = 0;
+	// The writes go to positions computed from the window and never touch
+	// the record markers, hence several processes can write disjoint
+	// windows of the same file at the same time.
+	const off_t    sizeOfPlane = (off_t)(grafic->np1) * grafic->np2
+	                             * sizeof(float) + 2 * sizeof(int);
+	const off_t    firstPlane  = grafic->headerSkip + 8L + sizeof(int);
+	const bool     isFullRow   = (dims[0] == grafic->np1);
+	const uint32_t numPerWrite = isFullRow ? dims[0] * dims[1] : dims[0];
+	float          *buffer     = xmalloc(sizeof(float) * numPerWrite);
+	size_t         dataOffset  = 0;
+	int            fd;
+
+	fd = xopen(grafic->graficFileName, O_WRONLY, 0);
 
-	f = xfopen(grafic->graficFileName, "r+b");
-	xfseek(f, grafic->headerSkip + 8L, SEEK_SET);
-	for (uint32_t k = 0; k < idxLo[2]; k++)
-		local_skipPlane(f, grafic->np1 * grafic->np2);
 	for (uint32_t k = 0; k < dims[2]; k++) {
-		int b1, b2;
-		xfread(&b1, sizeof(int), 1, f);
-		for (uint32_t j = 0; j < idxLo[1]; j++)
-			xfseek(f, grafic->np1 * sizeof(float), SEEK_CUR);
-		for (uint32_t j = 0; j < dims[1]; j++) {
-			if (idxLo[0] > 0)
-				xfseek(f, sizeof(float) * idxLo[0], SEEK_CUR);
-			local_cpDataToBuffer(buffer, dims[0], data, dataFormat,
+		off_t offset = firstPlane + (idxLo[2] + k) * sizeOfPlane;
+		for (uint32_t j = 0; j < dims[1]; j += (isFullRow ? dims[1] : 1)) {
+			off_t pos = offset + ((off_t)(idxLo[1] + j) * grafic->np1
+			                      + idxLo[0]) * sizeof(float);
+			local_cpDataToBuffer(buffer, numPerWrite, data, dataFormat,
 			                     numComponents, dataOffset, doByteswap);
-			dataOffset += dims[0];
-			xfwrite(buffer, sizeof(float), dims[0], f);
-			if (grafic->np1 - dims[0] - idxLo[0] > 0)
-				xfseek(f, sizeof(float) * (grafic->np1 - dims[0] - idxLo[0]),
-				       SEEK_CUR);
+			dataOffset += numPerWrite;
+			xpwrite(fd, buffer, sizeof(float) * numPerWrite, pos);
 		}
-		for (uint32_t j = 0; j < grafic->np2 - dims[1] - idxLo[1]; j++)
-			xfseek(f, grafic->np1 * sizeof(float), SEEK_CUR);
-		xfread(&b2, sizeof(int), 1, f);
-		if (b1 != b2)
-			diediedie(EXIT_FAILURE);
 	}
 
-	xfclose(&f);
+	close(fd);
 	xfree(buffer);
 } /* local_writeWindowedActualRead */
 
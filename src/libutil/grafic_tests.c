@@ -1045,6 +1045,33 @@ grafic_writeWindowed_test(void)
 	}
 	grafic_makeEmptyFile(grafic);
 	grafic_writeWindowed(grafic, data, GRAFIC_FORMAT_FLOAT, 1, idxLo, dims);
+	{
+		// Read back the window and a full plane written in one go.
+		float    back[4 * 5];
+		uint32_t idxLoPlane[3] = {0, 0, 1};
+		uint32_t dimsPlane[3]  = {4, 5, 1};
+		grafic_readWindowed(grafic, back, GRAFIC_FORMAT_FLOAT, 1,
+		                    idxLo, dims);
+		for (size_t i = 0; i < numElements; i++)
+			if (back[i] != data[i])
+				hasPassed = false;
+		for (size_t i = 0; i < 4 * 5; i++)
+			back[i] = (float)(100 + i);
+		grafic_writeWindowed(grafic, back, GRAFIC_FORMAT_FLOAT, 1,
+		                     idxLoPlane, dimsPlane);
+		for (size_t i = 0; i < 4 * 5; i++)
+			back[i] = 0.f;
+		grafic_readWindowed(grafic, back, GRAFIC_FORMAT_FLOAT, 1,
+		                    idxLoPlane, dimsPlane);
+		for (size_t i = 0; i < 4 * 5; i++)
+			if (back[i] != (float)(100 + i))
+				hasPassed = false;
+		grafic_readWindowed(grafic, back, GRAFIC_FORMAT_FLOAT, 1,
+		                    idxLo, dims);
+		for (size_t i = 0; i < numElements; i++)
+			if (back[i] != data[i])
+				hasPassed = false;
+	}
 	grafic_del(&grafic);
 	xfree(data);
 #ifdef XMEM_TRACK_MEM
@@ -32,6 +32,12 @@
 /** @brief  Indicates no process. */
 #define LOCAL_NOPROCESS -1
 
+/** @brief  The position of the ticket counter in the window. */
+#define LOCAL_ARRIVALS 0
+
+/** @brief  The position of the counter of finished tasks in the window. */
+#define LOCAL_DONE 1
+
 
 /*--- Prototypes of local functions -------------------------------------*/
 
@@ -80,6 +86,52 @@ static void
 local_calcGroupiDistribRoundRobin(groupi_t groupi);
 
 
+/**
+ * @brief  Applies an atomic operation to a counter of the group.
+ *
+ * @param[in,out]  groupi
+ *                    The group interface to work with.
+ * @param[in]      counter
+ *                    The counter to work with, either #LOCAL_ARRIVALS or
+ *                    #LOCAL_DONE.
+ * @param[in]      op
+ *                    The operation, @c MPI_SUM to increment the counter
+ *                    and @c MPI_NO_OP to read it.
+ *
+ * @return  Returns the value of the counter before the operation.
+ */
+static int
+local_fetchCounter(groupi_t groupi, int counter, MPI_Op op);
+
+
+/**
+ * @brief  Waits until a counter of the group reaches a value.
+ *
+ * @param[in,out]  groupi
+ *                    The group interface to work with.
+ * @param[in]      counter
+ *                    The counter to wait for.
+ * @param[in]      value
+ *                    The value to wait for.
+ *
+ * @return  Returns the value of the counter, at least @c value.
+ */
+static int
+local_waitForCounter(groupi_t groupi, int counter, int value);
+
+
+/**
+ * @brief  Acquires the lock by drawing a ticket.
+ *
+ * @param[in,out]  groupi
+ *                    The group interface to work with.
+ *
+ * @return  Returns nothing.
+ */
+static void
+local_acquireTicket(groupi_t groupi);
+
+
 /*--- Implementations of exported functios ------------------------------*/
 extern groupi_t
 groupi_new(int           numGroups,
@@ -102,11 +154,15 @@ groupi_new(int           numGroups,
 	groupi->acquireFuncData = NULL;
 	groupi->releaseFunc     = NULL;
 	groupi->releaseFuncData = NULL;
+	groupi->maxConcurrent   = 0;
+	groupi->numCycles       = 0;
+	groupi->counters        = NULL;
 
 	if (mode == GROUPI_MODE_BLOCK)
 		local_calcGroupiDistribBlock(groupi);
 	else
 		local_calcGroupiDistribRoundRobin(groupi);
+	groupi->seqNum = groupi->rankInGroup;
 
 	return groupi;
 }
@@ -118,6 +174,10 @@ groupi_del(groupi_t *groupi)
 
 	if (groupi_isAcquired(*groupi))
 		groupi_release(*groupi);
+	if ((*groupi)->maxConcurrent > 0) {
+		MPI_Win_free(&((*groupi)->win));
+		MPI_Free_mem((*groupi)->counters);
+	}
 
 	xfree(*groupi);
 
@@ -148,6 +208,23 @@ groupi_registerReleaseFunc(groupi_t            groupi,
 	groupi->releaseFuncData = releaseFuncData;
 }
 
+extern void
+groupi_setMaxConcurrent(groupi_t groupi, int maxConcurrent)
+{
+	assert(groupi != NULL);
+	assert(maxConcurrent > 0);
+	assert(!groupi_isAcquired(groupi));
+
+	if (groupi->maxConcurrent == 0) {
+		MPI_Alloc_mem(sizeof(int) * 2, MPI_INFO_NULL, &(groupi->counters));
+		groupi->counters[LOCAL_ARRIVALS] = 0;
+		groupi->counters[LOCAL_DONE]     = 0;
+		MPI_Win_create(groupi->counters, sizeof(int) * 2, sizeof(int),
+		               MPI_INFO_NULL, groupi->mpiComm, &(groupi->win));
+	}
+	groupi->maxConcurrent = maxConcurrent;
+}
+
 extern int
 groupi_getNumGroups(const groupi_t groupi)
 {
@@ -196,6 +273,22 @@ groupi_getRankInGroup(const groupi_t groupi)
 	return groupi->rankInGroup;
 }
 
+extern int
+groupi_getMaxConcurrent(const groupi_t groupi)
+{
+	assert(groupi != NULL);
+
+	return (groupi->maxConcurrent > 0) ? groupi->maxConcurrent : 1;
+}
+
+extern int
+groupi_getSeqNum(const groupi_t groupi)
+{
+	assert(groupi != NULL);
+
+	return groupi->seqNum;
+}
+
 extern int
 groupi_getPreviousProcess(const groupi_t groupi)
 {
@@ -244,7 +337,9 @@ groupi_acquire(groupi_t groupi)
 
 	assert(groupi != NULL);
 
-	if (!groupi_isFirstInGroup(groupi)) {
+	if (groupi->maxConcurrent > 0) {
+		local_acquireTicket(groupi);
+	} else if (!groupi_isFirstInGroup(groupi)) {
 		int        buf;
 		MPI_Status status;
 
@@ -255,7 +350,7 @@ groupi_acquire(groupi_t groupi)
 
 	if (groupi->acquireFunc != NULL)
 		rtn = groupi->acquireFunc(groupi->groupNumber,
-		                          groupi->rankInGroup,
+		                          groupi->seqNum,
 		                          groupi->sizeOfGroup,
 		                          groupi->acquireFuncData);
 
@@ -269,14 +364,16 @@ groupi_release(groupi_t groupi)
 {
 	assert(groupi != NULL);
 
-	if (!groupi_isLastInGroup(groupi)) {
+	if (groupi->maxConcurrent > 0) {
+		(void)local_fetchCounter(groupi, LOCAL_DONE, MPI_SUM);
+	} else if (!groupi_isLastInGroup(groupi)) {
 		MPI_Send(&(groupi->mpiTag), 1, MPI_INT, groupi->nextProcess,
 		         groupi->mpiTag, groupi->mpiComm);
 	}
 
 	if (groupi->releaseFunc != NULL)
 		groupi->releaseFunc(groupi->groupNumber,
-		                    groupi->rankInGroup,
+		                    groupi->seqNum,
 		                    groupi->sizeOfGroup,
 		                    groupi->releaseFuncData);
 
@@ -284,6 +381,58 @@ groupi_release(groupi_t groupi)
 }
 
 /*--- Implementations of local functions --------------------------------*/
+static int
+local_fetchCounter(groupi_t groupi, int counter, MPI_Op op)
+{
+	const int one = 1;
+	int       value;
+
+	MPI_Win_lock(MPI_LOCK_SHARED, groupi->leaderProcess, 0, groupi->win);
+	MPI_Fetch_and_op(&one, &value, MPI_INT, groupi->leaderProcess,
+	                 (MPI_Aint)counter, op, groupi->win);
+	MPI_Win_unlock(groupi->leaderProcess, groupi->win);
+
+	return value;
+}
+
+static int
+local_waitForCounter(groupi_t groupi, int counter, int value)
+{
+	int current;
+
+	while ((current = local_fetchCounter(groupi, counter, MPI_NO_OP))
+	       < value)
+		;
+
+	return current;
+}
+
+static void
+local_acquireTicket(groupi_t groupi)
+{
+	const int start = groupi->numCycles * groupi->sizeOfGroup;
+	int       ticket, done;
+
+	// Tasks that are a round ahead wait for the stragglers of the
+	// previous round to draw their tickets, this keeps the tickets of a
+	// round contiguous.
+	(void)local_waitForCounter(groupi, LOCAL_ARRIVALS, start);
+	ticket = local_fetchCounter(groupi, LOCAL_ARRIVALS, MPI_SUM);
+	assert(ticket >= start && ticket < start + groupi->sizeOfGroup);
+	groupi->seqNum = ticket - start;
+	groupi->numCycles++;
+
+	// The first task of a round waits for the previous round to finish
+	// and then works alone, all others wait for it and for a free slot.
+	if (groupi->seqNum == 0) {
+		(void)local_waitForCounter(groupi, LOCAL_DONE, start);
+	} else {
+		done = local_waitForCounter(groupi, LOCAL_DONE, start + 1);
+		while (ticket >= done + groupi->maxConcurrent)
+			done = local_fetchCounter(groupi, LOCAL_DONE, MPI_NO_OP);
+	}
+}
+
 static void
 local_calcGroupDistribCommon(const groupi_t groupi,
                              int            *rank,
@@ -322,6 +471,7 @@ local_calcGroupiDistribBlock(groupi_t groupi)
 		groupi->nextProcess = rank + 1;
 	if (groupi->rankInGroup > 0)
 		groupi->prevProcess = rank - 1;
+	groupi->leaderProcess = rank - groupi->rankInGroup;
 }
 
 static void
@@ -345,4 +495,5 @@ local_calcGroupiDistribRoundRobin(groupi_t groupi)
 		groupi->prevProcess = rank - groupi->numGroups;
 		assert(groupi->prevProcess >= 0);
 	}
+	groupi->leaderProcess = groupi->groupNumber;
 }
@@ -148,6 +148,39 @@ groupi_registerReleaseFunc(groupi_t            groupi,
                            void                *releaseFuncData);
 
 
+/**
+ * @brief  Lets up to @c maxConcurrent tasks of a group work at the same
+ *         time.
+ *
+ * Instead of passing a token from one task to the next in rank order,
+ * the tasks draw tickets from a shared counter of their group (held in an
+ * MPI-3 window on the first task of the group) and start working in the
+ * order in which they arrive in groupi_acquire().  The first task of
+ * every round of acquisitions works alone, such that it can prepare the
+ * file the others write into, afterwards up to @c maxConcurrent tasks
+ * work at the same time.  A round only starts once the previous one is
+ * complete.  groupi_getSeqNum() tells a task its position in the round.
+ * Waiting tasks poll the counters with passive target operations; with
+ * some MPI libraries they only progress while the first task of the
+ * group is inside an MPI call.
+ *
+ * This is a collective call over the communicator of the group interface
+ * and must not be made while the lock is held.
+ *
+ * @param[in,out]  groupi
+ *                    The group interface to work with.  Passing @c NULL
+ *                    is undefined.
+ * @param[in]      maxConcurrent
+ *                    The number of tasks that may work at the same time,
+ *                    must be at least @c 1.  Typically this would be
+ *                    tuned to the file system.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+groupi_setMaxConcurrent(groupi_t groupi, int maxConcurrent);
+
+
 /** @} */
 
 /**
@@ -237,6 +270,38 @@ extern int
 groupi_getRankInGroup(const groupi_t groupi);
 
 
+/**
+ * @brief  Queries for the number of tasks that may work at the same time.
+ *
+ * @param[in]  groupi
+ *                The group interface to query.  Passing @c NULL is
+ *                undefined.
+ *
+ * @return  Returns the number of tasks in a group that may hold the lock
+ *          at the same time, this is @c 1 for the token chain.
+ */
+extern int
+groupi_getMaxConcurrent(const groupi_t groupi);
+
+
+/**
+ * @brief  Queries for the position of the calling process in the order
+ *         in which the group works.
+ *
+ * With the token chain this is the rank in the group, otherwise it is the
+ * order of arrival which is only known once the lock has been acquired.
+ *
+ * @param[in]  groupi
+ *                The group interface to query.  Passing @c NULL is
+ *                undefined.
+ *
+ * @return  Returns the position of the calling process, @c 0 is the
+ *          process that works first.
+ */
+extern int
+groupi_getSeqNum(const groupi_t groupi);
+
+
 /**
  * @brief  Queries for the previous process.
  *
@@ -321,6 +386,9 @@ groupi_isLastInGroup(const groupi_t groupi);
  * @brief  Will try to acquire the right to work (waits for all process
  *         which come first in the group to do their work).
  *
+ * The acquire call-back function receives the group number, the result
+ * of groupi_getSeqNum() and the size of the group.
+ *
  * @param[in,out]  groupi
  *                    The group interface with which to work.
  *
@@ -51,6 +51,21 @@ struct groupi_struct {
 	groupiReleaseFunc_t releaseFunc;
 	/** @brief  The data to pass to the release call-back function. */
 	void                *releaseFuncData;
+	/**
+	 * @brief  The number of tasks that may work at the same time, @c 0
+	 *         selects the token chain.
+	 */
+	int                 maxConcurrent;
+	/** @brief  The rank of the task holding the counters of this group. */
+	int                 leaderProcess;
+	/** @brief  The number of times this task has acquired the lock. */
+	int                 numCycles;
+	/** @brief  The position of this task in the current cycle. */
+	int                 seqNum;
+	/** @brief  The counters of the group, only used on the leader. */
+	int                 *counters;
+	/** @brief  The window exposing the counters. */
+	MPI_Win             win;
 };
 
 
@@ -309,6 +309,84 @@ groupi_test(void)
 	return hasPassed ? true : false;
 }
 
+extern bool
+groupi_concurrent_test(void)
+{
+	bool     hasPassed = true;
+	int      rank      = 0;
+	int      size      = 1;
+	groupi_t groupi;
+	int      *active;
+	MPI_Win  win;
+	const int one = 1, minusOne = -1;
+#ifdef XMEM_TRACK_MEM
+	size_t   allocatedBytes = global_allocated_bytes;
+#endif
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+	MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	// Every rank exposes one counter per group of holders of the lock.
+	MPI_Alloc_mem(sizeof(int) * 3, MPI_INFO_NULL, &active);
+	active[0] = active[1] = active[2] = 0;
+	MPI_Win_create(active, sizeof(int) * 3, sizeof(int), MPI_INFO_NULL,
+	               MPI_COMM_WORLD, &win);
+	MPI_Barrier(MPI_COMM_WORLD);
+
+	groupi = groupi_new(3, MPI_COMM_WORLD, 123, GROUPI_MODE_ROUNDROBIN);
+	groupi_setMaxConcurrent(groupi, 2);
+	if (groupi_getMaxConcurrent(groupi) != 2)
+		hasPassed = false;
+
+	for (int round = 0; round < 3; round++) {
+		int numActive, sumSeqNum, expected;
+
+		(void)groupi_acquire(groupi);
+		MPI_Win_lock(MPI_LOCK_SHARED, 0, 0, win);
+		MPI_Fetch_and_op(&one, &numActive, MPI_INT, 0,
+		                 (MPI_Aint)groupi_getGroupNumber(groupi), MPI_SUM,
+		                 win);
+		MPI_Win_unlock(0, win);
+		if (numActive >= 2)
+			hasPassed = false;
+		if (groupi_getSeqNum(groupi) == 0 && numActive != 0)
+			hasPassed = false;
+		// Hold the lock for a while to give the others a chance to
+		// violate the limit.
+		for (double t = MPI_Wtime(); MPI_Wtime() - t < 1e-3;)
+			;
+		MPI_Win_lock(MPI_LOCK_SHARED, 0, 0, win);
+		MPI_Fetch_and_op(&minusOne, &numActive, MPI_INT, 0,
+		                 (MPI_Aint)groupi_getGroupNumber(groupi), MPI_SUM,
+		                 win);
+		MPI_Win_unlock(0, win);
+		groupi_release(groupi);
+
+		// The positions within a group must be a permutation.
+		MPI_Allreduce(&(groupi->seqNum), &sumSeqNum, 1, MPI_INT, MPI_SUM,
+		              MPI_COMM_WORLD);
+		expected = 0;
+		for (int i = 0; i < 3; i++) {
+			int n = size / 3 + (i < size % 3 ? 1 : 0);
+			expected += n * (n - 1) / 2;
+		}
+		if (sumSeqNum != expected)
+			hasPassed = false;
+	}
+
+	groupi_del(&groupi);
+	MPI_Win_free(&win);
+	MPI_Free_mem(active);
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+} /* groupi_concurrent_test */
+
 /*--- Implementations of local functions --------------------------------*/
 static void *
 local_fakeAcquireFunc(int seqID, int seqNum, int seqLen, void *fileStem)
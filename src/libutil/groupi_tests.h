@@ -21,5 +21,8 @@ groupi_del_test(void);
 extern bool
 groupi_test(void);
 
+extern bool
+groupi_concurrent_test(void);
+
 
 #endif
@@ -9,12 +9,15 @@
 #include "xstring_tests.h"
 #include "stai_tests.h"
 #include "varArr_tests.h"
+#include "memPool_tests.h"
+#include "profile_tests.h"
 #include "endian_tests.h"
 #include "tile_tests.h"
 #include "lIdx_tests.h"
 #include "filename_tests.h"
 #include "bov_tests.h"
 #include "grafic_tests.h"
+#include "art_tests.h"
 #include "cubepm_tests.h"
 #include "gadgetVersion_tests.h"
 #include "gadgetBlock_tests.h"
@@ -75,7 +78,7 @@ local_runtestMPI(bool       (*f
 
 /*--- M A I N -----------------------------------------------------------*/
 int
-main(void)
+main(int argc, char **argv)
 {
 	bool hasFailed = false;
 	int  rank      = 0;
@@ -162,8 +165,12 @@ main(void)
 		RUNTEST(&stai_del_test, hasFailed);
 		RUNTEST(&stai_setElement_test, hasFailed);
 		RUNTEST(&stai_setElementsMulti_test, hasFailed);
+		RUNTEST(&stai_setElementsMultiSwapped_test, hasFailed);
+		RUNTEST(&stai_setElementsMultiFromFloat_test, hasFailed);
 		RUNTEST(&stai_getElement_test, hasFailed);
 		RUNTEST(&stai_getElementsMulti_test, hasFailed);
+		RUNTEST(&stai_getElementsMultiSwapped_test, hasFailed);
+		RUNTEST(&stai_getElementsMultiAsFloat_test, hasFailed);
 		RUNTEST(&stai_isLinear_test, hasFailed);
 	}
 
@@ -178,6 +185,27 @@ main(void)
 		RUNTEST(&varArr_getElementHandle_test, hasFailed);
 	}
 
+	if (rank == 0) {
+		printf("\nRunning tests for memPool:\n");
+		RUNTEST(&memPool_malloc_test, hasFailed);
+		RUNTEST(&memPool_free_test, hasFailed);
+		RUNTEST(&memPool_getAllocSize_test, hasFailed);
+		RUNTEST(&memPool_trim_test, hasFailed);
+		RUNTEST(&memPool_setMaxBytesCached_test, hasFailed);
+	}
+
+	if (rank == 0) {
+		printf("\nRunning tests for profile:\n");
+		RUNTEST(&profile_enter_test, hasFailed);
+		RUNTEST(&profile_leave_test, hasFailed);
+		RUNTEST(&profile_reset_test, hasFailed);
+	}
+#ifdef WITH_MPI
+	RUNTESTMPI(&profile_report_test, hasFailed);
+#else
+	RUNTEST(&profile_report_test, hasFailed);
+#endif
+
 	if (rank == 0) {
 		printf("\nRunning tests for bov:\n");
 		RUNTEST(&bov_new_test, hasFailed);
@@ -205,6 +233,8 @@ main(void)
 		RUNTEST(&bov_setDataComponents_test, hasFailed);
 		RUNTEST(&bov_read_test, hasFailed);
 		RUNTEST(&bov_readWindowed_test, hasFailed);
+		RUNTEST(&bov_readWindowedDirectIO_test, hasFailed);
+		RUNTEST(&bov_writeWindowed_test, hasFailed);
 	}
 
 	if (rank == 0) {
@@ -239,6 +269,13 @@ main(void)
 		RUNTEST(&grafic_writeWindowed_test, hasFailed);
 	}
 
+	if (rank == 0) {
+		printf("\nRunning tests for art:\n");
+		RUNTEST(&art_new_test, hasFailed);
+		RUNTEST(&art_del_test, hasFailed);
+		RUNTEST(&art_write_test, hasFailed);
+	}
+
 	if (rank == 0) {
 		printf("\nRunning tests for cubepm:\n");
 		RUNTEST(&cubepm_new_test, hasFailed);
@@ -336,6 +373,7 @@ main(void)
 	RUNTESTMPI(&groupi_new_test, hasFailed);
 	RUNTESTMPI(&groupi_del_test, hasFailed);
 	RUNTESTMPI(&groupi_test, hasFailed);
+	RUNTESTMPI(&groupi_concurrent_test, hasFailed);
 
 	MPI_Finalize();
 #endif
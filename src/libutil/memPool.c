@@ -0,0 +1,388 @@
+// Copyright (C) 2010, 2011, Steffen Knollmann
+// Released under the terms of the GNU General Public License version 3.
+// This file is part of `ginnungagap'.
+
+
+/*--- Doxygen file description ------------------------------------------*/
+
+/**
+ * @file libutil/memPool.c
+ * @ingroup libutilCore
+ * @brief  Implements the pool recycling large buffers.
+ */
+
+
+/*--- Includes ----------------------------------------------------------*/
+#include "memPool.h"
+#include <assert.h>
+#include <string.h>
+#include <stdbool.h>
+#include "xmem.h"
+
+
+/*--- Local defines -----------------------------------------------------*/
+
+/** @brief  Identifies buffers handed out by the pool. */
+#define LOCAL_MAGIC UINT64_C(0x6d656d506f6f6c21)
+
+/** @brief  The number of size classes per power of two. */
+#define LOCAL_SUBCLASSES 4
+
+/** @brief  The logarithm of #MEMPOOL_MIN_POOLED_SIZE. */
+#define LOCAL_MIN_EXPONENT 20
+
+/** @brief  The number of size classes. */
+#define LOCAL_NUM_CLASSES ((64 - LOCAL_MIN_EXPONENT) * LOCAL_SUBCLASSES)
+
+/** @brief  The size of the region touched by one thread at a time. */
+#define LOCAL_TOUCH_CHUNK 4096
+
+
+/*--- Local structures and typedefs -------------------------------------*/
+
+/** @brief  The header preceding every buffer. */
+struct local_header_struct {
+	/** @brief  The pointer obtained from the system. */
+	void                       *raw;
+	/** @brief  The next cached buffer of the same class. */
+	struct local_header_struct *next;
+	/** @brief  The usable size, 0 for buffers that are not recycled. */
+	uint64_t                   size;
+	/** @brief  The class of the buffer. */
+	uint64_t                   idxClass;
+	/** @brief  Always #LOCAL_MAGIC. */
+	uint64_t                   magic;
+};
+
+/** @brief  Convenience typedef. */
+typedef struct local_header_struct *local_header_t;
+
+
+/*--- Local variables ---------------------------------------------------*/
+
+/** @brief  The cached buffers per size class. */
+static local_header_t local_freeList[LOCAL_NUM_CLASSES];
+
+/** @brief  The number of bytes held in cached buffers. */
+static uint64_t local_numBytesCached = 0;
+
+/** @brief  The maximal number of bytes held in cached buffers. */
+static uint64_t local_maxBytesCached = MEMPOOL_DEFAULT_MAX_BYTES_CACHED;
+
+
+/*--- Prototypes of local functions -------------------------------------*/
+
+/**
+ * @brief  Finds the size class for a request.
+ *
+ * @param[in]   size
+ *                 The requested size, must be at least
+ *                 #MEMPOOL_MIN_POOLED_SIZE.
+ * @param[out]  *sizeClass
+ *                 Will receive the size of the class.
+ *
+ * @return  Returns the index of the size class.
+ */
+static int
+local_getClass(size_t size, uint64_t *sizeClass);
+
+
+/**
+ * @brief  Gets a new buffer from the system.
+ *
+ * @param[in]  size
+ *                The usable size of the buffer.
+ *
+ * @return  Returns the header of the new buffer.
+ */
+static local_header_t
+local_getNewBuffer(size_t size);
+
+
+/**
+ * @brief  Retrieves the header of a buffer.
+ *
+ * @param[in]  *ptr
+ *                The buffer.
+ *
+ * @return  Returns the header.
+ */
+static local_header_t
+local_getHeader(void *ptr);
+
+
+/**
+ * @brief  Touches every page of a buffer in parallel.
+ *
+ * @param[in,out]  *ptr
+ *                    The buffer.
+ * @param[in]      size
+ *                    The size of the buffer.
+ *
+ * @return  Returns nothing.
+ */
+static void
+local_touch(void *ptr, uint64_t size);
+
+
+/**
+ * @brief  Takes all cached buffers out of the free lists.
+ *
+ * Must be called from within the critical section of the pool.
+ *
+ * @return  Returns the taken buffers as a list, the caller has to release
+ *          them with local_releaseList().
+ */
+static local_header_t
+local_takeAllCached(void);
+
+
+/**
+ * @brief  Returns a list of buffers to the system.
+ *
+ * @param[in,out]  header
+ *                    The first buffer of the list, may be @c NULL.
+ *
+ * @return  Returns nothing.
+ */
+static void
+local_releaseList(local_header_t header);
+
+
+/*--- Implementations of exported functions -----------------------------*/
+extern void *
+memPool_malloc(size_t size)
+{
+	local_header_t header  = NULL;
+	local_header_t evicted = NULL;
+	uint64_t       sizeClass;
+	int            idxClass;
+
+	if (size < MEMPOOL_MIN_POOLED_SIZE) {
+		header = local_getNewBuffer(size);
+		return (char *)header + sizeof(struct local_header_struct);
+	}
+
+	idxClass = local_getClass(size, &sizeClass);
+
+#ifdef WITH_OPENMP
+#  pragma omp critical (memPool)
+#endif
+	{
+		if (local_freeList[idxClass] != NULL) {
+			header                    = local_freeList[idxClass];
+			local_freeList[idxClass]  = header->next;
+			local_numBytesCached     -= header->size;
+		} else {
+			// A miss: the cached buffers of the other classes cannot serve
+			// this request, release them before getting a new buffer so
+			// that they do not add to the peak.
+			evicted = local_takeAllCached();
+		}
+	}
+	local_releaseList(evicted);
+
+	if (header == NULL) {
+		header           = local_getNewBuffer(sizeClass);
+		header->idxClass = (uint64_t)idxClass;
+		local_touch((char *)header + sizeof(struct local_header_struct),
+		            sizeClass);
+	}
+	header->next = NULL;
+
+	return (char *)header + sizeof(struct local_header_struct);
+}
+
+extern void
+memPool_free(void *ptr)
+{
+	local_header_t header;
+	bool           isCached = false;
+
+	assert(ptr != NULL);
+
+	header = local_getHeader(ptr);
+
+	if (header->size == 0) {
+		xfree(header->raw);
+		return;
+	}
+
+#ifdef WITH_OPENMP
+#  pragma omp critical (memPool)
+#endif
+	{
+		if (local_numBytesCached + header->size <= local_maxBytesCached) {
+			header->next                     = local_freeList[header->idxClass];
+			local_freeList[header->idxClass] = header;
+			local_numBytesCached            += header->size;
+			isCached                         = true;
+		}
+	}
+
+	if (!isCached)
+		xfree(header->raw);
+}
+
+extern uint64_t
+memPool_getAllocSize(size_t size)
+{
+	uint64_t sizeClass;
+
+	if (size < MEMPOOL_MIN_POOLED_SIZE)
+		return (uint64_t)size;
+
+	(void)local_getClass(size, &sizeClass);
+
+	return sizeClass;
+}
+
+extern void
+memPool_trim(void)
+{
+	local_header_t cached;
+
+#ifdef WITH_OPENMP
+#  pragma omp critical (memPool)
+#endif
+	cached = local_takeAllCached();
+
+	local_releaseList(cached);
+}
+
+extern void
+memPool_setMaxBytesCached(uint64_t maxBytesCached)
+{
+	local_header_t cached = NULL;
+
+#ifdef WITH_OPENMP
+#  pragma omp critical (memPool)
+#endif
+	{
+		local_maxBytesCached = maxBytesCached;
+		if (local_numBytesCached > local_maxBytesCached)
+			cached = local_takeAllCached();
+	}
+
+	local_releaseList(cached);
+}
+
+extern uint64_t
+memPool_getNumBytesCached(void)
+{
+	uint64_t numBytes;
+
+#ifdef WITH_OPENMP
+#  pragma omp critical (memPool)
+#endif
+	numBytes = local_numBytesCached;
+
+	return numBytes;
+}
+
+/*--- Implementations of local functions --------------------------------*/
+static int
+local_getClass(size_t size, uint64_t *sizeClass)
+{
+	int      exponent = LOCAL_MIN_EXPONENT;
+	uint64_t step, sub;
+
+	assert(size >= MEMPOOL_MIN_POOLED_SIZE);
+
+	while (exponent < 63 && (UINT64_C(1) << (exponent + 1)) <= size)
+		exponent++;
+
+	step = (UINT64_C(1) << exponent) / LOCAL_SUBCLASSES;
+	sub  = (size - (UINT64_C(1) << exponent) + step - 1) / step;
+	if (sub == LOCAL_SUBCLASSES) {
+		exponent++;
+		sub  = 0;
+		step = (UINT64_C(1) << exponent) / LOCAL_SUBCLASSES;
+	}
+	*sizeClass = (UINT64_C(1) << exponent) + sub * step;
+
+	return (exponent - LOCAL_MIN_EXPONENT) * LOCAL_SUBCLASSES + (int)sub;
+}
+
+static local_header_t
+local_getNewBuffer(size_t size)
+{
+	char           *raw;
+	uintptr_t      data;
+	local_header_t header;
+
+	raw  = xmalloc(size + sizeof(struct local_header_struct)
+	               + MEMPOOL_ALIGNMENT);
+	data = (uintptr_t)(raw + sizeof(struct local_header_struct));
+	data = (data + MEMPOOL_ALIGNMENT - 1)
+	       & ~((uintptr_t)MEMPOOL_ALIGNMENT - 1);
+
+	header           = (local_header_t)(data
+	                                    - sizeof(struct local_header_struct));
+	header->raw      = raw;
+	header->next     = NULL;
+	header->size     = (size < MEMPOOL_MIN_POOLED_SIZE) ? 0 : size;
+	header->idxClass = 0;
+	header->magic    = LOCAL_MAGIC;
+
+	return header;
+}
+
+static local_header_t
+local_getHeader(void *ptr)
+{
+	local_header_t header;
+
+	header = (local_header_t)((char *)ptr
+	                          - sizeof(struct local_header_struct));
+	assert(header->magic == LOCAL_MAGIC);
+
+	return header;
+}
+
+static void
+local_touch(void *ptr, uint64_t size)
+{
+	char    *data     = ptr;
+	int64_t numChunks = (int64_t)((size + LOCAL_TOUCH_CHUNK - 1)
+	                              / LOCAL_TOUCH_CHUNK);
+
+#ifdef WITH_OPENMP
+#  pragma omp parallel for schedule(static)
+#endif
+	for (int64_t i = 0; i < numChunks; i++) {
+		uint64_t offset = (uint64_t)i * LOCAL_TOUCH_CHUNK;
+		uint64_t len    = size - offset;
+
+		memset(data + offset, 0,
+		       len < LOCAL_TOUCH_CHUNK ? len : LOCAL_TOUCH_CHUNK);
+	}
+}
+
+static local_header_t
+local_takeAllCached(void)
+{
+	local_header_t list = NULL;
+
+	for (int i = 0; i < LOCAL_NUM_CLASSES; i++) {
+		while (local_freeList[i] != NULL) {
+			local_header_t header = local_freeList[i];
+			local_freeList[i] = header->next;
+			header->next      = list;
+			list              = header;
+		}
+	}
+	local_numBytesCached = 0;
+
+	return list;
+}
+
+static void
+local_releaseList(local_header_t header)
+{
+	while (header != NULL) {
+		local_header_t next = header->next;
+		xfree(header->raw);
+		header = next;
+	}
+}
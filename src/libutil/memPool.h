@@ -0,0 +1,130 @@
+// Copyright (C) 2010, 2011, Steffen Knollmann
+// Released under the terms of the GNU General Public License version 3.
+// This file is part of `ginnungagap'.
+
+#ifndef MEMPOOL_H
+#define MEMPOOL_H
+
+
+/*--- Doxygen file description ------------------------------------------*/
+
+/**
+ * @file libutil/memPool.h
+ * @ingroup libutilCore
+ * @brief  Provides a pool recycling large buffers.
+ *
+ * The functions memPool_malloc() and memPool_free() have the signatures
+ * of malloc() and free() and are meant to be used with
+ * dataVar_setMemFuncs().  Large buffers are not returned to the system
+ * when they are freed but are kept in size classes and handed out again
+ * for later requests of a similar size.  Newly requested buffers are
+ * touched in parallel once (first-touch placement on NUMA systems), all
+ * buffers are aligned to #MEMPOOL_ALIGNMENT bytes.
+ */
+
+
+/*--- Includes ----------------------------------------------------------*/
+#include "util_config.h"
+#include <stdlib.h>
+#include <stdint.h>
+
+
+/*--- Exported defines --------------------------------------------------*/
+
+/** @brief  The alignment of all buffers handed out by the pool. */
+#define MEMPOOL_ALIGNMENT 64
+
+/** @brief  Requests smaller than this are not recycled. */
+#define MEMPOOL_MIN_POOLED_SIZE (1 << 20)
+
+/** @brief  The default limit of the memory held in cached buffers. */
+#define MEMPOOL_DEFAULT_MAX_BYTES_CACHED UINT64_MAX
+
+
+/*--- Prototypes of exported functions ----------------------------------*/
+
+/**
+ * @brief  Allocates an aligned buffer, reusing a cached one if possible.
+ *
+ * This function will abort the program, if not enough memory could be
+ * allocated.
+ *
+ * @param[in]  size
+ *                The amount of bytes to allocate.
+ *
+ * @return  Returns a pointer to the allocated memory region.
+ */
+extern void *
+memPool_malloc(size_t size);
+
+
+/**
+ * @brief  Returns a buffer to the pool.
+ *
+ * @param[in,out]  *ptr
+ *                    The buffer to free, this must have been obtained
+ *                    from memPool_malloc().  Passing @c NULL is
+ *                    undefined.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+memPool_free(void *ptr);
+
+
+/**
+ * @brief  Gives the number of bytes memPool_malloc() reserves for a
+ *         request.
+ *
+ * Large requests are rounded up to their size class, this allows to
+ * model the footprint of the pool without allocating anything.
+ *
+ * @param[in]  size
+ *                The requested number of bytes.
+ *
+ * @return  Returns the usable size of the buffer that would be handed
+ *          out for the request.
+ */
+extern uint64_t
+memPool_getAllocSize(size_t size);
+
+
+/**
+ * @brief  Releases all cached buffers to the system.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+memPool_trim(void);
+
+
+/**
+ * @brief  Limits the amount of memory held in cached buffers.
+ *
+ * Buffers freed while the cache would exceed the limit are returned to
+ * the system directly.  Independent of the limit, a request that cannot
+ * be served from its size class releases all cached buffers before a new
+ * one is obtained, the cache hence never adds dead buffers of other sizes
+ * to the peak memory.  If the cache already holds more than the new limit,
+ * it is emptied.
+ *
+ * @param[in]  maxBytesCached
+ *                The maximal number of bytes to keep cached, @c 0 disables
+ *                recycling.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+memPool_setMaxBytesCached(uint64_t maxBytesCached);
+
+
+/**
+ * @brief  Retrieves the amount of memory held in cached buffers.
+ *
+ * @return  Returns the number of bytes that are currently cached.
+ */
+extern uint64_t
+memPool_getNumBytesCached(void);
+
+
+#endif
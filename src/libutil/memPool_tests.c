@@ -0,0 +1,174 @@
+// Copyright (C) 2010, 2011, Steffen Knollmann
+// Released under the terms of the GNU General Public License version 3.
+// This file is part of `ginnungagap'.
+
+
+/*--- Includes ----------------------------------------------------------*/
+#include "util_config.h"
+#include "memPool_tests.h"
+#include "memPool.h"
+#include <stdio.h>
+#include <stdint.h>
+#ifdef XMEM_TRACK_MEM
+#  include "xmem.h"
+#endif
+
+
+/*--- Implementations of exported functios ------------------------------*/
+extern bool
+memPool_malloc_test(void)
+{
+	bool    hasPassed = true;
+	char    *small, *large;
+#ifdef XMEM_TRACK_MEM
+	size_t  allocatedBytes = global_allocated_bytes;
+#endif
+
+	printf("Testing %s... ", __func__);
+
+	small = memPool_malloc(17);
+	large = memPool_malloc(MEMPOOL_MIN_POOLED_SIZE + 1);
+	if (((uintptr_t)small) % MEMPOOL_ALIGNMENT != 0)
+		hasPassed = false;
+	if (((uintptr_t)large) % MEMPOOL_ALIGNMENT != 0)
+		hasPassed = false;
+	// New large buffers are pre-faulted with zeros.
+	if (large[0] != 0 || large[MEMPOOL_MIN_POOLED_SIZE] != 0)
+		hasPassed = false;
+	memPool_free(small);
+	memPool_free(large);
+	memPool_trim();
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+}
+
+extern bool
+memPool_free_test(void)
+{
+	bool    hasPassed = true;
+	void    *a, *b, *c;
+	size_t  size = 3 * MEMPOOL_MIN_POOLED_SIZE;
+#ifdef XMEM_TRACK_MEM
+	size_t  allocatedBytes = global_allocated_bytes;
+#endif
+
+	printf("Testing %s... ", __func__);
+
+	a = memPool_malloc(size);
+	memPool_free(a);
+	if (memPool_getNumBytesCached() < size)
+		hasPassed = false;
+	// A slightly different size from the same class reuses the buffer.
+	b = memPool_malloc(size - 100);
+	if (a != b)
+		hasPassed = false;
+	if (memPool_getNumBytesCached() != 0)
+		hasPassed = false;
+	// A much larger request must not.
+	c = memPool_malloc(2 * size);
+	if (c == b)
+		hasPassed = false;
+	memPool_free(b);
+	memPool_free(c);
+	memPool_trim();
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+}
+
+extern bool
+memPool_getAllocSize_test(void)
+{
+	bool    hasPassed = true;
+	void    *a;
+	size_t  size = 3 * MEMPOOL_MIN_POOLED_SIZE + 100;
+
+	printf("Testing %s... ", __func__);
+
+	if (memPool_getAllocSize(17) != 17)
+		hasPassed = false;
+	if (memPool_getAllocSize(size) < size)
+		hasPassed = false;
+	// The reported size must be exactly what gets cached.
+	a = memPool_malloc(size);
+	memPool_free(a);
+	if (memPool_getNumBytesCached() != memPool_getAllocSize(size))
+		hasPassed = false;
+	memPool_trim();
+
+	return hasPassed ? true : false;
+}
+
+extern bool
+memPool_trim_test(void)
+{
+	bool    hasPassed = true;
+	void    *a;
+#ifdef XMEM_TRACK_MEM
+	size_t  allocatedBytes = global_allocated_bytes;
+#endif
+
+	printf("Testing %s... ", __func__);
+
+	a = memPool_malloc(MEMPOOL_MIN_POOLED_SIZE);
+	memPool_free(a);
+	if (memPool_getNumBytesCached() != MEMPOOL_MIN_POOLED_SIZE)
+		hasPassed = false;
+	memPool_trim();
+	if (memPool_getNumBytesCached() != 0)
+		hasPassed = false;
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+}
+
+extern bool
+memPool_setMaxBytesCached_test(void)
+{
+	bool    hasPassed = true;
+	void    *a, *b, *c;
+	size_t  size = 3 * MEMPOOL_MIN_POOLED_SIZE;
+#ifdef XMEM_TRACK_MEM
+	size_t  allocatedBytes = global_allocated_bytes;
+#endif
+
+	printf("Testing %s... ", __func__);
+
+	// Only one of two buffers fits under the limit.
+	memPool_setMaxBytesCached(memPool_getAllocSize(size));
+	a = memPool_malloc(size);
+	b = memPool_malloc(size);
+	memPool_free(a);
+	memPool_free(b);
+	if (memPool_getNumBytesCached() != memPool_getAllocSize(size))
+		hasPassed = false;
+
+	// A miss releases the cached buffers of the other classes.
+	memPool_setMaxBytesCached(MEMPOOL_DEFAULT_MAX_BYTES_CACHED);
+	c = memPool_malloc(4 * size);
+	if (memPool_getNumBytesCached() != 0)
+		hasPassed = false;
+	memPool_free(c);
+
+	// Lowering the limit below the cached amount empties the cache.
+	memPool_setMaxBytesCached(0);
+	if (memPool_getNumBytesCached() != 0)
+		hasPassed = false;
+	memPool_setMaxBytesCached(MEMPOOL_DEFAULT_MAX_BYTES_CACHED);
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+}
@@ -0,0 +1,31 @@
+// Copyright (C) 2010, 2011, Steffen Knollmann
+// Released under the terms of the GNU General Public License version 3.
+// This file is part of `ginnungagap'.
+
+#ifndef MEMPOOL_TESTS_H
+#define MEMPOOL_TESTS_H
+
+
+/*--- Includes ----------------------------------------------------------*/
+#include "util_config.h"
+#include <stdbool.h>
+
+
+/*--- Prototypes of exported functions ----------------------------------*/
+extern bool
+memPool_malloc_test(void);
+
+extern bool
+memPool_free_test(void);
+
+extern bool
+memPool_getAllocSize_test(void);
+
+extern bool
+memPool_trim_test(void);
+
+extern bool
+memPool_setMaxBytesCached_test(void);
+
+
+#endif
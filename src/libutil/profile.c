@@ -0,0 +1,595 @@
+// Copyright (C) 2010, 2011, 2012, Steffen Knollmann
+// Released under the terms of the GNU General Public License version 3.
+// This file is part of `ginnungagap'.
+
+
+/*--- Doxygen file description ------------------------------------------*/
+
+/**
+ * @file libutil/profile.c
+ * @ingroup libutilMisc
+ * @brief  This file provides the implementation of the region profiler.
+ */
+
+
+/*--- Includes ----------------------------------------------------------*/
+#include "util_config.h"
+#include "profile.h"
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+#include <inttypes.h>
+#include <assert.h>
+#if (defined WITH_MPI)
+#  include <mpi.h>
+#endif
+#if (defined _OPENMP)
+#  include <omp.h>
+#endif
+#if (!defined WITH_MPI && !defined _OPENMP)
+#  include <time.h>
+#endif
+#include "xmem.h"
+#include "xstring.h"
+#include "xfile.h"
+
+
+/*--- Local defines -----------------------------------------------------*/
+
+/** @brief  The number of regions by which the region table grows. */
+#define LOCAL_REGIONS_CHUNK 32
+
+
+/*--- Local structures and typedefs -------------------------------------*/
+
+/** @brief  Describes one region of the local tree. */
+struct local_region_struct {
+	/** @brief  The name of the region. */
+	char     *name;
+	/** @brief  The index of the parent region, -1 for top-level ones. */
+	int      idxParent;
+	/** @brief  The number of times the region has been entered. */
+	uint64_t numCalls;
+	/** @brief  The number of bytes moved in the region. */
+	uint64_t numBytes;
+	/** @brief  The timestamp at which the region was entered last. */
+	double   timeStart;
+	/** @brief  The accumulated time spent in the region. */
+	double   time;
+	/** @brief  The peak of the enclosing region when this one was entered. */
+	uint64_t memOuterPeak;
+	/** @brief  The largest amount of memory held while in the region. */
+	uint64_t memPeak;
+};
+
+/** @brief  Describes one region as it is sent to rank 0. */
+struct local_record_struct {
+	/** @brief  The names of the region and all its parents. */
+	char     path[PROFILE_MAX_PATH_LENGTH];
+	/** @brief  The number of times the region has been entered. */
+	uint64_t numCalls;
+	/** @brief  The number of bytes moved in the region. */
+	uint64_t numBytes;
+	/** @brief  The accumulated time spent in the region. */
+	double   time;
+	/** @brief  The largest amount of memory held while in the region. */
+	uint64_t memPeak;
+};
+
+/** @brief  Describes one region combined over all ranks. */
+struct local_stat_struct {
+	/** @brief  The path of the region. */
+	const char *path;
+	/** @brief  The index of the parent region, -1 for top-level ones. */
+	int        idxParent;
+	/** @brief  The number of ranks that entered the region. */
+	int        numRanks;
+	/** @brief  The maximal number of calls on any rank. */
+	uint64_t   numCalls;
+	/** @brief  The number of bytes moved summed over all ranks. */
+	uint64_t   numBytes;
+	/** @brief  The minimal time. */
+	double     timeMin;
+	/** @brief  The maximal time. */
+	double     timeMax;
+	/** @brief  The time summed over all ranks. */
+	double     timeSum;
+	/** @brief  The maximal memory peak. */
+	uint64_t   memPeak;
+};
+
+/** @brief  Convenience typedef. */
+typedef struct local_record_struct local_record_t;
+
+/** @brief  Convenience typedef. */
+typedef struct local_stat_struct local_stat_t;
+
+
+/*--- Local variables ---------------------------------------------------*/
+#if (!defined WITH_MPI && !defined _OPENMP)
+
+/**
+ * @brief  The conversion factor from the result of clock() to seconds.
+ */
+static double CPS_INV = 1. / ((double)CLOCKS_PER_SEC);
+#endif
+
+/** @brief  The table of all regions known to this rank. */
+static struct local_region_struct *local_regions = NULL;
+
+/** @brief  The number of used entries in #local_regions. */
+static int local_numRegions = 0;
+
+/** @brief  The number of allocated entries in #local_regions. */
+static int local_numRegionsAlloc = 0;
+
+/** @brief  The innermost open region, -1 if none is open. */
+static int local_idxCurrent = -1;
+
+
+/*--- Prototypes of local functions -------------------------------------*/
+
+/**
+ * @brief  Gets a local timestamp without any synchronisation.
+ *
+ * @return  Returns the current time in seconds.
+ */
+static double
+local_getTime(void);
+
+
+/**
+ * @brief  Gets the rank of the calling process in MPI_COMM_WORLD.
+ *
+ * @return  Returns the rank, 0 without MPI.
+ */
+static int
+local_getRank(void);
+
+
+/**
+ * @brief  Finds a child region of the current region or creates it.
+ *
+ * @param[in]  *name
+ *                The name of the region.
+ *
+ * @return  Returns the index of the region.
+ */
+static int
+local_getRegion(const char *name);
+
+
+/**
+ * @brief  Appends the path of a region to a string.
+ *
+ * @param[in]      idx
+ *                    The region.
+ * @param[in,out]  *path
+ *                    The string, must provide room for
+ *                    #PROFILE_MAX_PATH_LENGTH characters.  The path is
+ *                    truncated if it does not fit.
+ *
+ * @return  Returns nothing.
+ */
+static void
+local_getPath(int idx, char *path);
+
+
+/**
+ * @brief  Converts the local regions to records.
+ *
+ * @return  Returns a newly allocated array of #local_numRegions records.
+ */
+static local_record_t *
+local_getRecords(void);
+
+
+/**
+ * @brief  Collects the records of all ranks on rank 0.
+ *
+ * @param[in]   *records
+ *                 The local records.
+ * @param[out]  *numRecords
+ *                 Will receive the number of records returned, only set
+ *                 on rank 0.
+ *
+ * @return  Returns the records of all ranks on rank 0 and @c NULL on all
+ *          other ranks.
+ */
+static local_record_t *
+local_gatherRecords(local_record_t *records, int *numRecords);
+
+
+/**
+ * @brief  Combines the records of the same region.
+ *
+ * @param[in]   *records
+ *                 The records of all ranks.
+ * @param[in]   numRecords
+ *                 The number of records.
+ * @param[out]  *numStats
+ *                 Will receive the number of distinct regions.
+ *
+ * @return  Returns a newly allocated array of statistics, in the order
+ *          in which the regions first appear in the records.
+ */
+static local_stat_t *
+local_calcStats(const local_record_t *records,
+                int                  numRecords,
+                int                  *numStats);
+
+
+/**
+ * @brief  Writes one region and, recursively, all its children.
+ *
+ * @param[in,out]  *f
+ *                    The file to write to.
+ * @param[in]      *stats
+ *                    The statistics of all regions.
+ * @param[in]      numStats
+ *                    The number of regions.
+ * @param[in]      idx
+ *                    The region to write.
+ * @param[in]      isJSON
+ *                    Whether to write JSON or CSV.
+ * @param[in,out]  *isFirst
+ *                    Whether no region has been written yet.
+ *
+ * @return  Returns nothing.
+ */
+static void
+local_writeStat(FILE               *f,
+                const local_stat_t *stats,
+                int                numStats,
+                int                idx,
+                bool               isJSON,
+                bool               *isFirst);
+
+
+/*--- Implementations of exported functios ------------------------------*/
+extern void
+profile_enter(const char *name)
+{
+	int idx;
+
+	assert(name != NULL && strchr(name, '/') == NULL);
+#ifdef _OPENMP
+	assert(!omp_in_parallel());
+#endif
+
+	idx = local_getRegion(name);
+	local_regions[idx].numCalls++;
+#ifdef XMEM_TRACK_MEM
+	local_regions[idx].memOuterPeak = (uint64_t)xmem_pushPeak();
+#endif
+	local_regions[idx].timeStart    = local_getTime();
+	local_idxCurrent                = idx;
+}
+
+extern void
+profile_enter_text(const char *name, const char *text)
+{
+	if (local_getRank() == 0) {
+		printf("%s", text);
+		fflush(stdout);
+	}
+
+	profile_enter(name);
+}
+
+extern double
+profile_leave(void)
+{
+	struct local_region_struct *region;
+	double                     timing;
+
+	assert(local_idxCurrent >= 0);
+
+	region           = local_regions + local_idxCurrent;
+	timing           = local_getTime() - region->timeStart;
+	region->time    += timing;
+	local_idxCurrent = region->idxParent;
+#ifdef XMEM_TRACK_MEM
+	{
+		uint64_t peak;
+
+		peak = (uint64_t)xmem_popPeak((size_t)region->memOuterPeak);
+		if (peak > region->memPeak)
+			region->memPeak = peak;
+	}
+#endif
+
+	return timing;
+}
+
+extern double
+profile_leave_text(const char *text)
+{
+	double timing = profile_leave();
+
+	if (local_getRank() == 0) {
+		printf(text, timing);
+		fflush(stdout);
+	}
+
+	return timing;
+}
+
+extern void
+profile_addBytes(uint64_t numBytes)
+{
+	if (local_idxCurrent >= 0)
+		local_regions[local_idxCurrent].numBytes += numBytes;
+}
+
+extern void
+profile_report(const char *fileName)
+{
+	local_record_t *records, *allRecords;
+	local_stat_t   *stats;
+	int            numRecords, numStats, numRanks = 1;
+	bool           isJSON, isFirst = true;
+	size_t         lenName;
+	FILE           *f;
+
+	assert(fileName != NULL);
+	assert(local_idxCurrent == -1);
+
+	records    = local_getRecords();
+	allRecords = local_gatherRecords(records, &numRecords);
+	xfree(records);
+	if (allRecords == NULL)
+		return;
+
+#ifdef WITH_MPI
+	MPI_Comm_size(MPI_COMM_WORLD, &numRanks);
+#endif
+	stats   = local_calcStats(allRecords, numRecords, &numStats);
+	lenName = strlen(fileName);
+	isJSON  = (lenName >= 5) && (strcmp(fileName + lenName - 5, ".json") == 0);
+
+	f = xfopen(fileName, "w");
+	if (isJSON)
+		fprintf(f, "{\n  \"numRanks\": %i,\n  \"regions\": [\n", numRanks);
+	else
+		fprintf(f, "# path,numRanks,numCalls,timeMin,timeMean,timeMax,"
+		        "imbalance,numBytes,memPeak\n");
+	for (int i = 0; i < numStats; i++) {
+		if (stats[i].idxParent == -1)
+			local_writeStat(f, stats, numStats, i, isJSON, &isFirst);
+	}
+	if (isJSON)
+		fprintf(f, "\n  ]\n}\n");
+	xfclose(&f);
+
+	xfree(stats);
+	xfree(allRecords);
+} /* profile_report */
+
+extern void
+profile_reset(void)
+{
+	for (int i = 0; i < local_numRegions; i++)
+		xfree(local_regions[i].name);
+	if (local_regions != NULL)
+		xfree(local_regions);
+	local_regions         = NULL;
+	local_numRegions      = 0;
+	local_numRegionsAlloc = 0;
+	local_idxCurrent      = -1;
+}
+
+/*--- Implementations of local functions --------------------------------*/
+static double
+local_getTime(void)
+{
+#if (defined WITH_MPI)
+	return MPI_Wtime();
+#elif (defined _OPENMP)
+	return omp_get_wtime();
+#else
+	return clock() * CPS_INV;
+#endif
+}
+
+static int
+local_getRank(void)
+{
+	int rank = 0;
+
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+	return rank;
+}
+
+static int
+local_getRegion(const char *name)
+{
+	for (int i = 0; i < local_numRegions; i++) {
+		if ((local_regions[i].idxParent == local_idxCurrent)
+		    && (strcmp(local_regions[i].name, name) == 0))
+			return i;
+	}
+
+	if (local_numRegions == local_numRegionsAlloc) {
+		local_numRegionsAlloc += LOCAL_REGIONS_CHUNK;
+		local_regions          = xrealloc(local_regions,
+		                                  sizeof(struct local_region_struct)
+		                                  * local_numRegionsAlloc);
+	}
+
+	local_regions[local_numRegions].name         = xstrdup(name);
+	local_regions[local_numRegions].idxParent    = local_idxCurrent;
+	local_regions[local_numRegions].numCalls     = 0;
+	local_regions[local_numRegions].numBytes     = 0;
+	local_regions[local_numRegions].timeStart    = 0.0;
+	local_regions[local_numRegions].time         = 0.0;
+	local_regions[local_numRegions].memOuterPeak = 0;
+	local_regions[local_numRegions].memPeak      = 0;
+
+	return local_numRegions++;
+}
+
+static void
+local_getPath(int idx, char *path)
+{
+	if (local_regions[idx].idxParent != -1) {
+		local_getPath(local_regions[idx].idxParent, path);
+		strncat(path, "/", PROFILE_MAX_PATH_LENGTH - 1 - strlen(path));
+	}
+	strncat(path, local_regions[idx].name,
+	        PROFILE_MAX_PATH_LENGTH - 1 - strlen(path));
+}
+
+static local_record_t *
+local_getRecords(void)
+{
+	local_record_t *records;
+
+	records = xmalloc(sizeof(local_record_t) * (local_numRegions + 1));
+
+	for (int i = 0; i < local_numRegions; i++) {
+		memset(records[i].path, '\0', PROFILE_MAX_PATH_LENGTH);
+		local_getPath(i, records[i].path);
+		records[i].numCalls = local_regions[i].numCalls;
+		records[i].numBytes = local_regions[i].numBytes;
+		records[i].time     = local_regions[i].time;
+		records[i].memPeak  = local_regions[i].memPeak;
+	}
+
+	return records;
+}
+
+static local_record_t *
+local_gatherRecords(local_record_t *records, int *numRecords)
+{
+	local_record_t *allRecords = NULL;
+#ifdef WITH_MPI
+	int            rank, size;
+	int            numBytes = local_numRegions * (int)sizeof(local_record_t);
+	int            *counts  = NULL, *displs = NULL;
+
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+	MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+	if (rank == 0) {
+		counts = xmalloc(sizeof(int) * size);
+		displs = xmalloc(sizeof(int) * size);
+	}
+	MPI_Gather(&numBytes, 1, MPI_INT, counts, 1, MPI_INT, 0,
+	           MPI_COMM_WORLD);
+	if (rank == 0) {
+		displs[0] = 0;
+		for (int i = 1; i < size; i++)
+			displs[i] = displs[i - 1] + counts[i - 1];
+		*numRecords = (displs[size - 1] + counts[size - 1])
+		              / (int)sizeof(local_record_t);
+		allRecords  = xmalloc(sizeof(local_record_t) * (*numRecords + 1));
+	}
+	MPI_Gatherv(records, numBytes, MPI_BYTE,
+	            allRecords, counts, displs, MPI_BYTE, 0, MPI_COMM_WORLD);
+	if (rank == 0) {
+		xfree(displs);
+		xfree(counts);
+	}
+#else
+	*numRecords = local_numRegions;
+	allRecords  = xmalloc(sizeof(local_record_t) * (*numRecords + 1));
+	memcpy(allRecords, records, sizeof(local_record_t) * (*numRecords));
+#endif
+
+	return allRecords;
+}
+
+static local_stat_t *
+local_calcStats(const local_record_t *records,
+                int                  numRecords,
+                int                  *numStats)
+{
+	local_stat_t *stats;
+
+	stats     = xmalloc(sizeof(local_stat_t) * (numRecords + 1));
+	*numStats = 0;
+
+	for (int i = 0; i < numRecords; i++) {
+		int j = 0;
+
+		while (j < *numStats && strcmp(stats[j].path, records[i].path) != 0)
+			j++;
+
+		if (j == *numStats) {
+			const char *sep = strrchr(records[i].path, '/');
+
+			stats[j].path      = records[i].path;
+			stats[j].idxParent = -1;
+			if (sep != NULL) {
+				size_t len = (size_t)(sep - records[i].path);
+				for (int k = 0; k < *numStats; k++) {
+					if ((strlen(stats[k].path) == len)
+					    && (strncmp(stats[k].path, records[i].path, len)
+					        == 0))
+						stats[j].idxParent = k;
+				}
+			}
+			stats[j].numRanks = 0;
+			stats[j].numCalls = 0;
+			stats[j].numBytes = 0;
+			stats[j].timeMin  = records[i].time;
+			stats[j].timeMax  = records[i].time;
+			stats[j].timeSum  = 0.0;
+			stats[j].memPeak  = 0;
+			(*numStats)++;
+		}
+
+		stats[j].numRanks++;
+		if (records[i].numCalls > stats[j].numCalls)
+			stats[j].numCalls = records[i].numCalls;
+		stats[j].numBytes += records[i].numBytes;
+		if (records[i].time < stats[j].timeMin)
+			stats[j].timeMin = records[i].time;
+		if (records[i].time > stats[j].timeMax)
+			stats[j].timeMax = records[i].time;
+		stats[j].timeSum += records[i].time;
+		if (records[i].memPeak > stats[j].memPeak)
+			stats[j].memPeak = records[i].memPeak;
+	}
+
+	return stats;
+} /* local_calcStats */
+
+static void
+local_writeStat(FILE               *f,
+                const local_stat_t *stats,
+                int                numStats,
+                int                idx,
+                bool               isJSON,
+                bool               *isFirst)
+{
+	double mean      = stats[idx].timeSum / stats[idx].numRanks;
+	double imbalance = (mean > 0.0) ? stats[idx].timeMax / mean - 1.0 : 0.0;
+
+	if (isJSON) {
+		fprintf(f, "%s    {\"path\": \"%s\", \"numRanks\": %i, "
+		        "\"numCalls\": %" PRIu64 ", \"timeMin\": %e, "
+		        "\"timeMean\": %e, \"timeMax\": %e, \"imbalance\": %e, "
+		        "\"numBytes\": %" PRIu64 ", \"memPeak\": %" PRIu64 "}",
+		        *isFirst ? "" : ",\n",
+		        stats[idx].path, stats[idx].numRanks, stats[idx].numCalls,
+		        stats[idx].timeMin, mean, stats[idx].timeMax, imbalance,
+		        stats[idx].numBytes, stats[idx].memPeak);
+	} else {
+		fprintf(f, "%s,%i,%" PRIu64 ",%e,%e,%e,%e,%" PRIu64 ",%" PRIu64
+		        "\n",
+		        stats[idx].path, stats[idx].numRanks, stats[idx].numCalls,
+		        stats[idx].timeMin, mean, stats[idx].timeMax, imbalance,
+		        stats[idx].numBytes, stats[idx].memPeak);
+	}
+	*isFirst = false;
+
+	for (int i = idx + 1; i < numStats; i++) {
+		if (stats[i].idxParent == idx)
+			local_writeStat(f, stats, numStats, i, isJSON, isFirst);
+	}
+}
@@ -0,0 +1,136 @@
+// Copyright (C) 2010, 2011, 2012, Steffen Knollmann
+// Released under the terms of the GNU General Public License version 3.
+// This file is part of `ginnungagap'.
+
+#ifndef PROFILE_H
+#define PROFILE_H
+
+
+/*--- Doxygen file description ------------------------------------------*/
+
+/**
+ * @file libutil/profile.h
+ * @ingroup libutilMisc
+ * @brief  This file provides the interface of the region profiler.
+ *
+ * Regions are opened with profile_enter() and closed with
+ * profile_leave(); regions opened while another one is open become its
+ * children, so the same name may appear in several places of the tree.
+ * Entering and leaving only take a local timestamp, no communication is
+ * done.  The per-rank timings are combined once, by profile_report(),
+ * which gives the minimum, mean and maximum time of every region over
+ * all ranks together with the load imbalance and the number of bytes
+ * that were moved in it.  With -DXMEM_TRACK_MEM the largest amount of
+ * memory held by any rank while in the region is reported as well.
+ *
+ * The profiler keeps global state and must only be used outside of
+ * OpenMP parallel regions.
+ */
+
+
+/*--- Includes ----------------------------------------------------------*/
+#include "util_config.h"
+#include <stdint.h>
+
+
+/*--- Exported defines --------------------------------------------------*/
+
+/** @brief  The maximal length of the path of a region in the report. */
+#define PROFILE_MAX_PATH_LENGTH 128
+
+
+/*--- Prototypes of exported functions ----------------------------------*/
+
+/**
+ * @brief  Opens a region.
+ *
+ * @param[in]  *name
+ *                The name of the region, must not contain a @c / or
+ *                quotation marks.  Entering the same name again below the
+ *                same parent accumulates into the same region.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+profile_enter(const char *name);
+
+
+/**
+ * @brief  Opens a region and prints a message.
+ *
+ * @param[in]  *name
+ *                The name of the region, see profile_enter().
+ * @param[in]  *text
+ *                The message that is printed by rank 0.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+profile_enter_text(const char *name, const char *text);
+
+
+/**
+ * @brief  Closes the innermost open region.
+ *
+ * @return  Returns the local number of seconds spent in the region.
+ */
+extern double
+profile_leave(void);
+
+
+/**
+ * @brief  Closes the innermost open region and reports the elapsed time.
+ *
+ * @param[in]  *text
+ *                The text used by rank 0 to report the local time, must
+ *                contain a format string for a double, eg
+ *                <tt>.5%f</tt>.
+ *
+ * @return  Returns the local number of seconds spent in the region.
+ */
+extern double
+profile_leave_text(const char *text);
+
+
+/**
+ * @brief  Accounts bytes moved (communicated or read/written) to the
+ *         innermost open region.
+ *
+ * If no region is open, the call has no effect.
+ *
+ * @param[in]  numBytes
+ *                The number of bytes moved by the calling rank.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+profile_addBytes(uint64_t numBytes);
+
+
+/**
+ * @brief  Combines the timings of all ranks and writes the report.
+ *
+ * This is a collective function; it must be called by all ranks of
+ * @c MPI_COMM_WORLD and no region may be open.  The report is written
+ * by rank 0 as JSON if the file name ends in <tt>.json</tt> and as CSV
+ * otherwise.
+ *
+ * @param[in]  *fileName
+ *                The name of the report file.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+profile_report(const char *fileName);
+
+
+/**
+ * @brief  Forgets all regions and frees the associated memory.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+profile_reset(void);
+
+
+#endif
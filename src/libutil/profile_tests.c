@@ -0,0 +1,181 @@
+// Copyright (C) 2010, 2011, 2012, Steffen Knollmann
+// Released under the terms of the GNU General Public License version 3.
+// This file is part of `ginnungagap'.
+
+
+/*--- Includes ----------------------------------------------------------*/
+#include "util_config.h"
+#include "profile_tests.h"
+#include "profile.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <string.h>
+#ifdef WITH_MPI
+#  include <mpi.h>
+#endif
+#ifdef XMEM_TRACK_MEM
+#  include "xmem.h"
+#endif
+
+
+/*--- Local defines -----------------------------------------------------*/
+#define LOCAL_TESTFILE "profile_test.csv"
+
+
+/*--- Implementations of exported functios ------------------------------*/
+extern bool
+profile_enter_test(void)
+{
+	bool   hasPassed = true;
+	double outer, inner;
+#ifdef XMEM_TRACK_MEM
+	size_t allocatedBytes = global_allocated_bytes;
+#endif
+
+	printf("Testing %s... ", __func__);
+
+	profile_enter("outer");
+	profile_enter("inner");
+	inner = profile_leave();
+	outer = profile_leave();
+	if ((inner < 0.0) || (outer < inner))
+		hasPassed = false;
+	profile_reset();
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+}
+
+extern bool
+profile_leave_test(void)
+{
+	bool   hasPassed = true;
+	double timing;
+#ifdef XMEM_TRACK_MEM
+	size_t allocatedBytes = global_allocated_bytes;
+#endif
+
+	printf("Testing %s... ", __func__);
+
+	profile_enter("a");
+	profile_enter("a");
+	profile_enter("a");
+	timing = profile_leave();
+	timing = profile_leave() - timing;
+	// The outer region includes the inner one.
+	if (timing < 0.0)
+		hasPassed = false;
+	timing = profile_leave();
+	if (timing < 0.0)
+		hasPassed = false;
+	profile_reset();
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+}
+
+extern bool
+profile_reset_test(void)
+{
+	bool   hasPassed = true;
+#ifdef XMEM_TRACK_MEM
+	size_t allocatedBytes = global_allocated_bytes;
+#endif
+
+	printf("Testing %s... ", __func__);
+
+	profile_enter("a");
+	profile_addBytes(UINT64_C(100));
+	profile_enter("b");
+	profile_reset();
+	// A reset closes all regions, so this opens a new top-level region.
+	profile_enter("b");
+	if (profile_leave() < 0.0)
+		hasPassed = false;
+	profile_reset();
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+}
+
+extern bool
+profile_report_test(void)
+{
+	bool     hasPassed = true;
+	int      rank      = 0;
+	int      size      = 1;
+	char     line[256];
+	char     path[PROFILE_MAX_PATH_LENGTH];
+	int      numRanks;
+	uint64_t numCalls, numBytes;
+	double   tMin, tMean, tMax, imbalance;
+	FILE     *f;
+#ifdef XMEM_TRACK_MEM
+	size_t   allocatedBytes = global_allocated_bytes;
+#endif
+
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+	MPI_Comm_size(MPI_COMM_WORLD, &size);
+#endif
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	for (int i = 0; i < 2; i++) {
+		profile_enter("outer");
+		profile_enter("inner");
+		profile_addBytes(UINT64_C(10));
+		profile_leave();
+		profile_leave();
+	}
+	profile_enter("last");
+	profile_leave();
+	profile_report(LOCAL_TESTFILE);
+	profile_reset();
+
+	if (rank == 0) {
+		f = fopen(LOCAL_TESTFILE, "r");
+		if (f == NULL)
+			return false;
+		if ((fgets(line, 256, f) == NULL) || (line[0] != '#'))
+			hasPassed = false;
+		for (int i = 0; i < 3 && hasPassed; i++) {
+			if ((fgets(line, 256, f) == NULL)
+			    || (sscanf(line, "%127[^,],%i,%" SCNu64 ",%lf,%lf,%lf,%lf,%"
+			               SCNu64, path, &numRanks, &numCalls, &tMin,
+			               &tMean, &tMax, &imbalance, &numBytes) != 8)) {
+				hasPassed = false;
+				break;
+			}
+			if ((numRanks != size) || (tMin > tMean) || (tMean > tMax)
+			    || (imbalance < 0.0))
+				hasPassed = false;
+			if ((i == 0) && ((strcmp(path, "outer") != 0) || numCalls != 2
+			                 || numBytes != 0))
+				hasPassed = false;
+			if ((i == 1) && ((strcmp(path, "outer/inner") != 0)
+			                 || numBytes != UINT64_C(20) * size))
+				hasPassed = false;
+			if ((i == 2) && (strcmp(path, "last") != 0))
+				hasPassed = false;
+		}
+		fclose(f);
+		remove(LOCAL_TESTFILE);
+	}
+#ifdef XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+} /* profile_report_test */
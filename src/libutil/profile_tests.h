@@ -0,0 +1,28 @@
+// Copyright (C) 2010, 2011, 2012, Steffen Knollmann
+// Released under the terms of the GNU General Public License version 3.
+// This file is part of `ginnungagap'.
+
+#ifndef PROFILE_TESTS_H
+#define PROFILE_TESTS_H
+
+
+/*--- Includes ----------------------------------------------------------*/
+#include "util_config.h"
+#include <stdbool.h>
+
+
+/*--- Prototypes of exported functions ----------------------------------*/
+extern bool
+profile_enter_test(void);
+
+extern bool
+profile_leave_test(void);
+
+extern bool
+profile_reset_test(void);
+
+extern bool
+profile_report_test(void);
+
+
+#endif
@@ -20,12 +20,98 @@
 #include <inttypes.h>
 #include <stdbool.h>
 #include "../libutil/xmem.h"
+#include "../libutil/byteswap.h"
 
 
 /*--- Implementation of main structure ----------------------------------*/
 #include "stai_adt.h"
 
 
+/*--- Local defines -----------------------------------------------------*/
+
+/**
+ * @brief  The number of elements from which on bulk copies are spread
+ *         over the OpenMP threads.
+ *
+ * Below this the copy is too short to amortise starting the threads.
+ */
+#define LOCAL_MIN_ELEMENTS_FOR_THREADS UINT64_C(65536)
+
+
+/*--- Prototypes of local functions -------------------------------------*/
+
+/**
+ * @brief  Copies elements between two stridden arrays.
+ *
+ * The element sizes of 4 and 8 bytes are handled by loops with a fixed
+ * size copy, which the compiler turns into plain loads and stores.
+ *
+ * @param[out]  *dst
+ *                 The first element of the destination.
+ * @param[in]   strideDst
+ *                 The stride of the destination in bytes.
+ * @param[in]   *src
+ *                 The first element of the source.
+ * @param[in]   strideSrc
+ *                 The stride of the source in bytes.
+ * @param[in]   sizeOfElement
+ *                 The size of one element in bytes.
+ * @param[in]   numElements
+ *                 The number of elements to copy.
+ *
+ * @return  Returns nothing.
+ */
+static void
+local_copyStrided(char *restrict       dst,
+                  size_t               strideDst,
+                  const char *restrict src,
+                  size_t               strideSrc,
+                  size_t               sizeOfElement,
+                  uint64_t             numElements);
+
+
+/**
+ * @brief  Copies elements between two stridden arrays and reverses the
+ *         byte order of each of their components.
+ *
+ * @param[out]  *dst
+ *                 The first element of the destination.
+ * @param[in]   strideDst
+ *                 The stride of the destination in bytes.
+ * @param[in]   *src
+ *                 The first element of the source.
+ * @param[in]   strideSrc
+ *                 The stride of the source in bytes.
+ * @param[in]   sizeOfElement
+ *                 The size of one element in bytes.
+ * @param[in]   numComponents
+ *                 The number of components per element, each is swapped
+ *                 separately.
+ * @param[in]   numElements
+ *                 The number of elements to copy.
+ *
+ * @return  Returns nothing.
+ */
+static void
+local_copyStridedSwapped(char *restrict       dst,
+                         size_t               strideDst,
+                         const char *restrict src,
+                         size_t               strideSrc,
+                         size_t               sizeOfElement,
+                         int                  numComponents,
+                         uint64_t             numElements);
+
+
+/** @brief  Copies 4 bytes from @c src to @c dst reversing their order. */
+inline static void
+local_swap4(void *restrict dst, const void *restrict src);
+
+
+/** @brief  Copies 8 bytes from @c src to @c dst reversing their order. */
+inline static void
+local_swap8(void *restrict dst, const void *restrict src);
+
+
 /*--- Implementations of exported functions -----------------------------*/
 extern stai_t
 stai_new(void         *base,
@@ -119,9 +205,70 @@ stai_setElementsMulti(const stai_t stai,
 	assert(stai != NULL || numElements == UINT64_C(0));
 	assert(elements != NULL || numElements == UINT64_C(0));
 
-	for (uint64_t i = 0; i < numElements; i++)
-		stai_setElement(stai, pos + i, ((const char *)elements
-		                                + stai->sizeOfElementInBytes * i));
+	if (numElements == UINT64_C(0))
+		return;
+
+	char *dst = (char *)(stai->base) + pos * stai->strideInBytes;
+
+	if (stai_isLinear(stai))
+		memcpy(dst, elements, numElements * stai->sizeOfElementInBytes);
+	else
+		local_copyStrided(dst, stai->strideInBytes, elements,
+		                  stai->sizeOfElementInBytes,
+		                  stai->sizeOfElementInBytes, numElements);
+}
+
+extern void
+stai_setElementsMultiSwapped(const stai_t stai,
+                             uint64_t     pos,
+                             const void   *elements,
+                             uint64_t     numElements,
+                             int          numComponents)
+{
+	assert(stai != NULL || numElements == UINT64_C(0));
+	assert(elements != NULL || numElements == UINT64_C(0));
+
+	if (numElements == UINT64_C(0))
+		return;
+
+	assert(numComponents > 0);
+	assert(stai->sizeOfElementInBytes % numComponents == 0);
+
+	local_copyStridedSwapped((char *)(stai->base)
+	                         + pos * stai->strideInBytes,
+	                         stai->strideInBytes, elements,
+	                         stai->sizeOfElementInBytes,
+	                         stai->sizeOfElementInBytes, numComponents,
+	                         numElements);
+}
+
+extern void
+stai_setElementsMultiFromFloat(const stai_t stai,
+                               uint64_t     pos,
+                               const float  *values,
+                               uint64_t     numElements)
+{
+	assert(stai != NULL || numElements == UINT64_C(0));
+	assert(values != NULL || numElements == UINT64_C(0));
+
+	if (numElements == UINT64_C(0))
+		return;
+
+	if (stai->sizeOfElementInBytes == sizeof(float)) {
+		stai_setElementsMulti(stai, pos, values, numElements);
+	} else {
+		char *dst = (char *)(stai->base) + pos * stai->strideInBytes;
+
+		assert(stai->sizeOfElementInBytes == sizeof(double));
+#ifdef WITH_OPENMP
+#  pragma omp parallel for \
+		if (numElements >= LOCAL_MIN_ELEMENTS_FOR_THREADS)
+#endif
+		for (uint64_t i = 0; i < numElements; i++) {
+			double d = (double)(values[i]);
+			memcpy(dst + i * stai->strideInBytes, &d, sizeof(double));
+		}
+	}
 }
 
 extern void
@@ -144,9 +291,71 @@ stai_getElementsMulti(const stai_t stai,
 	assert(stai != NULL || numElements == UINT64_C(0));
 	assert(elements != NULL || numElements == UINT64_C(0));
 
-	for (uint64_t i = UINT64_C(0); i < numElements; i++)
-		stai_getElement(stai, pos + i,
-		                ((char *)elements + stai->sizeOfElementInBytes * i));
+	if (numElements == UINT64_C(0))
+		return;
+
+	const char *src = (char *)(stai->base) + pos * stai->strideInBytes;
+
+	if (stai_isLinear(stai))
+		memcpy(elements, src, numElements * stai->sizeOfElementInBytes);
+	else
+		local_copyStrided(elements, stai->sizeOfElementInBytes, src,
+		                  stai->strideInBytes, stai->sizeOfElementInBytes,
+		                  numElements);
+}
+
+extern void
+stai_getElementsMultiSwapped(const stai_t stai,
+                             uint64_t     pos,
+                             void         *elements,
+                             uint64_t     numElements,
+                             int          numComponents)
+{
+	assert(stai != NULL || numElements == UINT64_C(0));
+	assert(elements != NULL || numElements == UINT64_C(0));
+
+	if (numElements == UINT64_C(0))
+		return;
+
+	assert(numComponents > 0);
+	assert(stai->sizeOfElementInBytes % numComponents == 0);
+
+	local_copyStridedSwapped(elements, stai->sizeOfElementInBytes,
+	                         (char *)(stai->base)
+	                         + pos * stai->strideInBytes,
+	                         stai->strideInBytes,
+	                         stai->sizeOfElementInBytes, numComponents,
+	                         numElements);
+}
+
+extern void
+stai_getElementsMultiAsFloat(const stai_t stai,
+                             uint64_t     pos,
+                             float        *values,
+                             uint64_t     numElements)
+{
+	assert(stai != NULL || numElements == UINT64_C(0));
+	assert(values != NULL || numElements == UINT64_C(0));
+
+	if (numElements == UINT64_C(0))
+		return;
+
+	if (stai->sizeOfElementInBytes == sizeof(float)) {
+		stai_getElementsMulti(stai, pos, values, numElements);
+	} else {
+		const char *src = (char *)(stai->base) + pos * stai->strideInBytes;
+
+		assert(stai->sizeOfElementInBytes == sizeof(double));
+#ifdef WITH_OPENMP
+#  pragma omp parallel for \
+		if (numElements >= LOCAL_MIN_ELEMENTS_FOR_THREADS)
+#endif
+		for (uint64_t i = 0; i < numElements; i++) {
+			double d;
+			memcpy(&d, src + i * stai->strideInBytes, sizeof(double));
+			values[i] = (float)d;
+		}
+	}
 }
 
 extern void
@@ -167,3 +376,106 @@ stai_isLinear(const stai_t stai)
 
 	return stai->sizeOfElementInBytes == stai->strideInBytes ? true : false;
 }
+
+
+/*--- Implementations of local functions --------------------------------*/
+static void
+local_copyStrided(char *restrict       dst,
+                  size_t               strideDst,
+                  const char *restrict src,
+                  size_t               strideSrc,
+                  size_t               sizeOfElement,
+                  uint64_t             numElements)
+{
+	if (sizeOfElement == 4) {
+#ifdef WITH_OPENMP
+#  pragma omp parallel for \
+		if (numElements >= LOCAL_MIN_ELEMENTS_FOR_THREADS)
+#endif
+		for (uint64_t i = 0; i < numElements; i++)
+			memcpy(dst + i * strideDst, src + i * strideSrc, 4);
+	} else if (sizeOfElement == 8) {
+#ifdef WITH_OPENMP
+#  pragma omp parallel for \
+		if (numElements >= LOCAL_MIN_ELEMENTS_FOR_THREADS)
+#endif
+		for (uint64_t i = 0; i < numElements; i++)
+			memcpy(dst + i * strideDst, src + i * strideSrc, 8);
+	} else {
+#ifdef WITH_OPENMP
+#  pragma omp parallel for \
+		if (numElements >= LOCAL_MIN_ELEMENTS_FOR_THREADS)
+#endif
+		for (uint64_t i = 0; i < numElements; i++)
+			memcpy(dst + i * strideDst, src + i * strideSrc, sizeOfElement);
+	}
+}
+
+static void
+local_copyStridedSwapped(char *restrict       dst,
+                         size_t               strideDst,
+                         const char *restrict src,
+                         size_t               strideSrc,
+                         size_t               sizeOfElement,
+                         int                  numComponents,
+                         uint64_t             numElements)
+{
+	size_t sizeOfComponent = sizeOfElement / numComponents;
+
+	if (sizeOfComponent == 4) {
+#ifdef WITH_OPENMP
+#  pragma omp parallel for \
+		if (numElements >= LOCAL_MIN_ELEMENTS_FOR_THREADS)
+#endif
+		for (uint64_t i = 0; i < numElements; i++) {
+			for (int j = 0; j < numComponents; j++)
+				local_swap4(dst + i * strideDst + j * 4,
+				            src + i * strideSrc + j * 4);
+		}
+	} else if (sizeOfComponent == 8) {
+#ifdef WITH_OPENMP
+#  pragma omp parallel for \
+		if (numElements >= LOCAL_MIN_ELEMENTS_FOR_THREADS)
+#endif
+		for (uint64_t i = 0; i < numElements; i++) {
+			for (int j = 0; j < numComponents; j++)
+				local_swap8(dst + i * strideDst + j * 8,
+				            src + i * strideSrc + j * 8);
+		}
+	} else {
+#ifdef WITH_OPENMP
+#  pragma omp parallel for \
+		if (numElements >= LOCAL_MIN_ELEMENTS_FOR_THREADS)
+#endif
+		for (uint64_t i = 0; i < numElements; i++) {
+			memcpy(dst + i * strideDst, src + i * strideSrc, sizeOfElement);
+			byteswapVec(dst + i * strideDst, sizeOfElement, numComponents);
+		}
+	}
+} /* local_copyStridedSwapped */
+
+inline static void
+local_swap4(void *restrict dst, const void *restrict src)
+{
+	uint32_t v;
+
+	memcpy(&v, src, 4);
+	v = (v >> 24) | ((v >> 8) & UINT32_C(0x0000ff00))
+	    | ((v << 8) & UINT32_C(0x00ff0000)) | (v << 24);
+	memcpy(dst, &v, 4);
+}
+
+inline static void
+local_swap8(void *restrict dst, const void *restrict src)
+{
+	uint64_t v;
+
+	memcpy(&v, src, 8);
+	v = ((v & UINT64_C(0x00000000ffffffff)) << 32)
+	    | ((v & UINT64_C(0xffffffff00000000)) >> 32);
+	v = ((v & UINT64_C(0x0000ffff0000ffff)) << 16)
+	    | ((v & UINT64_C(0xffff0000ffff0000)) >> 16);
+	v = ((v & UINT64_C(0x00ff00ff00ff00ff)) << 8)
+	    | ((v & UINT64_C(0xff00ff00ff00ff00)) >> 8);
+	memcpy(dst, &v, 8);
+}
@@ -183,7 +183,8 @@ stai_setElement(const stai_t stai, uint64_t pos, const void *element);
  * @brief  Sets multiple consecutive elements of an stai.
  *
  * This can be used to explode the values of a proper linear array into
- * a stridden version of the array (it will unpack an array).
+ * a stridden version of the array (it will unpack an array).  A linear
+ * stai is filled with a single copy.
  *
  * @param[in]  stai
  *                The stai object to use.  Passing @c NULL is valid iff
@@ -213,6 +214,66 @@ stai_setElementsMulti(const stai_t stai,
                       const void   *elements,
                       uint64_t     numElements);
 
+/**
+ * @brief  Sets multiple consecutive elements of an stai, reversing the
+ *         byte order of their components.
+ *
+ * This works like stai_setElementsMulti() but byteswaps on the fly, the
+ * input array is left untouched.
+ *
+ * @param[in]  stai
+ *                The stai object to use.  Passing @c NULL is valid iff
+ *                @c numElements is @c 0.
+ * @param[in]  pos
+ *                The position in the stai from which to start setting
+ *                the elements.
+ * @param[in]  *elements
+ *                Pointer to the first element of a linear array of at
+ *                least @c numElements elements.  Passing @c NULL is
+ *                valid iff @c numElements is @c 0.
+ * @param[in]  numElements
+ *                The number of elements to set.
+ * @param[in]  numComponents
+ *                The number of components of one element, e.g. 3 for a
+ *                position vector.  The byte order of each component is
+ *                reversed separately, the size of an element must be a
+ *                multiple of this.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+stai_setElementsMultiSwapped(const stai_t stai,
+                             uint64_t     pos,
+                             const void   *elements,
+                             uint64_t     numElements,
+                             int          numComponents);
+
+/**
+ * @brief  Sets multiple consecutive elements of an stai from single
+ *         precision values.
+ *
+ * @param[in]  stai
+ *                The stai object to use.  Its elements must be either
+ *                @c float or @c double, in the latter case the values
+ *                are converted.  Passing @c NULL is valid iff
+ *                @c numElements is @c 0.
+ * @param[in]  pos
+ *                The position in the stai from which to start setting
+ *                the elements.
+ * @param[in]  *values
+ *                The values to set.  Passing @c NULL is valid iff
+ *                @c numElements is @c 0.
+ * @param[in]  numElements
+ *                The number of values to set.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+stai_setElementsMultiFromFloat(const stai_t stai,
+                               uint64_t     pos,
+                               const float  *values,
+                               uint64_t     numElements);
+
 /**
  * @brief  Gets an element form the stai.
  *
@@ -242,7 +303,7 @@ stai_getElement(const stai_t stai, uint64_t pos, void *element);
  *
  * This is the exact inverse of stai_setElementsMulti(), it implodes
  * the stai array into a linear array for a given amount of elements
- * (it will pack).
+ * (it will pack).  A linear stai is read with a single copy.
  *
  * @param[in]   stai
  *                 The stai to use.  Passing @c NULL is allowed iff
@@ -269,6 +330,65 @@ stai_getElementsMulti(const stai_t stai,
                       void         *elements,
                       uint64_t     numElements);
 
+/**
+ * @brief  Gets multiple consecutive elements from a stai, reversing the
+ *         byte order of their components.
+ *
+ * This is the inverse of stai_setElementsMultiSwapped(), the stai itself
+ * is left untouched.
+ *
+ * @param[in]   stai
+ *                 The stai to use.  Passing @c NULL is allowed iff
+ *                 @c numElements is @c 0.
+ * @param[in]   pos
+ *                 The position in the stai array from which to start
+ *                 copying out.
+ * @param[out]  *elements
+ *                 The linear array receiving the swapped elements.  It
+ *                 may be @c NULL iff @c numElements is @c 0.
+ * @param[in]   numElements
+ *                 The number of elements to copy out.
+ * @param[in]   numComponents
+ *                 The number of components of one element, see
+ *                 stai_setElementsMultiSwapped().
+ *
+ * @return  Returns nothing.
+ */
+extern void
+stai_getElementsMultiSwapped(const stai_t stai,
+                             uint64_t     pos,
+                             void         *elements,
+                             uint64_t     numElements,
+                             int          numComponents);
+
+/**
+ * @brief  Gets multiple consecutive elements from a stai as single
+ *         precision values.
+ *
+ * This is the inverse of stai_setElementsMultiFromFloat().
+ *
+ * @param[in]   stai
+ *                 The stai to use.  Its elements must be either @c float
+ *                 or @c double, in the latter case the values are
+ *                 converted.  Passing @c NULL is allowed iff
+ *                 @c numElements is @c 0.
+ * @param[in]   pos
+ *                 The position in the stai array from which to start
+ *                 copying out.
+ * @param[out]  *values
+ *                 The array receiving the values.  It may be @c NULL iff
+ *                 @c numElements is @c 0.
+ * @param[in]   numElements
+ *                 The number of values to copy out.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+stai_getElementsMultiAsFloat(const stai_t stai,
+                             uint64_t     pos,
+                             float        *values,
+                             uint64_t     numElements);
+
 /**
  * @brief  This allows to move the base of the stai.
  *
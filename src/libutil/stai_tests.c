@@ -23,6 +23,7 @@
 #  include <mpi.h>
 #endif
 #include "../libutil/xmem.h"
+#include "../libutil/byteswap.h"
 
 
 /*--- Implementation of main structure ----------------------------------*/
@@ -302,6 +303,15 @@ stai_setElementsMulti_test(void)
 		hasPassed = false;
 	stai_del(&stai);
 
+	double linear[6] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+	stai = stai_new(linear, sizeof(double), sizeof(double));
+	stai_setElementsMulti(stai, 1, newData, 4);
+	if (islessgreater(linear[0], 0.0) || islessgreater(linear[1], newData[0])
+	    || islessgreater(linear[4], newData[3])
+	    || islessgreater(linear[5], 0.0))
+		hasPassed = false;
+	stai_del(&stai);
+
 	xfree(testData);
 #ifdef ENABLE_XMEM_TRACK_MEM
 	if (allocatedBytes != global_allocated_bytes)
@@ -311,6 +321,114 @@ stai_setElementsMulti_test(void)
 	return hasPassed ? true : false;
 } /* stai_setElementsMulti_test */
 
+extern bool
+stai_setElementsMultiSwapped_test(void)
+{
+	bool        hasPassed = true;
+	int         rank      = 0;
+	stai_test_t testData;
+	stai_t      stai;
+	double      newData[] = {100.0, 101.0, 102.0};
+	double      swapped[3];
+#ifdef ENABLE_XMEM_TRACK_MEM
+	size_t      allocatedBytes = global_allocated_bytes;
+#endif
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	testData = local_getTestData();
+
+	for (int i = 0; i < 3; i++) {
+		swapped[i] = newData[i];
+		byteswap(swapped + i, sizeof(double));
+	}
+	stai = stai_new(&(testData->value), sizeof(double),
+	                sizeof(struct stai_test_struct));
+	stai_setElementsMultiSwapped(stai, 10, swapped, 3, 1);
+	for (int i = 0; i < 3; i++) {
+		if (islessgreater(testData[10 + i].value, newData[i]))
+			hasPassed = false;
+	}
+	if (islessgreater(testData[13].value, 13.0))
+		hasPassed = false;
+	stai_del(&stai);
+
+	// Two 4 byte components per element.
+	int32_t vec[4] = {1, 2, 3, 4};
+	int32_t vecSwapped[4];
+	for (int i = 0; i < 4; i++) {
+		vecSwapped[i] = vec[i];
+		byteswap(vecSwapped + i, sizeof(int32_t));
+	}
+	int32_t target[6] = {0, 0, 0, 0, 0, 0};
+	stai = stai_new(target, 2 * sizeof(int32_t), 3 * sizeof(int32_t));
+	stai_setElementsMultiSwapped(stai, 0, vecSwapped, 2, 2);
+	if ((target[0] != 1) || (target[1] != 2) || (target[2] != 0)
+	    || (target[3] != 3) || (target[4] != 4) || (target[5] != 0))
+		hasPassed = false;
+	stai_del(&stai);
+
+	xfree(testData);
+#ifdef ENABLE_XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+} /* stai_setElementsMultiSwapped_test */
+
+extern bool
+stai_setElementsMultiFromFloat_test(void)
+{
+	bool        hasPassed = true;
+	int         rank      = 0;
+	stai_test_t testData;
+	stai_t      stai;
+	float       newData[] = {100.f, 101.f, 102.f, 103.f};
+	float       linear[6] = {0.f, 0.f, 0.f, 0.f, 0.f, 0.f};
+#ifdef ENABLE_XMEM_TRACK_MEM
+	size_t      allocatedBytes = global_allocated_bytes;
+#endif
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	testData = local_getTestData();
+
+	stai = stai_new(&(testData->value), sizeof(double),
+	                sizeof(struct stai_test_struct));
+	stai_setElementsMultiFromFloat(stai, 20, newData, 4);
+	for (int i = 0; i < 4; i++) {
+		if (islessgreater(testData[20 + i].value, (double)newData[i]))
+			hasPassed = false;
+	}
+	if (islessgreater(testData[24].value, 24.0))
+		hasPassed = false;
+	stai_del(&stai);
+
+	stai = stai_new(linear, sizeof(float), sizeof(float));
+	stai_setElementsMultiFromFloat(stai, 2, newData, 4);
+	if (islessgreater(linear[1], 0.f) || islessgreater(linear[2], newData[0])
+	    || islessgreater(linear[5], newData[3]))
+		hasPassed = false;
+	stai_del(&stai);
+
+	xfree(testData);
+#ifdef ENABLE_XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+} /* stai_setElementsMultiFromFloat_test */
+
 extern bool
 stai_getElement_test(void)
 {
@@ -389,6 +507,101 @@ stai_getElementsMulti_test(void)
 	return hasPassed ? true : false;
 } /* stai_getElementsMulti_test */
 
+extern bool
+stai_getElementsMultiSwapped_test(void)
+{
+	bool        hasPassed = true;
+	int         rank      = 0;
+	stai_test_t testData;
+	stai_t      stai;
+	double      newData[3];
+#ifdef ENABLE_XMEM_TRACK_MEM
+	size_t      allocatedBytes = global_allocated_bytes;
+#endif
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	testData = local_getTestData();
+
+	stai = stai_new(&(testData->value), sizeof(double),
+	                sizeof(struct stai_test_struct));
+	stai_getElementsMultiSwapped(stai, 40, newData, 3, 1);
+	for (int i = 0; i < 3; i++) {
+		byteswap(newData + i, sizeof(double));
+		if (islessgreater(newData[i], 40.0 + i))
+			hasPassed = false;
+		if (islessgreater(testData[40 + i].value, 40.0 + i))
+			hasPassed = false;
+	}
+	stai_del(&stai);
+
+	// Elements of 7 bytes have no specialised copy.
+	char name[14];
+	stai = stai_new(testData->name, 7, sizeof(struct stai_test_struct));
+	stai_getElementsMultiSwapped(stai, 12, name, 2, 1);
+	if ((memcmp(name, "\0" "21tset", 7) != 0)
+	    || (memcmp(name + 7, "\0" "31tset", 7) != 0))
+		hasPassed = false;
+	stai_del(&stai);
+
+	xfree(testData);
+#ifdef ENABLE_XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+} /* stai_getElementsMultiSwapped_test */
+
+extern bool
+stai_getElementsMultiAsFloat_test(void)
+{
+	bool        hasPassed = true;
+	int         rank      = 0;
+	stai_test_t testData;
+	stai_t      stai;
+	float       newData[4];
+	float       linear[4] = {1.f, 2.f, 3.f, 4.f};
+#ifdef ENABLE_XMEM_TRACK_MEM
+	size_t      allocatedBytes = global_allocated_bytes;
+#endif
+#ifdef WITH_MPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+	if (rank == 0)
+		printf("Testing %s... ", __func__);
+
+	testData = local_getTestData();
+
+	stai = stai_new(&(testData->value), sizeof(double),
+	                sizeof(struct stai_test_struct));
+	stai_getElementsMultiAsFloat(stai, 3, newData, 4);
+	for (int i = 0; i < 4; i++) {
+		if (islessgreater(newData[i], (float)(3 + i)))
+			hasPassed = false;
+	}
+	stai_del(&stai);
+
+	stai = stai_new(linear, sizeof(float), sizeof(float));
+	stai_getElementsMultiAsFloat(stai, 1, newData, 3);
+	if (islessgreater(newData[0], 2.f) || islessgreater(newData[2], 4.f))
+		hasPassed = false;
+	stai_del(&stai);
+
+	xfree(testData);
+#ifdef ENABLE_XMEM_TRACK_MEM
+	if (allocatedBytes != global_allocated_bytes)
+		hasPassed = false;
+#endif
+
+	return hasPassed ? true : false;
+} /* stai_getElementsMultiAsFloat_test */
+
 extern bool
 stai_isLinear_test(void)
 {
@@ -76,6 +76,24 @@ extern bool
 stai_setElementsMulti_test(void);
 
 
+/**
+ * @brief  This will test stai_setElementsMultiSwapped().
+ *
+ * @return  Returns true if the test succeeds, false otherwise.
+ */
+extern bool
+stai_setElementsMultiSwapped_test(void);
+
+
+/**
+ * @brief  This will test stai_setElementsMultiFromFloat().
+ *
+ * @return  Returns true if the test succeeds, false otherwise.
+ */
+extern bool
+stai_setElementsMultiFromFloat_test(void);
+
+
 /**
  * @brief  This will test stai_getElement().
  *
@@ -93,6 +111,24 @@ stai_getElement_test(void);
 extern bool
 stai_getElementsMulti_test(void);
 
+
+/**
+ * @brief  This will test stai_getElementsMultiSwapped().
+ *
+ * @return  Returns true if the test succeeds, false otherwise.
+ */
+extern bool
+stai_getElementsMultiSwapped_test(void);
+
+
+/**
+ * @brief  This will test stai_getElementsMultiAsFloat().
+ *
+ * @return  Returns true if the test succeeds, false otherwise.
+ */
+extern bool
+stai_getElementsMultiAsFloat_test(void);
+
 /**
  * @brief  This will test stai_isLinear().
  *
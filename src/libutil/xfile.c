@@ -13,6 +13,8 @@
 
 
 /*--- Includes ----------------------------------------------------------*/
+// pread() and pwrite() are not C99.
+#define _POSIX_C_SOURCE 200809L
 #include "util_config.h"
 #include "xfile.h"
 #include <stdlib.h>
@@ -20,12 +22,10 @@
 #include <errno.h>
 #include <string.h>
 #include <assert.h>
-#if (defined _XOPEN_SOURCE && _XOPEN_SOURCE >= 600)
-#  include <unistd.h>
-#  include <sys/types.h>
-#  include <sys/stat.h>
-#  include <fcntl.h>
-#endif
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
 
 
 /*--- Implementations of exported functios ------------------------------*/
@@ -110,6 +110,84 @@ xftell(FILE *stream)
 	return pos;
 }
 
+extern int
+xopen(const char *path, int flags, mode_t mode)
+{
+	int fd = open(path, flags, mode);
+
+	if (fd == -1) {
+		fprintf(stderr, "Could not open %s: %s\n", path, strerror(errno));
+		fprintf(stderr, "Exiting... :-(\n");
+		exit(EXIT_FAILURE);
+	}
+
+	return fd;
+}
+
+extern size_t
+xpread(int fd, void *buf, size_t numBytes, off_t offset)
+{
+	if (xfile_preadUpTo(fd, buf, numBytes, offset) != numBytes) {
+		fprintf(stderr, "Could not read from file: unexpected end of file\n");
+		fprintf(stderr, "Exiting... :-(\n");
+		exit(EXIT_FAILURE);
+	}
+
+	return numBytes;
+}
+
+extern size_t
+xpwrite(int fd, const void *buf, size_t numBytes, off_t offset)
+{
+	size_t numLeft = numBytes;
+
+	while (numLeft > 0) {
+		ssize_t numWritten = pwrite(fd, buf, numLeft, offset);
+
+		if (numWritten <= 0) {
+			int errnum = errno;
+			if ((numWritten == -1) && (errnum == EINTR))
+				continue;
+			fprintf(stderr, "Could not write to file: %s\n",
+			        strerror(errnum));
+			fprintf(stderr, "Exiting... :-(\n");
+			exit(EXIT_FAILURE);
+		}
+		buf      = (const char *)buf + numWritten;
+		numLeft -= (size_t)numWritten;
+		offset  += numWritten;
+	}
+
+	return numBytes;
+}
+
+extern size_t
+xfile_preadUpTo(int fd, void *buf, size_t numBytes, off_t offset)
+{
+	size_t numTotal = 0;
+
+	while (numTotal < numBytes) {
+		ssize_t numRead = pread(fd, (char *)buf + numTotal,
+		                        numBytes - numTotal, offset);
+
+		if (numRead == 0)
+			break;
+		if (numRead == -1) {
+			int errnum = errno;
+			if (errnum == EINTR)
+				continue;
+			fprintf(stderr, "Could not read from file: %s\n",
+			        strerror(errnum));
+			fprintf(stderr, "Exiting... :-(\n");
+			exit(EXIT_FAILURE);
+		}
+		numTotal += (size_t)numRead;
+		offset   += numRead;
+	}
+
+	return numTotal;
+}
+
 extern int
 xfile_createFileWithSize(const char *fname, size_t bytes)
 {
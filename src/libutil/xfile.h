@@ -21,6 +21,7 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <stdbool.h>
+#include <sys/types.h>
 
 
 /*--- Prototypes of exported functions ----------------------------------*/
@@ -109,6 +110,68 @@ xfseek(FILE *stream, long offset, int whence);
 extern long
 xftell(FILE *stream);
 
+/**
+ * \brief  A wrapper function for open that will abort the program, if
+ *         the file could not be opened.
+ *
+ * \param  *path  The name of the file to open.
+ * \param  flags  The flags with which to open, see open(2).
+ * \param  mode   The permissions of a newly created file, only used if
+ *                the flags contain O_CREAT.
+ *
+ * \return  Returns the file descriptor of the opened file.
+ */
+extern int
+xopen(const char *path, int flags, mode_t mode);
+
+/**
+ * \brief  A wrapper function for pread that reads until all bytes are
+ *         read and will abort the program otherwise.
+ *
+ * Interrupted and short reads are continued, reaching the end of the file
+ * before all bytes have been read is an error.
+ *
+ * \param  fd        The file to read from.
+ * \param  *buf      The buffer receiving the bytes.  This needs to be
+ *                   large enough.
+ * \param  numBytes  The number of bytes to read.
+ * \param  offset    The position in the file.
+ *
+ * \return  This function always returns numBytes.
+ */
+extern size_t
+xpread(int fd, void *buf, size_t numBytes, off_t offset);
+
+/**
+ * \brief  A wrapper function for pwrite that writes until all bytes are
+ *         written and will abort the program otherwise.
+ *
+ * \param  fd        The file to write to.
+ * \param  *buf      The bytes to write.
+ * \param  numBytes  The number of bytes to write.
+ * \param  offset    The position in the file.
+ *
+ * \return  This function always returns numBytes.
+ */
+extern size_t
+xpwrite(int fd, const void *buf, size_t numBytes, off_t offset);
+
+/**
+ * \brief  Reads like xpread(), but stops without error at the end of the
+ *         file.
+ *
+ * \param  fd        The file to read from.
+ * \param  *buf      The buffer receiving the bytes.  This needs to be
+ *                   large enough.
+ * \param  numBytes  The maximal number of bytes to read.
+ * \param  offset    The position in the file.
+ *
+ * \return  Returns the number of bytes read, this is less than numBytes
+ *          only if the end of the file was reached.
+ */
+extern size_t
+xfile_preadUpTo(int fd, void *buf, size_t numBytes, off_t offset);
+
 /**
  * \brief  Creates a new file and ensures that it contains bytes number
  *         of bytes.
@@ -17,8 +17,58 @@
 #include "xmem.h"
 #include <stdlib.h>
 #include <stdio.h>
+#include <stdbool.h>
 #include <string.h>
 #include <inttypes.h>
+#if (defined XMEM_TRACK_MEM && defined WITH_MPI)
+#  include <mpi.h>
+#endif
+
+
+/*--- Local defines -----------------------------------------------------*/
+#ifdef XMEM_TRACK_MEM
+// The functions are implemented here, not the site-recording macros.
+#  undef xmalloc
+#  undef xrealloc
+
+/** @brief  The number of allocation sites that can be told apart. */
+#  define LOCAL_NUM_SITES 1024
+
+/** @brief  The number of sites listed by xmem_info(). */
+#  define LOCAL_NUM_SITES_INFO 10
+
+/** @brief  Identifies memory obtained via xmem_mallocExternal(). */
+#  define LOCAL_MAGIC_EXTERNAL UINT32_C(0x78657874)
+#endif
+
+
+/*--- Local structures and typedefs -------------------------------------*/
+#ifdef XMEM_TRACK_MEM
+
+/** @brief  The header preceding every tracked allocation. */
+struct local_header_struct {
+	/** @brief  The size of the allocation. */
+	uint64_t size;
+	/** @brief  The allocation site. */
+	uint32_t idxSite;
+	/** @brief  Only used for external allocations. */
+	uint32_t magic;
+};
+
+/** @brief  Describes one allocation site. */
+struct local_site_struct {
+	/** @brief  The file name, @c NULL for unused entries. */
+	const char *file;
+	/** @brief  The line number. */
+	int        line;
+	/** @brief  The number of allocations done at this site. */
+	uint64_t   numAllocs;
+	/** @brief  The bytes currently held by allocations from this site. */
+	size_t     bytes;
+	/** @brief  The largest value of @c bytes. */
+	size_t     peak;
+};
+#endif
 
 
 /*--- Implementation of exported variables ------------------------------*/
@@ -33,63 +83,138 @@ size_t  global_max_allocated_bytes = 0;
 int64_t global_malloc_vs_free      = 0;
 
 
+/*--- Local variables ---------------------------------------------------*/
+#ifdef XMEM_TRACK_MEM
+
+/** @brief  The peak of the current window, see xmem_pushPeak(). */
+static size_t local_windowPeak = 0;
+
+/**
+ * @brief  The table of allocation sites, the first one collects all
+ *         allocations of unknown origin.
+ */
+static struct local_site_struct local_sites[LOCAL_NUM_SITES]
+    = { { "unknown", 0, 0, 0, 0 } };
+
+#  ifdef XMEM_TRACK_HISTOGRAM
+
+/** @brief  The number of allocations per power of two of the size. */
+static uint64_t local_histogram[64];
+#  endif
+#endif
+
+
+/*--- Prototypes of local functions -------------------------------------*/
+
+/**
+ * @brief  Prints a number of bytes in a human readable unit.
+ *
+ * @param[in,out]  *f
+ *                    The stream to write to.
+ * @param[in]      numBytes
+ *                    The number of bytes.
+ *
+ * @return  Returns nothing.
+ */
+static void
+local_printBytes(FILE *f, size_t numBytes);
+
+
+/**
+ * @brief  Reports a failed allocation and aborts the program.
+ *
+ * @param[in]  *what
+ *                The action that failed.
+ * @param[in]  size
+ *                The requested size.
+ *
+ * @return  Does not return.
+ */
+static void
+local_die(const char *what, size_t size);
+
+#ifdef XMEM_TRACK_MEM
+
+/**
+ * @brief  Finds the entry of an allocation site, creating it if needed.
+ *
+ * Must be called from within the critical section.
+ *
+ * @param[in]  *file
+ *                The file name.
+ * @param[in]  line
+ *                The line.
+ *
+ * @return  Returns the index of the site, 0 if the table is full.
+ */
+static uint32_t
+local_getSite(const char *file, int line);
+
+
+/**
+ * @brief  Accounts an allocation.
+ *
+ * @param[in,out]  *header
+ *                    The header of the allocation, its site is set.
+ * @param[in]      size
+ *                    The size of the allocation.
+ * @param[in]      *file
+ *                    The file of the call.
+ * @param[in]      line
+ *                    The line of the call.
+ *
+ * @return  Returns nothing.
+ */
+static void
+local_addAlloc(struct local_header_struct *header,
+               size_t                     size,
+               const char                 *file,
+               int                        line);
+
+
+/**
+ * @brief  Accounts a release.
+ *
+ * @param[in]  *header
+ *                The header of the allocation.
+ *
+ * @return  Returns nothing.
+ */
+static void
+local_removeAlloc(const struct local_header_struct *header);
+
+#endif
+
+
 /*--- Implementation of exported functions ------------------------------*/
 extern void *
 xmalloc(size_t size)
 {
-	void *dummy;
-
 #ifdef XMEM_TRACK_MEM
-	dummy = malloc(size + 8);
+	return xmem_mallocAt(size, NULL, 0);
 #else
-	dummy = malloc(size);
-#endif
-	if (dummy == NULL) {
-		fprintf(stderr, "Could not allocate ");
-		if (size < 1024) {
-			fprintf(stderr, "%i b\n", (int)size);
-		} else if (size < 1048576) {
-			fprintf(stderr, "%.2f Kib\n", size / 1024.);
-		} else if (size < 1073741824) {
-			fprintf(stderr, "%.2f Mib\n", size / 1048576.);
-		} else {
-			fprintf(stderr, "%.2f Gib\n", size / 1073741824.);
-		}
-#ifdef XMEM_TRACK_MEM
-		xmem_info(stderr);
-#endif
-		fprintf(stderr, "Aborting... :-(\n");
-		abort();
-	}
+	void *dummy;
 
-#ifdef XMEM_TRACK_MEM
-	global_allocated_bytes += size;
-	global_malloc_vs_free++;
-	if (global_allocated_bytes > global_max_allocated_bytes) {
-		global_max_allocated_bytes = global_allocated_bytes;
-	}
-	*((uint64_t *)dummy) = (uint64_t)size;
-	dummy                = (void *)(((uint64_t *)dummy) + 1);
-#endif
+	dummy = malloc(size);
+	if (dummy == NULL)
+		local_die("allocate", size);
 
 	return dummy;
-} /* xmalloc */
+#endif
+}
 
 extern void
 xfree(void *ptr)
 {
 #ifdef XMEM_TRACK_MEM
+	struct local_header_struct *header;
+
 	if (ptr == NULL)
 		return;
 
-	if (global_malloc_vs_free <= 0) {
-		fprintf(stderr, "Calling free too often.\n");
-		xmem_info(stderr);
-		abort();
-	}
-	global_allocated_bytes -= *(((uint64_t *)ptr) - 1);
-	global_malloc_vs_free--;
-	free(((uint64_t *)ptr) - 1);
+	header = ((struct local_header_struct *)ptr) - 1;
+	local_removeAlloc(header);
+	free(header);
 #else
 	free(ptr);
 #endif
@@ -100,87 +225,374 @@ xfree(void *ptr)
 extern void *
 xrealloc(void *ptr, size_t size)
 {
-	void     *dummy;
 #ifdef XMEM_TRACK_MEM
-	uint64_t old_size;
-#endif
+	return xmem_reallocAt(ptr, size, NULL, 0);
+#else
+	void *dummy;
 
-	if (ptr == NULL) {
-		dummy = xmalloc(size);
-		return dummy;
-	}
+	if (ptr == NULL)
+		return xmalloc(size);
 	if (size == 0) {
 		xfree(ptr);
 		return NULL;
 	}
 
-#ifdef XMEM_TRACK_MEM
-	dummy = realloc(((uint64_t *)ptr) - 1, size + 8);
-#else
 	dummy = realloc(ptr, size);
+	if (dummy == NULL)
+		local_die("re-allocate", size);
+
+	return dummy;
 #endif
-	if (dummy == NULL) {
-		fprintf(stderr, "Could not re-allocate ");
-		if (size < 1024) {
-			fprintf(stderr, "%i b\n", (int)size);
-		} else if (size < 1048576) {
-			fprintf(stderr, "%f Kib\n", size / 1024.);
-		} else if (size < 1073741824) {
-			fprintf(stderr, "%f Mib\n", size / 1048576.);
-		} else {
-			fprintf(stderr, "%.2f Gib\n", size / 1073741824.);
-		}
+}
+
 #ifdef XMEM_TRACK_MEM
-		xmem_info(stderr);
-#endif
-		fprintf(stderr, "Aborting... :-(\n");
+extern void *
+xmem_mallocAt(size_t size, const char *file, int line)
+{
+	struct local_header_struct *header;
+
+	header = malloc(size + sizeof(struct local_header_struct));
+	if (header == NULL)
+		local_die("allocate", size);
+
+	header->magic = 0;
+	local_addAlloc(header, size, file, line);
+
+	return header + 1;
+}
+
+extern void *
+xmem_reallocAt(void *ptr, size_t size, const char *file, int line)
+{
+	struct local_header_struct *header;
+
+	if (ptr == NULL)
+		return xmem_mallocAt(size, file, line);
+	if (size == 0) {
+		xfree(ptr);
+		return NULL;
+	}
+
+	// Account the release first, the header is gone after realloc().
+	header = ((struct local_header_struct *)ptr) - 1;
+	local_removeAlloc(header);
+	header = realloc(header, size + sizeof(struct local_header_struct));
+	if (header == NULL)
+		local_die("re-allocate", size);
+	local_addAlloc(header, size, file, line);
+
+	return header + 1;
+}
+
+extern void *
+xmem_mallocExternal(void *(*mallocFunc)(size_t size), size_t size)
+{
+	char                       *mem;
+	struct local_header_struct *header;
+
+	mem = mallocFunc(size + XMEM_EXTERNAL_OFFSET);
+	if (mem == NULL)
+		local_die("allocate", size);
+
+	header        = (struct local_header_struct *)mem;
+	header->magic = LOCAL_MAGIC_EXTERNAL;
+	local_addAlloc(header, size, "external", 0);
+
+	return mem + XMEM_EXTERNAL_OFFSET;
+}
+
+extern void
+xmem_freeExternal(void (*freeFunc)(void *ptr), void *ptr)
+{
+	char                       *mem = ((char *)ptr) - XMEM_EXTERNAL_OFFSET;
+	struct local_header_struct *header;
+
+	header = (struct local_header_struct *)mem;
+	if (header->magic != LOCAL_MAGIC_EXTERNAL) {
+		fprintf(stderr, "Freeing memory that was not allocated with "
+		        "xmem_mallocExternal().\n");
 		abort();
 	}
+	local_removeAlloc(header);
+	freeFunc(mem);
+}
 
-#ifdef XMEM_TRACK_MEM
-	old_size                = *((uint64_t *)dummy);
-	global_allocated_bytes -= old_size;
-	global_allocated_bytes += size;
-	if (global_allocated_bytes > global_max_allocated_bytes) {
-		global_max_allocated_bytes = global_allocated_bytes;
-	}
-	*((uint64_t *)dummy) = (uint64_t)size;
-	dummy                = (void *)(((uint64_t *)dummy) + 1);
-#endif
+extern size_t
+xmem_pushPeak(void)
+{
+	size_t outerPeak;
 
-	return dummy;
-} /* xrealloc */
+#  ifdef WITH_OPENMP
+#    pragma omp critical (xmem)
+#  endif
+	{
+		outerPeak        = local_windowPeak;
+		local_windowPeak = global_allocated_bytes;
+	}
+
+	return outerPeak;
+}
+
+extern size_t
+xmem_popPeak(size_t outerPeak)
+{
+	size_t peak;
+
+#  ifdef WITH_OPENMP
+#    pragma omp critical (xmem)
+#  endif
+	{
+		peak = local_windowPeak;
+		if (outerPeak > local_windowPeak)
+			local_windowPeak = outerPeak;
+	}
+
+	return peak;
+}
 
-#ifdef XMEM_TRACK_MEM
 void
 xmem_info(FILE *f)
 {
+	int idxSites[LOCAL_NUM_SITES_INFO];
+	int numSites = 0;
+
 	fprintf(f, "Currently holding: ");
-	if (global_allocated_bytes < 1024) {
-		fprintf(f, "%i B\n", (int)global_allocated_bytes);
-	} else if (global_allocated_bytes < 1048576) {
-		fprintf(f, "%.2f KiB\n", global_allocated_bytes / 1024.);
-	} else if (global_allocated_bytes < 1073741824) {
-		fprintf(f, "%.2f MiB\n", global_allocated_bytes / 1048576.);
-	} else {
-		fprintf(stderr, "%.2f GiB\n",
-		        global_allocated_bytes / 1073741824.);
-	}
+	local_printBytes(f, global_allocated_bytes);
 	fprintf(f, "Peak usage: ");
-	if (global_max_allocated_bytes < 1024) {
-		fprintf(f, "%i B\n", (int)global_max_allocated_bytes);
-	} else if (global_max_allocated_bytes < 1048576) {
-		fprintf(f, "%.2f kiB\n", global_max_allocated_bytes / 1024.);
-	} else if (global_max_allocated_bytes < 1073741824) {
-		fprintf(f, "%.2f MiB\n", global_max_allocated_bytes / 1048576.);
-	} else {
-		fprintf(stderr, "%.2f GiB\n",
-		        global_max_allocated_bytes / 1073741824.);
-	}
+	local_printBytes(f, global_max_allocated_bytes);
 	fprintf(f, "Malloc vs. free balance: %" PRIi64 "\n",
 	        global_malloc_vs_free);
 
+	// Selection of the sites with the largest peaks, there are few.
+	while (numSites < LOCAL_NUM_SITES_INFO) {
+		int idxMax = -1;
+		for (int i = 0; i < LOCAL_NUM_SITES; i++) {
+			bool isListed = false;
+			if (local_sites[i].file == NULL || local_sites[i].peak == 0)
+				continue;
+			for (int j = 0; j < numSites; j++)
+				isListed = isListed || (idxSites[j] == i);
+			if (!isListed && ((idxMax == -1)
+			                  || (local_sites[i].peak
+			                      > local_sites[idxMax].peak)))
+				idxMax = i;
+		}
+		if (idxMax == -1)
+			break;
+		idxSites[numSites++] = idxMax;
+	}
+	if (numSites > 0)
+		fprintf(f, "Largest peaks by allocation site:\n");
+	for (int i = 0; i < numSites; i++) {
+		const struct local_site_struct *site = local_sites + idxSites[i];
+		fprintf(f, "  %s:%i (%" PRIu64 " allocations): ",
+		        site->file, site->line, site->numAllocs);
+		local_printBytes(f, site->peak);
+	}
+
+#  ifdef XMEM_TRACK_HISTOGRAM
+	fprintf(f, "Allocation sizes:\n");
+	for (int i = 0; i < 64; i++) {
+		if (local_histogram[i] > 0)
+			fprintf(f, "  [2^%i, 2^%i[ B: %" PRIu64 "\n",
+			        i, i + 1, local_histogram[i]);
+	}
+#  endif
+
 	return;
+} /* xmem_info */
+
+extern void
+xmem_infoGlobal(FILE *f)
+{
+	int    rank      = 0;
+	int    size      = 1;
+	double peakLocal = (double)global_max_allocated_bytes;
+	double peakMin, peakMax, peakSum, peakNode;
+	int    numNodes  = 1;
+#  ifdef WITH_MPI
+	char   name[MPI_MAX_PROCESSOR_NAME];
+	char   *names    = NULL;
+	double *peaks    = NULL;
+	int    lenName;
+
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+	MPI_Comm_size(MPI_COMM_WORLD, &size);
+	memset(name, '\0', MPI_MAX_PROCESSOR_NAME);
+	MPI_Get_processor_name(name, &lenName);
+	if (rank == 0) {
+		names = xmalloc(sizeof(char) * MPI_MAX_PROCESSOR_NAME * size);
+		peaks = xmalloc(sizeof(double) * size);
+	}
+	MPI_Gather(name, MPI_MAX_PROCESSOR_NAME, MPI_CHAR,
+	           names, MPI_MAX_PROCESSOR_NAME, MPI_CHAR, 0, MPI_COMM_WORLD);
+	MPI_Gather(&peakLocal, 1, MPI_DOUBLE, peaks, 1, MPI_DOUBLE, 0,
+	           MPI_COMM_WORLD);
+	if (rank == 0) {
+		peakMin  = peakMax = peakSum = peaks[0];
+		peakNode = 0.0;
+		numNodes = 0;
+		for (int i = 1; i < size; i++) {
+			peakMin  = peaks[i] < peakMin ? peaks[i] : peakMin;
+			peakMax  = peaks[i] > peakMax ? peaks[i] : peakMax;
+			peakSum += peaks[i];
+		}
+		for (int i = 0; i < size; i++) {
+			const char *nameI = names + i * MPI_MAX_PROCESSOR_NAME;
+			double     sum    = 0.0;
+			int        j      = 0;
+
+			// Only the first rank of a node does the summing.
+			while (strcmp(names + j * MPI_MAX_PROCESSOR_NAME, nameI) != 0)
+				j++;
+			if (j < i)
+				continue;
+			for (j = i; j < size; j++) {
+				if (strcmp(names + j * MPI_MAX_PROCESSOR_NAME, nameI) == 0)
+					sum += peaks[j];
+			}
+			peakNode = sum > peakNode ? sum : peakNode;
+			numNodes++;
+		}
+		xfree(peaks);
+		xfree(names);
+	}
+#  else
+	peakMin = peakMax = peakSum = peakNode = peakLocal;
+#  endif
+
+	if (rank == 0) {
+		fprintf(f, "Peak usage per rank, minimum over %i ranks: ", size);
+		local_printBytes(f, (size_t)peakMin);
+		fprintf(f, "Peak usage per rank, mean: ");
+		local_printBytes(f, (size_t)(peakSum / size));
+		fprintf(f, "Peak usage per rank, maximum: ");
+		local_printBytes(f, (size_t)peakMax);
+		fprintf(f, "Peak usage per node, maximum over %i nodes: ",
+		        numNodes);
+		local_printBytes(f, (size_t)peakNode);
+	}
+} /* xmem_infoGlobal */
+
+#endif
+
+
+/*--- Implementations of local functions --------------------------------*/
+static void
+local_printBytes(FILE *f, size_t numBytes)
+{
+	if (numBytes < 1024) {
+		fprintf(f, "%i B\n", (int)numBytes);
+	} else if (numBytes < 1048576) {
+		fprintf(f, "%.2f KiB\n", numBytes / 1024.);
+	} else if (numBytes < 1073741824) {
+		fprintf(f, "%.2f MiB\n", numBytes / 1048576.);
+	} else {
+		fprintf(f, "%.2f GiB\n", numBytes / 1073741824.);
+	}
+}
+
+static void
+local_die(const char *what, size_t size)
+{
+	fprintf(stderr, "Could not %s ", what);
+	local_printBytes(stderr, size);
+#ifdef XMEM_TRACK_MEM
+	xmem_info(stderr);
+#endif
+	fprintf(stderr, "Aborting... :-(\n");
+	abort();
+}
+
+#ifdef XMEM_TRACK_MEM
+static uint32_t
+local_getSite(const char *file, int line)
+{
+	uint32_t idx;
+
+	if (file == NULL)
+		return 0;
+
+	idx = (uint32_t)(((uintptr_t)file >> 4) * 31 + (uint32_t)line);
+	idx = 1 + idx % (LOCAL_NUM_SITES - 1);
+	for (int i = 1; i < LOCAL_NUM_SITES; i++) {
+		struct local_site_struct *site = local_sites + idx;
+
+		if (site->file == NULL) {
+			site->file = file;
+			site->line = line;
+			return idx;
+		}
+		if ((site->line == line)
+		    && ((site->file == file) || (strcmp(site->file, file) == 0)))
+			return idx;
+		idx = (idx == LOCAL_NUM_SITES - 1) ? 1 : idx + 1;
+	}
+
+	return 0;
+}
+
+static void
+local_addAlloc(struct local_header_struct *header,
+               size_t                     size,
+               const char                 *file,
+               int                        line)
+{
+	header->size = (uint64_t)size;
+
+#  ifdef WITH_OPENMP
+#    pragma omp critical (xmem)
+#  endif
+	{
+		struct local_site_struct *site;
+
+		header->idxSite = local_getSite(file, line);
+		site            = local_sites + header->idxSite;
+		site->numAllocs++;
+		site->bytes += size;
+		if (site->bytes > site->peak)
+			site->peak = site->bytes;
+
+		global_allocated_bytes += size;
+		global_malloc_vs_free++;
+		if (global_allocated_bytes > global_max_allocated_bytes)
+			global_max_allocated_bytes = global_allocated_bytes;
+		if (global_allocated_bytes > local_windowPeak)
+			local_windowPeak = global_allocated_bytes;
+#  ifdef XMEM_TRACK_HISTOGRAM
+		{
+			int bin = 0;
+			while (bin < 63 && (UINT64_C(1) << (bin + 1)) <= size)
+				bin++;
+			local_histogram[bin]++;
+		}
+#  endif
+	}
+}
+
+static void
+local_removeAlloc(const struct local_header_struct *header)
+{
+	bool isTooOften = false;
+
+#  ifdef WITH_OPENMP
+#    pragma omp critical (xmem)
+#  endif
+	{
+		if (global_malloc_vs_free <= 0) {
+			isTooOften = true;
+		} else {
+			local_sites[header->idxSite].bytes -= header->size;
+			global_allocated_bytes             -= header->size;
+			global_malloc_vs_free--;
+		}
+	}
+
+	if (isTooOften) {
+		fprintf(stderr, "Calling free too often.\n");
+		xmem_info(stderr);
+		abort();
+	}
 }
 
 #endif
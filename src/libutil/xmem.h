@@ -12,6 +12,11 @@
  * @file libutil/xmem.h
  * @ingroup libutilCore
  * @brief This file provides utility functions dealing with memory.
+ *
+ * If compiled with -DXMEM_TRACK_MEM, every allocation is accounted (also
+ * from within OpenMP parallel regions) and attributed to the source
+ * location of the xmalloc() or xrealloc() call.  Additionally defining
+ * XMEM_TRACK_HISTOGRAM records a histogram of the allocation sizes.
  */
 
 
@@ -87,10 +92,109 @@ xrealloc(void *ptr, size_t size);
 
 #ifdef XMEM_TRACK_MEM
 
+
+/**
+ * @brief  Allocates memory and attributes it to a source location.
+ *
+ * This is what xmalloc() expands to when the tracking is activated.
+ *
+ * @param[in]  size
+ *                The amount of bytes to allocate.
+ * @param[in]  *file
+ *                The file of the call, must be a string literal.
+ * @param[in]  line
+ *                The line of the call.
+ *
+ * @return  A pointer to the allocated memory region.
+ */
+extern void *
+xmem_mallocAt(size_t size, const char *file, int line);
+
+
+/**
+ * @brief  Resizes memory and attributes it to a source location.
+ *
+ * This is what xrealloc() expands to when the tracking is activated.
+ *
+ * @param[in,out]  *ptr
+ *                    The object to resize, see xrealloc().
+ * @param[in]      size
+ *                    The new size, see xrealloc().
+ * @param[in]      *file
+ *                    The file of the call, must be a string literal.
+ * @param[in]      line
+ *                    The line of the call.
+ *
+ * @return  A pointer to a resized objects, see xrealloc().
+ */
+extern void *
+xmem_reallocAt(void *ptr, size_t size, const char *file, int line);
+
+
+/**
+ * @brief  Allocates memory with a different allocator and accounts it.
+ *
+ * This is meant for allocators that do not use xmalloc(), e.g.
+ * fftw_malloc().  The returned pointer is offset from the one obtained
+ * from the allocator by #XMEM_EXTERNAL_OFFSET bytes, which preserves its
+ * alignment, and must be released with xmem_freeExternal().
+ *
+ * @param[in]  *mallocFunc
+ *                The allocator to use.
+ * @param[in]  size
+ *                The amount of bytes to allocate.
+ *
+ * @return  A pointer to the allocated memory region.
+ */
+extern void *
+xmem_mallocExternal(void *(*mallocFunc)(size_t size), size_t size);
+
+
+/**
+ * @brief  Releases memory obtained from xmem_mallocExternal().
+ *
+ * @param[in]      *freeFunc
+ *                    The function matching the allocator.
+ * @param[in,out]  *ptr
+ *                    The memory area to be freed.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+xmem_freeExternal(void (*freeFunc)(void *ptr), void *ptr);
+
+
+/**
+ * @brief  Starts a new window for recording the peak memory usage.
+ *
+ * Windows nest; the caller keeps the returned value and passes it to
+ * xmem_popPeak() when the window ends.
+ *
+ * @return  Returns the peak of the enclosing window so far.
+ */
+extern size_t
+xmem_pushPeak(void);
+
+
+/**
+ * @brief  Ends the current peak window.
+ *
+ * @param[in]  outerPeak
+ *                The value returned by the matching xmem_pushPeak().
+ *
+ * @return  Returns the largest number of bytes allocated at any time
+ *          during the window.
+ */
+extern size_t
+xmem_popPeak(size_t outerPeak);
+
+
 /**
  * @brief  Will output the current memory usage to a given stream.
  *
  * This function is only available if the memory tracking is activated.
+ * Besides the totals, the allocation sites with the largest peak usage
+ * and, if enabled, the size histogram are printed.
  *
  * @param[in,out]  *f
  *                    The stream to write to, must be opened for writing.
@@ -101,6 +205,33 @@ xrealloc(void *ptr, size_t size);
 void
 xmem_info(FILE *f);
 
+
+/**
+ * @brief  Reports the peak memory usage per rank and per node.
+ *
+ * This is a collective function with MPI, all ranks of @c MPI_COMM_WORLD
+ * must call it.  The output is written by rank 0.  The node peak is the
+ * largest sum of the rank peaks over the ranks sharing a processor name.
+ *
+ * @param[in,out]  *f
+ *                    The stream to write to, only used on rank 0.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+xmem_infoGlobal(FILE *f);
+
+
+/*--- Exported defines --------------------------------------------------*/
+
+/** @brief  The offset used by xmem_mallocExternal(). */
+#  define XMEM_EXTERNAL_OFFSET 64
+
+/// @cond IGNORE
+#  define xmalloc(size)       xmem_mallocAt((size), __FILE__, __LINE__)
+#  define xrealloc(ptr, size) xmem_reallocAt((ptr), (size), __FILE__, __LINE__)
+/// @endcond
+
 #endif
 
 
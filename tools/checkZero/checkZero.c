@@ -33,6 +33,7 @@
 #include "../../src/libgrid/gridHistogram.h"
 #include "../../src/libdata/dataVar.h"
 #include "../../src/libutil/xmem.h"
+#include "../../src/libutil/memPool.h"
 #include "../../src/libutil/timer.h"
 #include "../../src/libutil/rng.h"
 #include "../../src/libutil/tile.h"
@@ -185,6 +186,7 @@ checkZero_del(checkZero_t *te)
 	checkZeroSetup_del(&((*te)->setup));
 	gridRegular_del(&((*te)->gridIn));
 	gridReader_del(&((*te)->reader));
+	memPool_trim();
 	xfree(*te);
 
 	*te = NULL;
@@ -233,13 +235,7 @@ local_getGrid(double         boxsizeInMpch,
 	
 
 	var = dataVar_new(varName, DATAVARTYPE_FPV, 1);
-#ifdef WITH_FFT_FFTW3
-#  ifdef ENABLE_DOUBLE
-	dataVar_setMemFuncs(var, &fftw_malloc, &fftw_free);
-#  else
-	dataVar_setMemFuncs(var, &fftwf_malloc, &fftwf_free);
-#  endif
-#endif
+	dataVar_setMemFuncs(var, &memPool_malloc, &memPool_free);
 	gridRegular_attachVar(grid, var);
 
 	return grid;
@@ -9,14 +9,75 @@
 #include <stdlib.h>
 #include <math.h>
 #include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
 #include <assert.h>
 #include "../../src/libutil/xmem.h"
+#include "../../src/libutil/memPool.h"
+#include "../../src/libgrid/gridRegularDistrib.h"
+#include "../../src/libgrid/gridRegularFFT.h"
+#include "../../src/libgrid/gridIOCommon.h"
+#include "../../src/ginnungagap/g9pConfig.h"
 
 
 /*--- Implemention of main structure ------------------------------------*/
 #include "estimateMemReq_adt.h"
 
 
+/*--- Local defines -----------------------------------------------------*/
+
+/** @brief  The maximal number of distinct size classes of the pool. */
+#define LOCAL_MAX_CLASSES 64
+
+/** @brief  The maximal number of distinct phases. */
+#define LOCAL_MAX_PHASES 16
+
+
+/*--- Local structures and typedefs -------------------------------------*/
+
+/** @brief  Replays the allocations of one rank. */
+struct local_ledger_struct {
+	/** @brief  The bytes handed out to the program. */
+	uint64_t   numBytesLive;
+	/** @brief  The bytes kept in the cache of the memory pool. */
+	uint64_t   numBytesCached;
+	/** @brief  The highest footprint seen so far. */
+	uint64_t   numBytesPeak;
+	/** @brief  The size classes of the pool that have been used. */
+	uint64_t   classSize[LOCAL_MAX_CLASSES];
+	/** @brief  The number of cached buffers per size class. */
+	uint32_t   numCached[LOCAL_MAX_CLASSES];
+	/** @brief  The number of used size classes. */
+	int        numClasses;
+	/** @brief  The names of the phases in order of their appearance. */
+	const char *phaseName[LOCAL_MAX_PHASES];
+	/** @brief  The highest footprint seen in each phase. */
+	uint64_t   phasePeak[LOCAL_MAX_PHASES];
+	/** @brief  The number of phases. */
+	int        numPhases;
+	/** @brief  The current phase, -1 if outside of all phases. */
+	int        idxPhase;
+};
+
+/** @brief  Convenience typedef. */
+typedef struct local_ledger_struct *local_ledger_t;
+
+/** @brief  Collects the sizes of the local patches of one rank. */
+struct local_patches_struct {
+	/** @brief  The number of real cells. */
+	uint64_t          numCellsReal;
+	/** @brief  The number of real cells including the FFTW padding. */
+	uint64_t          numCellsRealPadded;
+	/** @brief  The number of complex cells in every phase of the FFT. */
+	uint64_t          numCellsComplex[NDIM];
+	/** @brief  The complex dimensions of the grid in every phase. */
+	gridPointUint32_t globalDims[NDIM];
+};
+
+/** @brief  Convenience typedef. */
+typedef struct local_patches_struct *local_patches_t;
+
+
 /*--- Prototypes of local functions -------------------------------------*/
 static void
 local_getProcessGrid(int *npTot, int pGrid[3]);
@@ -24,17 +85,90 @@ local_getProcessGrid(int *npTot, int pGrid[3]);
 static void
 local_printProcessGrid(const int pGrid[3]);
 
+static bool
+local_checkProcessGridFits(const estimateMemReq_t emr, const int pGrid[3]);
+
+static void
+local_calcPatches(const estimateMemReq_t emr,
+                  const int              pGrid[3],
+                  const int              pPos[3],
+                  local_patches_t        patches);
+
 static void
-local_getGrids(int       dim1D,
-               int       idealGrid[3],
-               int       worstGrid[3],
-               const int pGrid[3]);
+local_printPatches(const local_patches_t patches);
 
 static void
-local_printGrids(const int idealGrid[3], const int worstGrid[3]);
+local_replayRun(const estimateMemReq_t emr,
+                const int              pGrid[3],
+                const int              pPos[3],
+                local_ledger_t         ledger);
 
-static size_t
-local_getMemReq(const int grid[3], size_t bytesPerCell);
+static void
+local_replay2LPT(const estimateMemReq_t emr,
+                 const local_patches_t  patches,
+                 const int              pGrid[3],
+                 const int              pPos[3],
+                 local_ledger_t         ledger);
+
+static void
+local_replayWrite(const estimateMemReq_t emr,
+                  const local_patches_t  patches,
+                  const char             *phaseName,
+                  bool                   copiesPatch,
+                  local_ledger_t         ledger);
+
+static void
+local_replayFFTForward(const estimateMemReq_t emr,
+                       const local_patches_t  patches,
+                       const int              pGrid[3],
+                       const int              pPos[3],
+                       local_ledger_t         ledger);
+
+static void
+local_replayFFTBackward(const estimateMemReq_t emr,
+                        const local_patches_t  patches,
+                        const int              pGrid[3],
+                        const int              pPos[3],
+                        local_ledger_t         ledger);
+
+static void
+local_replayTranspose(const estimateMemReq_t emr,
+                      const local_patches_t  patches,
+                      const int              pGrid[3],
+                      const int              pPos[3],
+                      int                    phaseFrom,
+                      int                    phaseTo,
+                      local_ledger_t         ledger);
+
+static void
+local_replayPk(const estimateMemReq_t emr, local_ledger_t ledger);
+
+static void
+local_replayHistogram(const estimateMemReq_t emr, local_ledger_t ledger);
+
+static void
+local_ledgerInit(local_ledger_t ledger);
+
+static void
+local_ledgerEnter(local_ledger_t ledger, const char *phaseName);
+
+static void
+local_ledgerLeave(local_ledger_t ledger);
+
+static void
+local_ledgerAlloc(local_ledger_t ledger, uint64_t numBytes, bool isPooled);
+
+static void
+local_ledgerFree(local_ledger_t ledger, uint64_t numBytes, bool isPooled);
+
+static int
+local_ledgerGetClass(local_ledger_t ledger, uint64_t classSize);
+
+static void
+local_ledgerUpdatePeak(local_ledger_t ledger);
+
+static void
+local_suggestProcessGrid(const estimateMemReq_t emr, int npTot);
 
 static void
 local_checkProcessNumbers(const int npTot, const int npY, const int npZ);
@@ -62,7 +196,18 @@ estimateMemReq_new(int dim1D, bool isDouble)
 		        emr->dim1D, (1L << 17) - 2);
 		emr->dim1D = (1L << 17) - 2;
 	}
-	emr->bytesPerCell = isDouble ? 16 : 8; // complex number per cell
+	emr->bytesPerCell      = isDouble ? 16 : 8; // complex number per cell
+	emr->npY               = 0;
+	emr->npZ               = 0;
+	emr->doHistograms      = false;
+	emr->histogramNumBins  = 0;
+	emr->dumpWhiteNoise    = false;
+	emr->writeDensityField = true;
+	emr->doSmallScale      = false;
+	emr->doLargeScale      = false;
+	emr->do2LPTCorrections = false;
+	emr->dumpCopiesPatch   = false;
+	emr->outputCopiesPatch = true;
 
 	return emr;
 }
@@ -77,6 +222,63 @@ estimateMemReq_del(estimateMemReq_t *emr)
 	*emr = NULL;
 }
 
+extern void
+estimateMemReq_setupFromIni(estimateMemReq_t emr, parse_ini_t ini)
+{
+	uint32_t dim1D;
+	int32_t  *nProcs;
+	char     *secName;
+
+	assert(emr != NULL);
+	assert(ini != NULL);
+
+	// The defaults are the ones of g9pSetup and g9pWN.
+	getFromIni(&dim1D, parse_ini_get_uint32, ini, "dim1D", "Ginnungagap");
+	if ((int)dim1D != emr->dim1D)
+		fprintf(stderr, "Using dim1D = %" PRIu32 " from the ini file.\n",
+		        dim1D);
+	emr->dim1D = (int)dim1D;
+	if (!parse_ini_get_bool(ini, "writeDensityField", "Ginnungagap",
+	                        &(emr->writeDensityField)))
+		emr->writeDensityField = true;
+	if (!parse_ini_get_bool(ini, "doSmallScale", "Ginnungagap",
+	                        &(emr->doSmallScale)))
+		emr->doSmallScale = false;
+	if (!parse_ini_get_bool(ini, "doLargeScale", "Ginnungagap",
+	                        &(emr->doLargeScale)))
+		emr->doLargeScale = false;
+	if (!parse_ini_get_bool(ini, "do2LPTCorrections", "Ginnungagap",
+	                        &(emr->do2LPTCorrections)))
+		emr->do2LPTCorrections = false;
+	if (!parse_ini_get_bool(ini, "doHistograms", "Ginnungagap",
+	                        &(emr->doHistograms)))
+		emr->doHistograms = false;
+	if (emr->doHistograms)
+		getFromIni(&(emr->histogramNumBins), parse_ini_get_uint32,
+		           ini, "histogramNumBins", "Ginnungagap");
+
+	getFromIni(&(emr->dumpWhiteNoise), parse_ini_get_bool,
+	           ini, "dumpWhiteNoise", "WhiteNoise");
+	if (emr->dumpWhiteNoise) {
+		getFromIni(&secName, parse_ini_get_string, ini, "writerSection",
+		           "WhiteNoise");
+		emr->dumpCopiesPatch = (gridIOCommon_getType(ini, secName)
+		                        == GRIDIO_TYPE_HDF5);
+		xfree(secName);
+	}
+	emr->outputCopiesPatch = (gridIOCommon_getType(ini, "Output")
+	                          == GRIDIO_TYPE_HDF5);
+
+	if (parse_ini_get_int32list(ini, "nProcs", "MPI", NDIM, &nProcs)) {
+		if (nProcs[0] > 1)
+			fprintf(stderr, "The FFT requires nProcs[0] = 1, ignoring "
+			        "%" PRIi32 ".\n", nProcs[0]);
+		emr->npY = (int)(nProcs[1]);
+		emr->npZ = (int)(nProcs[2]);
+		xfree(nProcs);
+	}
+} /* estimateMemReq_setupFromIni */
+
 extern void
 estimateMemReq_run(estimateMemReq_t emr,
                    int              npTot,
@@ -85,45 +287,74 @@ estimateMemReq_run(estimateMemReq_t emr,
                    size_t           memPerProcessInBytes,
                    int              processesPerNode)
 {
-	int    pGrid[3]     = { 1, npY, npZ };
-	int    idealGrid[3], worstGrid[3];
-	int    totalGrid[3] = { emr->dim1D, emr->dim1D, emr->dim1D };
-	size_t memIdeal, memWorst, memTotal;
+	int                         pGrid[3];
+	int                         pPosFirst[3] = { 0, 0, 0 };
+	int                         pPosLast[3];
+	struct local_ledger_struct  first, last;
+	struct local_patches_struct patches;
+	size_t                      memTotal;
 
 	assert(emr != NULL);
 
+	pGrid[0] = 1;
+	pGrid[1] = npY > 0 ? npY : emr->npY;
+	pGrid[2] = npZ > 0 ? npZ : emr->npZ;
 	local_getProcessGrid(&npTot, pGrid);
 	local_printProcessGrid(pGrid);
+	if (!local_checkProcessGridFits(emr, pGrid)) {
+		fprintf(stderr, "A %i^3 grid cannot be distributed over "
+		        "%i x %i x %i processes.\n",
+		        emr->dim1D, pGrid[0], pGrid[1], pGrid[2]);
+		exit(EXIT_FAILURE);
+	}
+	for (int i = 0; i < 3; i++)
+		pPosLast[i] = pGrid[i] - 1;
 
-	local_getGrids(emr->dim1D, idealGrid, worstGrid, pGrid);
-	local_printGrids(idealGrid, worstGrid);
-
-	memIdeal = local_getMemReq(idealGrid, emr->bytesPerCell);
-	memWorst = local_getMemReq(worstGrid, emr->bytesPerCell);
-	// Total mem is in real space, hence the /2
-	memTotal = local_getMemReq(totalGrid, emr->bytesPerCell/2);
+	// The first process holds the largest patches in every phase, the
+	// last one the smallest.
+	local_calcPatches(emr, pGrid, pPosFirst, &patches);
+	local_printPatches(&patches);
+	local_replayRun(emr, pGrid, pPosFirst, &first);
+	local_replayRun(emr, pGrid, pPosLast, &last);
+	assert(first.numPhases == last.numPhases);
 
 	printf("Machine Info:\n");
 	printf("  npTotal: %i\n", npTot);
 	printf("  ppn    : %i\n", processesPerNode);
 	printf("  nodes  : %i\n", (int)ceil(npTot / ((double)processesPerNode)));
 
-	printf("\nRAM\n");
-	printf("Ideal memory per task:  grid: ");
-	local_printMem(memIdeal);
-	printf("  grid+buffer: ");
-	local_printMem(memIdeal * 2);
-	printf("\n");
-	printf("Worst memory per task:  grid: ");
-	local_printMem(memWorst);
-	printf("  grid+buffer: ");
-	local_printMem(memWorst * 2);
+	// This corresponds to the peaks that xmem_infoGlobal() reports, minus
+	// the tables of the cosmological model.
+	printf("\nRAM (peak per task, including the memory pool)\n");
+	printf("  %-16s %14s   %14s\n", "phase", "smallest task",
+	       "largest task");
+	for (int i = 0; i < first.numPhases; i++) {
+		printf("  %-16s ", first.phaseName[i]);
+		local_printMem(last.phasePeak[i]);
+		printf("   ");
+		local_printMem(first.phasePeak[i]);
+		printf("\n");
+	}
+	printf("  %-16s ", "total");
+	local_printMem(last.numBytesPeak);
+	printf("   ");
+	local_printMem(first.numBytesPeak);
+	printf("\n  %-16s %14s   ", "per node", "");
+	local_printMem(first.numBytesPeak * (size_t)processesPerNode);
 	if ((memPerProcessInBytes > 0)
-	    && (memPerProcessInBytes < memWorst * 2)) {
+	    && (memPerProcessInBytes < first.numBytesPeak)) {
 		printf("\n    not within memory limit of ");
 		local_printMem(memPerProcessInBytes);
 	}
-	printf("\n\nDISK\n");
+	printf("\n");
+
+	local_suggestProcessGrid(emr, npTot);
+
+	// Total mem is in real space, hence the /2
+	memTotal  = (size_t)emr->dim1D * (size_t)emr->dim1D
+	            * (size_t)emr->dim1D;
+	memTotal *= (size_t)(emr->bytesPerCell / 2);
+	printf("\nDISK\n");
 	printf("Velocity field: ");
 	local_printMem(memTotal * 3);
 	printf(" (not including file structure overhead)\n");
@@ -228,52 +459,436 @@ local_printProcessGrid(const int pGrid[3])
 	       pGrid[0], pGrid[1], pGrid[2], pGrid[0] * pGrid[1] * pGrid[2]);
 }
 
+
+static bool
+local_checkProcessGridFits(const estimateMemReq_t emr, const int pGrid[3])
+{
+	// Every distributed dimension carries the r2c dimension at some
+	// point of the FFT.
+	int maxProcs = emr->dim1D / 2 + 1;
+
+	return (pGrid[0] == 1) && (pGrid[1] <= maxProcs)
+	       && (pGrid[2] <= maxProcs);
+}
+
+static void
+local_calcPatches(const estimateMemReq_t emr,
+                  const int              pGrid[3],
+                  const int              pPos[3],
+                  local_patches_t        patches)
+{
+	gridPointUint32_t dims;
+	gridPointInt_t    nProcs, procCoords;
+	gridPointUint32_t idxLo[NDIM], idxHi[NDIM];
+
+	patches->numCellsReal = 1;
+	for (int i = 0; i < NDIM; i++) {
+		uint32_t lo, hi;
+		dims[i]       = (uint32_t)emr->dim1D;
+		nProcs[i]     = pGrid[i];
+		procCoords[i] = pPos[i];
+		gridRegularDistrib_calcIdxsForRank1D(dims[i], nProcs[i],
+		                                     procCoords[i], &lo, &hi, 1, 1);
+		patches->numCellsReal *= (uint64_t)(hi - lo + 1);
+	}
+
+	gridRegularFFT_calcIdxsForPhases(dims, nProcs, procCoords, 1, 1,
+	                                 patches->globalDims, idxLo, idxHi);
+	for (int i = 0; i < NDIM; i++) {
+		patches->numCellsComplex[i] = 1;
+		for (int j = 0; j < NDIM; j++)
+			patches->numCellsComplex[i] *= (uint64_t)(idxHi[i][j]
+			                                          - idxLo[i][j] + 1);
+	}
+
+	// The rows are padded to 2 * (dim / 2 + 1) values, which makes the
+	// real patch as large as the first complex pencil.
+	patches->numCellsRealPadded = 2 * patches->numCellsComplex[0];
+}
+
+static void
+local_printPatches(const local_patches_t patches)
+{
+	printf("Largest patch (real):  %" PRIu64 " cells (%" PRIu64
+	       " with padding)\n",
+	       patches->numCellsReal, patches->numCellsRealPadded);
+	printf("Largest patch (complex):");
+	for (int i = 0; i < NDIM; i++)
+		printf("  %" PRIu64, patches->numCellsComplex[i]);
+	printf(" cells\n\n");
+}
+
+static void
+local_replayRun(const estimateMemReq_t emr,
+                const int              pGrid[3],
+                const int              pPos[3],
+                local_ledger_t         ledger)
+{
+	struct local_patches_struct patches;
+	int                         numVelocities = 0;
+	uint64_t                    numBytesReal;
+
+	local_calcPatches(emr, pGrid, pPos, &patches);
+	numBytesReal = patches.numCellsRealPadded
+	               * (uint64_t)(emr->bytesPerCell / 2);
+	local_ledgerInit(ledger);
+
+	// This follows ginnungagap_new() and ginnungagap_run().
+	if (emr->doHistograms) {
+		local_ledgerEnter(ledger, "setup");
+		for (int i = 0; i < 3; i++) {
+			local_ledgerAlloc(ledger, sizeof(double)
+			                  * (emr->histogramNumBins + 1), false);
+			local_ledgerAlloc(ledger, sizeof(uint32_t)
+			                  * emr->histogramNumBins, false);
+		}
+		local_ledgerLeave(ledger);
+	}
+
+	if (!emr->doSmallScale)
+		numVelocities += 3;
+	if (emr->doLargeScale)
+		numVelocities += 3;
+	if (emr->doSmallScale)
+		numVelocities += 3;
+
+	// The padded real patch is allocated once and is then reused by every
+	// white noise, the in-place FFT hands it back and forth between the
+	// real and the Fourier patch.
+	local_ledgerEnter(ledger, "whiteNoise");
+	local_ledgerAlloc(ledger, numBytesReal, true);
+	local_ledgerLeave(ledger);
+	for (int i = 0; i <= numVelocities; i++) {
+		bool doHistogram = (i == 0) || (!emr->doSmallScale && i <= 3);
+
+		if ((i == 0) && emr->dumpWhiteNoise) {
+			local_replayWrite(emr, &patches, "writeWhiteNoise",
+			                  emr->dumpCopiesPatch, ledger);
+			local_replayHistogram(emr, ledger);
+		}
+		local_replayFFTForward(emr, &patches, pGrid, pPos, ledger);
+		// delta(k) and the velocities are calculated in place.
+		if (i == 0)
+			local_replayPk(emr, ledger);
+		local_replayFFTBackward(emr, &patches, pGrid, pPos, ledger);
+		if ((i > 0) || emr->writeDensityField)
+			local_replayWrite(emr, &patches,
+			                  i == 0 ? "writeDeltaX" : "writeVelocity",
+			                  emr->outputCopiesPatch, ledger);
+		if (doHistogram)
+			local_replayHistogram(emr, ledger);
+	}
+
+	if (emr->do2LPTCorrections)
+		local_replay2LPT(emr, &patches, pGrid, pPos, ledger);
+} /* local_replayRun */
+
+static void
+local_replay2LPT(const estimateMemReq_t emr,
+                 const local_patches_t  patches,
+                 const int              pGrid[3],
+                 const int              pPos[3],
+                 local_ledger_t         ledger)
+{
+	uint64_t numBytesReal = patches->numCellsRealPadded
+	                        * (uint64_t)(emr->bytesPerCell / 2);
+
+	// This follows local_do2LPTCorrections(), delta(x) and the source are
+	// plain xmalloc() copies of the padded real patch next to the grid.
+	local_replayFFTForward(emr, patches, pGrid, pPos, ledger);
+	local_replayFFTBackward(emr, patches, pGrid, pPos, ledger);
+	local_ledgerEnter(ledger, "2lpt");
+	local_ledgerAlloc(ledger, numBytesReal, false);
+	local_ledgerAlloc(ledger, numBytesReal, false);
+	local_ledgerLeave(ledger);
+	for (int i = 0; i < NDIM * (NDIM + 1) / 2; i++) {
+		local_replayFFTForward(emr, patches, pGrid, pPos, ledger);
+		local_replayFFTBackward(emr, patches, pGrid, pPos, ledger);
+	}
+	local_ledgerFree(ledger, numBytesReal, false);
+	for (int i = 0; i < NDIM; i++) {
+		local_replayFFTForward(emr, patches, pGrid, pPos, ledger);
+		local_replayFFTBackward(emr, patches, pGrid, pPos, ledger);
+		local_replayWrite(emr, patches, "writeVelocity",
+		                  emr->outputCopiesPatch, ledger);
+	}
+	local_ledgerFree(ledger, numBytesReal, false);
+}
+
+static void
+local_replayWrite(const estimateMemReq_t emr,
+                  const local_patches_t  patches,
+                  const char             *phaseName,
+                  bool                   copiesPatch,
+                  local_ledger_t         ledger)
+{
+	// The writers see the patch with the padding removed.
+	uint64_t numBytes = patches->numCellsReal
+	                    * (uint64_t)(emr->bytesPerCell / 2);
+
+#ifndef ENABLE_WRITING
+	if (strcmp(phaseName, "writeWhiteNoise") != 0)
+		return;
+#endif
+	local_ledgerEnter(ledger, phaseName);
+	if (copiesPatch) {
+		local_ledgerAlloc(ledger, numBytes, true);
+		local_ledgerFree(ledger, numBytes, true);
+	}
+	local_ledgerLeave(ledger);
+}
+
+static void
+local_replayFFTForward(const estimateMemReq_t emr,
+                       const local_patches_t  patches,
+                       const int              pGrid[3],
+                       const int              pPos[3],
+                       local_ledger_t         ledger)
+{
+	// The r2c pencil works in place, only the transpositions allocate.
+	local_ledgerEnter(ledger, "fftForward");
+	for (int i = 1; i < NDIM; i++)
+		local_replayTranspose(emr, patches, pGrid, pPos, i - 1, i, ledger);
+	local_ledgerLeave(ledger);
+}
+
+static void
+local_replayFFTBackward(const estimateMemReq_t emr,
+                        const local_patches_t  patches,
+                        const int              pGrid[3],
+                        const int              pPos[3],
+                        local_ledger_t         ledger)
+{
+	local_ledgerEnter(ledger, "fftBackward");
+	for (int i = NDIM - 1; i > 0; i--)
+		local_replayTranspose(emr, patches, pGrid, pPos, i, i - 1, ledger);
+	local_ledgerLeave(ledger);
+}
+
+static void
+local_replayTranspose(const estimateMemReq_t emr,
+                      const local_patches_t  patches,
+                      const int              pGrid[3],
+                      const int              pPos[3],
+                      int                    phaseFrom,
+                      int                    phaseTo,
+                      local_ledger_t         ledger)
+{
+	// The transposition exchanges dimension 0 with the dimension that
+	// is not in place in the later of both phases.
+	int               t1     = phaseFrom > phaseTo ? phaseFrom : phaseTo;
+	int               maxNum = pGrid[0] * pGrid[t1];
+	uint64_t          bytesPerCell = (uint64_t)emr->bytesPerCell;
+	uint32_t          numSend, numRecv;
+	gridPointInt_t    nProcs, procCoords;
+	gridPointUint32_t *idxLo, *idxHi;
+	gridPointInt_t    *coords;
+	uint64_t          *sendBytes, *recvBytes;
+
+	for (int i = 0; i < NDIM; i++) {
+		nProcs[i]     = pGrid[i];
+		procCoords[i] = pPos[i];
+	}
+	idxLo     = xmalloc(sizeof(gridPointUint32_t) * maxNum);
+	idxHi     = xmalloc(sizeof(gridPointUint32_t) * maxNum);
+	coords    = xmalloc(sizeof(gridPointInt_t) * maxNum);
+	sendBytes = xmalloc(sizeof(uint64_t) * maxNum);
+	recvBytes = xmalloc(sizeof(uint64_t) * maxNum);
+
+	numSend = gridRegularDistrib_calcTransposeLayout(
+	    patches->globalDims[phaseFrom], nProcs, procCoords, 0, t1, 1, 1,
+	    true, idxLo, idxHi, coords);
+	for (uint32_t j = 0; j < numSend; j++) {
+		sendBytes[j] = bytesPerCell;
+		for (int k = 0; k < NDIM; k++)
+			sendBytes[j] *= (uint64_t)(idxHi[j][k] - idxLo[j][k] + 1);
+	}
+	numRecv = gridRegularDistrib_calcTransposeLayout(
+	    patches->globalDims[phaseFrom], nProcs, procCoords, 0, t1, 1, 1,
+	    false, idxLo, idxHi, coords);
+	for (uint32_t j = 0; j < numRecv; j++) {
+		recvBytes[j] = bytesPerCell;
+		for (int k = 0; k < NDIM; k++)
+			recvBytes[j] *= (uint64_t)(idxHi[j][k] - idxLo[j][k] + 1);
+	}
+
+	// This is the sequence of local_transposeAllVarsAtPatch().
+	for (uint32_t j = 0; j < numSend; j++)
+		local_ledgerAlloc(ledger, sendBytes[j], true);
+	local_ledgerFree(ledger, patches->numCellsComplex[phaseFrom]
+	                 * bytesPerCell, true);
+	for (uint32_t j = 0; j < numRecv; j++)
+		local_ledgerAlloc(ledger, recvBytes[j], true);
+	for (uint32_t j = 0; j < numSend; j++)
+		local_ledgerFree(ledger, sendBytes[j], true);
+	local_ledgerAlloc(ledger, patches->numCellsComplex[phaseTo]
+	                  * bytesPerCell, true);
+	for (uint32_t j = 0; j < numRecv; j++)
+		local_ledgerFree(ledger, recvBytes[j], true);
+
+	xfree(recvBytes);
+	xfree(sendBytes);
+	xfree(coords);
+	xfree(idxHi);
+	xfree(idxLo);
+} /* local_replayTranspose */
+
+static void
+local_replayPk(const estimateMemReq_t emr, local_ledger_t ledger)
+{
+	uint64_t kMax = (uint64_t)(emr->dim1D / 2 + 1);
+
+	if (emr->dim1D < G9P_MINGRIDSIZE_FOR_PS)
+		return;
+
+	// See g9pIC_calcPkFromDelta(), the reduction buffers only exist with
+	// MPI but are included regardless.
+	local_ledgerEnter(ledger, "pk");
+	local_ledgerAlloc(ledger, kMax * (2 * sizeof(double) + sizeof(uint32_t)),
+	                  false);
+	local_ledgerAlloc(ledger, kMax * sizeof(double), false);
+	local_ledgerFree(ledger, kMax * sizeof(double), false);
+	local_ledgerFree(ledger, kMax * (2 * sizeof(double) + sizeof(uint32_t)),
+	                 false);
+	local_ledgerLeave(ledger);
+}
+
+static void
+local_replayHistogram(const estimateMemReq_t emr, local_ledger_t ledger)
+{
+	uint64_t numBytes = sizeof(uint32_t) * emr->histogramNumBins;
+
+	if (!emr->doHistograms)
+		return;
+
+	local_ledgerEnter(ledger, "histogram");
+	local_ledgerAlloc(ledger, numBytes, false);
+	local_ledgerFree(ledger, numBytes, false);
+	local_ledgerLeave(ledger);
+}
+
 static void
-local_getGrids(int       dim1D,
-               int       idealGrid[3],
-               int       worstGrid[3],
-               const int pGrid[3])
+local_ledgerInit(local_ledger_t ledger)
 {
-	if ((pGrid[2] == 1) || (pGrid[1] == 1)) {
-		// slab
-		idealGrid[0] = (dim1D / 2 + 1) / pGrid[0];
-		idealGrid[1] = dim1D / pGrid[1];
-		idealGrid[2] = dim1D / pGrid[2];
-		worstGrid[0] = idealGrid[0];
-		worstGrid[1] = dim1D % pGrid[1] == 0 ?
-		               idealGrid[1] : idealGrid[1] + 1;
-		worstGrid[2] = dim1D % pGrid[2] == 0 ?
-		               idealGrid[2] : idealGrid[2] + 1;
-	} else {
-		// pencil
-		idealGrid[0] = dim1D / pGrid[0];
-		idealGrid[1] = (dim1D / 2 + 1) / pGrid[1];
-		idealGrid[2] = dim1D / pGrid[2];
-		worstGrid[0] = idealGrid[0];
-		worstGrid[1] = (dim1D / 2 + 1) % pGrid[1] == 0 ?
-		               idealGrid[1] : idealGrid[1] + 1;
-		worstGrid[2] = dim1D % pGrid[2] == 0 ?
-		               idealGrid[2] : idealGrid[2] + 1;
+	memset(ledger, 0, sizeof(struct local_ledger_struct));
+	ledger->idxPhase = -1;
+}
+
+static void
+local_ledgerEnter(local_ledger_t ledger, const char *phaseName)
+{
+	int i = 0;
+
+	while (i < ledger->numPhases
+	       && strcmp(ledger->phaseName[i], phaseName) != 0)
+		i++;
+	if (i == ledger->numPhases) {
+		assert(ledger->numPhases < LOCAL_MAX_PHASES);
+		ledger->phaseName[i] = phaseName;
+		ledger->phasePeak[i] = 0;
+		ledger->numPhases++;
 	}
+	ledger->idxPhase = i;
+	local_ledgerUpdatePeak(ledger);
 }
 
 static void
-local_printGrids(const int idealGrid[3], const int worstGrid[3])
+local_ledgerLeave(local_ledger_t ledger)
 {
-	printf("Ideal grid (complex):  %i x %i x %i\n",
-	       idealGrid[0], idealGrid[1], idealGrid[2]);
-	printf("Worst grid (complex):  %i x %i x %i\n",
-	       worstGrid[0], worstGrid[1], worstGrid[2]);
+	ledger->idxPhase = -1;
 }
 
-static size_t
-local_getMemReq(const int grid[3], size_t bytesPerCell)
+static void
+local_ledgerAlloc(local_ledger_t ledger, uint64_t numBytes, bool isPooled)
 {
-	size_t memReq = 0;
+	if (isPooled && (numBytes >= MEMPOOL_MIN_POOLED_SIZE)) {
+		uint64_t classSize = memPool_getAllocSize((size_t)numBytes);
+		int      idxClass  = local_ledgerGetClass(ledger, classSize);
 
-	memReq = (size_t)(grid[0]) * (size_t)(grid[1]) * (size_t)(grid[2]);
+		if (ledger->numCached[idxClass] > 0) {
+			ledger->numCached[idxClass]--;
+			ledger->numBytesCached -= classSize;
+		}
+		numBytes = classSize;
+	}
+	ledger->numBytesLive += numBytes;
+	local_ledgerUpdatePeak(ledger);
+}
+
+static void
+local_ledgerFree(local_ledger_t ledger, uint64_t numBytes, bool isPooled)
+{
+	if (isPooled && (numBytes >= MEMPOOL_MIN_POOLED_SIZE)) {
+		uint64_t classSize = memPool_getAllocSize((size_t)numBytes);
+		int      idxClass  = local_ledgerGetClass(ledger, classSize);
+
+		ledger->numCached[idxClass]++;
+		ledger->numBytesCached += classSize;
+		numBytes                = classSize;
+	}
+	assert(ledger->numBytesLive >= numBytes);
+	ledger->numBytesLive -= numBytes;
+}
 
-	return memReq * bytesPerCell;
+static int
+local_ledgerGetClass(local_ledger_t ledger, uint64_t classSize)
+{
+	int i = 0;
+
+	while (i < ledger->numClasses && ledger->classSize[i] != classSize)
+		i++;
+	if (i == ledger->numClasses) {
+		assert(ledger->numClasses < LOCAL_MAX_CLASSES);
+		ledger->classSize[i] = classSize;
+		ledger->numCached[i] = 0;
+		ledger->numClasses++;
+	}
+
+	return i;
+}
+
+static void
+local_ledgerUpdatePeak(local_ledger_t ledger)
+{
+	uint64_t footprint = ledger->numBytesLive + ledger->numBytesCached;
+
+	if (footprint > ledger->numBytesPeak)
+		ledger->numBytesPeak = footprint;
+	if ((ledger->idxPhase >= 0)
+	    && (footprint > ledger->phasePeak[ledger->idxPhase]))
+		ledger->phasePeak[ledger->idxPhase] = footprint;
+}
+
+static void
+local_suggestProcessGrid(const estimateMemReq_t emr, int npTot)
+{
+	int      best[3]  = { 0, 0, 0 };
+	uint64_t bestPeak = UINT64_MAX;
+	int      pPos[3]  = { 0, 0, 0 };
+
+	for (int npY = 1; npY <= npTot; npY++) {
+		struct local_ledger_struct ledger;
+		int                        pGrid[3] = { 1, npY, npTot / npY };
+
+		if ((npTot % npY != 0) || !local_checkProcessGridFits(emr, pGrid))
+			continue;
+		local_replayRun(emr, pGrid, pPos, &ledger);
+		if (ledger.numBytesPeak < bestPeak) {
+			bestPeak = ledger.numBytesPeak;
+			for (int i = 0; i < 3; i++)
+				best[i] = pGrid[i];
+		}
+	}
+
+	if (best[0] == 0) {
+		printf("\nNo process grid with %i processes fits the grid.\n",
+		       npTot);
+		return;
+	}
+	printf("\nLowest peak with %i x %i x %i processes: ",
+	       best[0], best[1], best[2]);
+	local_printMem(bestPeak);
+	printf("\n");
 }
 
 static void
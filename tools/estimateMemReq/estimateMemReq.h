@@ -12,6 +12,30 @@
  * @file estimateMemReq/estimateMemReq.h
  * @ingroup  toolsEstimateMemReq
  * @brief  Provides the interface to the estimateMemReq tool.
+ *
+ * The estimate replays the allocations ginnungagap does on one rank:
+ * the real and complex patches of the FFT, the windows of every
+ * transposition, the copies made by the writers and the small
+ * statistics buffers.  The sizes are taken from the same functions
+ * that the allocating code uses, and the grid buffers are run through
+ * a model of the memory pool, which keeps freed buffers for reuse.
+ *
+ * The density field is FFTW padded and transformed in place, hence the
+ * real patch has 2 * (dim1D / 2 + 1) values per row and no separate
+ * buffer is needed for the r2c and c2r pencils.
+ *
+ * The estimate can be compared to the peak that ginnungagap reports
+ * when it is built with @c XMEM_TRACK_MEM (see xmem_infoGlobal()).  For
+ * a 64^3 grid on 1 x 2 x 2 processes with the Grafic writer this gave
+ * @verbatim
+                      estimated    measured (largest rank)
+   without 2LPT       544.00 KiB   621.32 KiB (memory pool 544.41 KiB)
+   with 2LPT            1.05 MiB     1.12 MiB (memory pool 544.41 KiB,
+                                               2LPT fields 528.00 KiB)
+   @endverbatim
+ * The difference is made up of the tables of the cosmological model and
+ * the power spectrum (about 75 KiB here, independent of the grid size)
+ * and of the headers of the pooled buffers; neither is modelled.
  */
 
 
@@ -19,6 +43,7 @@
 #include "estimateMemReqConfig.h"
 #include <stdlib.h>
 #include <stdbool.h>
+#include "../../src/libutil/parse_ini.h"
 
 
 /*--- ADT handle --------------------------------------------------------*/
@@ -32,6 +57,24 @@ estimateMemReq_new(int dim1D, bool isDouble);
 extern void
 estimateMemReq_del(estimateMemReq_t *emr);
 
+/**
+ * @brief  Takes the grid size, the process grid and the run options from
+ *         a ginnungagap ini file.
+ *
+ * Without an ini file the estimate assumes a run that writes the
+ * density and the three velocity fields through the HDF5 writer and
+ * nothing else.
+ *
+ * @param[in,out]  emr
+ *                    The estimator to set up.
+ * @param[in,out]  ini
+ *                    The ini file to read.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+estimateMemReq_setupFromIni(estimateMemReq_t emr, parse_ini_t ini);
+
 extern void
 estimateMemReq_run(estimateMemReq_t emr,
                    int              npTot,
@@ -8,12 +8,30 @@
 
 /*--- Includes ----------------------------------------------------------*/
 #include "estimateMemReqConfig.h"
+#include <stdbool.h>
+#include <stdint.h>
 
 
 /*--- Implemention of main structure ------------------------------------*/
 struct estimateMemReq_struct {
-	int    dim1D;
-	int    bytesPerCell;
+	int      dim1D;
+	int      bytesPerCell;
+	/** @brief  The process grid given in the ini file, 0 if unknown. */
+	int      npY;
+	/** @brief  See estimateMemReq_struct::npY. */
+	int      npZ;
+	bool     doHistograms;
+	uint32_t histogramNumBins;
+	bool     dumpWhiteNoise;
+	bool     writeDensityField;
+	bool     doSmallScale;
+	bool     doLargeScale;
+	/** @brief  Whether the second order velocities are calculated. */
+	bool     do2LPTCorrections;
+	/** @brief  Whether the white noise writer copies the patch. */
+	bool     dumpCopiesPatch;
+	/** @brief  Whether the output writer copies the patch. */
+	bool     outputCopiesPatch;
 };
 
 
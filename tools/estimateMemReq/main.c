@@ -22,9 +22,8 @@
 #include <string.h>
 #include <errno.h>
 #include "../../src/libutil/cmdline.h"
-#ifdef ENABLE_DEBUG
-#  include "../../src/libutil/xmem.h"
-#endif
+#include "../../src/libutil/parse_ini.h"
+#include "../../src/libutil/xmem.h"
 
 
 /*--- Local defines -----------------------------------------------------*/
@@ -49,6 +48,8 @@ static size_t localMemPerProcInBytes = 0;
 static int    localProcessesPerNode  = 1;
 /** @brief  Selects if the IC are to be generated in double precision. */
 static bool   localIsDouble          = false;
+/** @brief  Gives the name of the ginnungagap ini file, if any. */
+static char   *localIniFileName      = NULL;
 
 
 /*--- Prototypes of local functions -------------------------------------*/
@@ -126,6 +127,8 @@ local_initEnvironment(int *argc, char ***argv)
 	if (cmdline_checkOptSetByNum(cmdline, 6))
 		cmdline_getOptValueByNum(cmdline, 6, &localProcessesPerNode);
 	localIsDouble = cmdline_checkOptSetByNum(cmdline, 7);
+	if (cmdline_checkOptSetByNum(cmdline, 8))
+		cmdline_getOptValueByNum(cmdline, 8, &localIniFileName);
 	cmdline_getArgValueByNum(cmdline, 0, &localDim1D);
 	cmdline_del(&cmdline);
 }
@@ -148,6 +151,8 @@ local_registerCleanUpFunctions(void)
 static void
 local_finalMessage(void)
 {
+	if (localIniFileName != NULL)
+		xfree(localIniFileName);
 #ifdef XMEM_TRACK_MEM
 	printf("\n");
 	xmem_info(stdout);
@@ -171,7 +176,7 @@ local_cmdlineSetup(void)
 {
 	cmdline_t cmdline;
 
-	cmdline = cmdline_new(1, 8, THIS_PROGNAME);
+	cmdline = cmdline_new(1, 9, THIS_PROGNAME);
 	(void)cmdline_addOpt(cmdline, "version",
 	                     "This will output a version information.",
 	                     false, CMDLINE_TYPE_NONE);
@@ -198,6 +203,11 @@ local_cmdlineSetup(void)
 	                     "Use if you want to use double instead of float "
 	                     "for the grid.",
 	                     false, CMDLINE_TYPE_NONE);
+	(void)cmdline_addOpt(cmdline, "ini",
+	                     "The ginnungagap ini file of the run, gives the "
+	                     "grid size, the process grid (unless set "
+	                     "explicitly) and the run options.",
+	                     true, CMDLINE_TYPE_STRING);
 	(void)cmdline_addArg(cmdline,
 	                     "The dimensions of the grid.",
 	                     CMDLINE_TYPE_INT);
@@ -233,6 +243,16 @@ local_getEmr(void)
 	estimateMemReq_t emr;
 
 	emr = estimateMemReq_new(localDim1D, localIsDouble);
+	if (localIniFileName != NULL) {
+		parse_ini_t ini = parse_ini_open(localIniFileName);
+		if (ini == NULL) {
+			fprintf(stderr, "Could not open %s for reading.\n",
+			        localIniFileName);
+			exit(EXIT_FAILURE);
+		}
+		estimateMemReq_setupFromIni(emr, ini);
+		parse_ini_close(&ini);
+	}
 
 	return emr;
 }
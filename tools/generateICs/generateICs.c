@@ -31,7 +31,9 @@
 #include "../../src/libcosmo/cosmo.h"
 #include "../../src/libutil/utilMath.h"
 #include "../../src/libutil/xmem.h"
-#include "../../src/libutil/timer.h"
+#include "../../src/libutil/xstring.h"
+#include "../../src/libutil/profile.h"
+#include "../../src/libutil/xfile.h"
 #include "../../src/libutil/diediedie.h"
 #include "../../src/libutil/lIdx.h"
 #include "../../src/libutil/gadget.h"
@@ -48,6 +50,12 @@
 #include "generateICs_adt.h"
 
 
+/*--- Local defines -----------------------------------------------------*/
+
+/** @brief  The number of particles formed at a time when writing. */
+#define LOCAL_WRITE_CHUNK UINT64_C(65536)
+
+
 /*--- Prototypes of local functions -------------------------------------*/
 
 /**
@@ -76,6 +84,53 @@ static void
 local_setupCore(generateICsCore_t   core,
                 const generateICs_t genics);
 
+
+/**
+ * @brief  Sets up what happens to the particles of a file after the
+ *         positions have been computed.
+ *
+ * @param[out]  post
+ *                 The post-processing to set up.
+ * @param[in]   genics
+ *                 The application to work with.
+ * @param[in]   core
+ *                 The core, must have been set up with local_setupCore().
+ * @param[in]   numParticles
+ *                 The number of particles computed for the file, gas
+ *                 particles are formed from them when writing.
+ *
+ * @return  Returns nothing.
+ */
+static void
+local_setupPost(generateICsCorePost_s     *post,
+                const generateICs_t       genics,
+                const generateICsCore_t   core,
+                uint64_t                  numParticles);
+
+
+/**
+ * @brief  Produces the particles of the current zoom level.
+ *
+ * @param[in,out]  genics
+ *                    The application to work with, the level to produce is
+ *                    given by its zoom level.
+ * @param[in]      in
+ *                    The velocities of the level.
+ * @param[in]      cost
+ *                    The cost model for distributing the tiles onto the
+ *                    files.
+ * @param[in]      appendTimings
+ *                    Whether the timings are appended to those of an
+ *                    earlier level in the cost model file.
+ *
+ * @return  Returns nothing.
+ */
+static void
+local_runLevel(generateICs_t          genics,
+               const generateICsIn_t  in,
+               const g9pICMapCost_t   cost,
+               bool                   appendTimings);
+
 static uint64_t
 local_computeNumPartsLevel(const generateICs_t genics, 
 														int8_t level);
@@ -85,6 +140,8 @@ local_computeNumPartsLevel(const generateICs_t genics,
  *
  * @param[in,out]  genics
  *                    The application to work with.
+ * @param[in]      in
+ *                    The velocities of the current level.
  * @param[in]      map
  *                    The mapping of tiles onto the files, include auxiliary
  *                    information about the number of cells in each file.
@@ -94,13 +151,148 @@ local_computeNumPartsLevel(const generateICs_t genics,
  * @return  Returns nothing.
  */
 static void
-local_doFile(generateICs_t genics, const g9pICMap_t map, int file, uint64_t *startID);
+local_doFile(generateICs_t         genics,
+             const generateICsIn_t in,
+             const g9pICMap_t      map,
+             int                   file,
+             uint64_t              *startID);
+
+static void
+local_writeGadgetFile(generateICs_t               genics,
+                      int                         file,
+                      const partBunch_t           particles,
+                      g9pICMap_t                  map,
+                      const generateICsCorePost_s *post);
+
+
+/**
+ * @brief  Writes the gas and the dark matter particles made from the same
+ *         particles to the current file.
+ *
+ * The positions and IDs of the two kinds are formed in small chunks while
+ * writing, the particles are only stored once.
+ *
+ * @param[in,out]  genics
+ *                    The application to work with.
+ * @param[in]      particles
+ *                    The particles as computed by the core.
+ * @param[in]      post
+ *                    The post-processing forming gas and dark matter.
+ * @param[in,out]  buf
+ *                    Scratch space for @c chunk positions.
+ * @param[in]      chunk
+ *                    The number of particles formed at a time.
+ *
+ * @return  Returns nothing.
+ */
+static void
+local_writeWithGas(generateICs_t               genics,
+                   const partBunch_t           particles,
+                   const generateICsCorePost_s *post,
+                   fpv_t                       *buf,
+                   uint64_t                    chunk);
+
+
+/**
+ * @brief  Writes the same value for a number of particles to a block of
+ *         the current file.
+ *
+ * @param[in,out]  genics
+ *                    The application to work with.
+ * @param[in]      block
+ *                    The block to write.
+ * @param[in]      num
+ *                    The number of particles in the block.
+ * @param[in]      value
+ *                    The value to write.
+ * @param[in,out]  buf
+ *                    Scratch space for @c chunk values.
+ * @param[in]      chunk
+ *                    The number of values written at a time.
+ *
+ * @return  Returns nothing.
+ */
+static void
+local_writeConstBlock(generateICs_t genics,
+                      gadgetBlock_t block,
+                      uint64_t      num,
+                      fpv_t         value,
+                      fpv_t         *buf,
+                      uint64_t      chunk);
 
+
+/**
+ * @brief  Calibrates the cost model with the timings of an earlier run.
+ *
+ * @param[in]      genics
+ *                    The application to work with.  Nothing happens if it
+ *                    has no cost model file or the file cannot be read.
+ * @param[in,out]  cost
+ *                    The cost model to calibrate.
+ *
+ * @return  Returns nothing.
+ */
 static void
-local_writeGadgetFile(generateICs_t     genics,
-                      int               file,
-                      const partBunch_t particles,
-                      g9pICMap_t map);
+local_calibrateCost(const generateICs_t genics, g9pICMapCost_t cost);
+
+
+/**
+ * @brief  Writes the timings of this run to the cost model file.
+ *
+ * @param[in]  genics
+ *                The application to work with.
+ * @param[in]  map
+ *                The map used for this run.
+ * @param[in]  *seconds
+ *                The time taken for every file.
+ * @param[in]  append
+ *                Whether to append to the timings of an earlier level.
+ *
+ * @return  Returns nothing.
+ */
+static void
+local_writeCostModelFile(const generateICs_t genics,
+                         const g9pICMap_t    map,
+                         const double        *seconds,
+                         bool                append);
+
+
+/**
+ * @brief  Computes the first sequential ID of every file.
+ *
+ * @param[in]  genics
+ *                The application to work with.
+ * @param[in]  map
+ *                The map providing the particles in each file.
+ * @param[in]  numFiles
+ *                The number of files in the map.
+ * @param[in]  startID
+ *                The first ID of the first file.
+ *
+ * @return  Returns a new array of length @c numFiles + 1 holding the first
+ *          ID of every file, the last element is the ID after the last
+ *          particle.
+ */
+static uint64_t *
+local_calcFileStartIDs(const generateICs_t genics,
+                       const g9pICMap_t    map,
+                       uint32_t            numFiles,
+                       uint64_t            startID);
+
+
+/**
+ * @brief  Sorts the files by decreasing cost.
+ *
+ * @param[in]  map
+ *                The map providing the costs of the files.
+ * @param[in]  numFiles
+ *                The number of files in the map.
+ *
+ * @return  Returns a new array of length @c numFiles holding the file
+ *          numbers, the most expensive file comes first.
+ */
+static uint32_t *
+local_getFilesByCost(const g9pICMap_t map, uint32_t numFiles);
 
 
 /*--- Exported functions: Creating and deleting -------------------------*/
@@ -127,6 +319,11 @@ generateICs_del(generateICs_t *genics)
 		generateICsData_del( &( (*genics)->data ) );
 	if ( (*genics)->in != NULL )
 		generateICsIn_del( &( (*genics)->in ) );
+	if ( (*genics)->inForLevel != NULL ) {
+		for (int i = 0; i < (*genics)->numInForLevel; i++)
+			generateICsIn_del( &( (*genics)->inForLevel[i] ) );
+		xfree( (*genics)->inForLevel );
+	}
 	if ( (*genics)->out != NULL )
 		generateICsOut_del( &( (*genics)->out ) );
 	if ( (*genics)->hierarchy != NULL )
@@ -135,6 +332,8 @@ generateICs_del(generateICs_t *genics)
 		g9pDataStore_del(&(*genics)->datastore);
 	if ( (*genics)->mask != NULL )
 		g9pMask_del(&(*genics)->mask);
+	if ( (*genics)->costModelFile != NULL )
+		xfree((*genics)->costModelFile);
 
 	xfree(*genics);
 
@@ -166,14 +365,10 @@ extern void
 generateICs_run(generateICs_t genics)
 {
 	assert(genics != NULL);
-	uint32_t minlev = g9pMask_getMinLevel(genics->mask);
-	uint32_t maxlev = g9pMask_getMaxLevel(genics->mask);
-	uint32_t numFiles = genics->out->numFilesForLevel[genics->zoomlevel-minlev];
-	uint64_t startID = 0;
-
-	g9pICMap_t map = g9pICMap_new( numFiles, 0, NULL,
-	                               g9pMask_getRef(genics->mask),
-	                               genics->zoomlevel);
+	const int32_t  zoomlevel = genics->zoomlevel;
+	uint32_t       minlev    = g9pMask_getMinLevel(genics->mask);
+	g9pICMapCost_s cost      = G9PICMAPCOST_DEFAULT;
+	bool           appendTimings = false;
 
 	if (genics->rank == 0)
 		generateICs_printSummary(genics, stdout);
@@ -182,67 +377,121 @@ generateICs_run(generateICs_t genics)
 	gridPointUint32_t fullDims = {tmp, tmp, tmp};
 	generateICsOut_initBaseHeader(genics->out, genics->data, fullDims,
 	                              genics->mode);
-	                            
-	                              
-	if (genics->rank != 0 && genics->mode->sequentialIDs) {
-		fprintf(stderr, "Sorry, sequentialIDs are supported only for single CPU runs.\n");
-		diediedie(EXIT_FAILURE);
+	local_calibrateCost(genics, &cost);
+
+	if (genics->inForLevel == NULL) {
+		local_runLevel(genics, genics->in, &cost, appendTimings);
+		return;
 	}
+
+	// The mask, the cost model and the output header are shared by all
+	// levels, each level only reads its own velocities into its own files.
+	for (int i = 0; i < genics->numInForLevel; i++) {
+		if (genics->out->numFilesForLevel[i] == 0)
+			continue;
+		genics->zoomlevel = (int32_t)minlev + i;
+		if (genics->rank == 0)
+			printf("Producing level %" PRIi32 "\n", genics->zoomlevel);
+		local_runLevel(genics, genics->inForLevel[i], &cost, appendTimings);
+		appendTimings = true;
+	}
+	genics->zoomlevel = zoomlevel;
+} // generateICs_run
+
+/*--- Implementations of local functions --------------------------------*/
+static void
+local_runLevel(generateICs_t          genics,
+               const generateICsIn_t  in,
+               const g9pICMapCost_t   cost,
+               bool                   appendTimings)
+{
+	uint32_t minlev = g9pMask_getMinLevel(genics->mask);
+	uint32_t numFiles = genics->out->numFilesForLevel[genics->zoomlevel-minlev];
+	uint64_t startID = 0;
+	int8_t   gasLevel = (int8_t)(genics->zoomlevel);
+	uint32_t numGasLevel = 0;
+
+	if (genics->mode->doGas
+	    && (genics->typeForLevel)[genics->zoomlevel-minlev]==1)
+		numGasLevel = 1;
+	g9pICMap_t map = g9pICMap_newWithCost( numFiles, numGasLevel, &gasLevel,
+	                                       g9pMask_getRef(genics->mask),
+	                                       genics->zoomlevel, cost );
+
 	for (uint8_t lev=minlev; lev < genics->zoomlevel;lev++) {
 		startID += local_computeNumPartsLevel(genics,lev);
 	}
+	// The first ID of every file follows from the particles in the files
+	// before it, hence every task can work on any file.
+	uint64_t *fileStartID = local_calcFileStartIDs(genics, map, numFiles,
+	                                               startID);
 	
-        uint32_t N1, N2, Nperproc;
-        uint32_t  NDO=0;
-        uint32_t foffset=0;
-        for (uint32_t i = 0; i < genics->zoomlevel-minlev; i++){
-			foffset+=genics->out->numFilesForLevel[i];
-		}
+	uint32_t foffset=0;
+	for (uint32_t i = 0; i < genics->zoomlevel-minlev; i++){
+		foffset+=genics->out->numFilesForLevel[i];
+	}
 
-        if (genics->size <=  numFiles ) 
-          {
-            Nperproc= numFiles / genics->size;
-            N1 = Nperproc * genics->rank ;
-            N2= Nperproc  + N1;
-
-            if (genics->rank  ==  genics->size -1 )
-              {
-                N2 = numFiles;
-              } 
-          }
-        else
-          {
-            if ( genics->rank <=  numFiles -1 )
-              {
-                N1 = genics->rank;
-                N2 = N1+1;
-              }
-            else
-              {NDO=1;}
-          }
-
-        printf(" * Comienzo a producir files desde  %i a %i\n", N1, N2);
-
-        if ( NDO == 0 ) 
-          {
-            for (uint32_t i = N1; i < N2; i++) 
-              {
-		
-		//	for (uint32_t i = 0; i < genics->out->numFiles; i++) {
-		printf(" * Working on file %i\n", i+foffset);
-		double timing = timer_start();
+	// The files are handed out one at a time, the most expensive first,
+	// such that ranks finishing early pick up the remaining files.  A
+	// single task keeps the natural order for the sequential IDs.
+	uint32_t *files   = local_getFilesByCost(map, numFiles);
+	double   *seconds = xmalloc(sizeof(double) * numFiles);
+	uint32_t next     = 0;
+	for (uint32_t i = 0; i < numFiles; i++)
+		seconds[i] = 0.;
+#ifdef WITH_MPI
+	MPI_Win  win;
+	uint32_t *counter = NULL;
+	if (genics->rank == 0) {
+		MPI_Alloc_mem(sizeof(uint32_t), MPI_INFO_NULL, &counter);
+		*counter = 0;
+	}
+	MPI_Win_create(counter, (genics->rank == 0) ? sizeof(uint32_t) : 0,
+	               sizeof(uint32_t), MPI_INFO_NULL, MPI_COMM_WORLD, &win);
+#endif
+
+	while (true) {
+#ifdef WITH_MPI
+		const uint32_t one = 1;
+		MPI_Win_lock(MPI_LOCK_SHARED, 0, 0, win);
+		MPI_Fetch_and_op(&one, &next, MPI_UINT32_T, 0, 0, MPI_SUM, win);
+		MPI_Win_unlock(0, win);
+#endif
+		if (next >= numFiles)
+			break;
+		uint32_t i = (genics->size > 1) ? files[next] : next;
+#ifndef WITH_MPI
+		next++;
+#endif
+
+		printf(" * Working on file %i (cost %.3g)\n", i+foffset,
+		       g9pICMap_getCostOfFile(map, i));
+		profile_enter("doFile");
 		
-		local_doFile(genics, map, i, &startID);
+		startID = fileStartID[i];
+		local_doFile(genics, in, map, i, &startID);
+		assert(!genics->mode->sequentialIDs || startID == fileStartID[i + 1]);
 		
-		timing = timer_stop(timing);
-		printf("      File processed in in %.2fs\n", timing);
-	      }
-	  }
+		seconds[i] = profile_leave();
+		printf("      File processed in in %.2fs\n", seconds[i]);
+	}
 
+#ifdef WITH_MPI
+	MPI_Win_free(&win);
+	if (counter != NULL)
+		MPI_Free_mem(counter);
+	MPI_Allreduce(MPI_IN_PLACE, seconds, (int)numFiles, MPI_DOUBLE, MPI_SUM,
+	              MPI_COMM_WORLD);
+#endif
+	if (genics->rank == 0)
+		local_writeCostModelFile(genics, map, seconds, appendTimings);
+
+	xfree(fileStartID);
+	xfree(seconds);
+	xfree(files);
 	g9pICMap_del(&map);
-} // generateICs_run
+} // local_runLevel
 
-/*--- Implementations of local functions --------------------------------*/
 inline static generateICs_t
 local_alloc(void)
 {
@@ -271,12 +520,15 @@ local_init(generateICs_t genics)
 	genics->mode      = NULL;
 	genics->data      = NULL;
 	genics->in        = NULL;
+	genics->inForLevel    = NULL;
+	genics->numInForLevel = 0;
 	genics->out       = NULL;
 	genics->hierarchy = NULL;
 	genics->datastore = NULL;
 	genics->mask      = NULL;
 	genics->typeForLevel = NULL;
 	genics->shift = xmalloc(sizeof(double)*3);
+	genics->costModelFile = NULL;
 } // local_init
 
 static uint64_t
@@ -319,8 +571,52 @@ local_setupCore(generateICsCore_t   core,
 
 	printf("   fullDims = (%u, %u, %u)\n", core->fullDims[0],
 	       core->fullDims[1], core->fullDims[2]);
+
+	// The IDs from positions are calculated on the finest level of the
+	// mask, such that they are unique across all levels.
+	core->idGen = g9pIDGenerator_newWithScheme(
+	    g9pHierarchy_getRef(genics->hierarchy),
+	    (uint8_t)g9pMask_getMaxLevel(genics->mask),
+	    genics->mode->idScheme);
 }
 
+static void
+local_setupPost(generateICsCorePost_s     *post,
+                const generateICs_t       genics,
+                const generateICsCore_t   core,
+                uint64_t                  numParticles)
+{
+	if (genics->mode->doGas && (genics->typeForLevel)[genics->zoomlevel-g9pMask_getMinLevel(genics->mask)]==1) {
+		post->doGas    = true;
+		post->gasShift = genics->data->boxsizeInMpch / core->fullDims[0]
+		                 * 0.25;
+		post->idOffset = local_computeNumPartsLevel(genics,
+		                                            genics->zoomlevel);
+		printf("   Gas offset: %lf\n", post->gasShift);
+		printf("   Local gas particles: %" PRIu64 "\n", numParticles);
+		printf("   Total gas particles: %" PRIu64 "\n", post->idOffset);
+	}
+
+	if (genics->mode->autoCenter) {
+		float newCenter[3];
+		g9pMask_getCenter(genics->mask, newCenter);
+		generateICsCorePost_addRecenter(post, genics->data->boxsizeInMpch,
+		                                newCenter);
+	}
+
+	if (genics->shift[0]!=0 || genics->shift[1]!=0 || genics->shift[2]!=0) {
+		float newCenter[3];
+		for (int i=0;i<3;i++) {
+			newCenter[i] = (genics->data->boxsizeInMpch/2 - genics->shift[i])/genics->data->boxsizeInMpch;
+		}
+		generateICsCorePost_addRecenter(post, genics->data->boxsizeInMpch,
+		                                newCenter);
+	}
+
+	if (genics->mode->kpc)
+		post->scale = FPV_C(1000.0);
+} // local_setupPost
+
 static partBunch_t
 local_getParticleStorage(const generateICs_t genics,
                          const uint32_t      firstTile,
@@ -330,8 +626,6 @@ local_getParticleStorage(const generateICs_t genics,
 	for (uint32_t i = firstTile; i <= lastTile; i++) {
 		numParticles += local_computeNumParts(genics, i);
 	}
-	if (genics->mode->doGas && (genics->typeForLevel)[genics->zoomlevel-g9pMask_getMinLevel(genics->mask)]==1)
-		numParticles *= 2;
 
 	dataVar_t      var;
 	dataParticle_t desc = dataParticle_new("Standard", 0, 3);
@@ -353,7 +647,11 @@ local_getParticleStorage(const generateICs_t genics,
 } // local_getParticleStorage
 
 static void
-local_doFile(generateICs_t genics, g9pICMap_t map, int file, uint64_t *startID)
+local_doFile(generateICs_t         genics,
+             const generateICsIn_t in,
+             const g9pICMap_t      map,
+             int                   file,
+             uint64_t              *startID)
 {
 	uint32_t    firstTile = g9pICMap_getFirstTileInFile(map, file);
 	uint32_t    lastTile  = g9pICMap_getLastTileInFile(map, file);
@@ -365,6 +663,14 @@ local_doFile(generateICs_t genics, g9pICMap_t map, int file, uint64_t *startID)
 	generateICsCore_s core = GENICSCORE_INIT_STRUCT(genics->data,
 	                                                genics->mode);
 	local_setupCore(&core, genics);
+
+	generateICsCorePost_s post     = GENICSCOREPOST_INIT_STRUCT;
+	generateICsCorePost_s identity = GENICSCOREPOST_INIT_STRUCT;
+	local_setupPost(&post, genics, &core,
+	                partBunch_getNumParticles(particles));
+	// With gas the particles are stored once, the gas and dark matter
+	// particles are formed from them when writing.
+	core.post = post.doGas ? &identity : &post;
 	
 	printf("np in level: %i\n",
 				local_computeNumPartsLevel(genics, genics->zoomlevel)); 
@@ -378,26 +684,32 @@ local_doFile(generateICs_t genics, g9pICMap_t map, int file, uint64_t *startID)
 		core.id           = partBunch_at(particles, 2, partsRead);
 		core.patch        = g9pMask_getEmptyPatchForTileLevel(genics->mask, i, genics->zoomlevel);
 		core.level		  = genics->zoomlevel;
-		core.maxDims	  = g9pMask_getDim1DLevel(genics->mask,g9pMask_getMaxLevel(genics->mask));
-		core.maskdata	  = g9pMask_getTileData(genics->mask,i);
+		core.mask		  = genics->mask;
+		core.tile		  = i;
 		core.maskDim1D	  = g9pMask_getDim1D(genics->mask);
 		core.partDim1D	  = g9pMask_getDim1DLevel(genics->mask,genics->zoomlevel);
 		core.startID	  = *startID;
-		(void)gridPatch_attachVar(core.patch, genics->in->varVelx);
-		(void)gridPatch_attachVar(core.patch, genics->in->varVely);
-		(void)gridPatch_attachVar(core.patch, genics->in->varVelz);
+		(void)gridPatch_attachVar(core.patch, in->varVelx);
+		(void)gridPatch_attachVar(core.patch, in->varVely);
+		(void)gridPatch_attachVar(core.patch, in->varVelz);
 
 //		fpv_t             *velxP = gridPatch_getVarDataHandle(core.patch, 0);
 	//	printf("\n %i \n", i);
 
-		gridReader_readIntoPatchForVar(genics->in->velx, core.patch, 0);
-		gridReader_readIntoPatchForVar(genics->in->vely, core.patch, 1);
-		gridReader_readIntoPatchForVar(genics->in->velz, core.patch, 2);
+		profile_enter("readVelocities");
+		gridReader_readIntoPatchForVar(in->velx, core.patch, 0);
+		gridReader_readIntoPatchForVar(in->vely, core.patch, 1);
+		gridReader_readIntoPatchForVar(in->velz, core.patch, 2);
+		profile_addBytes(3 * sizeof(fpv_t)
+		                 * gridPatch_getNumCells(core.patch));
+		profile_leave();
 		
 		//fpv_t             *velx1P = gridPatch_getVarDataHandle(core.patch, 0);
 		//printf(" %i \n", velx1P);
 		
+		profile_enter("toParticles");
 		generateICsCore_toParticles(&core);
+		profile_leave();
 		
 		*startID = core.startID;
 		printf("StartID: %i\n",*startID);
@@ -410,68 +722,30 @@ local_doFile(generateICs_t genics, g9pICMap_t map, int file, uint64_t *startID)
 	    }
 	}
 	printf("   Particles read: %lu\n", partsRead);
-	//printf("pos: %f", core.pos[1]);
-	if (genics->mode->doGas && (genics->typeForLevel)[genics->zoomlevel-g9pMask_getMinLevel(genics->mask)]==1) {
-		printf("   Making gas particles\n");
-		uint64_t npGasTotal = local_computeNumPartsLevel(genics, genics->zoomlevel);
-		//npGasTotal = core.fullDims[0];
-		//npGasTotal *= core.fullDims[1];
-		//npGasTotal *= core.fullDims[2];
-		core.numParticles = partBunch_getNumParticles(particles);
-		core.pos          = partBunch_at(particles, 0, 0);
-		core.vel          = partBunch_at(particles, 1, 0);
-		core.id           = partBunch_at(particles, 2, 0);
-		generateICsCode_dm2Gas(&core, 0.25, npGasTotal);
-	}
-	
-	if (genics->mode->autoCenter) {
-		float newCenter[3];
-		g9pMask_getCenter(genics->mask, newCenter);
-		core.numParticles = partBunch_getNumParticles(particles);
-		core.pos          = partBunch_at(particles, 0, 0);
-		core.vel          = partBunch_at(particles, 1, 0);
-		core.id           = partBunch_at(particles, 2, 0);
-		generateICsCore_recenter(&core, newCenter);
-	}
-	
-	if (genics->shift[0]!=0 || genics->shift[1]!=0 || genics->shift[2]!=0) {
-		float newCenter[3];
-		for (int i=0;i<3;i++) {
-			newCenter[i] = (genics->data->boxsizeInMpch/2 - genics->shift[i])/genics->data->boxsizeInMpch;
-		}
-		core.numParticles = partBunch_getNumParticles(particles);
-		core.pos          = partBunch_at(particles, 0, 0);
-		core.vel          = partBunch_at(particles, 1, 0);
-		core.id           = partBunch_at(particles, 2, 0);
-		generateICsCore_recenter(&core, newCenter);
-	}
-	
-	if (genics->mode->kpc) {
-        core.numParticles = partBunch_getNumParticles(particles);
-        core.pos          = partBunch_at(particles, 0, 0);
-        core.vel          = partBunch_at(particles, 1, 0);
-        core.id           = partBunch_at(particles, 2, 0);
-		generateICsCore_kpc(&core);
-	}
-
 
-	local_writeGadgetFile(genics, file, particles, map);
+	profile_enter("writeGadget");
+	local_writeGadgetFile(genics, file, particles, map, &post);
+	profile_leave();
 
+	g9pIDGenerator_del(&(core.idGen));
 	partBunch_del(&particles);
 } // local_doFile
 
 static void
-local_writeGadgetFile(generateICs_t     genics,
-                      int               file,
-                      const partBunch_t particles,
-                      g9pICMap_t map)
+local_writeGadgetFile(generateICs_t               genics,
+                      int                         file,
+                      const partBunch_t           particles,
+                      g9pICMap_t                  map,
+                      const generateICsCorePost_s *post)
 {
 	uint32_t       npLocal[6] = {0, 0, 0, 0, 0, 0};
 	uint64_t       npAll[6] = {0, 0, 0, 0, 0, 0};
 	double         massArr[6] = {0., 0., 0., 0., 0., 0.};
 	gadgetHeader_t myHeader;
+	gadgetTOC_t    toc = gadgetTOC_clone(genics->out->toc);
 
-	const uint64_t               np = partBunch_getNumParticles(particles);
+	const uint64_t npBase = partBunch_getNumParticles(particles);
+	const uint64_t np     = post->doGas ? 2 * npBase : npBase;
 	uint32_t minlev = g9pMask_getMinLevel(genics->mask);
 	uint32_t maxlev = g9pMask_getMaxLevel(genics->mask);
 	uint32_t   numLevels = maxlev - minlev + 1;
@@ -490,9 +764,9 @@ local_writeGadgetFile(generateICs_t     genics,
 		}
 	}
     
-	if (genics->mode->doGas && arrIdx==1) {
-		assert(np % 2 == 0);
-		npLocal[0] = np / 2;
+	if (post->doGas) {
+		assert(genics->mode->doGas && arrIdx==1);
+		npLocal[0] = (uint32_t)npBase;
 		npLocal[arrIdx] = npLocal[0];
 	} else {
 		npLocal[arrIdx] = (uint32_t)np;
@@ -524,7 +798,7 @@ local_writeGadgetFile(generateICs_t     genics,
 	printf("\n mass: %lf\n",generateICsOut_boxMass(genics->data));
 	
 	if(nlevfortype[arrIdx]>1 || genics->mode->doMassBlock) {
-		gadgetTOC_addEntryByType(genics->out->toc, GADGETBLOCK_MASS);
+		gadgetTOC_addEntryByType(toc, GADGETBLOCK_MASS);
 	}
 	if (genics->mode->doGas) {
 		const double omegaBaryon0 = cosmoModel_getOmegaBaryon0(genics->data->model);
@@ -533,7 +807,7 @@ local_writeGadgetFile(generateICs_t     genics,
 		massArr[0]  = massArr[1] * omegaBaryon0 / omegaMatter0;
 		massArr[1]  -= massArr[0];
 		if(arrIdx==1)
-			gadgetTOC_addEntryByType(genics->out->toc, GADGETBLOCK_U___);
+			gadgetTOC_addEntryByType(toc, GADGETBLOCK_U___);
 	}
 	gadgetHeader_setNall(myHeader,npAll);
 	gadgetHeader_setMassArr(myHeader, massArr);
@@ -542,62 +816,272 @@ local_writeGadgetFile(generateICs_t     genics,
 	
 	gadgetHeader_getMassArr(myHeader, massArr);
 	gadgetHeader_setNp(myHeader, npLocal);
-	gadgetTOC_calcSizes(genics->out->toc, npLocal, massArr, false,
+	gadgetTOC_calcSizes(toc, npLocal, massArr, false,
 	                    genics->mode->useLongIDs);
-	gadgetTOC_calcOffset(genics->out->toc);
+	gadgetTOC_calcOffset(toc);
 	gadget_setHeaderOfFile(genics->out->gadget, file+foffset, myHeader);
 	gadget_setTOCOfFile( genics->out->gadget, file+foffset,
-	                     gadgetTOC_clone(genics->out->toc) );
+	                     toc );
 	gadget_open(genics->out->gadget, GADGET_MODE_WRITE_CREATE, file+foffset);
 	gadget_writeHeaderToCurrentFile(genics->out->gadget);
 	{
-		stai_t stai;
-		stai = stai_new( partBunch_at(particles, 0, 0),
-		                 3 * sizeof(fpv_t), 3 * sizeof(fpv_t) );
-		gadget_writeBlockToCurrentFile(genics->out->gadget, GADGETBLOCK_POS_,
-		                               0, np, stai);
-		stai_del(&stai);
-		stai = stai_new( partBunch_at(particles, 1, 0),
-		                 3 * sizeof(fpv_t), 3 * sizeof(fpv_t) );
-		gadget_writeBlockToCurrentFile(genics->out->gadget, GADGETBLOCK_VEL_,
-		                               0, np, stai);
-		stai_del(&stai);
-		if (genics->mode->useLongIDs) {
-			stai = stai_new( partBunch_at(particles, 2, 0),
-			                 sizeof(uint64_t), sizeof(uint64_t) );
+		const uint64_t chunk = (np < LOCAL_WRITE_CHUNK) ? np + 1
+		                       : LOCAL_WRITE_CHUNK;
+		fpv_t          *buf  = xmalloc(sizeof(fpv_t) * 3 * chunk);
+		stai_t         stai;
+
+		if (post->doGas) {
+			local_writeWithGas(genics, particles, post, buf, chunk);
 		} else {
-			stai = stai_new( partBunch_at(particles, 2, 0),
-			                 sizeof(uint32_t), sizeof(uint32_t) );
+			stai = stai_new( partBunch_at(particles, 0, 0),
+			                 3 * sizeof(fpv_t), 3 * sizeof(fpv_t) );
+			gadget_writeBlockToCurrentFile(genics->out->gadget,
+			                               GADGETBLOCK_POS_, 0, np, stai);
+			stai_del(&stai);
+			stai = stai_new( partBunch_at(particles, 1, 0),
+			                 3 * sizeof(fpv_t), 3 * sizeof(fpv_t) );
+			gadget_writeBlockToCurrentFile(genics->out->gadget,
+			                               GADGETBLOCK_VEL_, 0, np, stai);
+			stai_del(&stai);
+			if (genics->mode->useLongIDs) {
+				stai = stai_new( partBunch_at(particles, 2, 0),
+				                 sizeof(uint64_t), sizeof(uint64_t) );
+			} else {
+				stai = stai_new( partBunch_at(particles, 2, 0),
+				                 sizeof(uint32_t), sizeof(uint32_t) );
+			}
+			gadget_writeBlockToCurrentFile(genics->out->gadget,
+			                               GADGETBLOCK_ID__, 0, np, stai);
+			stai_del(&stai);
 		}
-		gadget_writeBlockToCurrentFile(genics->out->gadget, GADGETBLOCK_ID__,
-		                               0, np, stai);
-		stai_del(&stai);
-		
-		
+
 		if(nlevfortype[arrIdx]>1 || genics->mode->doMassBlock) {
-			fpv_t masses[np];
 			npFull = POW_NDIM((uint64_t)g9pMask_getDim1DLevel(genics->mask,genics->zoomlevel));
 			fpv_t mass1 = generateICsOut_boxMass(genics->data) / npFull;
-			for(int i=0; i<np; i++) {
-				masses[i] = mass1;
-			}
-			stai = stai_new( masses, sizeof(fpv_t), sizeof(fpv_t) );
-			gadget_writeBlockToCurrentFile(genics->out->gadget, GADGETBLOCK_MASS,
-		                               0, np, stai);
-		    stai_del(&stai);
+			local_writeConstBlock(genics, GADGETBLOCK_MASS, np, mass1, buf,
+			                      chunk);
 		}
 		
 		if(genics->mode->doGas && arrIdx==1) {
-			uint64_t npl = npLocal[0];
-			fpv_t energies[npl];
-			for(int i=0;i<npl;i++) {
-				energies[i]=0;
-			}
-			stai = stai_new(energies, sizeof(fpv_t), sizeof(fpv_t) );
-			gadget_writeBlockToCurrentFile(genics->out->gadget, GADGETBLOCK_U___,
-		                               0, npl, stai);
-		    stai_del(&stai);
+			local_writeConstBlock(genics, GADGETBLOCK_U___, npLocal[0],
+			                      FPV_C(0.0), buf, chunk);
 		}
+		xfree(buf);
 	}
 	gadget_close(genics->out->gadget);
 } // local_writeGadgetFile
+
+static void
+local_writeWithGas(generateICs_t               genics,
+                   const partBunch_t           particles,
+                   const generateICsCorePost_s *post,
+                   fpv_t                       *buf,
+                   uint64_t                    chunk)
+{
+	const uint64_t np       = partBunch_getNumParticles(particles);
+	const fpv_t    *pos     = partBunch_at(particles, 0, 0);
+	const size_t   sizeOfID = genics->mode->useLongIDs ? sizeof(uint64_t)
+	                          : sizeof(uint32_t);
+	stai_t         stai;
+
+	// The gas particles come first, then their dark matter twins.
+	for (int asGas = 1; asGas >= 0; asGas--) {
+		const uint64_t skip = asGas ? 0 : np;
+		uint64_t       off  = 0;
+		do {
+			uint64_t num = (np - off < chunk) ? np - off : chunk;
+			generateICsCorePost_getPos(post, genics->data->boxsizeInMpch,
+			                           pos + 3 * off, num, asGas, buf);
+			stai = stai_new(buf, 3 * sizeof(fpv_t), 3 * sizeof(fpv_t));
+			gadget_writeBlockToCurrentFile(genics->out->gadget,
+			                               GADGETBLOCK_POS_, skip + off,
+			                               num, stai);
+			stai_del(&stai);
+			off += num;
+		} while (off < np);
+
+		stai = stai_new( partBunch_at(particles, 1, 0),
+		                 3 * sizeof(fpv_t), 3 * sizeof(fpv_t) );
+		gadget_writeBlockToCurrentFile(genics->out->gadget, GADGETBLOCK_VEL_,
+		                               skip, np, stai);
+		stai_del(&stai);
+
+		off = 0;
+		do {
+			uint64_t num = (np - off < chunk) ? np - off : chunk;
+			generateICsCorePost_getID(post, genics->mode->useLongIDs,
+			                          (const char *)partBunch_at(particles,
+			                                                     2, 0)
+			                          + off * sizeOfID,
+			                          num, asGas, buf);
+			stai = stai_new(buf, sizeOfID, sizeOfID);
+			gadget_writeBlockToCurrentFile(genics->out->gadget,
+			                               GADGETBLOCK_ID__, skip + off,
+			                               num, stai);
+			stai_del(&stai);
+			off += num;
+		} while (off < np);
+	}
+} // local_writeWithGas
+
+static void
+local_writeConstBlock(generateICs_t genics,
+                      gadgetBlock_t block,
+                      uint64_t      num,
+                      fpv_t         value,
+                      fpv_t         *buf,
+                      uint64_t      chunk)
+{
+	uint64_t off = 0;
+	stai_t   stai;
+
+	for (uint64_t i = 0; i < chunk; i++)
+		buf[i] = value;
+
+	stai = stai_new(buf, sizeof(fpv_t), sizeof(fpv_t));
+	do {
+		uint64_t n = (num - off < chunk) ? num - off : chunk;
+		gadget_writeBlockToCurrentFile(genics->out->gadget, block, off, n,
+		                               stai);
+		off += n;
+	} while (off < num);
+	stai_del(&stai);
+}
+
+static void
+local_calibrateCost(const generateICs_t genics, g9pICMapCost_t cost)
+{
+	FILE     *f;
+	uint32_t numSamples = 0, maxSamples = 64;
+	uint64_t *numCellsRead, *numParticles;
+	double   *seconds;
+	char     line[256];
+
+	if (genics->costModelFile == NULL)
+		return;
+	f = fopen(genics->costModelFile, "r");
+	if (f == NULL)
+		return;
+
+	numCellsRead = xmalloc(sizeof(uint64_t) * maxSamples);
+	numParticles = xmalloc(sizeof(uint64_t) * maxSamples);
+	seconds      = xmalloc(sizeof(double) * maxSamples);
+	while (fgets(line, 256, f) != NULL) {
+		uint32_t file;
+		if (line[0] == '#')
+			continue;
+		if (numSamples == maxSamples) {
+			maxSamples  *= 2;
+			numCellsRead = xrealloc(numCellsRead,
+			                        sizeof(uint64_t) * maxSamples);
+			numParticles = xrealloc(numParticles,
+			                        sizeof(uint64_t) * maxSamples);
+			seconds      = xrealloc(seconds, sizeof(double) * maxSamples);
+		}
+		if (sscanf(line, "%" SCNu32 " %" SCNu64 " %" SCNu64 " %lf", &file,
+		           numCellsRead + numSamples, numParticles + numSamples,
+		           seconds + numSamples) == 4)
+			numSamples++;
+	}
+	fclose(f);
+
+	if (g9pICMap_calibrateCost(cost, numSamples, numCellsRead,
+	                           numParticles, seconds) && genics->rank == 0)
+		printf("Cost model from %s: %g s per cell read, "
+		       "%g s per particle\n", genics->costModelFile,
+		       cost->perCellRead, cost->perParticle);
+
+	xfree(seconds);
+	xfree(numParticles);
+	xfree(numCellsRead);
+} // local_calibrateCost
+
+static void
+local_writeCostModelFile(const generateICs_t genics,
+                         const g9pICMap_t    map,
+                         const double        *seconds,
+                         bool                append)
+{
+	FILE     *f;
+	uint32_t numFiles
+	    = genics->out->numFilesForLevel[genics->zoomlevel
+	                                    - g9pMask_getMinLevel(genics->mask)];
+
+	if (genics->costModelFile == NULL)
+		return;
+	f = xfopen(genics->costModelFile, append ? "a" : "w");
+	if (!append)
+		fprintf(f, "# file  cellsRead  particles  seconds\n");
+	for (uint32_t i = 0; i < numFiles; i++) {
+		uint64_t numCellsRead, numParticles;
+		g9pICMap_getWorkInFile(map, i, &numCellsRead, &numParticles);
+		fprintf(f, "%" PRIu32 " %" PRIu64 " %" PRIu64 " %.6f\n", i,
+		        numCellsRead, numParticles, seconds[i]);
+	}
+	xfclose(&f);
+}
+
+static uint64_t *
+local_calcFileStartIDs(const generateICs_t genics,
+                       const g9pICMap_t    map,
+                       uint32_t            numFiles,
+                       uint64_t            startID)
+{
+	const uint32_t zoomIdx = genics->zoomlevel
+	                         - g9pMask_getMinLevel(genics->mask);
+	uint64_t       *fileStartID = xmalloc(sizeof(uint64_t) * (numFiles + 1));
+
+	fileStartID[0] = startID;
+	for (uint32_t i = 0; i < numFiles; i++)
+		fileStartID[i + 1] = fileStartID[i]
+		                     + g9pICMap_getNumCellsPerLevelInFile(map, i)[zoomIdx];
+
+	if (genics->mode->sequentialIDs && !genics->mode->useLongIDs
+	    && (fileStartID[numFiles] > (uint64_t)UINT32_MAX + 1)) {
+		fprintf(stderr, "FATAL:  %" PRIu64 " sequential IDs do not fit into "
+		        "32 bit, use doLongIDs.\n", fileStartID[numFiles]);
+		diediedie(EXIT_FAILURE);
+	}
+
+	return fileStartID;
+}
+
+/** @brief  Pairs a file with its cost for sorting. */
+struct local_fileCost_struct {
+	/** @brief  The cost of the file. */
+	double   cost;
+	/** @brief  The number of the file. */
+	uint32_t file;
+};
+
+static int
+local_cmpFilesByCost(const void *a, const void *b)
+{
+	const struct local_fileCost_struct *fa = a;
+	const struct local_fileCost_struct *fb = b;
+
+	if (fa->cost != fb->cost)
+		return (fa->cost > fb->cost) ? -1 : 1;
+
+	return (fa->file < fb->file) ? -1 : (fa->file > fb->file);
+}
+
+static uint32_t *
+local_getFilesByCost(const g9pICMap_t map, uint32_t numFiles)
+{
+	struct local_fileCost_struct *fc;
+	uint32_t                     *files = xmalloc(sizeof(uint32_t) * numFiles);
+
+	fc = xmalloc(sizeof(struct local_fileCost_struct) * numFiles);
+	for (uint32_t i = 0; i < numFiles; i++) {
+		fc[i].cost = g9pICMap_getCostOfFile(map, i);
+		fc[i].file = i;
+	}
+	qsort(fc, numFiles, sizeof(struct local_fileCost_struct),
+	      &local_cmpFilesByCost);
+	for (uint32_t i = 0; i < numFiles; i++)
+		files[i] = fc[i].file;
+	xfree(fc);
+
+	return files;
+}
@@ -79,6 +79,28 @@ generateICs_setData(generateICs_t genics, generateICsData_t data);
 extern void
 generateICs_setIn(generateICs_t genics, generateICsIn_t in);
 
+/**
+ * @brief  Sets the input for every level, all levels are then produced in
+ *         a single run.
+ *
+ * If the inputs are already set, the execution will fail.
+ *
+ * @param[in,out]  genics
+ *                    The application object to work with.  Passing @c NULL
+ *                    is undefined.
+ * @param[in]      in
+ *                    The array of inputs, one for each level from the
+ *                    minimum to the maximum level of the mask.  The
+ *                    application takes ownership of the inputs, but not of
+ *                    the array.
+ * @param[in]      s
+ *                    The array size.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+generateICs_setInForLevels(generateICs_t genics, generateICsIn_t *in, int s);
+
 extern void
 generateICs_setOut(generateICs_t genics, generateICsOut_t out);
 
@@ -166,6 +188,26 @@ generateICs_setShift(generateICs_t genics, gridPointDbl_t shift);
 extern void
 generateICs_setZoomLevel(generateICs_t genics, int32_t z);
 
+/**
+ * @brief  Sets the file keeping the timings used for the cost model.
+ *
+ * If the file exists when generateICs_run() starts, the cost model
+ * distributing the tiles onto the files is calibrated with the timings in
+ * it.  At the end of the run, the file is replaced with the timings of
+ * this run.
+ *
+ * @param[in,out]  genics
+ *                    The application object to work with.  Passing @c NULL
+ *                    is undefined.
+ * @param[in]      *fileName
+ *                    The name of the file, this may be @c NULL to disable
+ *                    the calibration.  A copy is made.
+ *
+ * @return  Returns nothing.
+ */
+extern void
+generateICs_setCostModelFile(generateICs_t genics, const char *fileName);
+
 /** @} */
 
 /**
@@ -35,6 +35,12 @@
 
 #define GENERATEICSCONFIG_DEFAULT_DOMASSBLOCK false
 
+/** @brief  Gives the default scheme for the IDs calculated from positions. */
+#define GENERATEICSCONFIG_DEFAULT_IDSCHEME "rowMajor"
+
+/** @brief  Gives the default for producing all levels in one run or not. */
+#define GENERATEICSCONFIG_DEFAULT_ALLLEVELS false
+
 /** @brief  Gives the default for re-centering to zoom region or not. */
 #define GENERATEICSCONFIG_DEFAULT_AUTOCENTER false
 
@@ -17,24 +17,89 @@
 #include "generateICsConfig.h"
 #include "generateICsCore.h"
 #include <assert.h>
+#include <stdlib.h>
 #include <string.h>
 #include "../../src/libutil/xmem.h"
-#include "../../src/libutil/lIdx.h"
 
 
 /*--- Local defines -----------------------------------------------------*/
 
 
+/*--- Local structures --------------------------------------------------*/
+
+/** @brief  Connects the key of a particle to its place in the tile. */
+struct local_keyIdx_struct {
+	/** @brief  The key of the particle. */
+	g9pID_t  key;
+	/** @brief  The index of the particle in the tile. */
+	uint64_t idx;
+};
+
+/** @brief  Short name for the key-index pair. */
+typedef struct local_keyIdx_struct local_keyIdx_s;
+
+
 /*--- Prototypes of local functions -------------------------------------*/
 
+/**
+ * @brief  Computes one position coordinate from the Lagrangian position
+ *         and the velocity.
+ *
+ * Uses type generic fmod, i.e. float MOD(float, float) or double
+ * MOD(double, double), depending on what fpv_t is.
+ */
+static inline fpv_t
+local_scale(generateICsCore_const_t d, fpv_t pos, fpv_t vel);
+
+
+/**
+ * @brief  Does generateICsCore_vel2pos(), generateICsCore_convertVel()
+ *         and the post-processing of the core in one sweep.
+ */
+static void
+local_vel2posPost(generateICsCore_const_t d);
+
+
+/**
+ * @brief  Sets the ID of one particle from its key or its running index.
+ */
+static inline void
+local_setID(generateICsCore_const_t d, uint64_t i, g9pID_t key);
+
+
+/**
+ * @brief  Sorts the particles of a tile along the space-filling curve and
+ *         sets their IDs in the new order.
+ */
+static void
+local_sortAlongCurve(generateICsCore_const_t d,
+                     local_keyIdx_s          *keys,
+                     uint64_t                numParticles);
+
+
+/** @brief  Compares two key-index pairs by their key, for qsort(). */
+static int
+local_cmpKeyIdx(const void *a, const void *b);
+
+
+/**
+ * @brief  Re-centers and scales one position.
+ */
+static inline void
+local_postPos(const generateICsCorePost_s *post, fpv_t box, fpv_t *pos);
+
 
 /*--- Implementations of exported functions -----------------------------*/
 extern void
 generateICsCore_toParticles(generateICsCore_const_t d)
 {
 	generateICsCore_initPosID(d);
-	generateICsCore_vel2pos(d);
-	generateICsCore_convertVel(d);
+	if (d->post == NULL) {
+		generateICsCore_vel2pos(d);
+		generateICsCore_convertVel(d);
+	} else {
+		local_vel2posPost(d);
+	}
 }
 
 extern void
@@ -46,8 +111,11 @@ generateICsCore_initPosID(generateICsCore_const_t d)
 	fpv_t             *velzP = gridPatch_getVarDataHandle(d->patch, 2);
 	const double      dx     = d->data->boxsizeInMpch / d->fullDims[0];
 	bool			  flg;
-	gridPointUint32_t maxDims3;
-	maxDims3[0]=d->maxDims; maxDims3[1]=d->maxDims; maxDims3[2]=d->maxDims;
+	// Along a space-filling curve the particles are sorted before the IDs
+	// are set, the row-major order is the order of the loops.
+	local_keyIdx_s    *keys  = NULL;
+	if (g9pIDGenerator_getScheme(d->idGen) != G9PIDGENERATOR_SCHEME_ROWMAJOR)
+		keys = xmalloc(sizeof(local_keyIdx_s) * d->numParticles);
 
 	gridPatch_getIdxLo(d->patch, idxLo);
 	gridPatch_getDims(d->patch, dims);
@@ -55,20 +123,33 @@ generateICsCore_initPosID(generateICsCore_const_t d)
 	printf("   Patch idxLo: (%u,%u,%u)\n", idxLo[0], idxLo[1], idxLo[2]);
 	printf("   Patch dims:  (%u,%u,%u)\n", dims[0], dims[1], dims[2]);
 
-	gridPointUint32_t p, q, pm;
+	gridPointUint32_t p, q;
 	uint64_t          i = 0;
-	uint64_t          iin = 0, idxM;
-	uint64_t		   patchMaskDim = (dims[0]*(d->maskDim1D))/(d->partDim1D);
+	uint64_t          iin = 0;
 	for (p[2] = idxLo[2]; p[2] < idxLo[2] + dims[2]; p[2]++) {
 		for (p[1] = idxLo[1]; p[1] < idxLo[1] + dims[1]; p[1]++) {
-			for (p[0] = idxLo[0]; p[0] < idxLo[0] + dims[0]; p[0]++) {
-				for(int j=0;j<3;j++) {
+			// The mask is walked along the runs of the row.
+			const int8_t   *runLevel = NULL;
+			const uint32_t *runEnd   = NULL;
+			uint32_t       numRuns   = 0, r = 0;
+			if (d->mask != NULL) {
+				for(int j=1;j<3;j++) {
 					q[j]=((p[j]-idxLo[j])*(d->maskDim1D))/(d->partDim1D);
 				}
-				idxM = q[0] + (q[1] + q[2]*patchMaskDim)*patchMaskDim;
-				
-				if(d->maskdata == NULL) flg = true;
-				else flg = (d->level == d->maskdata[idxM]);
+				numRuns = g9pMask_getRunsInTileRow(d->mask, d->tile, q[1], q[2],
+				                                   &runLevel, &runEnd);
+				if (numRuns == 1 && runLevel[0] != d->level) {
+					iin += dims[0];
+					continue;
+				}
+			}
+			for (p[0] = idxLo[0]; p[0] < idxLo[0] + dims[0]; p[0]++) {
+				if(d->mask == NULL) flg = true;
+				else {
+					q[0]=((p[0]-idxLo[0])*(d->maskDim1D))/(d->partDim1D);
+					while (q[0] >= runEnd[r]) r++;
+					flg = (d->level == runLevel[r]);
+				}
 				
 				if(flg) {
 					//printf(" %i/%i ",i,idxM);
@@ -78,20 +159,13 @@ generateICsCore_initPosID(generateICsCore_const_t d)
 					d->pos[i * 3]     = (fpv_t)( (p[0] + .5) * dx );
 					d->pos[i * 3 + 1] = (fpv_t)( (p[1] + .5) * dx );
 					d->pos[i * 3 + 2] = (fpv_t)( (p[2] + .5) * dx );
-					for(int k=0;k<3;k++) {
-						pm[k] = p[k]*((d->maxDims)/(d->partDim1D));
-					}
-					if (d->mode->useLongIDs) {
-						( (uint64_t *)(d->id) )[i] = lIdx_fromCoord3d(pm,
-						                                              maxDims3);
-						//printf("%lu\n",( (uint64_t *)(d->id))[i]);
+					g9pID_t key = g9pIDGenerator_calcID(d->idGen, p,
+					                                    (uint8_t)(d->level));
+					if (keys != NULL) {
+						keys[i].key = key;
+						keys[i].idx = i;
 					} else {
-						if (d->mode->sequentialIDs) {
-							( (uint32_t *)(d->id) )[i] = d->startID + i;
-						} else {
-							( (uint32_t *)(d->id) )[i] = lIdx_fromCoord3d(pm,
-						                                              maxDims3);
-						}
+						local_setID(d, i, key);
 					}
 					i++;
 				}
@@ -99,31 +173,27 @@ generateICsCore_initPosID(generateICsCore_const_t d)
 			}
 		}
 	}
+	if (keys != NULL) {
+		local_sortAlongCurve(d, keys, i);
+		xfree(keys);
+	}
 	d->startID += i;
 	//printf(" %i/%i ",i,idxM);
-} // generateICsCore_vel2pos
+} // generateICsCore_initPosID
 
 extern void
 generateICsCore_vel2pos(generateICsCore_const_t d)
 {
-// uses type generic fmod, i.e. float MOD(float, float) or
-// double MOD(double, double), depending on what fpv_t is
-#define SCALE(d, k)                                           \
-	( fmod( (fpv_t)( (d->pos[k] + d->data->vFact * d->vel[k]) \
-	                 * d->data->posFactor ),                  \
-	        (fpv_t)(d->data->boxsizeInMpch * d->data->posFactor) ) )
 #ifdef _OPENMP
 #  pragma omp parallel for
 #endif
 	for (uint64_t i = 0; i < d->numParticles; i++) {
-		d->pos[i * 3]     += (fpv_t)(d->data->boxsizeInMpch);
-		d->pos[i * 3]      = SCALE( d, (i * 3) );
-		d->pos[i * 3 + 1] += (fpv_t)(d->data->boxsizeInMpch);
-		d->pos[i * 3 + 1]  = SCALE( d, (i * 3 + 1) );
-		d->pos[i * 3 + 2] += (fpv_t)(d->data->boxsizeInMpch);
-		d->pos[i * 3 + 2]  = SCALE( d, (i * 3 + 2) );
+		for (int k = 0; k < 3; k++) {
+			d->pos[i * 3 + k] += (fpv_t)(d->data->boxsizeInMpch);
+			d->pos[i * 3 + k]  = local_scale(d, d->pos[i * 3 + k],
+			                                 d->vel[i * 3 + k]);
+		}
 	}
-#undef SCALE
 } // generateICsCore_vel2pos
 
 extern void
@@ -142,74 +212,166 @@ generateICsCore_convertVel(generateICsCore_const_t d)
 }
 
 extern void
-generateICsCode_dm2Gas(generateICsCore_const_t d,
-                       const double            gasOffset,
-                       const uint64_t          npGasTotal)
+generateICsCorePost_addRecenter(generateICsCorePost_s *post,
+                                double                boxsize,
+                                const float           *newCenter)
 {
-	const double shift     = d->data->boxsizeInMpch / d->fullDims[0]
-	                         * gasOffset;
-	uint64_t     npGasOrDM = d->numParticles / 2;
+	const fpv_t box = (fpv_t)boxsize;
 
-	printf("   Gas offset: %lf\n", shift);
-	printf("   Local gas particles: %lu\n", npGasOrDM);
-	printf("   Total gas particles: %lu\n", npGasTotal);
+	assert(post != NULL && newCenter != NULL);
+	assert(post->numRecenter < GENICSCOREPOST_MAX_RECENTER);
 
-	memcpy(d->pos + 3 * npGasOrDM, d->pos, sizeof(fpv_t) * 3 * npGasOrDM);
-	memcpy(d->vel + 3 * npGasOrDM, d->vel, sizeof(fpv_t) * 3 * npGasOrDM);
-	if (d->mode->useLongIDs) {
-		memcpy( (uint64_t *)(d->id) + npGasOrDM, d->id,
-		        sizeof(uint64_t) * npGasOrDM );
-	} else {
-		memcpy( (uint32_t *)(d->id) + npGasOrDM, d->id,
-		        sizeof(uint32_t) * npGasOrDM );
-	}
+	for (int k = 0; k < 3; k++)
+		post->recenter[post->numRecenter][k] = box / 2 - (newCenter[k] * box);
+	post->numRecenter++;
+}
+
+extern void
+generateICsCorePost_getPos(const generateICsCorePost_s *post,
+                           double                      boxsize,
+                           const fpv_t                 *pos,
+                           uint64_t                    num,
+                           bool                        asGas,
+                           fpv_t                       *out)
+{
+	const fpv_t box = (fpv_t)boxsize;
+
+	assert(post != NULL && pos != NULL && out != NULL);
 
 #ifdef _OPENMP
 #  pragma omp parallel for
 #endif
-	for (uint64_t i = 0; i < npGasOrDM; i++) {
-		d->pos[i * 3]     += shift;
-		d->pos[i * 3 + 1] += shift;
-		d->pos[i * 3 + 2] += shift;
+	for (uint64_t i = 0; i < num; i++) {
+		for (int k = 0; k < 3; k++) {
+			out[i * 3 + k] = pos[i * 3 + k];
+			if (asGas)
+				out[i * 3 + k] += post->gasShift;
+		}
+		local_postPos(post, box, out + i * 3);
 	}
-#ifdef _OPENMP
-#  pragma omp parallel for
-#endif
-	for (uint64_t i = npGasOrDM; i < d->numParticles; i++) {
-		if (d->mode->useLongIDs) {
-			( (uint64_t *)(d->id) )[i] += npGasTotal;
+}
+
+extern void
+generateICsCorePost_getID(const generateICsCorePost_s *post,
+                          bool                        useLongIDs,
+                          const void                  *id,
+                          uint64_t                    num,
+                          bool                        asGas,
+                          void                        *out)
+{
+	const uint64_t offset = asGas ? 0 : post->idOffset;
+
+	assert(post != NULL && id != NULL && out != NULL);
+
+	for (uint64_t i = 0; i < num; i++) {
+		if (useLongIDs) {
+			( (uint64_t *)out )[i] = ( (const uint64_t *)id )[i] + offset;
 		} else {
-			( (uint32_t *)(d->id) )[i] += (uint32_t)npGasTotal;
+			( (uint32_t *)out )[i] = ( (const uint32_t *)id )[i]
+			                         + (uint32_t)offset;
 		}
 	}
-} // generateICsCode_dm2Gas
+}
 
-extern void
-generateICsCore_recenter(generateICsCore_const_t d, float* newCenter) {
-	fpv_t box = (fpv_t)(d->data->boxsizeInMpch);
+/*--- Implementations of local functions --------------------------------*/
+static inline fpv_t
+local_scale(generateICsCore_const_t d, fpv_t pos, fpv_t vel)
+{
+	return fmod( (fpv_t)( (pos + d->data->vFact * vel)
+	                      * d->data->posFactor ),
+	             (fpv_t)(d->data->boxsizeInMpch * d->data->posFactor) );
+}
+
+static void
+local_vel2posPost(generateICsCore_const_t d)
+{
+	const generateICsCorePost_s *post = d->post;
+	const fpv_t                 box   = (fpv_t)(d->data->boxsizeInMpch);
+
+	assert(!post->doGas);
+	const fpv_t                 fac   = d->data->velFactor
+	                                    / sqrt(d->data->aInit);
+
+	// Every particle is finished while it is in cache, instead of
+	// sweeping over all particles once per step.
 #ifdef _OPENMP
 #  pragma omp parallel for
 #endif
 	for (uint64_t i = 0; i < d->numParticles; i++) {
-		for(int k = 0; k<3; k++) {
-			d->pos[i*3 + k] += box/2 - (newCenter[k]*box);
-			if(d->pos[i*3 + k] > box) d->pos[i*3 + k] -= box;
-			if(d->pos[i*3 + k] < 0) d->pos[i*3 + k] += box;
+		fpv_t *pos = d->pos + i * 3;
+		fpv_t *vel = d->vel + i * 3;
+
+		for (int k = 0; k < 3; k++) {
+			pos[k] += box;
+			pos[k]  = local_scale(d, pos[k], vel[k]);
+			vel[k] *= fac;
+		}
+		local_postPos(post, box, pos);
+	}
+} // local_vel2posPost
+
+static inline void
+local_setID(generateICsCore_const_t d, uint64_t i, g9pID_t key)
+{
+	if (d->mode->useLongIDs) {
+		( (uint64_t *)(d->id) )[i] = key;
+	} else {
+		if (d->mode->sequentialIDs) {
+			( (uint32_t *)(d->id) )[i] = d->startID + i;
+		} else {
+			( (uint32_t *)(d->id) )[i] = key;
 		}
 	}
 }
 
-extern void
-generateICsCore_kpc(generateICsCore_const_t d) {
-#ifdef _OPENMP
-#  pragma omp parallel for
-#endif
-        for (uint64_t i = 0; i < d->numParticles; i++) {
-                for(int k = 0; k<3; k++) {
-                        d->pos[i*3 + k] *= 1000;
-                }
-        }
+static void
+local_sortAlongCurve(generateICsCore_const_t d,
+                     local_keyIdx_s          *keys,
+                     uint64_t                numParticles)
+{
+	fpv_t *tmp = xmalloc(sizeof(fpv_t) * 3 * numParticles);
+
+	qsort(keys, numParticles, sizeof(local_keyIdx_s), &local_cmpKeyIdx);
+
+	for (uint64_t i = 0; i < numParticles; i++)
+		for (int k = 0; k < 3; k++)
+			tmp[i * 3 + k] = d->pos[keys[i].idx * 3 + k];
+	memcpy(d->pos, tmp, sizeof(fpv_t) * 3 * numParticles);
+
+	for (uint64_t i = 0; i < numParticles; i++)
+		for (int k = 0; k < 3; k++)
+			tmp[i * 3 + k] = d->vel[keys[i].idx * 3 + k];
+	memcpy(d->vel, tmp, sizeof(fpv_t) * 3 * numParticles);
 
+	for (uint64_t i = 0; i < numParticles; i++)
+		local_setID(d, i, keys[i].key);
+
+	xfree(tmp);
 }
 
-/*--- Implementations of local functions --------------------------------*/
+static int
+local_cmpKeyIdx(const void *a, const void *b)
+{
+	const g9pID_t keyA = ((const local_keyIdx_s *)a)->key;
+	const g9pID_t keyB = ((const local_keyIdx_s *)b)->key;
+
+	return (keyA > keyB) - (keyA < keyB);
+}
+
+static inline void
+local_postPos(const generateICsCorePost_s *post, fpv_t box, fpv_t *pos)
+{
+	for (int s = 0; s < post->numRecenter; s++) {
+		for (int k = 0; k < 3; k++) {
+			pos[k] += post->recenter[s][k];
+			if (pos[k] > box)
+				pos[k] -= box;
+			if (pos[k] < 0)
+				pos[k] += box;
+		}
+	}
+	if (post->scale != FPV_C(1.0)) {
+		for (int k = 0; k < 3; k++)
+			pos[k] *= post->scale;
+	}
+}
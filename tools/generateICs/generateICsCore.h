@@ -17,9 +17,59 @@
 
 /*--- Includes ----------------------------------------------------------*/
 #include "generateICsConfig.h"
+#include <stdbool.h>
 #include "generateICsData.h"
 #include "generateICsMode.h"
 #include "../../src/libgrid/gridPatch.h"
+#include "../../src/libg9p/g9pMask.h"
+#include "../../src/libg9p/g9pIDGenerator.h"
+
+
+/*--- Exported defines --------------------------------------------------*/
+
+/** @brief  The maximal number of re-centerings of the positions. */
+#define GENICSCOREPOST_MAX_RECENTER 2
+
+
+/*--- Post-processing of the particles ----------------------------------*/
+
+/**
+ * @brief  Describes what happens to the particles after the positions
+ *         have been computed.
+ *
+ * The steps are applied in this order: making gas particles, re-centering
+ * (each step followed by a periodic wrap) and scaling the positions.
+ *
+ * Without gas the steps are done in place by generateICsCore_toParticles().
+ * With gas every particle yields a gas and a dark matter particle, which
+ * are only formed when writing them with generateICsCorePost_getPos() and
+ * generateICsCorePost_getID().
+ */
+struct generateICsCorePost_struct {
+	/** @brief  Whether every particle also yields a gas particle. */
+	bool     doGas;
+	/** @brief  The shift of the gas particles. */
+	double   gasShift;
+	/** @brief  Added to the IDs of the dark matter particles with gas. */
+	uint64_t idOffset;
+	/** @brief  The number of re-centering steps. */
+	int      numRecenter;
+	/** @brief  The shifts of the re-centering steps. */
+	fpv_t    recenter[GENICSCOREPOST_MAX_RECENTER][3];
+	/** @brief  The final factor applied to the positions. */
+	fpv_t    scale;
+};
+
+typedef struct generateICsCorePost_struct generateICsCorePost_s;
+
+#define GENICSCOREPOST_INIT_STRUCT \
+	{                              \
+		.doGas       = false,      \
+		.gasShift    = 0.,         \
+		.idOffset    = 0,          \
+		.numRecenter = 0,          \
+		.scale       = FPV_C(1.0), \
+	}
 
 
 /*--- Simple structure easing the data passing --------------------------*/
@@ -36,8 +86,10 @@ struct generateICsCore_struct {
 	uint32_t				maskDim1D;
 	uint32_t				partDim1D;
 	int8_t					level;
-	int8_t					*maskdata;
-	uint64_t				maxDims;
+	g9pMask_t				mask;
+	uint32_t				tile;
+	g9pIDGenerator_t		idGen;
+	const generateICsCorePost_s *post;
 };
 
 typedef struct generateICsCore_struct        generateICsCore_s;
@@ -45,7 +97,6 @@ typedef struct generateICsCore_struct        *generateICsCore_t;
 typedef struct generateICsCore_struct *const generateICsCore_const_t;
 
 
-/*--- Exported defines --------------------------------------------------*/
 #define GENICSCORE_INIT_STRUCT(d, m) \
 	{                                \
 		.patch = NULL,               \
@@ -55,11 +106,13 @@ typedef struct generateICsCore_struct *const generateICsCore_const_t;
 		.data  = (d),                \
 		.mode  = (m),                \
 		.level = 0,					 \
-		.maskdata =	NULL,			 \
+		.mask = NULL,				 \
+		.tile = 0,					 \
 		.startID = 0,				 \
 		.maskDim1D = 0,				 \
 		.partDim1D = 0,				 \
-		.maxDims = 0,				 \
+		.idGen = NULL,				 \
+		.post = NULL,				 \
 	}
 
 
@@ -76,16 +129,76 @@ generateICsCore_vel2pos(generateICsCore_const_t d);
 extern void
 generateICsCore_convertVel(generateICsCore_const_t d);
 
+/**
+ * @brief  Adds a re-centering step to the post-processing.
+ *
+ * @param[in,out]  post
+ *                    The post-processing to extend.
+ * @param[in]      boxsize
+ *                    The size of the box, which is also the period of the
+ *                    wrapping.
+ * @param[in]      newCenter
+ *                    The position moved to the center of the box, in units
+ *                    of the box size.
+ *
+ * @return  Returns nothing.
+ */
 extern void
-generateICsCode_dm2Gas(generateICsCore_const_t d,
-                       const double            gasOffset,
-                       const uint64_t          npGasTotal);
-                       
+generateICsCorePost_addRecenter(generateICsCorePost_s *post,
+                                double                boxsize,
+                                const float           *newCenter);
+
+/**
+ * @brief  Computes the final positions of gas or dark matter particles.
+ *
+ * @param[in]   post
+ *                 The post-processing to apply.
+ * @param[in]   boxsize
+ *                 The size of the box.
+ * @param[in]   pos
+ *                 The positions as computed by generateICsCore_toParticles().
+ * @param[in]   num
+ *                 The number of particles.
+ * @param[in]   asGas
+ *                 Whether to compute the positions of the gas particles.
+ * @param[out]  out
+ *                 Receives the @c 3 * @c num final coordinates.
+ *
+ * @return  Returns nothing.
+ */
 extern void
-generateICsCore_recenter(generateICsCore_const_t d, float* newCenter);
+generateICsCorePost_getPos(const generateICsCorePost_s *post,
+                           double                      boxsize,
+                           const fpv_t                 *pos,
+                           uint64_t                    num,
+                           bool                        asGas,
+                           fpv_t                       *out);
 
+/**
+ * @brief  Computes the IDs of gas or dark matter particles.
+ *
+ * @param[in]   post
+ *                 The post-processing to apply.
+ * @param[in]   useLongIDs
+ *                 Whether the IDs are 64 bit.
+ * @param[in]   id
+ *                 The IDs as computed by generateICsCore_toParticles().
+ * @param[in]   num
+ *                 The number of particles.
+ * @param[in]   asGas
+ *                 Whether to compute the IDs of the gas particles.
+ * @param[out]  out
+ *                 Receives the @c num IDs.
+ *
+ * @return  Returns nothing.
+ */
 extern void
-generateICsCore_kpc(generateICsCore_const_t d);
+generateICsCorePost_getID(const generateICsCorePost_s *post,
+                          bool                        useLongIDs,
+                          const void                  *id,
+                          uint64_t                    num,
+                          bool                        asGas,
+                          void                        *out);
 
 /*--- Doxygen group definitions -----------------------------------------*/
 
@@ -36,6 +36,7 @@
 #include "../../src/libcosmo/cosmoModel.h"
 #include "../../src/libg9p/g9pHierarchy.h"
 #include "../../src/libg9p/g9pHierarchyIO.h"
+#include "../../src/libg9p/g9pIDGenerator.h"
 #include "../../src/libg9p/g9pDataStore.h"
 #include "../../src/libg9p/g9pMask.h"
 #include "../../src/libg9p/g9pMaskIO.h"
@@ -65,6 +66,8 @@ struct generateICs_IniData_struct {
 	bool   sequentialIDs;
 	/** @brief  Stores key @c doMassBlock. */
 	bool   doMassBlock;
+	/** @brief  Stores key @c idScheme. */
+	g9pIDGeneratorScheme_t idScheme;
 	/** @brief  Stores key @c ginnungagapSection. */
 	char   *g9pSection;
 	/** @brief  Stores key @c inputSection. */
@@ -200,6 +203,13 @@ inline static void
 local_iniDataNewFromIni_doMassBlock(generateICs_iniData_t iniData,
                                   parse_ini_t           ini,
                                   const char            *secName);
+
+/** @copydoc local_iniDataNewFromIni_boxsize() */
+inline static void
+local_iniDataNewFromIni_idScheme(generateICs_iniData_t iniData,
+                                 parse_ini_t           ini,
+                                 const char            *secName);
+
 /**
  * @brief  Helper function for generateICsFactory_newFromIni() dealing with
  *         the input.
@@ -219,6 +229,34 @@ local_newFromIni_input(parse_ini_t   ini,
                        const char    *secName,
                        generateICs_t genics);
 
+/**
+ * @brief  Helper function for generateICsFactory_newFromIni() dealing with
+ *         the input of all levels.
+ *
+ * The sections of the velocities of level @c i are given by the keys
+ * @c velxSection<i>, @c velySection<i> and @c velzSection<i>.
+ *
+ * @param[in,out]  ini
+ *                    The ini file to work with.
+ * @param[in]      *secName
+ *                    The name of the section from which to construct the
+ *                    input details.
+ * @param[in,out]  genics
+ *                    The object to work with.
+ * @param[in]      minlev
+ *                    The minimum level of the mask.
+ * @param[in]      maxlev
+ *                    The maximum level of the mask.
+ *
+ * @return  Returns nothing.
+ */
+inline static void
+local_newFromIni_inputLevels(parse_ini_t   ini,
+                             const char    *secName,
+                             generateICs_t genics,
+                             int32_t       minlev,
+                             int32_t       maxlev);
+
 
 /**
  * @brief  Helper function for generateICsFactory_newFromIni() dealing with
@@ -253,6 +291,7 @@ generateICsFactory_newFromIni(parse_ini_t ini, const char *sectionName)
 	char 		tname[50];
 	int32_t	minlev, maxlev;
 	double* shift;
+	bool    allLevels;
 
 	assert(ini != NULL);
 
@@ -264,7 +303,8 @@ generateICsFactory_newFromIni(parse_ini_t ini, const char *sectionName)
 
 	generateICsMode_t mode;
 	mode = generateICsMode_new(iniData->doGas, iniData->doLongIDs, iniData->autoCenter, 
-	                           iniData->kpc,iniData->sequentialIDs, iniData->doMassBlock);
+	                           iniData->kpc,iniData->sequentialIDs, iniData->doMassBlock,
+	                           iniData->idScheme);
 	generateICs_setMode(genics, mode);
 
 	generateICsData_t data;
@@ -290,18 +330,36 @@ generateICsFactory_newFromIni(parse_ini_t ini, const char *sectionName)
 	minlev = g9pMask_getMinLevel(mask);
 	maxlev = g9pMask_getMaxLevel(mask);
 
-	local_newFromIni_input(ini, iniData->inputSection, genics);
+	if (!parse_ini_get_bool(ini, "allLevels",
+	                        (sectionName != NULL) ? sectionName :
+	                        GENERATEICSCONFIG_DEFAULT_SECTIONNAME,
+	                        &allLevels))
+		allLevels = GENERATEICSCONFIG_DEFAULT_ALLLEVELS;
+
+	if (allLevels)
+		local_newFromIni_inputLevels(ini, iniData->inputSection, genics,
+		                             minlev, maxlev);
+	else
+		local_newFromIni_input(ini, iniData->inputSection, genics);
 	local_newFromIni_output(ini, iniData->outputSection, genics,minlev,maxlev);
 
 	local_iniDataDel(&iniData);
 	
-	getFromIni(
-	&(zlevel),
-	parse_ini_get_int32,
-	ini,
-	"zoomLevel",
-		        (sectionName != NULL) ? sectionName :
-	                                  GENERATEICSCONFIG_DEFAULT_SECTIONNAME);
+	if (allLevels) {
+		if (!parse_ini_get_int32(ini, "zoomLevel",
+		                         (sectionName != NULL) ? sectionName :
+		                         GENERATEICSCONFIG_DEFAULT_SECTIONNAME,
+		                         &zlevel))
+			zlevel = minlev;
+	} else {
+		getFromIni(
+		&(zlevel),
+		parse_ini_get_int32,
+		ini,
+		"zoomLevel",
+			        (sectionName != NULL) ? sectionName :
+		                                  GENERATEICSCONFIG_DEFAULT_SECTIONNAME);
+	}
 	generateICs_setZoomLevel(genics,zlevel);
 	
 	int32_t  TypeForLevel [maxlev-minlev+1];
@@ -323,6 +381,15 @@ generateICsFactory_newFromIni(parse_ini_t ini, const char *sectionName)
 		}
 	}
 	generateICs_setShift(genics, shift);
+
+	char *costModelFile;
+	if (parse_ini_get_string(ini, "costModelFile",
+	                         (sectionName != NULL) ? sectionName :
+	                         GENERATEICSCONFIG_DEFAULT_SECTIONNAME,
+	                         &costModelFile)) {
+		generateICs_setCostModelFile(genics, costModelFile);
+		xfree(costModelFile);
+	}
 	
 	return genics;
 } // generateICsFactory_newFromIni
@@ -343,6 +410,7 @@ local_iniDataNewFromIni(parse_ini_t ini, const char *sectionName)
 	local_iniDataNewFromIni_kpc(iniData, ini, sectionName);
 	local_iniDataNewFromIni_sequentialIDs(iniData, ini, sectionName);
 	local_iniDataNewFromIni_doMassBlock(iniData, ini, sectionName);
+	local_iniDataNewFromIni_idScheme(iniData, ini, sectionName);
 	local_iniDataNewFromIni_section(iniData, ini, sectionName);
 
 	local_iniDataNewFromIni_boxsize(iniData, ini, iniData->g9pSection);
@@ -361,6 +429,7 @@ local_iniDataInit(generateICs_iniData_t iniData)
 	iniData->doLongIDs        = false;
 	iniData->sequentialIDs    = true;
 	iniData->doMassBlock      = false;
+	iniData->idScheme         = G9PIDGENERATOR_SCHEME_ROWMAJOR;
 	iniData->g9pSection       = NULL;
 	iniData->inputSection     = NULL;
 	iniData->outputSection    = NULL;
@@ -480,6 +549,27 @@ local_iniDataNewFromIni_doMassBlock(generateICs_iniData_t iniData,
 	}
 }
 
+inline static void
+local_iniDataNewFromIni_idScheme(generateICs_iniData_t iniData,
+                                 parse_ini_t           ini,
+                                 const char            *secName)
+{
+	char *name;
+
+	assert(iniData != NULL);
+	assert(ini != NULL);
+	assert(secName != NULL);
+
+	if ( !parse_ini_get_string( ini, "idScheme", secName, &name ) )
+		name = xstrdup(GENERATEICSCONFIG_DEFAULT_IDSCHEME);
+	iniData->idScheme = g9pIDGenerator_getSchemeFromName(name);
+	if (iniData->idScheme == G9PIDGENERATOR_SCHEME_UNKNOWN) {
+		fprintf(stderr, "ID scheme %s unknown\n", name);
+		diediedie(EXIT_FAILURE);
+	}
+	xfree(name);
+}
+
 inline static void
 local_iniDataNewFromIni_autoCenter(generateICs_iniData_t iniData,
                                   parse_ini_t           ini,
@@ -584,6 +674,31 @@ local_newFromIni_input(parse_ini_t   ini,
 	                   generateICsIn_new(reader[0], reader[1], reader[2]) );
 }
 
+inline static void
+local_newFromIni_inputLevels(parse_ini_t   ini,
+                             const char    *secName,
+                             generateICs_t genics,
+                             int32_t       minlev,
+                             int32_t       maxlev)
+{
+	char            *name;
+	char            tname[50];
+	gridReader_t    reader[3];
+	generateICsIn_t in[maxlev - minlev + 1];
+
+	for (int32_t i = minlev; i <= maxlev; i++) {
+		for (int j = 0; j < 3; j++) {
+			sprintf(tname, "vel%cSection%" PRIi32, 'x' + j, i);
+			getFromIni(&name, parse_ini_get_string, ini, tname, secName);
+			reader[j] = gridReaderFactory_newReaderFromIni(ini, name);
+			xfree(name);
+		}
+		in[i - minlev] = generateICsIn_new(reader[0], reader[1], reader[2]);
+	}
+
+	generateICs_setInForLevels(genics, in, maxlev - minlev + 1);
+}
+
 void
 local_doPatch(parse_ini_t ini, const char *sectionName, gridReader_t reader)
 {
@@ -29,7 +29,8 @@
 /*--- Implementations of exported functions -----------------------------*/
 extern generateICsMode_t
 generateICsMode_new(const bool doGas, const bool useLongIDs, const bool autoCenter, const bool kpc,
-                    const bool sequentialIDs, const bool doMassBlock)
+                    const bool sequentialIDs, const bool doMassBlock,
+                    const g9pIDGeneratorScheme_t idScheme)
 {
 	generateICsMode_t             mode;
 	struct generateICsMode_struct tmp = {
@@ -38,7 +39,8 @@ generateICsMode_new(const bool doGas, const bool useLongIDs, const bool autoCent
 		.autoCenter = autoCenter,
 		.kpc = kpc,
 		.sequentialIDs = sequentialIDs,
-		.doMassBlock = doMassBlock
+		.doMassBlock = doMassBlock,
+		.idScheme = idScheme
 	};
 
 	mode = xmalloc( sizeof(struct generateICsMode_struct) );
@@ -18,6 +18,7 @@
 /*--- Includes ----------------------------------------------------------*/
 #include "generateICsConfig.h"
 #include <stdbool.h>
+#include "../../src/libg9p/g9pIDGenerator.h"
 
 
 /*--- ADT handle --------------------------------------------------------*/
@@ -32,13 +33,16 @@ struct generateICsMode_struct {
 	const bool kpc;
 	const bool sequentialIDs;
 	const bool doMassBlock;
+	/** @brief  The order of the particles and of their IDs in a tile. */
+	const g9pIDGeneratorScheme_t idScheme;
 };
 
 
 /*--- Prototypes of exported functions ----------------------------------*/
 extern generateICsMode_t
 generateICsMode_new(const bool doGas, const bool useLongIDs, const bool autoCenter, 
-                    const bool kpc, const bool sequentialIDs, const bool doMassBlock);
+                    const bool kpc, const bool sequentialIDs, const bool doMassBlock,
+                    const g9pIDGeneratorScheme_t idScheme);
 
 extern void
 generateICsMode_del(generateICsMode_t *mode);
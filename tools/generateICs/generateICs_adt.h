@@ -56,12 +56,25 @@ struct generateICs_struct {
 
 	/** @brief  Stores the input information. */
 	generateICsIn_t in;
+	/**
+	 * @brief  Stores the input information for every level from the
+	 *         minimum to the maximum level of the mask, may be NULL.
+	 *
+	 * If this is set, all levels are produced in one run and #in is not
+	 * used.
+	 */
+	generateICsIn_t *inForLevel;
+	/** @brief  Stores the number of elements in #inForLevel. */
+	int             numInForLevel;
 	/** @brief  Stores the output information. */
 	generateICsOut_t out;
 	
 	int32_t zoomlevel;
 	int32_t *typeForLevel;
 	double *shift;
+
+	/** @brief  Stores the file with the timings of the files, may be NULL. */
+	char *costModelFile;
 };
 
 
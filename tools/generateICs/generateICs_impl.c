@@ -50,6 +50,23 @@ generateICs_setIn(generateICs_t genics, generateICsIn_t in)
 	genics->in = in;
 }
 
+extern void
+generateICs_setInForLevels(generateICs_t genics, generateICsIn_t *in, int s)
+{
+	assert(genics != NULL);
+	assert(in != NULL && s > 0);
+
+	if (genics->inForLevel != NULL) {
+		fprintf(stderr, "ERROR: The inputs for levels can only be set once.\n");
+		diediedie(EXIT_FAILURE);
+	}
+
+	genics->inForLevel    = xmalloc(sizeof(generateICsIn_t) * s);
+	genics->numInForLevel = s;
+	for (int i = 0; i < s; i++)
+		genics->inForLevel[i] = in[i];
+}
+
 extern void
 generateICs_setOut(generateICs_t genics, generateICsOut_t out)
 {
@@ -125,6 +142,16 @@ generateICs_setShift(generateICs_t genics, double* shift)
 	}
 }
 
+extern void
+generateICs_setCostModelFile(generateICs_t genics, const char *fileName)
+{
+	assert(genics != NULL);
+
+	if (genics->costModelFile != NULL)
+		xfree(genics->costModelFile);
+	genics->costModelFile = (fileName != NULL) ? xstrdup(fileName) : NULL;
+}
+
 /*--- Exported function: Getter -----------------------------------------*/
 extern g9pHierarchy_t
 generateICs_getHierarchy(const generateICs_t genics)
@@ -30,6 +30,7 @@
 #include "../../src/libutil/xstring.h"
 #include "../../src/libutil/cmdline.h"
 #include "../../src/libutil/parse_ini.h"
+#include "../../src/libutil/profile.h"
 
 
 /*--- Local variables ---------------------------------------------------*/
@@ -43,6 +44,9 @@ static char *local_iniFileName = NULL;
 /** @brief  Stores the section name from which to parse the setup. */
 static char *local_sectionName = NULL;
 
+/** @brief  Stores the name of the file receiving the timing profile. */
+static char *local_profileFileName = NULL;
+
 /** @brief  Stores the position of the various elements in the cmdline. */
 struct local_cmdlinePos {
 	/** @brief  The position for #local_iniFileName. */
@@ -53,6 +57,8 @@ struct local_cmdlinePos {
 	int version;
 	/** @brief  The position for #local_sectionName. */
 	int sectionName;
+	/** @brief  The position for #local_profileFileName. */
+	int profileFileName;
 } local_cmdlinePos;
 
 
@@ -90,7 +96,13 @@ main(int argc, char **argv)
 
 	genics = local_getGenerateICs();
 	generateICs_run(genics);
+	if (local_profileFileName != NULL)
+		profile_report(local_profileFileName);
+#ifdef XMEM_TRACK_MEM
+	xmem_infoGlobal(stdout);
+#endif
 	generateICs_del(&genics);
+	profile_reset();
 
 	return EXIT_SUCCESS;
 }
@@ -112,6 +124,9 @@ local_initEnvironment(int *argc, char ***argv)
 	if (cmdline_checkOptSetByNum(cmdline, local_cmdlinePos.sectionName))
 		cmdline_getOptValueByNum(cmdline, local_cmdlinePos.sectionName,
 		                         &local_sectionName);
+	if (cmdline_checkOptSetByNum(cmdline, local_cmdlinePos.profileFileName))
+		cmdline_getOptValueByNum(cmdline, local_cmdlinePos.profileFileName,
+		                         &local_profileFileName);
 	cmdline_del(&cmdline);
 }
 
@@ -137,6 +152,8 @@ local_finalMessage(void)
 		xfree(local_iniFileName);
 	if (local_sectionName != NULL)
 		xfree(local_sectionName);
+	if (local_profileFileName != NULL)
+		xfree(local_profileFileName);
 #ifdef XMEM_TRACK_MEM
 	printf("\n");
 	xmem_info(stdout);
@@ -160,7 +177,7 @@ local_cmdlineSetup(void)
 {
 	cmdline_t cmdline;
 
-	cmdline = cmdline_new(1, 3, local_thisProgramName);
+	cmdline = cmdline_new(1, 4, local_thisProgramName);
 
 	local_cmdlinePos.version
 	        = cmdline_addOpt(cmdline, "version",
@@ -174,6 +191,11 @@ local_cmdlineSetup(void)
 	    = cmdline_addOpt(cmdline, "section",
 	                     "Gives the section in the ini file to use.",
 	                     false, CMDLINE_TYPE_STRING);
+	local_cmdlinePos.profileFileName
+	    = cmdline_addOpt(cmdline, "profile",
+	                     "Writes a timing profile of the run to the given "
+	                     "file (JSON if it ends in .json, CSV otherwise).",
+	                     true, CMDLINE_TYPE_STRING);
 	local_cmdlinePos.iniFileName
 	    = cmdline_addArg(cmdline,
 	                     "Gives the name of the configuration file.",
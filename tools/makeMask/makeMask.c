@@ -31,6 +31,15 @@
 #include "makeMask_adt.h"
 
 
+/*--- Local defines -----------------------------------------------------*/
+
+/**
+ * @brief  The number of cells per dimension of the tiles in which the
+ *         mask is marked in parallel.
+ */
+#define LOCAL_TILE_DIM1D 32
+
+
 /*--- Prototypes of local functions -------------------------------------*/
 
 /**
@@ -76,6 +85,11 @@ local_createEmptyMask(makeMask_t mama);
  * @brief  Helper function to tag the level at which each cell of the mask
  *         should be generated.
  *
+ * The local patch is split into tiles of #LOCAL_TILE_DIM1D cells per
+ * dimension and the lare elements are sorted into the tiles their shape
+ * touches (an element is put into every tile it touches).  The tiles are
+ * then marked in parallel, each only writing its own cells.
+ *
  * @param[in,out]  mama
  *                    The makeMask object to work with.
  *
@@ -85,6 +99,76 @@ inline static void
 local_markRegions(makeMask_t mama);
 
 
+/**
+ * @brief  Finds the tiles the shape of an element touches in every
+ *         dimension.
+ *
+ * @param[in]   element
+ *                 The element in grid coordinates.
+ * @param[in]   shapeExtent
+ *                 The number of cells of the shape on either side of the
+ *                 element.
+ * @param[in]   idxLo
+ *                 The starting index of the local patch.
+ * @param[in]   dimsPatch
+ *                 The extent of the local patch.
+ * @param[in]   dimsGrid
+ *                 The extent of the grid.
+ * @param[out]  tiles
+ *                 Receives the tile coordinates per dimension, each row
+ *                 must have room for 2 * @c shapeExtent + 1 entries.
+ * @param[out]  numTiles
+ *                 Receives the number of touched tiles per dimension,
+ *                 this is 0 if the shape misses the local patch.
+ *
+ * @return  Returns nothing.
+ */
+inline static void
+local_getTilesOfElement(const gridPointUint32_t element,
+                        int32_t                 shapeExtent,
+                        const gridPointUint32_t idxLo,
+                        const gridPointUint32_t dimsPatch,
+                        const gridPointUint32_t dimsGrid,
+                        uint32_t                **tiles,
+                        uint32_t                *numTiles);
+
+
+/**
+ * @brief  Sorts the lare elements into the tiles of the local patch.
+ *
+ * This is a counting sort on the tile index, elements touching several
+ * tiles appear in every one of them.
+ *
+ * @param[in]   mama
+ *                 The makeMask object to work with.
+ * @param[in]   shapeExtent
+ *                 The number of cells of the shape on either side of an
+ *                 element.
+ * @param[in]   idxLo
+ *                 The starting index of the local patch.
+ * @param[in]   dimsPatch
+ *                 The extent of the local patch.
+ * @param[in]   dimsGrid
+ *                 The extent of the grid.
+ * @param[in]   numTilesPerDim
+ *                 The number of tiles per dimension.
+ * @param[out]  **binStart
+ *                 Receives an array of the number of tiles plus one
+ *                 entries, giving the first element of each tile in the
+ *                 returned array.
+ *
+ * @return  Returns the element indices sorted by tile.
+ */
+inline static uint32_t *
+local_binElements(const makeMask_t        mama,
+                  int32_t                 shapeExtent,
+                  const gridPointUint32_t idxLo,
+                  const gridPointUint32_t dimsPatch,
+                  const gridPointUint32_t dimsGrid,
+                  const gridPointUint32_t numTilesPerDim,
+                  uint64_t                **binStart);
+
+
 /**
  * @brief  Helper function to write the mask to disk.
  *
@@ -155,6 +239,12 @@ local_createDegradeShape(uint32_t shapeDim1D);
  *                    The starting index of the patch of the calling
  *                    function, this is required to be able to convert patch
  *                    coordinates to grid coordinates.
+ * @param[in]      tileLo
+ *                    The first cell (in patch coordinates) that may be
+ *                    written.
+ * @param[in]      tileHi
+ *                    One past the last cell (in patch coordinates) that
+ *                    may be written.
  * @param[in]      dimsPatch
  *                    The extent of the patch.
  * @param[in]      dimsGrid
@@ -168,6 +258,8 @@ local_throwShapeOnMask(int8_t                  *restrict maskData,
                        const uint8_t           *restrict shape,
                        uint32_t                shapeDim1D,
                        const gridPointUint32_t idxLo,
+                       const gridPointUint32_t tileLo,
+                       const gridPointUint32_t tileHi,
                        const gridPointUint32_t dimsPatch,
                        const gridPointUint32_t dimsGrid);
 
@@ -293,11 +385,14 @@ local_createEmptyMask(makeMask_t mama)
 inline static void
 local_markRegions(makeMask_t mama)
 {
-	gridPointUint32_t dimsGrid, dimsPatch, idxLo;
+	gridPointUint32_t dimsGrid, dimsPatch, idxLo, numTilesPerDim;
 	gridPatch_t       patch;
 	int8_t            *maskData;
 	uint32_t          shapeDim1D;
 	uint8_t           *shape;
+	uint32_t          *bins;
+	uint64_t          *binStart;
+	uint64_t          numTiles = 1;
 
 	gridRegular_getDims(mama->grid, dimsGrid);
 	patch = gridRegular_getPatchHandle(mama->grid, 0);
@@ -308,14 +403,141 @@ local_markRegions(makeMask_t mama)
 	shapeDim1D = 2 * (mama->setup->numLevels - 2) + 1;
 	shape      = local_createDegradeShape(shapeDim1D);
 
-	for (uint32_t i = 0; i < lare_getNumElements(mama->setup->lare); i++) {
-		gridPointUint32_t element;
-		lare_getElement(mama->setup->lare, element, i);
-		local_throwShapeOnMask(maskData, element, shape, shapeDim1D,
-		                       idxLo, dimsPatch, dimsGrid);
+	for (int i = 0; i < NDIM; i++) {
+		numTilesPerDim[i] = (dimsPatch[i] + LOCAL_TILE_DIM1D - 1)
+		                    / LOCAL_TILE_DIM1D;
+		numTiles         *= numTilesPerDim[i];
+	}
+	bins = local_binElements(mama, (int32_t)(shapeDim1D / 2), idxLo,
+	                         dimsPatch, dimsGrid, numTilesPerDim, &binStart);
+
+#ifdef WITH_OPENMP
+#  pragma omp parallel for shared(maskData, shape, shapeDim1D, bins, \
+	binStart, numTiles, numTilesPerDim, idxLo, dimsPatch, dimsGrid, mama) \
+	schedule(dynamic)
+#endif
+	for (uint64_t t = 0; t < numTiles; t++) {
+		gridPointUint32_t tileLo, tileHi;
+		uint64_t          tmp = t;
+
+		for (int i = 0; i < NDIM; i++) {
+			tileLo[i] = (uint32_t)(tmp % numTilesPerDim[i])
+			            * LOCAL_TILE_DIM1D;
+			tileHi[i] = tileLo[i] + LOCAL_TILE_DIM1D;
+			tileHi[i] = (tileHi[i] > dimsPatch[i]) ? dimsPatch[i]
+			            : tileHi[i];
+			tmp      /= numTilesPerDim[i];
+		}
+		for (uint64_t j = binStart[t]; j < binStart[t + 1]; j++) {
+			gridPointUint32_t element;
+			lare_getElement(mama->setup->lare, element, bins[j]);
+			local_throwShapeOnMask(maskData, element, shape, shapeDim1D,
+			                       idxLo, tileLo, tileHi, dimsPatch,
+			                       dimsGrid);
+		}
+	}
+
+	xfree(binStart);
+	xfree(bins);
+	xfree(shape);
+} /* local_markRegions */
+
+inline static void
+local_getTilesOfElement(const gridPointUint32_t element,
+                        int32_t                 shapeExtent,
+                        const gridPointUint32_t idxLo,
+                        const gridPointUint32_t dimsPatch,
+                        const gridPointUint32_t dimsGrid,
+                        uint32_t                **tiles,
+                        uint32_t                *numTiles)
+{
+	for (int i = 0; i < NDIM; i++) {
+		numTiles[i] = 0;
+		for (int32_t j = -shapeExtent; j <= shapeExtent; j++) {
+			int64_t  posG = ((int64_t)element[i] + j + dimsGrid[i])
+			                % dimsGrid[i];
+			int64_t  posM = posG - idxLo[i];
+			uint32_t tile;
+
+			if ((posM < 0) || (posM >= dimsPatch[i]))
+				continue;
+			tile = (uint32_t)(posM / LOCAL_TILE_DIM1D);
+			// Along the shape the tiles only change at tile boundaries
+			// and at the periodic wrap, so comparing against the last
+			// one suffices.
+			if ((numTiles[i] == 0) || (tiles[i][numTiles[i] - 1] != tile))
+				tiles[i][numTiles[i]++] = tile;
+		}
 	}
 }
 
+inline static uint32_t *
+local_binElements(const makeMask_t        mama,
+                  int32_t                 shapeExtent,
+                  const gridPointUint32_t idxLo,
+                  const gridPointUint32_t dimsPatch,
+                  const gridPointUint32_t dimsGrid,
+                  const gridPointUint32_t numTilesPerDim,
+                  uint64_t                **binStart)
+{
+	uint32_t numElements = lare_getNumElements(mama->setup->lare);
+	uint64_t numTiles    = 1;
+	uint32_t *tiles[NDIM];
+	uint32_t numTilesElement[NDIM];
+	uint64_t *count;
+	uint32_t *bins = NULL;
+
+	for (int i = 0; i < NDIM; i++) {
+		numTiles *= numTilesPerDim[i];
+		tiles[i]  = xmalloc(sizeof(uint32_t) * (2 * shapeExtent + 1));
+	}
+	count = xmalloc(sizeof(uint64_t) * (numTiles + 1));
+	for (uint64_t t = 0; t <= numTiles; t++)
+		count[t] = 0;
+
+	// The first pass counts, the second one fills the bins.
+	for (int pass = 0; pass < 2; pass++) {
+		for (uint32_t e = 0; e < numElements; e++) {
+			gridPointUint32_t element;
+
+			lare_getElement(mama->setup->lare, element, e);
+			local_getTilesOfElement(element, shapeExtent, idxLo, dimsPatch,
+			                        dimsGrid, tiles, numTilesElement);
+			for (uint32_t k = 0; k < numTilesElement[2]; k++) {
+				for (uint32_t j = 0; j < numTilesElement[1]; j++) {
+					for (uint32_t i = 0; i < numTilesElement[0]; i++) {
+						uint64_t t = tiles[0][i] + (tiles[1][j]
+						             + (uint64_t)tiles[2][k]
+						             * numTilesPerDim[1])
+						             * numTilesPerDim[0];
+						if (pass == 0)
+							count[t + 1]++;
+						else
+							bins[count[t]++] = e;
+					}
+				}
+			}
+		}
+		if (pass == 0) {
+			for (uint64_t t = 0; t < numTiles; t++)
+				count[t + 1] += count[t];
+			bins = xmalloc(sizeof(uint32_t) * (count[numTiles] + 1));
+		}
+	}
+
+	// After filling, count[t] is the end of bin t, i.e. the start of bin
+	// t + 1.
+	for (uint64_t t = numTiles; t > 0; t--)
+		count[t] = count[t - 1];
+	count[0] = 0;
+
+	for (int i = 0; i < NDIM; i++)
+		xfree(tiles[i]);
+	*binStart = count;
+
+	return bins;
+} /* local_binElements */
+
 inline static void
 local_writeMask(makeMask_t mama)
 {
@@ -397,6 +619,8 @@ local_throwShapeOnMask(int8_t                  *restrict maskData,
                        const uint8_t           *restrict shape,
                        uint32_t                shapeDim1D,
                        const gridPointUint32_t idxLo,
+                       const gridPointUint32_t tileLo,
+                       const gridPointUint32_t tileHi,
                        const gridPointUint32_t dimsPatch,
                        const gridPointUint32_t dimsGrid)
 {
@@ -408,17 +632,17 @@ local_throwShapeOnMask(int8_t                  *restrict maskData,
 	for (int32_t k = -shapeExtent; k <= shapeExtent; k++) {
 		kSG = (hiResCellIdxG[2] + k + dimsGrid[2]) % dimsGrid[2];
 		kSM = kSG - idxLo[2];
-		if ((kSM < 0) || (kSM >= dimsPatch[2]))
+		if ((kSM < (int32_t)tileLo[2]) || (kSM >= (int32_t)tileHi[2]))
 			continue;
 		for (int32_t j = -shapeExtent; j <= shapeExtent; j++) {
 			jSG = (hiResCellIdxG[1] + j + dimsGrid[1]) % dimsGrid[1];
 			jSM = jSG - idxLo[1];
-			if ((jSM < 0) || (jSM >= dimsPatch[1]))
+			if ((jSM < (int32_t)tileLo[1]) || (jSM >= (int32_t)tileHi[1]))
 				continue;
 			for (int32_t i = -shapeExtent; i <= shapeExtent; i++) {
 				iSG = (hiResCellIdxG[0] + i + dimsGrid[0]) % dimsGrid[0];
 				iSM = iSG - idxLo[0];
-				if ((iSM < 0) || (iSM >= dimsPatch[0]))
+				if ((iSM < (int32_t)tileLo[0]) || (iSM >= (int32_t)tileHi[0]))
 					continue;
 				idxS = (i + shapeExtent)
 				       + (j + shapeExtent) * shapeDim1D
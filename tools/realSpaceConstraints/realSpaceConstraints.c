@@ -34,12 +34,32 @@
 #include "../../src/libutil/timer.h"
 #include "../../src/libutil/rng.h"
 #include "../../src/libutil/tile.h"
+#include "../../src/libutil/utilMath.h"
 
 
 /*--- Implemention of main structure ------------------------------------*/
 #include "realSpaceConstraints_adt.h"
 
 
+/*--- Local variables ---------------------------------------------------*/
+
+/** @brief  Normalisation of the 3D Haar transform, @f$1/\sqrt{8}@f$. */
+static const double local_haarNorm = 0.5 * M_SQRT1_2;
+
+/** @brief  The basis used to expand into @c 4x4x4 blocks. */
+static const double local_e4[4][4]
+    = {{0.5, -0.661437827766, -0.5, 0.25},
+	   {0.5, -0.25, 0.5, -0.661437827766},
+	   {0.5, 0.25, 0.5, 0.661437827766},
+	   {0.5, 0.661437827766, -0.5, -0.25}};
+
+/** @brief  The basis used to expand into @c 3x3x3 blocks. */
+static const double local_e3[3][3]
+    = {{0.57735026918962584, -0.70710678118654746, -0.40824829046386307},
+	   {0.57735026918962584, 0.0, 0.81649658092772615},
+	   {0.57735026918962584, 0.70710678118654746, -0.40824829046386307}};
+
+
 /*--- Prototypes of local functions -------------------------------------*/
 
 /**
@@ -225,22 +245,113 @@ local_enforceConstraints(fpv_t             *dataOut,
                          gridPointUint32_t dimsIn);
 
 
+/**
+ * @brief  Fills the expansion coefficients of one output block.
+ *
+ * The coefficients are initialised with the white noise already present in
+ * the output block, the lowest @c 2x2x2 coefficients are then replaced by
+ * the normalised Haar transform of the @c 2x2x2 input cells constraining
+ * the block.  The Haar transform is separable and done as three 1D
+ * butterfly passes.
+ *
+ * @param[in]   *dataIn
+ *                 The input data, must point to the first cell of the
+ *                 @c 2x2x2 input block.
+ * @param[in]   *dataOut
+ *                 The output data, must point to the first cell of the
+ *                 output block.
+ * @param[in]   dimsIn
+ *                 The dimensions of the input data cube.
+ * @param[in]   dimsOut
+ *                 The dimensions of the output data cube.
+ * @param[in]   len
+ *                 The extent of the output block, either @c 3 or @c 4.
+ * @param[out]  *a
+ *                 Array of at least @c len^3 elements that receives the
+ *                 coefficients.
+ *
+ * @return  Returns nothing.
+ */
 inline static void
-local_fillCoeff(const fpv_t       *dataIn,
-		const fpv_t       *dataOut,
-		gridPointUint32_t dimsIn,
-		gridPointUint32_t dimsOut,
-		double		*a);
+local_fillCoeff(const fpv_t *restrict dataIn,
+                const fpv_t *restrict dataOut,
+                gridPointUint32_t     dimsIn,
+                gridPointUint32_t     dimsOut,
+                int                   len,
+                double *restrict      a);
+
 
+/**
+ * @brief  Expands @c 4x4x4 coefficients into an output block.
+ *
+ * @param[out]  *data
+ *                 The output data, must point to the first cell of the
+ *                 block.
+ * @param[in]   dims
+ *                 The dimensions of the output data cube.
+ * @param[in]   *a
+ *                 The @c 64 expansion coefficients.
+ *
+ * @return  Returns nothing.
+ */
 inline static void
-local_refine4(fpv_t       *data,
-		gridPointUint32_t dims,
-		const double		*a);
+local_refine4(fpv_t *restrict        data,
+              gridPointUint32_t      dims,
+              const double *restrict a);
 
+
+/**
+ * @brief  Expands @c 3x3x3 coefficients into an output block.
+ *
+ * @param[out]  *data
+ *                 The output data, must point to the first cell of the
+ *                 block.
+ * @param[in]   dims
+ *                 The dimensions of the output data cube.
+ * @param[in]   *a
+ *                 The @c 27 expansion coefficients.
+ *
+ * @return  Returns nothing.
+ */
 inline static void
-local_refine3(fpv_t       *data,
-		gridPointUint32_t dims,
-		const double		*a);
+local_refine3(fpv_t *restrict        data,
+              gridPointUint32_t      dims,
+              const double *restrict a);
+
+
+/**
+ * @brief  Applies a separable basis expansion to a block of coefficients.
+ *
+ * This computes
+ * @f[
+ *   d_{ijk} = \sum_{i'j'k'} e_{kk'} e_{jj'} e_{ii'} a_{i'j'k'}
+ * @f]
+ * as three successive 1D passes, reducing the work per block from
+ * @f$len^6@f$ to @f$3 len^4@f$ multiply-adds.  The function is meant to
+ * be inlined with a constant @c len, so that all loops have fixed trip
+ * counts and can be unrolled and vectorised by the compiler.
+ *
+ * @param[out]  *data
+ *                 The output data, must point to the first cell of the
+ *                 block.
+ * @param[in]   dims
+ *                 The dimensions of the output data cube.
+ * @param[in]   *a
+ *                 The @c len^3 expansion coefficients.
+ * @param[in]   *e
+ *                 The @c len x @c len basis matrix, row-major.
+ * @param[in]   len
+ *                 The extent of the block.
+ *
+ * @return  Returns nothing.
+ */
+inline static void
+local_expandSeparable(fpv_t *restrict        data,
+                      gridPointUint32_t      dims,
+                      const double *restrict a,
+                      const double *restrict e,
+                      int                    len);
+
 
 /**
  * @brief  This will sum over a subvolume.
@@ -660,91 +771,145 @@ local_enforceConstraints(fpv_t             *dataOut,
 				                     + (j * dimsOut[1] / dimsIn[1]
 				                        + k * dimsOut[2] / dimsIn[2]
 				                        * dimsOut[1]) * dimsOut[0];
-				double			  a[64], b[27]; // expansion coefficients
-
-
-
-				if(ncoef == 4){
-					local_fillCoeff(dataIn+idxIn,dataOut+idxOut,dimsIn,dimsOut,a);
-					local_refine4(dataOut+idxOut,dimsOut,a);
-				}
-				else {
-					local_fillCoeff(dataIn+idxIn,dataOut+idxOut,dimsIn,dimsOut,b);
-					local_refine3(dataOut+idxOut,dimsOut,b);
+				double      a[64]; // expansion coefficients
+
+				if (ncoef == 4) {
+					local_fillCoeff(dataIn + idxIn, dataOut + idxOut,
+					                dimsIn, dimsOut, 4, a);
+					local_refine4(dataOut + idxOut, dimsOut, a);
+				} else {
+					local_fillCoeff(dataIn + idxIn, dataOut + idxOut,
+					                dimsIn, dimsOut, 3, a);
+					local_refine3(dataOut + idxOut, dimsOut, a);
 				}
-
-
 			}
 		}
 	}
 } /* local_enforceConstraints */
 
 inline static void
-local_fillCoeff(const fpv_t       *dataIn,
-		const fpv_t       *dataOut,
-		gridPointUint32_t dimsIn,
-		gridPointUint32_t dimsOut,
-		double		*a)
+local_fillCoeff(const fpv_t *restrict dataIn,
+                const fpv_t *restrict dataOut,
+                gridPointUint32_t     dimsIn,
+                gridPointUint32_t     dimsOut,
+                int                   len,
+                double *restrict      a)
 {
-	int i,j,k,ii,jj,kk;
-	int len = 4;
-	if ((dimsOut[0]*2) == (dimsIn[0]*3)) len = 3;
+	const uint64_t strideInY  = dimsIn[0];
+	const uint64_t strideInZ  = (uint64_t)dimsIn[0] * dimsIn[1];
+	const uint64_t strideOutY = dimsOut[0];
+	const uint64_t strideOutZ = (uint64_t)dimsOut[0] * dimsOut[1];
+	double         h[8];
 
-	const double mat[8][8] = {{1.0,1.0,1.0,1.0,1.0,1.0,1.0,1.0},{-1.0,1.0,-1.0,1.0,-1.0,1.0,-1.0,1.0},{-1.0,-1.0,1.0,1.0,-1.0,-1.0,1.0,1.0},{1.0,-1.0,-1.0,1.0,1.0,-1.0,-1.0,1.0},{-1.0,-1.0,-1.0,-1.0,1.0,1.0,1.0,1.0},{1.0,-1.0,1.0,-1.0,-1.0,1.0,-1.0,1.0},{1.0,1.0,-1.0,-1.0,-1.0,-1.0,1.0,1.0},{-1.0,1.0,1.0,-1.0,1.0,-1.0,-1.0,1.0}};
 	// initially fill a[][][] with random numbers from dataOut:
-	for (k=0; k<len; k++)
-		for (j=0; j<len; j++)
-			for (i=0; i<len; i++) {
-				a[i+(j+k*len)*len] = dataOut[i + (j + k * dimsOut[1]) * dimsOut[0]];
-			}
-	// put constraints on a[0..1][0..1][0..1]:
-	for (k=0; k<2; k++)
-		for (j=0; j<2; j++)
-			for (i=0; i<2; i++) {
-				a[i+(j+k*len)*len] = 0;
-				for (kk=0; kk<2; kk++)
-					for (jj=0; jj<2; jj++)
-						for (ii=0; ii<2; ii++)
-							a[i+(j+k*len)*len] += dataIn[ii+(jj+kk*dimsIn[1])*dimsIn[0]] * mat[2*(2*k+j)+i][2*(2*kk+jj)+ii]/sqrt(8.0);
-			}
-}
+	for (int k = 0; k < len; k++) {
+		for (int j = 0; j < len; j++) {
+			for (int i = 0; i < len; i++)
+				a[i + (j + k * len) * len]
+				    = dataOut[i + j * strideOutY + k * strideOutZ];
+		}
+	}
+
+	// Haar transform of the constraints, pass along x:
+	for (int k = 0; k < 2; k++) {
+		for (int j = 0; j < 2; j++) {
+			const fpv_t *in = dataIn + j * strideInY + k * strideInZ;
+			h[2 * (j + 2 * k)]     = (double)in[0] + (double)in[1];
+			h[2 * (j + 2 * k) + 1] = (double)in[1] - (double)in[0];
+		}
+	}
+	// ... along y:
+	for (int k = 0; k < 2; k++) {
+		for (int i = 0; i < 2; i++) {
+			double y0 = h[i + 4 * k];
+			double y1 = h[i + 2 + 4 * k];
+			h[i + 4 * k]     = y0 + y1;
+			h[i + 2 + 4 * k] = y1 - y0;
+		}
+	}
+	// ... and along z, putting the constraints on a[0..1][0..1][0..1]:
+	for (int j = 0; j < 2; j++) {
+		for (int i = 0; i < 2; i++) {
+			double z0 = h[i + 2 * j];
+			double z1 = h[i + 2 * j + 4];
+			a[i + j * len]         = (z0 + z1) * local_haarNorm;
+			a[i + (j + len) * len]     = (z1 - z0) * local_haarNorm;
+		}
+	}
+} /* local_fillCoeff */
 
 inline static void
-local_refine4(fpv_t       *data,
-		gridPointUint32_t dims,
-		const double		*a)
+local_refine4(fpv_t *restrict        data,
+              gridPointUint32_t      dims,
+              const double *restrict a)
 {
-	int i,j,k,ii,jj,kk;
-	double e[4][4]={{0.5,-0.661437827766,-0.5,0.25},{0.5,-0.25,0.5,-0.661437827766},{0.5,0.25,0.5,0.661437827766},{0.5,0.661437827766,-0.5,-0.25}};
-	for (k=0; k<4; k++)
-			for (j=0; j<4; j++)
-				for (i=0; i<4; i++) {
-					data[i+(j+k*dims[1])*dims[0]] = 0;
-					for (kk=0; kk<4; kk++)
-						for (jj=0; jj<4; jj++)
-							for (ii=0; ii<4; ii++)
-								data[i+(j+k*dims[1])*dims[0]] += a[ii+(jj+kk*4)*4] * e[k][kk] * e[j][jj] * e[i][ii];
-				}
+	local_expandSeparable(data, dims, a, local_e4[0], 4);
 }
 
 inline static void
-local_refine3(fpv_t       *data,
-		gridPointUint32_t dims,
-		const double		*a)
+local_refine3(fpv_t *restrict        data,
+              gridPointUint32_t      dims,
+              const double *restrict a)
 {
-	int i,j,k,ii,jj,kk;
-	double e[3][3]={{0.57735026918962584,-0.70710678118654746,-0.40824829046386307},{0.57735026918962584,0.0,0.81649658092772615},{0.57735026918962584,0.70710678118654746,-0.40824829046386307}};
-	for (k=0; k<3; k++)
-			for (j=0; j<3; j++)
-				for (i=0; i<3; i++) {
-					data[i+(j+k*dims[1])*dims[0]] = 0;
-					for (kk=0; kk<3; kk++)
-						for (jj=0; jj<3; jj++)
-							for (ii=0; ii<3; ii++)
-								data[i+(j+k*dims[1])*dims[0]] += a[ii+(jj+kk*3)*3] * e[k][kk] * e[j][jj] * e[i][ii];
-				}
+	local_expandSeparable(data, dims, a, local_e3[0], 3);
 }
 
+inline static void
+local_expandSeparable(fpv_t *restrict        data,
+                      gridPointUint32_t      dims,
+                      const double *restrict a,
+                      const double *restrict e,
+                      int                    len)
+{
+	const uint64_t strideY = dims[0];
+	const uint64_t strideZ = (uint64_t)dims[0] * dims[1];
+	double         tx[64], ty[64];
+
+	// tx[i][jj][kk] = sum_ii e[i][ii] a[ii][jj][kk]
+	for (int kk = 0; kk < len; kk++) {
+		for (int jj = 0; jj < len; jj++) {
+			const double *aRow = a + (jj + kk * len) * len;
+			double       *tRow = tx + (jj + kk * len) * len;
+			for (int i = 0; i < len; i++) {
+				double sum = 0.0;
+				for (int ii = 0; ii < len; ii++)
+					sum += e[i * len + ii] * aRow[ii];
+				tRow[i] = sum;
+			}
+		}
+	}
+
+	// ty[i][j][kk] = sum_jj e[j][jj] tx[i][jj][kk]
+	for (int kk = 0; kk < len; kk++) {
+		for (int j = 0; j < len; j++) {
+			double *tRow = ty + (j + kk * len) * len;
+			for (int i = 0; i < len; i++)
+				tRow[i] = 0.0;
+			for (int jj = 0; jj < len; jj++) {
+				const double ejj  = e[j * len + jj];
+				const double *src = tx + (jj + kk * len) * len;
+				for (int i = 0; i < len; i++)
+					tRow[i] += ejj * src[i];
+			}
+		}
+	}
+
+	// data[i][j][k] = sum_kk e[k][kk] ty[i][j][kk]
+	for (int k = 0; k < len; k++) {
+		for (int j = 0; j < len; j++) {
+			double sum[4] = {0.0, 0.0, 0.0, 0.0};
+			for (int kk = 0; kk < len; kk++) {
+				const double ekk  = e[k * len + kk];
+				const double *src = ty + (j + kk * len) * len;
+				for (int i = 0; i < len; i++)
+					sum[i] += ekk * src[i];
+			}
+			for (int i = 0; i < len; i++)
+				data[i + j * strideY + k * strideZ] = (fpv_t)sum[i];
+		}
+	}
+} /* local_expandSeparable */
+
 inline static long double
 local_sumSV(const fpv_t       *data,
             gridPointUint32_t dimsIn,
@@ -29,6 +29,7 @@
 #include "../../src/libutil/xstring.h"
 #include "../../src/libutil/cmdline.h"
 #include "../../src/libutil/parse_ini.h"
+#include "../../src/libutil/profile.h"
 
 
 /*--- Local defines -----------------------------------------------------*/
@@ -38,6 +39,8 @@
 /*--- Local variables ---------------------------------------------------*/
 static char *localIniFileName = NULL;
 
+static char *localProfileFileName = NULL;
+
 
 /*--- Prototypes of local functions -------------------------------------*/
 static void
@@ -73,7 +76,13 @@ main(int argc, char **argv)
 
 	te = local_getTest();
 	refineGrid_run(te);
+	if (localProfileFileName != NULL)
+		profile_report(localProfileFileName);
+#ifdef XMEM_TRACK_MEM
+	xmem_infoGlobal(stdout);
+#endif
 	refineGrid_del(&te);
+	profile_reset();
 
 	return EXIT_SUCCESS;
 }
@@ -91,6 +100,8 @@ local_initEnvironment(int *argc, char ***argv)
 	cmdline_parse(cmdline, *argc, *argv);
 	local_checkForPrematureTermination(cmdline);
 	cmdline_getArgValueByNum(cmdline, 0, &localIniFileName);
+	if (cmdline_checkOptSetByNum(cmdline, 2))
+		cmdline_getOptValueByNum(cmdline, 2, &localProfileFileName);
 	cmdline_del(&cmdline);
 }
 
@@ -116,6 +127,8 @@ local_finalMessage(void)
 
 	if (localIniFileName != NULL)
 		xfree(localIniFileName);
+	if (localProfileFileName != NULL)
+		xfree(localProfileFileName);
 #ifdef WITH_MPI
 	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
 	//MPI_Finalize();
@@ -145,13 +158,18 @@ local_cmdlineSetup(void)
 {
 	cmdline_t cmdline;
 
-	cmdline = cmdline_new(1, 2, THIS_PROGNAME);
+	cmdline = cmdline_new(1, 3, THIS_PROGNAME);
 	(void)cmdline_addOpt(cmdline, "version",
 	                     "This will output a version information.",
 	                     false, CMDLINE_TYPE_NONE);
 	(void)cmdline_addOpt(cmdline, "help",
 	                     "This will print this help text.",
 	                     false, CMDLINE_TYPE_NONE);
+	(void)cmdline_addOpt(cmdline, "profile",
+	                     "This will write a timing profile of the run to the "
+	                     "given file (JSON if it ends in .json, CSV "
+	                     "otherwise).",
+	                     true, CMDLINE_TYPE_STRING);
 	(void)cmdline_addArg(cmdline,
 	                     "Gives the name of the configuration file.",
 	                     CMDLINE_TYPE_STRING);
@@ -20,6 +20,7 @@
 #include <inttypes.h>
 #include <math.h>
 #include <string.h>
+#include <stdbool.h>
 #ifdef WITH_OPENMP
 #  include <omp.h>
 #endif
@@ -33,7 +34,8 @@
 #include "../../src/libgrid/gridHistogram.h"
 #include "../../src/libdata/dataVar.h"
 #include "../../src/libutil/xmem.h"
-#include "../../src/libutil/timer.h"
+#include "../../src/libutil/memPool.h"
+#include "../../src/libutil/profile.h"
 #include "../../src/libutil/rng.h"
 #include "../../src/libutil/tile.h"
 #include "../../src/libutil/utilMath.h"
@@ -43,12 +45,30 @@
 #  include <complex.h>
 #  include <fftw3.h>
 #endif
+#ifdef WITH_MPI
+#  include <mpi.h>
+#  include "../../src/libutil/commScheme.h"
+#  include "../../src/libutil/commSchemeBuffer.h"
+#endif
 
 #define MIN(x, y) (((x) < (y)) ? (x) : (y))
 #define MAX(x, y) (((x) > (y)) ? (x) : (y))
 #define NBR(x,dx,dim) ( MIN(MAX(((x)+(dx)-1),0),((dim)-1) ) )
-#define CUT_SMALL 0
-#define CUT_LARGE 1
+
+/** @brief  Low-pass filter with deconvolution of the CIC kernel. */
+#define LOCAL_KSPACE_FILTER_SMALL 1
+/** @brief  High-pass filter. */
+#define LOCAL_KSPACE_FILTER_LARGE 2
+/** @brief  Phase shift by half a cell in every dimension. */
+#define LOCAL_KSPACE_SHIFT 4
+/** @brief  Accumulation of the power spectrum. */
+#define LOCAL_KSPACE_PK 8
+
+/** @brief  The extent (in input cells) of the tiles used for refining. */
+#define LOCAL_TILE_SIZE 16
+
+/** @brief  The first MPI tag used for the halo exchange. */
+#define LOCAL_HALO_TAG 4300
 
 
 /*--- Implemention of main structure ------------------------------------*/
@@ -71,6 +91,14 @@
  *                The grid name.
  * @param[in]  *varName
  *                The variable name.
+ * @param[in]  dim1D_proto
+ *                The size of the smaller of the input and output grid, the
+ *                distribution is aligned to this grid.
+ * @param[in]  *nProcs
+ *                The process grid, may be @c NULL to request a slab
+ *                decomposition.
+ * @param[out] *distrib
+ *                Will receive the distribution of the grid.
  *
  * @return  Returns a new grid.
  */
@@ -80,6 +108,7 @@ local_getGrid(double         boxsizeInMpch,
               const char     *name,
               const char	 *varName,
               int            dim1D_proto,
+              const int      *nProcs,
               gridRegularDistrib_t *distrib);
 
 
@@ -113,13 +142,16 @@ local_fillInputGrid(gridRegular_t grid, gridReader_t reader);
  * @param[in]      gridIn2
  *                    The second input grid that will be added to the results if not 
  *                    @c NULL.
+ * @param[in]      distribIn
+ *                    The distribution of the input grid.
  *
  * @return  Returns nothing.
  */
 static void
-local_fillOutputGrid(gridRegular_t       gridOut,
-                     const gridRegular_t gridIn,
-                     const gridRegular_t gridIn2);
+local_fillOutputGrid(gridRegular_t              gridOut,
+                     const gridRegular_t        gridIn,
+                     const gridRegular_t        gridIn2,
+                     const gridRegularDistrib_t distribIn);
 
 static void
 local_dataCopy(fpv_t            *dataOut,
@@ -149,6 +181,11 @@ local_addGrid(fpv_t             *dataOut,
 /**
  * @brief  Will enforce constraints of a lowRes grid onto a highRes grid.
  *
+ * The input patch is copied into a buffer with a one cell wide halo that
+ * is filled from the neighbouring patches (or periodically), afterwards
+ * the output is computed tile by tile with three one-dimensional CIC
+ * passes.
+ *
  * @param[out]  *dataOut
  *                 The output data cube.
  * @param[in]   *dataIn
@@ -157,15 +194,162 @@ local_addGrid(fpv_t             *dataOut,
  *                 The dimensions of the output data cube.
  * @param[in]   dimsIn
  *                 The dimensions of the input data cube.
+ * @param[in]   distribIn
+ *                 The distribution of the input grid.
+ *
+ * @return  Returns nothing.
+ */
+static void
+local_enforceConstraints(fpv_t                      *dataOut,
+                         const fpv_t                *dataIn,
+                         gridPointUint32_t          dimsOut,
+                         gridPointUint32_t          dimsIn,
+                         const gridRegularDistrib_t distribIn);
+
+
+/**
+ * @brief  Copies a data cube into a new one with a one cell wide halo.
+ *
+ * @param[in]   *data
+ *                 The data cube to copy.
+ * @param[in]   dims
+ *                 The dimensions of the data cube.
+ * @param[out]  dimsHalo
+ *                 Will receive the dimensions of the returned cube.
+ *
+ * @return  Returns a new data cube, the halo cells are not initialised.
+ */
+static fpv_t *
+local_getHaloCopy(const fpv_t       *data,
+                  gridPointUint32_t dims,
+                  gridPointUint32_t dimsHalo);
+
+
+/**
+ * @brief  Fills the halo of a data cube from the neighbouring patches.
+ *
+ * The dimensions are processed one after the other including the halo
+ * cells of the previous dimensions, which also fills edges and corners.
+ * Dimensions that are not split are wrapped periodically.
+ *
+ * @param[in,out]  *data
+ *                    The data cube with halo.
+ * @param[in]      dimsHalo
+ *                    The dimensions of the data cube including the halo.
+ * @param[in]      distrib
+ *                    The distribution the data cube belongs to.
+ *
+ * @return  Returns nothing.
+ */
+static void
+local_exchangeHalo(fpv_t                      *data,
+                   gridPointUint32_t          dimsHalo,
+                   const gridRegularDistrib_t distrib);
+
+
+/**
+ * @brief  Copies a plane of a data cube into a contiguous buffer.
+ *
+ * @param[in]   *data
+ *                 The data cube.
+ * @param[in]   dims
+ *                 The dimensions of the data cube.
+ * @param[in]   dim
+ *                 The dimension perpendicular to the plane.
+ * @param[in]   pos
+ *                 The position of the plane along @c dim.
+ * @param[out]  *buf
+ *                 The buffer, must be large enough to hold the plane.
+ *
+ * @return  Returns nothing.
+ */
+static void
+local_packFace(const fpv_t       *data,
+               gridPointUint32_t dims,
+               int               dim,
+               uint32_t          pos,
+               fpv_t             *buf);
+
+
+/**
+ * @brief  Copies a contiguous buffer into a plane of a data cube.
+ *
+ * @param[in,out]  *data
+ *                    The data cube.
+ * @param[in]      dims
+ *                    The dimensions of the data cube.
+ * @param[in]      dim
+ *                    The dimension perpendicular to the plane.
+ * @param[in]      pos
+ *                    The position of the plane along @c dim.
+ * @param[in]      *buf
+ *                    The buffer as filled by local_packFace().
+ *
+ * @return  Returns nothing.
+ */
+static void
+local_unpackFace(fpv_t             *data,
+                 gridPointUint32_t dims,
+                 int               dim,
+                 uint32_t          pos,
+                 const fpv_t       *buf);
+
+
+/**
+ * @brief  Computes the one-dimensional CIC weights for a refinement.
+ *
+ * @param[in]   factor
+ *                 The refinement factor.
+ * @param[out]  *weights
+ *                 Will receive the three weights (lower neighbour, cell,
+ *                 upper neighbour) for each of the @c factor sub-cells,
+ *                 must hold 3 * @c factor values.
+ *
+ * @return  Returns nothing.
+ */
+static void
+local_calcCICWeights(uint32_t factor, double *weights);
+
+
+/**
+ * @brief  Refines one tile of the input data into the output data.
+ *
+ * @param[out]  *dataOut
+ *                 The output data cube.
+ * @param[in]   dimsOut
+ *                 The dimensions of the output data cube.
+ * @param[in]   *dataHalo
+ *                 The input data cube including the halo.
+ * @param[in]   dimsHalo
+ *                 The dimensions of the input data cube including the
+ *                 halo.
+ * @param[in]   dimsSV
+ *                 The refinement factors.
+ * @param[in]   lo
+ *                 The first input cell of the tile.
+ * @param[in]   hi
+ *                 The first input cell after the tile.
+ * @param[in]   *weights
+ *                 The CIC weights for each dimension.
+ * @param[in]   *bufX
+ *                 Scratch space for the pass along x.
+ * @param[in]   *bufY
+ *                 Scratch space for the pass along y.
  *
  * @return  Returns nothing.
  */
 static void
-local_enforceConstraints(fpv_t             *dataOut,
-                         const fpv_t       *dataIn,
-                         gridPointUint32_t dimsOut,
-                         gridPointUint32_t dimsIn,
-                         const gridRegular_t gridIn);
+local_refineTile(fpv_t *restrict         dataOut,
+                 gridPointUint32_t       dimsOut,
+                 const fpv_t *restrict   dataHalo,
+                 gridPointUint32_t       dimsHalo,
+                 gridPointUint32_t       dimsSV,
+                 const gridPointUint32_t lo,
+                 const gridPointUint32_t hi,
+                 double *const           *weights,
+                 double *restrict        bufX,
+                 double *restrict        bufY);
+
 
 
 /**
@@ -190,31 +374,74 @@ local_setToSV(fpv_t             *data,
               double            value);
               
 /**
- * @brief  Interpolates values to a subvolume.
+ * @brief  Computes the per-axis tables used in a k-space pass.
  *
- * @param[in,out]  *data
- *                    The data, must point to the beginning of the
- *                    subvolume.
- * @param[in]      dimsIn
- *                    The dimensions of the input data.
- * @param[in]      dimsSV
- *                    The dimensions of the subvolume.
- * @param[in]      *valArr
- *                    The value array of size 8 (2x2x2) that should be interpolated to the subvolume.
+ * @param[in]   ops
+ *                 The operations of the pass, see local_doKSpacePass().
+ * @param[in]   dimPatch
+ *                 The extent of the patch along the axis.
+ * @param[in]   idxLo
+ *                 The first index of the patch along the axis.
+ * @param[in]   kMaxGrid
+ *                 The largest positive wavenumber along the axis.
+ * @param[in]   dimGrid
+ *                 The extent of the grid along the axis.
+ * @param[in]   realGrid
+ *                 The size of the grid in real space.
+ * @param[in]   dim1D
+ *                 The grid size used for the phase shift.
+ * @param[out]  *kSqr
+ *                 Will receive the squared wavenumbers.
+ * @param[out]  *factor
+ *                 Will receive the separable part of the operator (CIC
+ *                 deconvolution and phase shift).
  *
  * @return  Returns nothing.
- */           
-inline static void
-local_CICToSV(fpv_t             *data,
-              gridPointUint32_t dimsIn,
-              gridPointUint32_t dimsSV,
-              double 			*valArr);
-              
+ */
 static void
-local_doFilter(gridRegularFFT_t fft, int cut_kind, uint32_t dim1D);
+local_fillKSpaceTable(int      ops,
+                      uint32_t dimPatch,
+                      uint32_t idxLo,
+                      uint32_t kMaxGrid,
+                      uint32_t dimGrid,
+                      uint32_t realGrid,
+                      uint32_t dim1D,
+                      double   *kSqr,
+                      double complex *factor);
 
+
+/**
+ * @brief  Applies a chain of operations to a field in k-space.
+ *
+ * All operations are applied in one sweep over the data together with
+ * the FFT normalisation, the separable factors are taken from per-axis
+ * tables.  Unless only #LOCAL_KSPACE_PK is requested, the mode k=0 is
+ * set to zero.
+ *
+ * @param[in,out]  fft
+ *                    The FFT object holding the forward transformed
+ *                    field.
+ * @param[in]      dim1D
+ *                    The grid size setting the filter scale.
+ * @param[in]      ops
+ *                    A combination of #LOCAL_KSPACE_FILTER_SMALL or
+ *                    #LOCAL_KSPACE_FILTER_LARGE, #LOCAL_KSPACE_SHIFT and
+ *                    #LOCAL_KSPACE_PK.
+ * @param[in,out]  *P
+ *                    The power per wavenumber bin, only used with
+ *                    #LOCAL_KSPACE_PK.
+ * @param[in,out]  *numFreqHits
+ *                    The number of modes per wavenumber bin, only used
+ *                    with #LOCAL_KSPACE_PK.
+ *
+ * @return  Returns nothing.
+ */
 static void
-local_doShiftFFT(gridRegularFFT_t fft, uint32_t          dim1D);
+local_doKSpacePass(gridRegularFFT_t fft,
+                   uint32_t         dim1D,
+                   int              ops,
+                   double           *P,
+                   uint32_t         *numFreqHits);
 
 static cosmoPk_t
 local_calcPk(gridRegularFFT_t gridFFT,
@@ -250,6 +477,7 @@ refineGrid_newFromIni(parse_ini_t ini)
 	refineGrid_t te;
 	assert(ini != NULL);
 	int  dim1D_proto;
+	const int *nProcs = NULL;
 
 	te        = xmalloc(sizeof(struct refineGrid_struct));
 
@@ -260,19 +488,27 @@ refineGrid_newFromIni(parse_ini_t ini)
 	} else {
 		dim1D_proto = te->setup->outputDim1D;
 	}
+#ifdef WITH_MPI
+	nProcs = te->setup->nProcs;
+#endif
 	
 	te->gridIn = local_getGrid(te->setup->boxsizeInMpch,
 	                           te->setup->inputDim1D,
 	                           "Input",
 	                           te->setup->varName,
 	                           dim1D_proto,
+	                           nProcs,
 	                           &te->distribIn);
 	te->gridOut = local_getGrid(te->setup->boxsizeInMpch,
 	                            te->setup->outputDim1D,
 	                            "Output",
 	                            te->setup->varName,
 	                            dim1D_proto,
+	                            nProcs,
 	                            &te->distribOut);
+	// The input grids are only filtered in k-space, padding them allows
+	// the FFTs to work in place.
+	dataVar_setFFTWPadded(gridRegular_getVarHandle(te->gridIn, 0));
 	te->reader   = gridReaderFactory_newReaderFromIni(
 		    ini, te->setup->readerSecName);
 	te->writer = gridWriterFactory_newWriterFromIni(
@@ -287,7 +523,9 @@ refineGrid_newFromIni(parse_ini_t ini)
 	                           "Input2",
 	                           te->setup->varName,
 	                           dim1D_proto,
+	                           nProcs,
 	                           &te->distribIn2);
+		dataVar_setFFTWPadded(gridRegular_getVarHandle(te->gridIn2, 0));
 	    te->reader2   = gridReaderFactory_newReaderFromIni(
 		    ini, te->setup->reader2SecName);
 	} else {
@@ -301,113 +539,132 @@ refineGrid_newFromIni(parse_ini_t ini)
 extern void
 refineGrid_run(refineGrid_t te)
 {
-	double           timing;
 	gridStatistics_t stat;
 	gridRegularFFT_t fft1, fft2;
         double   mean;
 	int              rank = 0, size = 1;
+	bool             doShift;
 #ifdef WITH_MPI
 	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
 	MPI_Comm_size(MPI_COMM_WORLD, &size);
 #endif
 
 	assert(te != NULL);
+	doShift = (te->setup->inputDim1D > te->setup->outputDim1D);
 	
+	profile_enter("refineGrid_run");
 	stat   = gridStatistics_new();
 
-	timing = timer_start_text("  Filling input grid... ");
+	profile_enter_text("fillInput", "  Filling input grid... ");
 	local_fillInputGrid(te->gridIn, te->reader);
-	timing = timer_stop_text(timing, "took %.5fs\n");
+	profile_leave_text("took %.5fs\n");
 
-	timing = timer_start_text("  Calculating statistics on input grid... ");
+	profile_enter_text("statisticsInput",
+	                   "  Calculating statistics on input grid... ");
 #ifdef WITH_MPI	
 	gridStatistics_calcGridRegularDistrib(stat, te->distribIn, 0);
 #else
 	gridStatistics_calcGridRegular(stat, te->gridIn, 0);
 #endif
         mean = gridStatistics_getMean(stat);
-	timing = timer_stop_text(timing, "took %.5fs\n");
+	profile_leave_text("took %.5fs\n");
 	if (rank == 0)
 		gridStatistics_printPretty(stat, stdout, "  ");
 
     if(te->setup->addFields) {
-		timing = timer_start_text("  Filling second input grid... ");
+		profile_enter_text("fillInput2", "  Filling second input grid... ");
 		local_fillInputGrid(te->gridIn2, te->reader2);
-		timing = timer_stop_text(timing, "took %.5fs\n");
+		profile_leave_text("took %.5fs\n");
 	
-		timing = timer_start_text("  Calculating statistics on second input grid... ");
+		profile_enter_text("statisticsInput2",
+		                   "  Calculating statistics on second input grid... ");
 #ifdef WITH_MPI	
 		gridStatistics_calcGridRegularDistrib(stat, te->distribIn2, 0);
 #else
 		gridStatistics_calcGridRegular(stat, te->gridIn2, 0);
 #endif
-		timing = timer_stop_text(timing, "took %.5fs\n");
+		profile_leave_text("took %.5fs\n");
 		if (rank == 0)
 			gridStatistics_printPretty(stat, stdout, "  ");
 			
 		
-		timing = timer_start_text("  Filtering first grid in k-space... ");
+		// The shift for the NGP degrading is applied in the same pass,
+		// it would remove the mean again.
+		profile_enter_text("filterInput", "  Filtering first grid in k-space... ");
 		fft1 = gridRegularFFT_new(te->gridIn,te->distribIn,0);
 		gridRegularFFT_execute(fft1, GRIDREGULARFFT_FORWARD);
-		local_doFilter(fft1,CUT_SMALL,te->setup->inputDim1D);
+		local_doKSpacePass(fft1, te->setup->inputDim1D,
+		                   LOCAL_KSPACE_FILTER_SMALL
+		                   | (doShift ? LOCAL_KSPACE_SHIFT : 0),
+		                   NULL, NULL);
 		gridRegularFFT_execute(fft1, GRIDREGULARFFT_BACKWARD);
 		gridRegularFFT_del(&fft1);
-                local_addGridVal(te->gridIn,mean);
-		timing = timer_stop_text(timing, "took %.5fs\n");
+		if (!doShift)
+			local_addGridVal(te->gridIn,mean);
+		profile_leave_text("took %.5fs\n");
 		
-		timing = timer_start_text("  Filtering second grid in k-space... ");
+		profile_enter_text("filterInput2", "  Filtering second grid in k-space... ");
 		fft2 = gridRegularFFT_new(te->gridIn2,te->distribIn2,0);
 		gridRegularFFT_execute(fft2, GRIDREGULARFFT_FORWARD);
-		local_doFilter(fft2,CUT_LARGE,te->setup->inputDim1D);
+		local_doKSpacePass(fft2, te->setup->inputDim1D,
+		                   LOCAL_KSPACE_FILTER_LARGE, NULL, NULL);
 		gridRegularFFT_execute(fft2, GRIDREGULARFFT_BACKWARD);
 		gridRegularFFT_del(&fft2);
-		timing = timer_stop_text(timing, "took %.5fs\n");
-	}
-	
-	if(te->setup->inputDim1D > te->setup->outputDim1D) {
-		timing = timer_start_text("  FFT correction before NGP interpolation... ");
+		profile_leave_text("took %.5fs\n");
+	} else if (doShift) {
+		profile_enter_text("shiftInput",
+		                   "  FFT correction before NGP interpolation... ");
 		fft1 = gridRegularFFT_new(te->gridIn,te->distribIn,0);
 		gridRegularFFT_execute(fft1, GRIDREGULARFFT_FORWARD);
-		local_doShiftFFT(fft1,te->setup->inputDim1D);
+		local_doKSpacePass(fft1, te->setup->inputDim1D,
+		                   LOCAL_KSPACE_SHIFT, NULL, NULL);
 		gridRegularFFT_execute(fft1, GRIDREGULARFFT_BACKWARD);
 		gridRegularFFT_del(&fft1);
-		timing = timer_stop_text(timing, "took %.5fs\n");
+		profile_leave_text("took %.5fs\n");
 	}
 
-	timing = timer_start_text("  Filling output grid... ");
-	local_fillOutputGrid(te->gridOut, te->gridIn, te->gridIn2);
-	timing = timer_stop_text(timing, "took %.5fs\n");
+	// The refinement expects dense rows.
+	gridRegular_removePadding(te->gridIn, 0);
+	if (te->gridIn2 != NULL)
+		gridRegular_removePadding(te->gridIn2, 0);
 
-	timing = timer_start_text("  Calculating statistics on output grid... ");
+	profile_enter_text("fillOutput", "  Filling output grid... ");
+	local_fillOutputGrid(te->gridOut, te->gridIn, te->gridIn2,
+	                     te->distribIn);
+	profile_leave_text("took %.5fs\n");
+
+	profile_enter_text("statisticsOutput",
+	                   "  Calculating statistics on output grid... ");
 #ifdef WITH_MPI 
         gridStatistics_calcGridRegularDistrib(stat, te->distribOut, 0);
 #else
 	gridStatistics_calcGridRegular(stat, te->gridOut, 0);
 #endif
-	timing = timer_stop_text(timing, "took %.5fs\n");
+	profile_leave_text("took %.5fs\n");
 	if (rank == 0)
 		gridStatistics_printPretty(stat, stdout, "  ");
 
-	timing = timer_start_text("  Writing output grid to file... ");
+	profile_enter_text("writeOutput", "  Writing output grid to file... ");
 	gridWriter_activate(te->writer);
 	gridWriter_writeGridRegular(te->writer, te->gridOut);
 	gridWriter_deactivate(te->writer);
-	timing = timer_stop_text(timing, "took %.5fs\n");
+	profile_leave_text("took %.5fs\n");
 
 	if(te->setup->doPk) {
 		gridRegularFFT_t fft = gridRegularFFT_new(te->gridOut,te->distribOut,0);
 		cosmoPk_t pk;
-		timing = timer_start_text("  Calculating P(k)...");
+		profile_enter_text("pk", "  Calculating P(k)...");
 		gridRegularFFT_execute(fft, GRIDREGULARFFT_FORWARD);
 		pk     = local_calcPk(fft,
 				                 te->setup->outputDim1D,
 				                               te->setup->boxsizeInMpch);
 				cosmoPk_dumpToFile(pk, te->setup->PkFile, 1);
 				cosmoPk_del(&pk);
-		timing = timer_stop_text(timing, "took %.5fs\n");
+		profile_leave_text("took %.5fs\n");
 	}
 
 	gridStatistics_del(&stat);
+	profile_leave();
 } /* refineGrid_run */
 
 extern void
@@ -425,6 +682,7 @@ refineGrid_del(refineGrid_t *te)
 	    gridRegular_del(&((*te)->gridIn2));
 	if((*te)->reader2 != NULL)
 	    gridReader_del(&((*te)->reader2));
+	memPool_trim();
 	xfree(*te);
 
 	*te = NULL;
@@ -476,123 +734,102 @@ local_cutoff(double f, double rs)
 #define WRAP_WAVENUM(k, kmax, dims) \
     k = (k > kmax) ? k - dims : k
 
-#define WAVE_SQR(k) \
-    (k[0] * k[0] + k[1] * k[1] + k[2] * k[2])
-
 static void
-local_doFilter(gridRegularFFT_t fft, int cut_kind, uint32_t          dim1D)
+local_fillKSpaceTable(int      ops,
+                      uint32_t dimPatch,
+                      uint32_t idxLo,
+                      uint32_t kMaxGrid,
+                      uint32_t dimGrid,
+                      uint32_t realGrid,
+                      uint32_t dim1D,
+                      double   *kSqr,
+                      double complex *factor)
 {
-	double norm          = (gridRegularFFT_getNorm(fft));
-	gridPointUint32_t dimsGrid, dimsPatch, idxLo, kMaxGrid;
-	fpvComplex_t      *data;
-
-	local_getGridStuff(fft, dim1D, &data, dimsGrid, dimsPatch,
-	                   idxLo, kMaxGrid);
-	                   
-	const uint32_t realGrid = dimsGrid[0]>dimsGrid[1] ? dimsGrid[0] : dimsGrid[1]; // because one of them is r2c dimension
-	
-	double rsSqr = (4.0/dim1D)*(4.0/dim1D);
-
-	//printf("%i %i\n",);
-
-#ifdef _OPENMP
-#  pragma omp parallel for shared(dimsPatch, idxLo, kMaxGrid, \
-	dimsGrid, data)
-#endif
-	for (uint64_t k = 0; k < dimsPatch[2]; k++) {
-		int64_t kReal[3];
-		kReal[2] = k + idxLo[2];
-		WRAP_WAVENUM(kReal[2], kMaxGrid[2], dimsGrid[2]);
-		for (uint64_t j = 0; j < dimsPatch[1]; j++) {
-			kReal[1] = j + idxLo[1];
-			WRAP_WAVENUM(kReal[1], kMaxGrid[1], dimsGrid[1]);
-			for (uint64_t i = 0; i < dimsPatch[0]; i++) {
-				double   kCellSqr;
-				uint64_t idx;
-
-				kReal[0] = i + idxLo[0];
-				WRAP_WAVENUM(kReal[0], kMaxGrid[0], dimsGrid[0]);
-
-				idx      = i + (j + k * dimsPatch[1]) * dimsPatch[0];
-				kCellSqr = ((double)(WAVE_SQR(kReal)));
-				
-
-				if ((kReal[0] == 0) && (kReal[1] == 0)
-				    && (kReal[2] == 0)) {
-					data[idx] = 0.0;
-				} else {
-					data[idx] *= (fpv_t)(norm);
-					if (cut_kind == CUT_SMALL) {
-						data[idx] *= (fpv_t)local_cutoff(kCellSqr, rsSqr);
-                        //                        data[idx] *= exp(-kCellSqr*rsSqr/2);
-						if(kReal[0]!=0)
-							data[idx] /= (fpv_t)local_kernel1D(((double)kReal[0])*M_PI/realGrid);
-						if(kReal[1]!=0)
-							data[idx] /= (fpv_t)local_kernel1D(((double)kReal[1])*M_PI/realGrid);
-						if(kReal[2]!=0)
-							data[idx] /= (fpv_t)local_kernel1D(((double)kReal[2])*M_PI/realGrid);
-					} else
-						data[idx] *= (fpv_t)(1 - local_cutoff(kCellSqr, rsSqr));
-                        //                        data[idx] *= 1-exp(-kCellSqr*rsSqr/2);
-				}
-			}
-		}
+	for (uint32_t i = 0; i < dimPatch; i++) {
+		int64_t kReal = i + idxLo;
+		WRAP_WAVENUM(kReal, kMaxGrid, dimGrid);
+
+		kSqr[i]   = (double)(kReal * kReal);
+		factor[i] = 1.0;
+		if ((ops & LOCAL_KSPACE_FILTER_SMALL) && (kReal != 0))
+			factor[i] /= local_kernel1D(((double)kReal) * M_PI / realGrid);
+		if (ops & LOCAL_KSPACE_SHIFT)
+			factor[i] *= cexp(I * M_PI * ((double)kReal) / dim1D);
 	}
 }
 
-
 static void
-local_doShiftFFT(gridRegularFFT_t fft, uint32_t          dim1D)
+local_doKSpacePass(gridRegularFFT_t fft,
+                   uint32_t         dim1D,
+                   int              ops,
+                   double           *P,
+                   uint32_t         *numFreqHits)
 {
-	double norm          = (gridRegularFFT_getNorm(fft));
+	double            norm = gridRegularFFT_getNorm(fft);
 	gridPointUint32_t dimsGrid, dimsPatch, idxLo, kMaxGrid;
 	fpvComplex_t      *data;
+	double            *kSqr[NDIM];
+	double complex    *factor[NDIM];
+	uint32_t          realGrid;
+	double            rsSqr   = (4.0 / dim1D) * (4.0 / dim1D);
+	bool              zeroDC  = (ops & ~LOCAL_KSPACE_PK) ? true : false;
+
+	assert(((ops & LOCAL_KSPACE_PK) == 0) || (P != NULL && numFreqHits != NULL));
 
 	local_getGridStuff(fft, dim1D, &data, dimsGrid, dimsPatch,
 	                   idxLo, kMaxGrid);
-	                   
-	const uint32_t realGrid = dimsGrid[0]>dimsGrid[1] ? dimsGrid[0] : dimsGrid[1]; // because one of them is r2c dimension
-	
+	// One of the first two dimensions is the r2c dimension.
+	realGrid = dimsGrid[0] > dimsGrid[1] ? dimsGrid[0] : dimsGrid[1];
+
+	for (int d = 0; d < NDIM; d++) {
+		kSqr[d]   = xmalloc(sizeof(double) * dimsPatch[d]);
+		factor[d] = xmalloc(sizeof(double complex) * dimsPatch[d]);
+		local_fillKSpaceTable(ops, dimsPatch[d], idxLo[d], kMaxGrid[d],
+		                      dimsGrid[d], realGrid, dim1D,
+		                      kSqr[d], factor[d]);
+	}
+
 #ifdef _OPENMP
-#  pragma omp parallel for shared(dimsPatch, idxLo, kMaxGrid, \
-	dimsGrid, data)
+#  pragma omp parallel for shared(dimsPatch, kMaxGrid, data, kSqr, factor) \
+	if (!(ops & LOCAL_KSPACE_PK))
 #endif
 	for (uint64_t k = 0; k < dimsPatch[2]; k++) {
-		int64_t kReal[3];
-		kReal[2] = k + idxLo[2];
-		WRAP_WAVENUM(kReal[2], kMaxGrid[2], dimsGrid[2]);
-		double kz = ((double)kReal[2])/dim1D;
 		for (uint64_t j = 0; j < dimsPatch[1]; j++) {
-			kReal[1] = j + idxLo[1];
-			WRAP_WAVENUM(kReal[1], kMaxGrid[1], dimsGrid[1]);
-			double ky = ((double)kReal[1])/dim1D;
+			double         kSqrYZ   = kSqr[1][j] + kSqr[2][k];
+			double complex factorYZ = norm * factor[1][j] * factor[2][k];
+			fpvComplex_t   *row     = data + (j + k * dimsPatch[1])
+			                          * dimsPatch[0];
 			for (uint64_t i = 0; i < dimsPatch[0]; i++) {
-				double   kCellSqr;
-				uint64_t idx;
-
-				kReal[0] = i + idxLo[0];
-				WRAP_WAVENUM(kReal[0], kMaxGrid[0], dimsGrid[0]);
-				double kx = ((double)kReal[0])/dim1D;
-
-				idx      = i + (j + k * dimsPatch[1]) * dimsPatch[0];
-				kCellSqr = ((double)(WAVE_SQR(kReal)));
-				
-
-				if ((kReal[0] == 0) && (kReal[1] == 0)
-				    && (kReal[2] == 0)) {
-					data[idx] = 0.0;
-				} else {
-					data[idx] *= (fpv_t)(norm);
-					data[idx] *= cos(M_PI*(kx+ky+kz))+I*sin(M_PI*(kx+ky+kz));
-					if(abs(kx)>0.25 || abs(ky)>0.25 || abs(kz)>0.25)
-							data[idx] = FPV_C(0.0);
+				double kCellSqr = kSqrYZ + kSqr[0][i];
+
+				if (zeroDC && (kCellSqr == 0.0)) {
+					row[i] = FPV_C(0.0);
+					continue;
+				}
+				row[i] *= (fpvComplex_t)(factorYZ * factor[0][i]);
+				if ((ops & LOCAL_KSPACE_FILTER_SMALL)
+				    && (local_cutoff(kCellSqr, rsSqr) == 0.0))
+					row[i] = FPV_C(0.0);
+				if ((ops & LOCAL_KSPACE_FILTER_LARGE)
+				    && (local_cutoff(kCellSqr, rsSqr) != 0.0))
+					row[i] = FPV_C(0.0);
+				if (ops & LOCAL_KSPACE_PK) {
+					int kCell = (int)floor(sqrt(kCellSqr));
+					if ((kCell <= kMaxGrid[0]) && (kCell > 0)) {
+						P[kCell - 1] += creal(row[i]) * creal(row[i])
+						                + cimag(row[i]) * cimag(row[i]);
+						numFreqHits[kCell - 1]++;
+					}
 				}
 			}
 		}
 	}
-}
-
 
+	for (int d = 0; d < NDIM; d++) {
+		xfree(factor[d]);
+		xfree(kSqr[d]);
+	}
+} /* local_doKSpacePass */
 
 static cosmoPk_t
 local_calcPk(gridRegularFFT_t gridFFT,
@@ -607,8 +844,6 @@ local_calcPk(gridRegularFFT_t gridFFT,
 
 	assert(gridFFT != NULL);
 
-	double norm          = (gridRegularFFT_getNorm(gridFFT));
-
 	local_getGridStuff(gridFFT, dim1D, &data, dimsGrid, dimsPatch,
 	                   idxLo, kMaxGrid);
 	wavenumToFreq = 2. * M_PI * 1. / boxsizeInMpch;
@@ -618,36 +853,13 @@ local_calcPk(gridRegularFFT_t gridFFT,
 	numFreqHits   = xmalloc(sizeof(uint32_t) * kMaxGrid[0]);
 	for (int i = 0; i < kMaxGrid[0]; i++) {
 		P[i]           = 0.0;
-		freq[i]        = -1.0;
 		numFreqHits[i] = 0;
 	}
 
-	for (uint64_t k = 0; k < dimsPatch[2]; k++) {
-		int64_t k2 = k + idxLo[2];
-		k2 = (k2 > kMaxGrid[2]) ? k2 - dimsGrid[2] : k2;
-		for (uint64_t j = 0; j < dimsPatch[1]; j++) {
-			int64_t k1 = j + idxLo[1];
-			k1 = (k1 > kMaxGrid[1]) ? k1 - dimsGrid[1] : k1;
-			for (uint64_t i = 0; i < dimsPatch[0]; i++) {
-				int64_t  k0 = i + idxLo[0];
-				uint64_t idx;
-				int      kCell;
-
-				k0    = (k0 > kMaxGrid[0]) ? k0 - dimsGrid[0] : k0;
-				idx   = i + (j + k * dimsPatch[1]) * dimsPatch[0];
-				kCell = (int)floor(sqrt((double)(k0 * k0 + k1 * k1
-				                                 + k2 * k2)));
-				data[idx] *= norm;
-
-				if ((kCell <= kMaxGrid[0]) && (kCell > 0)) {
-					P[kCell - 1]   += creal(data[idx]) * creal(data[idx])
-					                  + cimag(data[idx]) * cimag(data[idx]);
-					freq[kCell - 1] = kCell * wavenumToFreq;
-					numFreqHits[kCell - 1]++;
-				}
-			}
-		}
-	}
+	local_doKSpacePass(gridFFT, dim1D, LOCAL_KSPACE_PK, P, numFreqHits);
+
+	for (int i = 0; i < kMaxGrid[0]; i++)
+		freq[i] = (numFreqHits[i] > 0) ? (i + 1) * wavenumToFreq : -1.0;
 #ifdef WITH_MPI
 	local_reducePk(P, freq, numFreqHits, kMaxGrid[0]);
 #endif
@@ -698,6 +910,7 @@ local_getGrid(double         boxsizeInMpch,
               const char     *name,
               const char	 *varName,
               int            dim1D_proto,
+              const int      *nProcs,
               gridRegularDistrib_t *distrib)
 {
 	gridPointDbl_t    origin, extent;
@@ -707,9 +920,12 @@ local_getGrid(double         boxsizeInMpch,
 	dataVar_t         var;
 	gridPointInt_t nProc;
 
-	nProc[0] = 1;
-	nProc[1] = 1;
-	nProc[2] = 0;
+	for (int i = 0; i < NDIM; i++) {
+		if (nProcs != NULL)
+			nProc[i] = nProcs[i];
+		else
+			nProc[i] = (i == NDIM - 1) ? 0 : 1;
+	}
 
 	for (int i = 0; i < NDIM; i++) {
 		origin[i] = 0.0;
@@ -734,13 +950,7 @@ local_getGrid(double         boxsizeInMpch,
 	
 
 	var = dataVar_new(varName, DATAVARTYPE_FPV, 1);
-#ifdef WITH_FFT_FFTW3
-#  ifdef ENABLE_DOUBLE
-	dataVar_setMemFuncs(var, &fftw_malloc, &fftw_free);
-#  else
-	dataVar_setMemFuncs(var, &fftwf_malloc, &fftwf_free);
-#  endif
-#endif
+	dataVar_setMemFuncs(var, &memPool_malloc, &memPool_free);
 	gridRegular_attachVar(grid, var);
 
 	return grid;
@@ -758,9 +968,10 @@ local_fillInputGrid(gridRegular_t grid, gridReader_t reader)
 }
 
 static void
-local_fillOutputGrid(gridRegular_t       gridOut,
-                     const gridRegular_t gridIn,
-                     const gridRegular_t gridIn2)
+local_fillOutputGrid(gridRegular_t              gridOut,
+                     const gridRegular_t        gridIn,
+                     const gridRegular_t        gridIn2,
+                     const gridRegularDistrib_t distribIn)
 {
 	gridPatch_t       patchIn, patchOut, patchIn2;
 	fpv_t             *dataIn, *dataOut, *dataIn2;
@@ -782,7 +993,8 @@ local_fillOutputGrid(gridRegular_t       gridOut,
 
 	if ((dimsIn[0] < dimsOut[0]) && (dimsIn[1] < dimsOut[1])
 	    && (dimsIn[2] < dimsOut[2])) {
-		local_enforceConstraints(dataOut, dataIn, dimsOut, dimsIn, gridIn);
+		local_enforceConstraints(dataOut, dataIn, dimsOut, dimsIn,
+		                         distribIn);
 	} else {
 		fprintf(stdout, " (Interpolation: doing NGP)\n");
 		local_dataCopy(dataOut, dataIn, dimsOut, dimsIn, gridInDims,gridOutDims);
@@ -850,9 +1062,11 @@ local_addGridVal(gridRegular_t       gridOut,
 gridPointUint32_t dimsOut;
 gridPatch_t patchOut;
 fpv_t             *dataOut;
+uint64_t          dimRow;
 patchOut = gridRegular_getPatchHandle(gridOut, 0);
 dataOut  = (fpv_t *)gridPatch_getVarDataHandle(patchOut, 0);
 gridPatch_getDims(patchOut, dimsOut);
+dimRow   = gridPatch_getDimActual1D(patchOut, 0, 0);
 
 #if (NDIM > 2)
 #  ifdef WITH_OPENMP
@@ -863,159 +1077,323 @@ gridPatch_getDims(patchOut, dimsOut);
 	{
 		for (uint64_t j = 0; j < dimsOut[1]; j++) {
 			for (uint64_t i = 0; i < dimsOut[0]; i++) {
-				uint64_t    idxOut = i + (j + k * dimsOut[1]) * dimsOut[0];
+				uint64_t    idxOut = i + (j + k * dimsOut[1]) * dimRow;
 				dataOut[idxOut] += (fpv_t) val;
 			}
 		}
 	}
 } /* local_addGridVal */
 
-#define WRAP(i,dim) ((i)<0? (dim)+(i) : ((i)>=(dim)? (i)-(dim) : (i) ))
 static void
-local_enforceConstraints(fpv_t             *dataOut,
-                         const fpv_t       *dataIn,
-                         gridPointUint32_t dimsOut,
-                         gridPointUint32_t dimsIn,
-                         const gridRegular_t gridIn)
+local_enforceConstraints(fpv_t                      *dataOut,
+                         const fpv_t                *dataIn,
+                         gridPointUint32_t          dimsOut,
+                         gridPointUint32_t          dimsIn,
+                         const gridRegularDistrib_t distribIn)
 {
-	gridPointUint32_t dimsSV;
-	uint64_t bufsize = dimsIn[0]*dimsIn[1];
+	gridPointUint32_t dimsSV, dimsHalo, numTiles;
+	fpv_t             *dataHalo;
+	double            *weights[NDIM];
+	uint64_t          numTilesTotal = 1;
 
-	fpv_t *buffSendLo = malloc(sizeof(fpv_t) * bufsize);
-	fpv_t *buffSendHi = malloc(sizeof(fpv_t) * bufsize);
-	fpv_t *buffLo = malloc(sizeof(fpv_t) * bufsize);
-	fpv_t *buffHi = malloc(sizeof(fpv_t) * bufsize);
-	
-	for(uint64_t j = 0; j < dimsIn[1]; j++) {
-		for(uint64_t i = 0; i < dimsIn[0]; i++) {
-			uint64_t idx = i + j*dimsIn[0];
-			buffLo[idx] = dataIn[i+(j+(dimsIn[2]-1)*dimsIn[1])*dimsIn[0]];
-			buffHi[idx] = dataIn[idx];
-			buffSendLo[idx] = buffLo[idx];
-			buffSendHi[idx] = buffHi[idx];
-		}
+	for (int i = 0; i < NDIM; i++) {
+		assert(dimsOut[i] % dimsIn[i] == 0);
+		dimsSV[i]      = dimsOut[i] / dimsIn[i];
+		weights[i]     = xmalloc(sizeof(double) * 3 * dimsSV[i]);
+		local_calcCICWeights(dimsSV[i], weights[i]);
+		numTiles[i]    = (dimsIn[i] + LOCAL_TILE_SIZE - 1) / LOCAL_TILE_SIZE;
+		numTilesTotal *= numTiles[i];
 	}
 
-#ifdef WITH_MPI
-    int tile     = 0;
-	int numTiles = 1;
-	MPI_Status status;
-	MPI_Comm_size(MPI_COMM_WORLD, &numTiles);
-	MPI_Comm_rank(MPI_COMM_WORLD, &tile);
-	if(numTiles>1) {
-		int tile_lo = WRAP(tile-1,numTiles);
-		int tile_hi = WRAP(tile+1,numTiles);
-		if(tile%2 == 0) {
-			MPI_Send(&(buffSendLo[0]), bufsize, MPI_FLOAT, tile_hi, 1, MPI_COMM_WORLD);
-			MPI_Send(&(buffSendHi[0]), bufsize, MPI_FLOAT, tile_lo, 2, MPI_COMM_WORLD);
-			MPI_Recv(&(buffLo[0]), bufsize, MPI_FLOAT, tile_lo, 3, MPI_COMM_WORLD, &status);
-			MPI_Recv(&(buffHi[0]), bufsize, MPI_FLOAT, tile_hi, 4, MPI_COMM_WORLD, &status);
-		} else {
-			MPI_Recv(&(buffLo[0]), bufsize, MPI_FLOAT, tile_lo, 1, MPI_COMM_WORLD, &status);
-			MPI_Recv(&(buffHi[0]), bufsize, MPI_FLOAT, tile_hi, 2, MPI_COMM_WORLD, &status);
-			MPI_Send(&(buffSendLo[0]), bufsize, MPI_FLOAT, tile_hi, 3, MPI_COMM_WORLD);
-			MPI_Send(&(buffSendHi[0]), bufsize, MPI_FLOAT, tile_lo, 4, MPI_COMM_WORLD);
+	dataHalo = local_getHaloCopy(dataIn, dimsIn, dimsHalo);
+	local_exchangeHalo(dataHalo, dimsHalo, distribIn);
+
+#ifdef WITH_OPENMP
+#  pragma omp parallel
+#endif
+	{
+		double *bufX = xmalloc(sizeof(double) * LOCAL_TILE_SIZE * dimsSV[0]
+		                       * (LOCAL_TILE_SIZE + 2)
+		                       * (LOCAL_TILE_SIZE + 2));
+		double *bufY = xmalloc(sizeof(double) * LOCAL_TILE_SIZE * dimsSV[0]
+		                       * LOCAL_TILE_SIZE * dimsSV[1]
+		                       * (LOCAL_TILE_SIZE + 2));
+#ifdef WITH_OPENMP
+#  pragma omp for schedule(dynamic)
+#endif
+		for (uint64_t t = 0; t < numTilesTotal; t++) {
+			gridPointUint32_t lo, hi;
+			uint64_t          tmp = t;
+
+			for (int i = 0; i < NDIM; i++) {
+				lo[i] = (uint32_t)(tmp % numTiles[i]) * LOCAL_TILE_SIZE;
+				hi[i] = MIN(lo[i] + LOCAL_TILE_SIZE, dimsIn[i]);
+				tmp  /= numTiles[i];
+			}
+			local_refineTile(dataOut, dimsOut, dataHalo, dimsHalo, dimsSV,
+			                 lo, hi, weights, bufX, bufY);
 		}
+		xfree(bufY);
+		xfree(bufX);
 	}
-	
-#endif
+
+	xfree(dataHalo);
+	for (int i = 0; i < NDIM; i++)
+		xfree(weights[i]);
+} /* local_enforceConstraints */
+
+static fpv_t *
+local_getHaloCopy(const fpv_t       *data,
+                  gridPointUint32_t dims,
+                  gridPointUint32_t dimsHalo)
+{
+	fpv_t    *dataHalo;
+	uint64_t numCellsHalo = 1;
 
 	for (int i = 0; i < NDIM; i++) {
-		assert(dimsOut[i] % dimsIn[i] == 0);
-		dimsSV[i]           = dimsOut[i] / dimsIn[i];
+		dimsHalo[i]   = dims[i] + 2;
+		numCellsHalo *= dimsHalo[i];
 	}
+	dataHalo = xmalloc(sizeof(fpv_t) * numCellsHalo);
 
-#if (NDIM > 2)
-#  ifdef WITH_OPENMP
-#    pragma omp parallel for
-#  endif
-	for (int64_t k = 0; k < dimsIn[2]; k++)
+#ifdef WITH_OPENMP
+#  pragma omp parallel for
 #endif
-	{
-		for (int64_t j = 0; j < dimsIn[1]; j++) {
-			for (int64_t i = 0; i < dimsIn[0]; i++) {
-				double   dataInArr[27];
-				for (int kk=0;kk<3;kk++)
-				  for (int jj=0;jj<3;jj++)
-				    for (int ii=0;ii<3;ii++) {
-						if(k+kk-1>=0 && k+kk-1<dimsIn[2]) {
-							uint64_t    idxIn = WRAP(i+ii-1,dimsIn[0]) + (WRAP(j+jj-1,dimsIn[1]) + WRAP(k+kk-1,dimsIn[2]) * dimsIn[1]) * dimsIn[0];
-							dataInArr[ii+(jj+kk*3)*3] = dataIn[idxIn];
-						} else {
-							uint64_t    idxIn = WRAP(i+ii-1,dimsIn[0]) + WRAP(j+jj-1,dimsIn[1]) * dimsIn[0];
-							if(k+kk-1<0)
-								dataInArr[ii+(jj+kk*3)*3] = buffLo[idxIn];
-							if(k+kk-1>=dimsIn[2])
-								dataInArr[ii+(jj+kk*3)*3] = buffHi[idxIn];
-						}
-					}
-				      
-
-				uint64_t    idxOut = i * dimsSV[0]
-				                     + (j * dimsSV[1]
-				                        + k * dimsSV[2]
-				                        * dimsOut[1]) * dimsOut[0];
-				local_CICToSV(dataOut + idxOut, dimsOut, dimsSV,
-				              dataInArr);
-			}
+	for (uint32_t k = 0; k < dims[2]; k++) {
+		for (uint32_t j = 0; j < dims[1]; j++) {
+			memcpy(dataHalo + 1 + ((j + 1) + (k + 1) * (uint64_t)dimsHalo[1])
+			       * dimsHalo[0],
+			       data + (j + k * (uint64_t)dims[1]) * dims[0],
+			       sizeof(fpv_t) * dims[0]);
 		}
 	}
-	
-	free(buffSendLo);
-	free(buffSendHi);
-	free(buffLo);
-	free(buffHi);
-} /* local_enforceConstraints */
 
-inline static void
-local_setToSV(fpv_t             *data,
-              gridPointUint32_t dimsIn,
-              gridPointUint32_t dimsSV,
-              double            value)
+	return dataHalo;
+}
+
+static void
+local_exchangeHalo(fpv_t                      *data,
+                   gridPointUint32_t          dimsHalo,
+                   const gridRegularDistrib_t distrib)
 {
-#if (NDIM > 2)
-	for (uint64_t k = 0; k < dimsSV[2]; k++)
+	gridPointInt_t nProcs;
+
+	profile_enter("haloExchange");
+	gridRegularDistrib_getNProcs(distrib, nProcs);
+
+	for (int d = 0; d < NDIM; d++) {
+		uint64_t faceSize = 1;
+		fpv_t    *bufSendLo, *bufSendHi, *bufRecvLo, *bufRecvHi;
+
+		for (int i = 0; i < NDIM; i++)
+			faceSize *= (i == d) ? 1 : dimsHalo[i];
+		bufSendLo = xmalloc(sizeof(fpv_t) * faceSize);
+		bufSendHi = xmalloc(sizeof(fpv_t) * faceSize);
+		bufRecvLo = xmalloc(sizeof(fpv_t) * faceSize);
+		bufRecvHi = xmalloc(sizeof(fpv_t) * faceSize);
+
+		local_packFace(data, dimsHalo, d, 1, bufSendLo);
+		local_packFace(data, dimsHalo, d, dimsHalo[d] - 2, bufSendHi);
+
+		if (nProcs[d] == 1) {
+			memcpy(bufRecvLo, bufSendHi, sizeof(fpv_t) * faceSize);
+			memcpy(bufRecvHi, bufSendLo, sizeof(fpv_t) * faceSize);
+		} else {
+#ifdef WITH_MPI
+			MPI_Comm       comm = gridRegularDistrib_getCartComm(distrib);
+			gridPointInt_t coords;
+			int            rankLo, rankHi;
+			commScheme_t   schemeDown, schemeUp;
+
+			gridRegularDistrib_getProcCoords(distrib, coords);
+			coords[d] = (coords[d] + nProcs[d] - 1) % nProcs[d];
+			MPI_Cart_rank(comm, coords, &rankLo);
+			coords[d] = (coords[d] + 2) % nProcs[d];
+			MPI_Cart_rank(comm, coords, &rankHi);
+
+			// Separate schemes (and tags) for both directions, the two
+			// neighbours are identical if there are only two processes.
+			schemeDown = commScheme_new(comm, LOCAL_HALO_TAG + 2 * d);
+			schemeUp   = commScheme_new(comm, LOCAL_HALO_TAG + 2 * d + 1);
+			commScheme_addBuffer(schemeDown,
+			                     commSchemeBuffer_new(bufSendLo,
+			                                          (int)faceSize,
+			                                          MYMPI_FPV, rankLo),
+			                     COMMSCHEME_TYPE_SEND);
+			commScheme_addBuffer(schemeDown,
+			                     commSchemeBuffer_new(bufRecvHi,
+			                                          (int)faceSize,
+			                                          MYMPI_FPV, rankHi),
+			                     COMMSCHEME_TYPE_RECV);
+			commScheme_addBuffer(schemeUp,
+			                     commSchemeBuffer_new(bufSendHi,
+			                                          (int)faceSize,
+			                                          MYMPI_FPV, rankHi),
+			                     COMMSCHEME_TYPE_SEND);
+			commScheme_addBuffer(schemeUp,
+			                     commSchemeBuffer_new(bufRecvLo,
+			                                          (int)faceSize,
+			                                          MYMPI_FPV, rankLo),
+			                     COMMSCHEME_TYPE_RECV);
+			commScheme_fire(schemeDown);
+			commScheme_fire(schemeUp);
+			commScheme_wait(schemeDown);
+			commScheme_wait(schemeUp);
+			commScheme_del(&schemeDown);
+			commScheme_del(&schemeUp);
+			profile_addBytes(2 * sizeof(fpv_t) * faceSize);
+#else
+			assert(nProcs[d] == 1);
 #endif
-	{
-		for (uint64_t j = 0; j < dimsSV[1]; j++) {
-			for (uint64_t i = 0; i < dimsSV[0]; i++) {
-				data[i + (j + k * dimsIn[1]) * dimsIn[0]] = (fpv_t)value;
-			}
 		}
+
+		local_unpackFace(data, dimsHalo, d, 0, bufRecvLo);
+		local_unpackFace(data, dimsHalo, d, dimsHalo[d] - 1, bufRecvHi);
+
+		xfree(bufRecvHi);
+		xfree(bufRecvLo);
+		xfree(bufSendHi);
+		xfree(bufSendLo);
+	}
+	profile_leave();
+} /* local_exchangeHalo */
+
+static void
+local_packFace(const fpv_t       *data,
+               gridPointUint32_t dims,
+               int               dim,
+               uint32_t          pos,
+               fpv_t             *buf)
+{
+	uint64_t strides[3] = {1, dims[0], (uint64_t)dims[0] * dims[1]};
+	int      a          = (dim == 0) ? 1 : 0;
+	int      b          = (dim == 2) ? 1 : 2;
+	uint64_t n          = 0;
+
+	for (uint32_t ib = 0; ib < dims[b]; ib++) {
+		const fpv_t *row = data + pos * strides[dim] + ib * strides[b];
+		for (uint32_t ia = 0; ia < dims[a]; ia++)
+			buf[n++] = row[ia * strides[a]];
+	}
+}
+
+static void
+local_unpackFace(fpv_t             *data,
+                 gridPointUint32_t dims,
+                 int               dim,
+                 uint32_t          pos,
+                 const fpv_t       *buf)
+{
+	uint64_t strides[3] = {1, dims[0], (uint64_t)dims[0] * dims[1]};
+	int      a          = (dim == 0) ? 1 : 0;
+	int      b          = (dim == 2) ? 1 : 2;
+	uint64_t n          = 0;
+
+	for (uint32_t ib = 0; ib < dims[b]; ib++) {
+		fpv_t *row = data + pos * strides[dim] + ib * strides[b];
+		for (uint32_t ia = 0; ia < dims[a]; ia++)
+			row[ia * strides[a]] = buf[n++];
+	}
+}
+
+static void
+local_calcCICWeights(uint32_t factor, double *weights)
+{
+	for (uint32_t s = 0; s < factor; s++) {
+		double d = (s + 0.5) / ((double)factor);
+
+		weights[3 * s]     = fmax(0, 0.5 - d);
+		weights[3 * s + 1] = fmin(0.5 + d, 1.5 - d);
+		weights[3 * s + 2] = fmax(0, d - 0.5);
 	}
 }
 
+static void
+local_refineTile(fpv_t *restrict         dataOut,
+                 gridPointUint32_t       dimsOut,
+                 const fpv_t *restrict   dataHalo,
+                 gridPointUint32_t       dimsHalo,
+                 gridPointUint32_t       dimsSV,
+                 const gridPointUint32_t lo,
+                 const gridPointUint32_t hi,
+                 double *const           *weights,
+                 double *restrict        bufX,
+                 double *restrict        bufY)
+{
+	const uint64_t strideHaloY = dimsHalo[0];
+	const uint64_t strideHaloZ = (uint64_t)dimsHalo[0] * dimsHalo[1];
+	const uint64_t strideOutY  = dimsOut[0];
+	const uint64_t strideOutZ  = (uint64_t)dimsOut[0] * dimsOut[1];
+	const uint32_t nx          = hi[0] - lo[0];
+	const uint32_t ny          = hi[1] - lo[1];
+	const uint32_t nz          = hi[2] - lo[2];
+	const uint64_t nxX         = (uint64_t)nx * dimsSV[0];
+	const uint64_t nyY         = (uint64_t)ny * dimsSV[1];
+
+	// Along x, keeping the halo in y and z: bufX[x][j][k]
+	for (uint32_t k = 0; k < nz + 2; k++) {
+		for (uint32_t j = 0; j < ny + 2; j++) {
+			const fpv_t *src = dataHalo + lo[0] + (lo[1] + j) * strideHaloY
+			                   + (lo[2] + k) * strideHaloZ;
+			double      *dst = bufX + (j + k * (ny + 2)) * nxX;
+			for (uint32_t i = 0; i < nx; i++) {
+				for (uint32_t s = 0; s < dimsSV[0]; s++) {
+					const double *w = weights[0] + 3 * s;
+					dst[i * dimsSV[0] + s] = w[0] * src[i] + w[1] * src[i + 1]
+					                         + w[2] * src[i + 2];
+				}
+			}
+		}
+	}
+
+	// Along y, keeping the halo in z: bufY[x][y][k]
+	for (uint32_t k = 0; k < nz + 2; k++) {
+		for (uint32_t j = 0; j < ny; j++) {
+			const double *r0 = bufX + (j + k * (ny + 2)) * nxX;
+			const double *r1 = r0 + nxX;
+			const double *r2 = r1 + nxX;
+			for (uint32_t s = 0; s < dimsSV[1]; s++) {
+				const double *w   = weights[1] + 3 * s;
+				double       *dst = bufY + (j * dimsSV[1] + s + k * nyY) * nxX;
+				for (uint64_t x = 0; x < nxX; x++)
+					dst[x] = w[0] * r0[x] + w[1] * r1[x] + w[2] * r2[x];
+			}
+		}
+	}
+
+	// Along z, directly into the output.
+	for (uint32_t k = 0; k < nz; k++) {
+		for (uint32_t s = 0; s < dimsSV[2]; s++) {
+			const double *w = weights[2] + 3 * s;
+			for (uint64_t y = 0; y < nyY; y++) {
+				const double *p0  = bufY + (y + k * nyY) * nxX;
+				const double *p1  = p0 + nyY * nxX;
+				const double *p2  = p1 + nyY * nxX;
+				fpv_t        *dst = dataOut + lo[0] * dimsSV[0]
+				                    + (lo[1] * dimsSV[1] + y) * strideOutY
+				                    + ((lo[2] + k) * dimsSV[2] + s)
+				                    * strideOutZ;
+				for (uint64_t x = 0; x < nxX; x++)
+					dst[x] = (fpv_t)(w[0] * p0[x] + w[1] * p1[x]
+					                 + w[2] * p2[x]);
+			}
+		}
+	}
+} /* local_refineTile */
+
 inline static void
-local_CICToSV(fpv_t             *data,
+local_setToSV(fpv_t             *data,
               gridPointUint32_t dimsIn,
               gridPointUint32_t dimsSV,
-              double 			*valArr)
+              double            value)
 {
-	double    tx[3],ty[3],tz[3];
 #if (NDIM > 2)
 	for (uint64_t k = 0; k < dimsSV[2]; k++)
 #endif
 	{
-		double dz = ((double)k)/((double) dimsSV[2]) + 1/(2*(double) dimsSV[2]);
-		tz[0]=fmax(0, 0.5- dz);
-		tz[2]=fmax(0, dz-0.5 );
-		tz[1]=fmin( 0.5+dz , 1.5-dz );
 		for (uint64_t j = 0; j < dimsSV[1]; j++) {
-			double dy = ((double)j)/((double) dimsSV[1]) + 1/(2*(double) dimsSV[1]);
-			ty[0]=fmax(0, 0.5-dy );
-			ty[2]=fmax(0, dy-0.5 );
-			ty[1]=fmin( 0.5+dy , 1.5-dy );
 			for (uint64_t i = 0; i < dimsSV[0]; i++) {
-				double dx = ((double)i)/((double) dimsSV[0]) + 1/(2*(double) dimsSV[0]);
-				tx[0]=fmax(0, 0.5-dx );
-				tx[2]=fmax(0, dx-0.5 );
-				tx[1]=fmin( 0.5+dx , 1.5-dx );
-				double val=0;
-				for (int kk=0;kk<3;kk++)
-				  for (int jj=0;jj<3;jj++)
-				    for (int ii=0;ii<3;ii++)
-				       val = val+valArr[ii+(jj+kk*3)*3]*tx[ii]*ty[jj]*tz[kk];
-				data[i + (j + k * dimsIn[1]) * dimsIn[0]] = (fpv_t)val;
+				data[i + (j + k * dimsIn[1]) * dimsIn[0]] = (fpv_t)value;
 			}
 		}
 	}
@@ -16,6 +16,7 @@
 #include "refineGridConfig.h"
 #include "refineGridSetup.h"
 #include <stdlib.h>
+#include <stdio.h>
 #include <assert.h>
 #include "../../src/libutil/xmem.h"
 #include "../../src/libutil/xstring.h"
@@ -24,6 +25,22 @@
 
 
 /*--- Prototypes of local functions -------------------------------------*/
+#ifdef WITH_MPI
+
+/**
+ * @brief  Reads the process grid from the MPI section.
+ *
+ * @param[in,out]  setup
+ *                    The setup to fill.
+ * @param[in,out]  ini
+ *                    The ini file to read from.
+ *
+ * @return  Returns nothing.
+ */
+static void
+local_parseMPIStuff(refineGridSetup_t setup, parse_ini_t ini);
+
+#endif
 
 
 /*--- Implementations of exported functios ------------------------------*/
@@ -66,6 +83,9 @@ refineGridSetup_newFromIni(parse_ini_t ini,
 	} else {
 		setup->reader2SecName = NULL;
 	}
+#ifdef WITH_MPI
+	local_parseMPIStuff(setup, ini);
+#endif
 
 	return setup;
 } /* refineGridSetup_newFromIni */
@@ -88,3 +108,24 @@ refineGridSetup_del(refineGridSetup_t *setup)
 }
 
 /*--- Implementations of local functions --------------------------------*/
+#ifdef WITH_MPI
+static void
+local_parseMPIStuff(refineGridSetup_t setup, parse_ini_t ini)
+{
+	int32_t *nProcs;
+
+	if (parse_ini_get_int32list(ini, "nProcs", "MPI", NDIM, &nProcs)) {
+		for (int i = 0; i < NDIM; i++)
+			setup->nProcs[i] = (int)(nProcs[i]);
+		xfree(nProcs);
+	} else {
+		for (int i = 0; i < NDIM; i++)
+			setup->nProcs[i] = (i == NDIM - 1) ? 0 : 1;
+	}
+	if (setup->nProcs[0] != 1) {
+		fprintf(stderr, "The x dimension cannot be partitioned.\n");
+		exit(EXIT_FAILURE);
+	}
+}
+
+#endif
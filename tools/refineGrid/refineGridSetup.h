@@ -40,6 +40,10 @@ struct refineGridSetup_struct {
 	char     *reader2SecName;
 	bool	 doPk;
 	char	 *PkFile;
+#ifdef WITH_MPI
+	/** @brief  The process grid. */
+	int      nProcs[NDIM];
+#endif
 };
 
 
@@ -109,6 +113,23 @@ refineGridSetup_del(refineGridSetup_t *setup);
  * Please see @ref libgridIOOutIniFormat and @ref libgridIOInIniFormat for
  * details on how to write correct writer/reader sections.
  *
+ * Should MPI be enabled in the code, another section is evaluated:
+ *
+ * @code
+ * [MPI]
+ * #
+ * #################
+ * # Optional keys #
+ * #################
+ * #
+ * # This gives the processor grid employed in the domain decomposition of
+ * # both the input and the output grid.  The first number must be 1 (the
+ * # x dimension is not partitioned), the others may be 0 to let the
+ * # partitioning be done automatically.  Defaults to 1 1 0, which is a
+ * # slab decomposition.
+ * nProcs = <2 or 3 integers>
+ * #
+ * @endcode
  */
 
 